@@ -142,6 +142,9 @@ NMLumassEngine::~NMLumassEngine()
 void
 NMLumassEngine::shutdown(void)
 {
+    // deliver any pending async log messages
+    mLogger->setAsync(false);
+
     if (mLogFile.isOpen())
     {
         mLogFile.flush();
@@ -199,6 +202,16 @@ NMLumassEngine::setLogProvenance(bool logProv)
     }
 }
 
+void
+NMLumassEngine::setProfileFileName(const QString &fileName)
+{
+    mController->setProfileFileName(fileName);
+    if (!fileName.isEmpty())
+    {
+        NMLogInfo(<< "Model execution profiling enabled: " << fileName.toStdString());
+    }
+}
+
 std::string NMLumassEngine::processStringParameter(const QString& param)
 {
     std::string ret = param.toStdString();
@@ -312,7 +325,9 @@ NMLumassEngine::doModel(const QString& userFile, QString &workspace, QString& en
             workspace = ctrl->processStringParameter(nullptr, yamlWorkspace);
         }
 
-        if (mLogFileName.isEmpty() && !yamlLogfileName.isEmpty())
+        if (    mLogFileName.isEmpty()
+            &&  !mLogger->hasJsonSink()
+            &&  !yamlLogfileName.isEmpty())
         {
             yamlLogfileName = ctrl->processStringParameter(nullptr, yamlLogfileName);
 
@@ -120,6 +120,11 @@ public slots:
      */
     void setLogProvenance(bool logProv);
 
+    /*! writes an execution profile (Chrome trace JSON) of
+     *  each model run into the given file
+     */
+    void setProfileFileName(const QString& fileName);
+
     LumassEngineMode getEngineMode(void) { return mMode; }
 
     void doMOSO(const QString& losFileName);
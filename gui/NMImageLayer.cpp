@@ -45,6 +45,7 @@
 #include "NMVtkLookupTable.h"
 
 #include <QTime>
+#include <algorithm>
 #include <QtCore>
 #include <QtConcurrent>
 #include <QInputDialog>
@@ -79,6 +80,9 @@
 #include "itkImageRegion.h"
 #include "itkStatisticsImageFilter.h"
 #include "itkCastImageFilter.h"
+#include "itkRGBPixel.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
 
 #include "vtkImageData.h"
 #include "vtkImageSlice.h"
@@ -400,6 +404,90 @@ public:
         wrapName<PixelType, 3>::getSignedSpacing(img, numBands, sspacing); \
 }
 
+/*! assembles the tiles read by NMImageLayer::readTiles
+ *  into a single image covering the given (vtk) extent
+ */
+template<class PixelType, unsigned int Dimension>
+class InternalTileHelper
+{
+public:
+    typedef otb::Image<PixelType, Dimension> ImgType;
+    typedef otb::Image<itk::RGBPixel<PixelType>, Dimension> RGBImgType;
+
+    static itk::DataObject::Pointer mosaic(const std::vector<itk::DataObject::Pointer>& tiles,
+                                           unsigned int numBands, const int* ext)
+    {
+        if (numBands == 3)
+        {
+            return mosaicImage<RGBImgType>(tiles, ext);
+        }
+        return mosaicImage<ImgType>(tiles, ext);
+    }
+
+protected:
+    template<class TImage>
+    static itk::DataObject::Pointer mosaicImage(const std::vector<itk::DataObject::Pointer>& tiles,
+                                                const int* ext)
+    {
+        itk::DataObject::Pointer ret;
+        if (tiles.size() == 0)
+        {
+            return ret;
+        }
+
+        TImage* first = dynamic_cast<TImage*>(tiles.at(0).GetPointer());
+        if (first == nullptr)
+        {
+            return ret;
+        }
+
+        typename TImage::RegionType region;
+        for (unsigned int d=0; d < Dimension; ++d)
+        {
+            region.SetIndex(d, ext[d*2]);
+            region.SetSize(d, ext[d*2+1] - ext[d*2] + 1);
+        }
+
+        typename TImage::Pointer img = TImage::New();
+        img->CopyInformation(first);
+        img->SetRegions(region);
+        img->Allocate();
+
+        for (int t=0; t < tiles.size(); ++t)
+        {
+            TImage* tile = dynamic_cast<TImage*>(tiles.at(t).GetPointer());
+            if (tile == nullptr)
+            {
+                return ret;
+            }
+
+            typename TImage::RegionType treg = tile->GetBufferedRegion();
+            if (!treg.Crop(region))
+            {
+                continue;
+            }
+
+            itk::ImageRegionConstIterator<TImage> inIt(tile, treg);
+            itk::ImageRegionIterator<TImage> outIt(img, treg);
+            for (; !inIt.IsAtEnd(); ++inIt, ++outIt)
+            {
+                outIt.Set(inIt.Get());
+            }
+        }
+
+        ret = img.GetPointer();
+        return ret;
+    }
+};
+
+#define MosaicTiles( PixelType ) \
+{ \
+    if (req.numDimensions == 3) \
+        req.img = InternalTileHelper<PixelType, 3>::mosaic(tiles, req.numBands, req.ext); \
+    else \
+        req.img = InternalTileHelper<PixelType, 2>::mosaic(tiles, req.numBands, req.ext); \
+}
+
 
 //#define getInternalImgStats( PixelType, wrapName ) \
 //{	\
@@ -437,6 +525,7 @@ NMImageLayer::NMImageLayer(vtkRenderWindow* renWin,
     this->mScalarBand = 1;
 
     this->mScalarColIdx = -1;
+    this->mbUpdateScalars = false;
     this->mScalarBufferFile = 0;
 
     this->mZSliceIdx = 0;
@@ -449,6 +538,22 @@ NMImageLayer::NMImageLayer(vtkRenderWindow* renWin,
     this->mWTLx = itk::NumericTraits<double>::NonpositiveMin();
     this->mPrevZIdx = 0;
 
+    this->mLoadedOvIdx = mNotLoaded;
+    this->mPendingOvIdx = mNotLoaded;
+    this->mLoadedZIdx = 0;
+    this->mPendingZIdx = 0;
+    for (int i=0; i < 6; ++i)
+    {
+        this->mLoadedExtent[i] = 0;
+        this->mPendingExtent[i] = 0;
+    }
+
+    // tiles are read on a worker thread (s. mapExtentChanged)
+    this->mTileReader = nullptr;
+    this->mTileCache.setMaxCost(mTileCacheSize);
+    this->mTileRequestId = 0;
+    connect(&mTileWatcher, SIGNAL(finished()), this, SLOT(tilesLoaded()));
+
 //	this->mVtkConn->Connect(style, vtkCommand::ResetWindowLevelEvent,
 //			this, SLOT(windowLevelReset(vtkObject*)));
 //	this->mVtkConn->Connect(style, vtkCommand::InteractionEvent,
@@ -491,9 +596,9 @@ NMImageLayer::~NMImageLayer()
         QSqlDatabase::removeDatabase(conname);
     }
 
-    if (this->mOtbRAT.IsNotNull())
+    otb::SQLiteTable::Pointer st = dynamic_cast<otb::SQLiteTable*>(mOtbRAT.GetPointer());
+    if (st.IsNotNull())
     {
-        otb::SQLiteTable::Pointer st = static_cast<otb::SQLiteTable*>(mOtbRAT.GetPointer());
         st->CloseTable();
     }
 
@@ -502,6 +607,14 @@ NMImageLayer::~NMImageLayer()
         fclose(mScalarBufferFile);
     }
 
+    // cancel and wait for any tile request in progress
+    this->clearTileCache();
+    this->mTileWatcher.waitForFinished();
+    if (this->mTileReader)
+    {
+        delete this->mTileReader;
+    }
+
     if (this->mReader)
     {
         delete this->mReader;
@@ -1247,11 +1360,23 @@ NMImageLayer::updateAttributeTable()
     otb::RAMTable::Pointer ramTable = 0;
     if (mOtbRAT->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
     {
-        ramTable = static_cast<otb::RAMTable*>(mOtbRAT.GetPointer());
+        ramTable = dynamic_cast<otb::RAMTable*>(mOtbRAT.GetPointer());
     }
-    else
+    else if (mOtbRAT->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_SQLITE)
+    {
+        sqlTable = dynamic_cast<otb::SQLiteTable*>(mOtbRAT.GetPointer());
+    }
+
+    // e.g. a columnar table produced by a model's image reader: the
+    // table models address rows by index rather than by primary key
+    // and would try to edit the (read-only) mapped columns, so we
+    // just use the table for rendering, but don't provide a view
+    if (ramTable.IsNull() && sqlTable.IsNull())
     {
-        sqlTable = static_cast<otb::SQLiteTable*>(mOtbRAT.GetPointer());
+        NMLogWarn(<< ctxNMImageLayer << "::" << __FUNCTION__ << "() - "
+                  << "Attribute tables of type '" << mOtbRAT->GetNameOfClass()
+                  << "' can't be displayed!");
+        return 0;
     }
 
 
@@ -1482,6 +1607,36 @@ NMImageLayer::setFileName(QString filename)
     this->mComponentType = this->mReader->getOutputComponentType();
     this->mNodata = this->getDefaultNodata();
 
+    // a second reader (i.e. GDAL dataset) reading the display tiles
+    // on a worker thread; netCDF and rasdaman images aren't read
+    // concurrently, so their tiles are read through mReader instead
+    this->clearTileCache();
+    if (this->mTileReader != nullptr)
+    {
+        this->mTileWatcher.waitForFinished();
+        delete this->mTileReader;
+        this->mTileReader = nullptr;
+    }
+
+    if (    !this->mReader->isRasMode()
+        &&  dynamic_cast<const otb::GDALRATImageIO*>(this->mReader->getImageIOBase()) != nullptr
+       )
+    {
+        this->mTileReader = new NMImageReader(nullptr);
+        this->mTileReader->setRATType("ATTABLE_TYPE_SQLITE");
+        this->mTileReader->setRGBMode(true);
+        this->mTileReader->setDbRATReadOnly(true);
+        this->mTileReader->setFileName(filename);
+        this->mTileReader->instantiateObject();
+        if (!this->mTileReader->isInitialised())
+        {
+            delete this->mTileReader;
+            this->mTileReader = nullptr;
+        }
+    }
+    this->mLoadedOvIdx = mNotLoaded;
+    this->mPendingOvIdx = mNotLoaded;
+
     // ==> set the desired overview and requested region, if supported
     this->mapExtentChanged();
 
@@ -1801,12 +1956,6 @@ NMImageLayer::mapExtentChanged(void)
     // get the bbox and fullsize of this layer
     double h_ext = mBBox[1] - mBBox[0];
     double v_ext = mBBox[3] - mBBox[2];
-    double t_ext = mBBox[5] - mBBox[4];
-
-    int fullcols = h_ext / mSignedSpacing[0];
-    int fullrows = v_ext / ::fabs(mSignedSpacing[1]);
-    int fullslices = mNumDimensions == 3
-            ? t_ext / mSignedSpacing[2] :  0;
 
     double h_res;
     double v_res;
@@ -1938,81 +2087,416 @@ NMImageLayer::mapExtentChanged(void)
 
     if (this->mRenderer->GetViewProps()->GetNumberOfItems() > 0)
     {
-        // overview properties and visible extent
-        int cols = ovidx >= 0 ? mOverviewSize[ovidx][0] : fullcols;
-        int rows = ovidx >= 0 ? mOverviewSize[ovidx][1] : fullrows;
-        int slices = ovidx >= 0 ? mOverviewSize[ovidx][2] : fullslices;
-
-        double uspacing[3];
-        uspacing[0] = h_ext / cols;
-        uspacing[1] = v_ext / rows;
-        uspacing[2] = t_ext / slices;
-
-        int xo, yo, xe, ye, zo, ze;
-        xo = ((wminx - mBBox[0]) / uspacing[0]);
-        yo = ((mBBox[3] - wmaxy) / ::fabs(uspacing[1]));
-        zo = ((wminz - mBBox[4]) / uspacing[2]);
-        xe = ((wmaxx - mBBox[0]) / uspacing[0]);
-        ye = ((mBBox[3] - wminy) / ::fabs(uspacing[1]));
-        ze = ((wmaxz - mBBox[4]) / uspacing[2]);
+        const double wbox[4] = {wminx, wmaxx, wminy, wmaxy};
 
+        // the visible extent, snapped to the tile grid of the
+        // overview (incl. a one tile margin for panning)
+        int text[6];
+        this->getOverviewExtent(ovidx, wbox, text, true);
 
-        // calc vtk update extent
-        int uext[6];
-        uext[0] = xo > cols-1 ? cols-1 : xo < 0 ? 0 : xo;
-        uext[1] = xe > cols-1 ? cols-1 : xe < 0 ? 0 : xe;
-        uext[2] = yo > rows-1 ? rows-1 : yo < 0 ? 0 : yo;
-        uext[3] = ye > rows-1 ? rows-1 : ye < 0 ? 0 : ye;
-        uext[4] = mNumDimensions == 3 ? mZSliceIdx : 0;
-        uext[5] = mNumDimensions == 3 ? mZSliceIdx : 0;
+        int vext[6];
+        this->getOverviewExtent(ovidx, wbox, vext, false);
 
-        // visible itk image region
-        mVisibleRegion[0] = uext[0];                  // x-origin
-        mVisibleRegion[1] = uext[1] - uext[0] + 1;    // x-size
-        mVisibleRegion[2] = uext[2];                  // y-origin
-        mVisibleRegion[3] = uext[3] - uext[2] + 1;    // y-size
-        mVisibleRegion[4] = mNumDimensions == 3 ? mZSliceIdx : 0;
-        mVisibleRegion[5] = mNumDimensions == 3 ? 1 : 0;
-
-        //mVisibleRegion[4] = uext[4];                  // z-origin
-        //mVisibleRegion[5] = uext[4] == 0 && uext[5] == 0 ? 0 : uext[5] - uext[4] + 1; // z-size
+        // nothing to do, if the loaded tiles cover the visible extent ...
+        if (    ovidx == mLoadedOvIdx
+            &&  mZSliceIdx == mLoadedZIdx
+            &&  vext[0] >= mLoadedExtent[0] && vext[1] <= mLoadedExtent[1]
+            &&  vext[2] >= mLoadedExtent[2] && vext[3] <= mLoadedExtent[3]
+           )
+        {
+            // (any request still pending is stale now)
+            if (mPendingOvIdx != mNotLoaded)
+            {
+                ++mTileRequestId;
+                mPendingOvIdx = mNotLoaded;
+            }
+            return;
+        }
 
-        this->mReader->setOverviewIdx(ovidx, mVisibleRegion);
+        // ... or the tiles requested last
+        if (    ovidx == mPendingOvIdx
+            &&  mZSliceIdx == mPendingZIdx
+            &&  vext[0] >= mPendingExtent[0] && vext[1] <= mPendingExtent[1]
+            &&  vext[2] >= mPendingExtent[2] && vext[3] <= mPendingExtent[3]
+           )
+        {
+            return;
+        }
 
-        // update mapper, if actor is visible
-        if (this->mActor->GetVisibility())
+        // until the first tiles have arrived, the reader just
+        // provides the coarsest overview to the display pipeline
+        if (mLoadedOvIdx == mNotLoaded)
         {
-            this->mMapper->UpdateInformation();
-            NMVtkOpenGLImageSliceMapper* ism = NMVtkOpenGLImageSliceMapper::SafeDownCast(this->mMapper);
-            ism->SetDisplayExtent(uext);
-            ism->SetDataWholeExtent(uext);
-            this->mMapper->Update();
+            this->mReader->setOverviewIdx(mOverviewSize.size() - 1, 0);
+            this->requestTiles(ovidx, text);
+            return;
         }
 
-        // update the selection mapper if selection
-        // actor is visible
-        if (this->mImgSelSlice->GetVisibility())
+        // progressive display: if the view has left the loaded tiles
+        // altogether, show a coarse overview of it first
+        int coarseidx = mNotLoaded;
+        int cext[6];
+        if (mZSliceIdx == mLoadedZIdx)
         {
-            vtkSmartPointer<NMVtkOpenGLImageSliceMapper> imselm = NMVtkOpenGLImageSliceMapper::SafeDownCast(
-                        mImgSelMapper.GetPointer());
-            if (imselm.GetPointer() != nullptr)
+            int lext[6];
+            this->getOverviewExtent(mLoadedOvIdx, wbox, lext, false);
+            if (    lext[1] < mLoadedExtent[0] || lext[0] > mLoadedExtent[1]
+                ||  lext[3] < mLoadedExtent[2] || lext[2] > mLoadedExtent[3]
+               )
             {
-                imselm->UpdateInformation();
-                imselm->SetDisplayExtent(uext);
-                imselm->SetDataWholeExtent(uext);
-                imselm->Update();
+                const int lastidx = static_cast<int>(mOverviewSize.size()) - 1;
+                if (ovidx + 2 <= lastidx)
+                {
+                    coarseidx = ovidx + 2;
+                }
+                else if (ovidx < lastidx)
+                {
+                    coarseidx = lastidx;
+                }
+
+                if (coarseidx != mNotLoaded)
+                {
+                    this->getOverviewExtent(coarseidx, wbox, cext, true);
+                }
             }
         }
+
+        this->requestTiles(ovidx, text, coarseidx, cext);
     }
     else
     {
         this->mReader->setOverviewIdx(ovidx, 0);
+        this->mOverviewIdx = ovidx;
+        this->mLoadedOvIdx = mNotLoaded;
+        this->mDisplayedImage = nullptr;
     }
 
-    this->mOverviewIdx = ovidx;
     //NMDebugCtx(ctxNMImageLayer, << "done!");
 }
 
+void
+NMImageLayer::getOverviewExtent(int ovidx, const double wbox[4], int ext[6], bool bTileAligned)
+{
+    double h_ext = mBBox[1] - mBBox[0];
+    double v_ext = mBBox[3] - mBBox[2];
+
+    int cols = ovidx >= 0 ? mOverviewSize[ovidx][0] : h_ext / mSignedSpacing[0];
+    int rows = ovidx >= 0 ? mOverviewSize[ovidx][1] : v_ext / ::fabs(mSignedSpacing[1]);
+
+    double uspacing[2];
+    uspacing[0] = h_ext / cols;
+    uspacing[1] = v_ext / rows;
+
+    int xo, yo, xe, ye;
+    xo = ((wbox[0] - mBBox[0]) / uspacing[0]);
+    yo = ((mBBox[3] - wbox[3]) / ::fabs(uspacing[1]));
+    xe = ((wbox[1] - mBBox[0]) / uspacing[0]);
+    ye = ((mBBox[3] - wbox[2]) / ::fabs(uspacing[1]));
+
+    // calc vtk update extent
+    ext[0] = xo > cols-1 ? cols-1 : xo < 0 ? 0 : xo;
+    ext[1] = xe > cols-1 ? cols-1 : xe < 0 ? 0 : xe;
+    ext[2] = yo > rows-1 ? rows-1 : yo < 0 ? 0 : yo;
+    ext[3] = ye > rows-1 ? rows-1 : ye < 0 ? 0 : ye;
+    ext[4] = mNumDimensions == 3 ? mZSliceIdx : 0;
+    ext[5] = mNumDimensions == 3 ? mZSliceIdx : 0;
+
+    if (bTileAligned)
+    {
+        ext[0] = std::max(0, (ext[0] / mTileSize - 1) * mTileSize);
+        ext[1] = std::min(cols-1, (ext[1] / mTileSize + 2) * mTileSize - 1);
+        ext[2] = std::max(0, (ext[2] / mTileSize - 1) * mTileSize);
+        ext[3] = std::min(rows-1, (ext[3] / mTileSize + 2) * mTileSize - 1);
+    }
+}
+
+NMImageLayer::TileRequest
+NMImageLayer::createTileRequest(int ovidx, const int ext[6], bool bPreview)
+{
+    TileRequest req;
+    req.id = mTileRequestId;
+    req.bPreview = bPreview;
+    req.ovidx = ovidx;
+    req.zidx = mZSliceIdx;
+
+    const double h_ext = mBBox[1] - mBBox[0];
+    const double v_ext = mBBox[3] - mBBox[2];
+    req.cols = ovidx >= 0 ? mOverviewSize[ovidx][0] : h_ext / mSignedSpacing[0];
+    req.rows = ovidx >= 0 ? mOverviewSize[ovidx][1] : v_ext / ::fabs(mSignedSpacing[1]);
+
+    for (int i=0; i < 6; ++i)
+    {
+        req.ext[i] = ext[i];
+    }
+    req.bandMap = mBandMap;
+    req.componentType = mComponentType;
+    req.numDimensions = mNumDimensions;
+    req.numBands = mNumBands;
+
+    return req;
+}
+
+void
+NMImageLayer::requestTiles(int ovidx, const int ext[6], int previewidx, const int* pext)
+{
+    // the preview and the actual request share the same id,
+    // so any newer request cancels both of them
+    ++mTileRequestId;
+
+    QQueue<TileRequest> requests;
+    if (previewidx != mNotLoaded && pext != nullptr)
+    {
+        requests.enqueue(this->createTileRequest(previewidx, pext, true));
+    }
+    requests.enqueue(this->createTileRequest(ovidx, ext, false));
+
+    for (int i=0; i < 6; ++i)
+    {
+        mPendingExtent[i] = ext[i];
+    }
+    mPendingOvIdx = ovidx;
+    mPendingZIdx = mZSliceIdx;
+
+    // images we can't read concurrently are read right here
+    if (mTileReader == nullptr)
+    {
+        while (!requests.isEmpty())
+        {
+            this->displayTiles(this->readTiles(requests.dequeue()));
+            this->mRenderWindow->Render();
+        }
+        return;
+    }
+
+    // the request in progress notices that it's been superseded
+    // (s. readTiles), so we just queue these until it's done
+    mTileRequestQueue = requests;
+    if (mTileWatcher.isRunning())
+    {
+        return;
+    }
+
+    mTileWatcher.setFuture(QtConcurrent::run(this, &NMImageLayer::readTiles,
+                                             mTileRequestQueue.dequeue()));
+}
+
+NMImageLayer::TileRequest
+NMImageLayer::readTiles(TileRequest req)
+{
+    QMutexLocker readerLock(&mTileReaderMutex);
+
+    NMImageReader* reader = mTileReader != nullptr ? mTileReader : mReader;
+    if (req.bandMap.size() > 0 && reader->getBandMap() != req.bandMap)
+    {
+        reader->setBandMap(req.bandMap);
+    }
+
+    if (req.numDimensions == 3 && reader->getZSliceIdx() != req.zidx)
+    {
+        reader->setZSliceIdx(req.zidx);
+    }
+
+    const otb::ImageIOBase* io = reader->getImageIOBase();
+    const int pixelSize = io != nullptr ? io->GetComponentSize() * req.numBands : 1;
+
+    std::vector<itk::DataObject::Pointer> tiles;
+    for (int ty = req.ext[2] / mTileSize; ty <= req.ext[3] / mTileSize; ++ty)
+    {
+        for (int tx = req.ext[0] / mTileSize; tx <= req.ext[1] / mTileSize; ++tx)
+        {
+            // this request has been superseded
+            if (req.id != mTileRequestId)
+            {
+                return req;
+            }
+
+            const QString key = QString("%1:%2:%3:%4").arg(req.ovidx).arg(req.zidx).arg(tx).arg(ty);
+            {
+                QMutexLocker cacheLock(&mTileCacheMutex);
+                itk::DataObject::Pointer* cached = mTileCache.object(key);
+                if (cached != nullptr)
+                {
+                    tiles.push_back(*cached);
+                    continue;
+                }
+            }
+
+            int tlpr[6];
+            tlpr[0] = tx * mTileSize;
+            tlpr[1] = std::min(mTileSize, req.cols - tlpr[0]);
+            tlpr[2] = ty * mTileSize;
+            tlpr[3] = std::min(mTileSize, req.rows - tlpr[2]);
+            tlpr[4] = req.numDimensions == 3 ? req.zidx : 0;
+            tlpr[5] = req.numDimensions == 3 ? 1 : 0;
+
+            itk::DataObject::Pointer tile;
+            try
+            {
+                reader->setOverviewIdx(req.ovidx, tlpr);
+                tile = reader->getItkImage();
+                if (tile.IsNull())
+                {
+                    req.errMsg = "Failed reading image tile!";
+                    return req;
+                }
+                tile->Update();
+
+                // the reader creates a new output for the next tile
+                tile->DisconnectPipeline();
+            }
+            catch (itk::ExceptionObject& e)
+            {
+                req.errMsg = e.GetDescription();
+                return req;
+            }
+
+            tiles.push_back(tile);
+
+            // don't cache a tile of a cancelled request, it may
+            // have been read with settings that are out of date
+            // by now (s. clearTileCache)
+            QMutexLocker cacheLock(&mTileCacheMutex);
+            if (req.id != mTileRequestId)
+            {
+                return req;
+            }
+            mTileCache.insert(key, new itk::DataObject::Pointer(tile),
+                              std::max(1, (tlpr[1] * tlpr[3] * pixelSize) / 1024));
+        }
+    }
+
+    switch (req.componentType)
+    {
+    LocalMacroPerSingleType( MosaicTiles )
+    default:
+        req.errMsg = "Unsupported pixel type!";
+        break;
+    }
+
+    return req;
+}
+
+void
+NMImageLayer::tilesLoaded(void)
+{
+    TileRequest req = mTileWatcher.result();
+    if (req.id == mTileRequestId)
+    {
+        this->displayTiles(req);
+        this->mRenderWindow->Render();
+    }
+
+    // start the next queued request, unless it's been superseded
+    // by the tiles we've just got
+    while (!mTileRequestQueue.isEmpty())
+    {
+        TileRequest next = mTileRequestQueue.dequeue();
+        if (    next.id == mTileRequestId
+            &&  mPendingOvIdx != mNotLoaded
+           )
+        {
+            mTileWatcher.setFuture(QtConcurrent::run(this, &NMImageLayer::readTiles, next));
+            break;
+        }
+    }
+}
+
+void
+NMImageLayer::displayTiles(const TileRequest& req)
+{
+    if (!req.errMsg.empty())
+    {
+        NMLogError(<< ctxNMImageLayer << ": " << this->objectName().toStdString()
+                   << " - " << req.errMsg);
+    }
+
+    if (req.img.IsNull())
+    {
+        return;
+    }
+
+    // visible itk image region
+    mVisibleRegion[0] = req.ext[0];                     // x-origin
+    mVisibleRegion[1] = req.ext[1] - req.ext[0] + 1;    // x-size
+    mVisibleRegion[2] = req.ext[2];                     // y-origin
+    mVisibleRegion[3] = req.ext[3] - req.ext[2] + 1;    // y-size
+    mVisibleRegion[4] = req.numDimensions == 3 ? req.zidx : 0;
+    mVisibleRegion[5] = req.numDimensions == 3 ? 1 : 0;
+
+    // keep the reader's region in line with what's displayed
+    // (just meta data, no pixels are read here)
+    if (mTileReader != nullptr)
+    {
+        this->mReader->setOverviewIdx(req.ovidx, mVisibleRegion);
+    }
+
+    QSharedPointer<NMItkDataObjectWrapper> imgW(new NMItkDataObjectWrapper(0,
+            req.img, req.componentType, req.numDimensions, req.numBands));
+    if (req.numBands == 3)
+    {
+        imgW->setIsRGBImage(true);
+    }
+    this->mPipeconn->setInput(imgW);
+    mDisplayedImage = req.img;
+
+    int uext[6];
+    for (int i=0; i < 6; ++i)
+    {
+        uext[i] = req.ext[i];
+        mLoadedExtent[i] = req.ext[i];
+    }
+    mLoadedOvIdx = req.ovidx;
+    mLoadedZIdx = req.zidx;
+    mOverviewIdx = req.ovidx;
+
+    // a preview is followed by the actual request
+    if (!req.bPreview)
+    {
+        mPendingOvIdx = mNotLoaded;
+    }
+
+    // update mapper, if actor is visible
+    if (this->mActor.GetPointer() != nullptr && this->mActor->GetVisibility())
+    {
+        this->mMapper->UpdateInformation();
+        NMVtkOpenGLImageSliceMapper* ism = NMVtkOpenGLImageSliceMapper::SafeDownCast(this->mMapper);
+        ism->SetDisplayExtent(uext);
+        ism->SetDataWholeExtent(uext);
+        this->mMapper->Update();
+    }
+
+    // update the selection mapper if selection
+    // actor is visible
+    if (this->mImgSelSlice.GetPointer() != nullptr && this->mImgSelSlice->GetVisibility())
+    {
+        vtkSmartPointer<NMVtkOpenGLImageSliceMapper> imselm = NMVtkOpenGLImageSliceMapper::SafeDownCast(
+                    mImgSelMapper.GetPointer());
+        if (imselm.GetPointer() != nullptr)
+        {
+            imselm->UpdateInformation();
+            imselm->SetDisplayExtent(uext);
+            imselm->SetDataWholeExtent(uext);
+            imselm->Update();
+        }
+    }
+}
+
+void
+NMImageLayer::clearTileCache(void)
+{
+    mTileRequestQueue.clear();
+    mDisplayedImage = nullptr;
+    mPendingOvIdx = mNotLoaded;
+    mLoadedOvIdx = mNotLoaded;
+    mWTLx = itk::NumericTraits<double>::NonpositiveMin();
+
+    // bump the id while holding the cache lock, so a request in
+    // progress can't slip a stale tile in after the cache's cleared
+    QMutexLocker cacheLock(&mTileCacheMutex);
+    ++mTileRequestId;
+    mTileCache.clear();
+}
+
 void
 NMImageLayer::setBandMap(const std::vector<int> map)
 {
@@ -2020,6 +2504,10 @@ NMImageLayer::setBandMap(const std::vector<int> map)
     if (this->mReader != 0 && this->mReader->isInitialised())
     {
         this->mReader->setBandMap(mBandMap);
+
+        // cached tiles are of no use with a different band map
+        this->clearTileCache();
+        this->mapExtentChanged();
     }
 }
 
@@ -2274,15 +2762,12 @@ NMImageLayer::setScalars(vtkImageData* img)
         }
     }
 
-    if (colidx != mScalarColIdx)
+    // the cached scalar values are kept across redraws
+    // until the legend value field or the table changes
+    if (colidx != mScalarColIdx || mbUpdateScalars)
     {
         mScalarColIdx = colidx;
-        if (1)//mNumRecords <= 1e6)
-        {
-            mScalarDoubleMap.clear();
-            mScalarLongLongMap.clear();
-            updateScalarBuffer();
-        }
+        this->clearScalarBuffer();
     }
 
     vtkDataSetAttributes* dsa = img->GetAttributes(vtkDataSet::POINT);
@@ -2302,7 +2787,6 @@ NMImageLayer::setScalars(vtkImageData* img)
             double* out = static_cast<double*>(ar->GetVoidPointer(0));
             const double nodata = this->getNodata();
 
-            std::map<long long, double>::iterator it;
             switch(idxScalars->GetDataType())
             {
             vtkTemplateMacro(setDoubleScalars(static_cast<VTK_TT*>(buf),
@@ -2311,19 +2795,12 @@ NMImageLayer::setScalars(vtkImageData* img)
                             );
             default:
                 {
+                    std::vector<long long> idxbuf(numPix);
                     for (int i=0; i < numPix; ++i)
                     {
-                        const long idx = idxScalars->GetVariantValue(i).ToLong();
-                        it = mScalarDoubleMap.find(idx);
-                        if (it != mScalarDoubleMap.end())
-                        {
-                            out[i] = it->second;
-                        }
-                        else
-                        {
-                            out[i] = nodata;
-                        }
+                        idxbuf[i] = idxScalars->GetVariantValue(i).ToLongLong();
                     }
+                    setDoubleScalars(idxbuf.data(), out, numPix, nodata);
                 }
             }
 
@@ -2348,7 +2825,6 @@ NMImageLayer::setScalars(vtkImageData* img)
             long long* out = static_cast<long long*>(ar->GetVoidPointer(0));
             long long nodata = static_cast<long long>(this->getNodata());
 
-            std::map<long long, long long>::iterator it;
             switch(idxScalars->GetDataType())
             {
             vtkTemplateMacro(
@@ -2358,19 +2834,12 @@ NMImageLayer::setScalars(vtkImageData* img)
                         );
             default:
                 {
+                    std::vector<long long> idxbuf(numPix);
                     for (int i=0; i < numPix; ++i)
                     {
-                        const long idx = idxScalars->GetVariantValue(i).ToLong();
-                        it = mScalarLongLongMap.find(idx);
-                        if (it != mScalarLongLongMap.end())
-                        {
-                            out[i] = it->second;
-                        }
-                        else
-                        {
-                            out[i] = nodata;
-                        }
+                        idxbuf[i] = idxScalars->GetVariantValue(i).ToLongLong();
                     }
+                    setLongScalars(idxbuf.data(), out, numPix, nodata);
                 }
             }
             dsa->AddArray(ar);
@@ -2397,10 +2866,32 @@ NMImageLayer::setComponentScalars(T* in, T* out, int numPix)
 }
 
 void
-NMImageLayer::updateScalarBuffer()
+NMImageLayer::updateScalarBuffer(const std::vector<long long>& keys)
 {
+    // only fetch what we haven't got already
+    std::vector<long long> fetchKeys;
+    fetchKeys.reserve(keys.size());
+    for (size_t k=0; k < keys.size(); ++k)
+    {
+        const long long key = keys[k];
+        if (    mScalarLongLongMap.find(key) == mScalarLongLongMap.end()
+            &&  mScalarDoubleMap.find(key) == mScalarDoubleMap.end()
+            &&  mScalarMissingKeys.find(key) == mScalarMissingKeys.end()
+           )
+        {
+            fetchKeys.push_back(key);
+        }
+    }
+
+    if (fetchKeys.size() == 0)
+    {
+        return;
+    }
+
     NMDebugCtx(ctxNMImageLayer, << "...");
 
+    const QVariant::Type coltype = this->getColumnType(mScalarColIdx);
+
     NMSqlTableModel* sqlModel = qobject_cast<NMSqlTableModel*>(mTableModel);
     QString conSuffix = QString("updateBuffer_%1").arg(NMGlobalHelper::getRandomString(8));
     QString conname;
@@ -2414,7 +2905,7 @@ NMImageLayer::updateScalarBuffer()
         }
 
         QSqlDriver* drv = db.driver();
-        QString prepStr = QString("SELECT %1,%2 from %3")
+        const QString selStr = QString("SELECT %1,%2 from %3 where %1 in (")
                             .arg(drv->escapeIdentifier(sqlModel->getNMPrimaryKey(), QSqlDriver::FieldName))
                             .arg(drv->escapeIdentifier(mLegendValueField, QSqlDriver::FieldName))
                             .arg(drv->escapeIdentifier(sqlModel->tableName(), QSqlDriver::TableName));
@@ -2426,238 +2917,200 @@ NMImageLayer::updateScalarBuffer()
             return;
         }
 
+        // we fetch the values of all (new) distinct pixel values of the
+        // buffer in batches, rather than one by one or the whole table
+        std::unordered_set<long long> fetched;
+        const size_t batchSize = 4096;
         QSqlQuery q(db);
         q.setForwardOnly(true);
-        if (!q.exec(prepStr))
-        {
-            NMLogError(<< ctxNMImageLayer << ": Couldn't fetch scalar values from database: "
-                       << q.lastError().text().toStdString());
-            return;
-        }
-
-        double dnodata = 0;
-        long long inodata = 0;
-
-        const int rep = mNumRecords / 20;
-        for (int r=0; r < mNumRecords; ++r)
+        for (size_t b=0; b < fetchKeys.size(); b += batchSize)
         {
-            q.next();
+            const size_t bend = std::min(b + batchSize, fetchKeys.size());
+            QString inList;
+            inList.reserve(static_cast<int>((bend - b) * 8));
+            for (size_t k=b; k < bend; ++k)
+            {
+                if (k > b)
+                {
+                    inList += QStringLiteral(",");
+                }
+                inList += QString::number(fetchKeys[k]);
+            }
 
-            switch(this->getColumnType(mScalarColIdx))
+            if (!q.exec(QString("%1%2)").arg(selStr).arg(inList)))
             {
-            case QVariant::Int:
-            case QVariant::LongLong:
-            case QVariant::UInt:
-            case QVariant::ULongLong:
+                NMLogError(<< ctxNMImageLayer << ": Couldn't fetch scalar values from database: "
+                           << q.lastError().text().toStdString());
+                break;
+            }
 
-                    mScalarLongLongMap.insert(
-                                std::pair<long long, long long>(
-                                q.value(0).toLongLong(),
-                                q.value(1).toLongLong()));
+            while (q.next())
+            {
+                const long long key = q.value(0).toLongLong();
+                switch(coltype)
+                {
+                case QVariant::Int:
+                case QVariant::LongLong:
+                case QVariant::UInt:
+                case QVariant::ULongLong:
+                    mScalarLongLongMap[key] = q.value(1).toLongLong();
                     break;
 
-            case QVariant::Double:
-
-                    mScalarDoubleMap.insert(
-                                   std::pair<long long, double>(
-                                   q.value(0).toLongLong(),
-                                   q.value(1).toDouble()));
-                   break;
+                case QVariant::Double:
+                    mScalarDoubleMap[key] = q.value(1).toDouble();
+                    break;
 
-            default:
-                break;
+                default:
+                    break;
+                }
+                fetched.insert(key);
             }
+            q.finish();
+        }
+        db.commit();
 
-            if (r % (rep > 0 ? rep : 1) == 0)
+        // remember the ones not in the table
+        for (size_t k=0; k < fetchKeys.size(); ++k)
+        {
+            if (fetched.find(fetchKeys[k]) == fetched.end())
             {
-                NMDebug(<< ".");
+                mScalarMissingKeys.insert(fetchKeys[k]);
             }
         }
-        q.finish();
-        db.commit();
     }
     NMGlobalHelper::getMainWindow()->removeDbConnection(sqlModel->getDatabaseName(), conname);
 
-    NMDebug(<< std::endl);
+    NMDebugAI(<< "fetched " << fetchKeys.size() << " scalar values" << std::endl);
     NMDebugCtx(ctxNMImageLayer, << "done!");
 }
 
-// worker function for scalars setting
-template<class T>
 void
-NMImageLayer::setLongScalars(T* buf, long long *out,
-                                     long long numPix,
-                                     long long nodata)
+NMImageLayer::clearScalarBuffer(void)
 {
-    //CALLGRIND_START_INSTRUMENTATION;
-    if (0)//mNumRecords > 1e6)
-    {
-        int nthreads = QThread::idealThreadCount();
-        long long threadpix = numPix / nthreads;
-        long long rest = numPix - (threadpix * nthreads);
-
-        QList<QFuture<void> > flist;
-        for (int t=0; t < nthreads; ++t)
-        {
-            flist << QFuture<void>();
-        }
-
-        long long start=0, end=0;
-        for (int th=0; th < nthreads; ++th)
-        {
-            end = start+threadpix-1;
-
-            if (th == nthreads-1)
-            {
-                end += rest;
-            }
-
-            flist[th] = QtConcurrent::run(this, &NMImageLayer::setLongDBScalars<T>,
-                                           buf, out, start, end, nodata);
+    mScalarLongLongMap.clear();
+    mScalarDoubleMap.clear();
+    mScalarMissingKeys.clear();
+}
 
-            start = end+1;
-        }
+void
+NMImageLayer::tableDataChanged(const QModelIndex& tl, const QModelIndex& br)
+{
+    // the cached scalar values are likely to be out of date
+    this->mbUpdateScalars = true;
+    NMLayer::tableDataChanged(tl, br);
+}
 
-        for (int th=0; th < nthreads; ++th)
-        {
-            flist[th].waitForFinished();
-        }
-    }
-    else
+// worker function for getting the distinct pixel values
+template<class T>
+void
+NMImageLayer::getUniqueKeys(T* buf, long long start, long long end,
+                            std::vector<long long>* keys)
+{
+    keys->resize(end - start + 1);
+    for (long long i=start; i <= end; ++i)
     {
-        std::map<long long, long long>::iterator it;
-        for (int i=0; i < numPix; ++i)
-        {
-            it = mScalarLongLongMap.find(buf[i]);
-            if (it != mScalarLongLongMap.end())
-            {
-                out[i] = it->second;
-            }
-            else
-            {
-                out[i] = nodata;
-            }
-        }
+        (*keys)[i-start] = static_cast<long long>(buf[i]);
     }
+    std::sort(keys->begin(), keys->end());
+    keys->erase(std::unique(keys->begin(), keys->end()), keys->end());
 }
 
 template<class T>
 void
-NMImageLayer::setLongDBScalars(T* buf,
-                               long long* out,
-                               long long start,
-                               long long end,
-                               long long nodata
-                               )
+NMImageLayer::collectUniqueKeys(T* buf, long long numPix, std::vector<long long>& keys)
 {
-    NMSqlTableModel* sqlModel = qobject_cast<NMSqlTableModel*>(mTableModel);
+    keys.clear();
+    if (numPix <= 0)
+    {
+        return;
+    }
 
-    QString conname = QString("NMImageLayer_%1").arg(NMGlobalHelper::getRandomString(8));
+    // don't bother with threads for small buffers
+    const long long minThreadPix = 65536;
+    int nthreads = QThread::idealThreadCount();
+    if (nthreads < 1 || numPix < nthreads * minThreadPix)
+    {
+        nthreads = std::max(1LL, numPix / minThreadPix);
+    }
+    long long threadpix = numPix / nthreads;
+    long long rest = numPix - (threadpix * nthreads);
 
-    // db scope
-    // without db and q going out of scope, we cannot remove
-    // db without Qt complaining
+    std::vector<std::vector<long long> > parts(nthreads);
+    QList<QFuture<void> > flist;
+
+    long long start=0, end=0;
+    for (int th=0; th < nthreads; ++th)
     {
-        NMQSQLiteDriver* drv = new NMQSQLiteDriver();
-        QSqlDatabase db = QSqlDatabase::addDatabase(drv, conname);
-        db.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE;"
-                                "QSQLITE_INIT_SPATIALITE;"
-                                "QSQLITE_OPEN_URI;"
-                                "QSQLITE_OPEN_READONLY");
-        db.setDatabaseName(sqlModel->getDatabaseName());
-        if (!db.open())
+        end = start+threadpix-1;
+
+        if (th == nthreads-1)
         {
-            NMLogError(<< ctxNMImageLayer << "::" << __FUNCTION__ << "() - setLongDBScalars '"
-                       << sqlModel->getDatabaseName().toStdString() << "' failed: "
-                       << db.lastError().text().toStdString());
+            end += rest;
         }
 
-        QString prepStr = QString("SELECT %1 from %2 where %3 = :row")
-                            .arg(drv->escapeIdentifier(mLegendValueField, QSqlDriver::FieldName))
-                            .arg(drv->escapeIdentifier(sqlModel->tableName(), QSqlDriver::TableName))
-                            .arg(drv->escapeIdentifier(sqlModel->getNMPrimaryKey(), QSqlDriver::FieldName));
+        flist << QtConcurrent::run(this, &NMImageLayer::getUniqueKeys<T>,
+                                   buf, start, end, &parts[th]);
+        start = end+1;
+    }
 
-        db.transaction();
-        QSqlQuery q(db);
-        if (q.prepare(prepStr))
-        {
-            for (int i=start; i <= end; ++i)
-            {
-                q.bindValue(0, QVariant::fromValue(buf[i]));
-                if (q.exec())
-                {
-                    if (q.next())
-                    {
-                        out[i] = q.value(0).toLongLong();
-                    }
-                    else
-                    {
-                        out[i] = nodata;
-                    }
-                }
-                else
-                {
-                    out[i] = nodata;
-                }
-                q.finish();
-            }
-        }
-        else
-        {
-            std::string err = q.lastError().text().toStdString();
-            NMLogError(<< ctxNMImageLayer << ": " << err);
-        }
-        q.finish();
-        db.commit();
-        db.close();
+    for (int th=0; th < nthreads; ++th)
+    {
+        flist[th].waitForFinished();
+    }
+
+    // merge the sorted partial results
+    keys.swap(parts[0]);
+    std::vector<long long> merged;
+    for (int th=1; th < nthreads; ++th)
+    {
+        merged.clear();
+        merged.reserve(keys.size() + parts[th].size());
+        std::set_union(keys.begin(), keys.end(),
+                       parts[th].begin(), parts[th].end(),
+                       std::back_inserter(merged));
+        keys.swap(merged);
     }
-    QSqlDatabase::removeDatabase(conname);
 }
 
-template<class T>
+template<class T, class V>
 void
-NMImageLayer::setDoubleScalars(T* buf, double* out,
-                               long long numPix, double nodata)
+NMImageLayer::mapCachedScalars(T* buf, V* out, long long numPix, V nodata,
+                               const std::vector<long long>& keys,
+                               const std::unordered_map<long long, V>& cache)
 {
-    if (0)//mNumRecords > 1e6)
+    if (keys.size() == 0)
     {
-        int nthreads = QThread::idealThreadCount();
-        long long threadpix = numPix / nthreads;
-        long long rest = numPix - (threadpix * nthreads);
-
-        QList<QFuture<void> > flist;
-        for (int t=0; t < nthreads; ++t)
-        {
-            flist << QFuture<void>();
-        }
+        return;
+    }
 
-        long long start=0, end=0;
-        for (int th=0; th < nthreads; ++th)
+    // use a dense lookup table, if the range of pixel values is compact
+    // (e.g. categories), otherwise go for the hashed cache
+    const long long minKey = keys.front();
+    const long long range = keys.back() - minKey + 1;
+    if (range > 0 && range <= static_cast<long long>(keys.size()) * 4 + 1024)
+    {
+        std::vector<V> lut(range, nodata);
+        for (size_t k=0; k < keys.size(); ++k)
         {
-            end = start+threadpix-1;
-
-            if (th == nthreads-1)
+            typename std::unordered_map<long long, V>::const_iterator it = cache.find(keys[k]);
+            if (it != cache.end())
             {
-                end += rest;
+                lut[keys[k] - minKey] = it->second;
             }
-
-            flist[th] = QtConcurrent::run(this, &NMImageLayer::setDoubleDBScalars<T>,
-                                           buf, out, start, end, nodata);
-            start = end+1;
         }
 
-        for (int th=0; th < nthreads; ++th)
+        for (long long i=0; i < numPix; ++i)
         {
-            flist[th].waitForFinished();
+            out[i] = lut[static_cast<long long>(buf[i]) - minKey];
         }
     }
     else
     {
-        std::map<long long, double>::iterator it;
-        for (int i=0; i < numPix; ++i)
+        typename std::unordered_map<long long, V>::const_iterator it;
+        for (long long i=0; i < numPix; ++i)
         {
-            it = mScalarDoubleMap.find(buf[i]);
-            if (it != mScalarDoubleMap.end())
+            it = cache.find(static_cast<long long>(buf[i]));
+            if (it != cache.end())
             {
                 out[i] = it->second;
             }
@@ -2671,76 +3124,26 @@ NMImageLayer::setDoubleScalars(T* buf, double* out,
 
 template<class T>
 void
-NMImageLayer::setDoubleDBScalars(T* buf,
-                                 double* out,
-                                 long long start,
-                                 long long end,
-                                 double nodata
-                                 )
+NMImageLayer::setLongScalars(T* buf, long long *out,
+                                     long long numPix,
+                                     long long nodata)
 {
-    NMSqlTableModel* sqlModel = qobject_cast<NMSqlTableModel*>(mTableModel);
-
-    QString conname = QString("NMImageLayer_%1").arg(NMGlobalHelper::getRandomString(8));
-
-    // db scope
-    // without db and q going out of scope, we cannot remove
-    // db without Qt complaining
-    {
-        NMQSQLiteDriver* drv = new NMQSQLiteDriver();
-        QSqlDatabase db = QSqlDatabase::addDatabase(drv, conname);
-        db.setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE;"
-                                "QSQLITE_INIT_SPATIALITE;"
-                                "QSQLITE_OPEN_URI;"
-                                "QSQLITE_OPEN_READONLY");
-        db.setDatabaseName(sqlModel->getDatabaseName());
-        if (!db.open())
-        {
-            NMLogError(<< ctxNMImageLayer << "::" << __FUNCTION__ << "() - setDoubleDBScalars '"
-                       << sqlModel->getDatabaseName().toStdString() << "' failed: "
-                       << db.lastError().text().toStdString());
-        }
-
-        QString prepStr = QString("SELECT %1 from %2 where %3 = :row")
-                            .arg(drv->escapeIdentifier(mLegendValueField, QSqlDriver::FieldName))
-                            .arg(drv->escapeIdentifier(sqlModel->tableName(), QSqlDriver::TableName))
-                            .arg(drv->escapeIdentifier(sqlModel->getNMPrimaryKey(), QSqlDriver::FieldName));
-
+    //CALLGRIND_START_INSTRUMENTATION;
+    std::vector<long long> keys;
+    this->collectUniqueKeys(buf, numPix, keys);
+    this->updateScalarBuffer(keys);
+    this->mapCachedScalars(buf, out, numPix, nodata, keys, mScalarLongLongMap);
+}
 
-        db.transaction();
-        QSqlQuery q(db);
-        if (q.prepare(prepStr))
-        {
-            for (int i=start; i <= end; ++i)
-            {
-                q.bindValue(0, QVariant::fromValue(buf[i]));
-                if (q.exec())
-                {
-                    if (q.next())
-                    {
-                        out[i] = q.value(0).toDouble();
-                    }
-                    else
-                    {
-                        out[i] = nodata;
-                    }
-                }
-                else
-                {
-                    out[i] = nodata;
-                }
-                q.finish();
-            }
-        }
-        else
-        {
-            std::string err = q.lastError().text().toStdString();
-            NMLogError(<< ctxNMImageLayer << ": " << err);
-        }
-        q.finish();
-        db.commit();
-        db.close();
-    }
-    QSqlDatabase::removeDatabase(conname);
+template<class T>
+void
+NMImageLayer::setDoubleScalars(T* buf, double* out,
+                               long long numPix, double nodata)
+{
+    std::vector<long long> keys;
+    this->collectUniqueKeys(buf, numPix, keys);
+    this->updateScalarBuffer(keys);
+    this->mapCachedScalars(buf, out, numPix, nodata, keys, mScalarDoubleMap);
 }
 
 template<class T>
@@ -2856,6 +3259,7 @@ NMImageLayer::updateSourceBuffer(void)
         }
 
         this->mPipeconn->setInput(dc->getOutput(0));
+        this->mDisplayedImage = nullptr;
         this->mMapper->Update();
         this->mRenderer->Render();
         this->updateMapping();
@@ -3029,6 +3433,7 @@ NMImageLayer::setImage(QSharedPointer<NMItkDataObjectWrapper> imgWrapper)
 
     // concatenate the pipeline
     this->mPipeconn->setInput(imgWrapper);
+    this->mDisplayedImage = nullptr;
 
     vtkSmartPointer<vtkImageResliceMapper> m = vtkSmartPointer<vtkImageResliceMapper>::New();
     m->SetInputConnection(this->mPipeconn->getVtkAlgorithmOutput());
@@ -3213,7 +3618,9 @@ QSharedPointer<NMItkDataObjectWrapper> NMImageLayer::getImage(void)
     QSharedPointer<NMItkDataObjectWrapper> dw;
     dw.clear();
 
-    itk::DataObject* img = this->getITKImage();
+    // with tiled loading, the reader's output isn't what's displayed
+    itk::DataObject* img = mDisplayedImage.IsNotNull()
+                            ? mDisplayedImage.GetPointer() : this->getITKImage();
     if (img == 0)
         return dw;
 
@@ -3300,10 +3707,15 @@ NMImageLayer::writeDataSet(void)
         return;
     }
 
-    otb::SQLiteTable::Pointer sqlTab = static_cast<otb::SQLiteTable*>(this->mOtbRAT.GetPointer());
-    sqlTab->SetOpenReadOnly(true);
-    sqlTab->SetUseSharedCache(true);
-    if (sqlTab->openConnection())
+    // only SQLite tables need (re-)connecting, any other
+    // table type is written from memory as it is
+    otb::SQLiteTable::Pointer sqlTab = dynamic_cast<otb::SQLiteTable*>(this->mOtbRAT.GetPointer());
+    if (sqlTab.IsNotNull())
+    {
+        sqlTab->SetOpenReadOnly(true);
+        sqlTab->SetUseSharedCache(true);
+    }
+    if (sqlTab.IsNotNull() && sqlTab->openConnection())
     {
         if (!sqlTab->PopulateTableAdmin())
         {
@@ -3355,7 +3767,10 @@ NMImageLayer::writeDataSet(void)
         }
     }
 
-    sqlTab->CloseTable();
+    if (sqlTab.IsNotNull())
+    {
+        sqlTab->CloseTable();
+    }
 
     if (berr)
     {
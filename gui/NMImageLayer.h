@@ -42,6 +42,13 @@
 #include "vtkImageProperty.h"
 #include "vtkAlgorithmOutput.h"
 
+#include <QCache>
+#include <QMutex>
+#include <QFutureWatcher>
+#include <QQueue>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef BUILD_RASSUPPORT
   #include "RasdamanConnector.hh"
@@ -160,26 +167,86 @@ public slots:
 
     void loadLegend(const QString &filename);
 
+    virtual void tableDataChanged(const QModelIndex& tl, const QModelIndex& br);
+
 protected:
 
     void createTableView(void);
     void createImgSelData(void);
-    void updateScalarBuffer(void);
+    /*! fetches the legend values of the given (distinct) pixel
+     *  values from the attribute table, unless already cached */
+    void updateScalarBuffer(const std::vector<long long>& keys);
+    void clearScalarBuffer(void);
     void updateSelectionColor(void);
 
     void sendData(QSharedPointer<NMItkDataObjectWrapper> imgWrapper);
 
+    /*!
+     * \brief Calculates the (vtk) extent of the world box wbox
+     *        (minx, maxx, miny, maxy) on the given overview; if
+     *        bTileAligned, the extent is snapped to the tile grid
+     *        (mTileSize) and extended by one tile on each side
+     */
+    void getOverviewExtent(int ovidx, const double wbox[4], int ext[6], bool bTileAligned);
+
+    /*! a request for the tiles covering the given (tile aligned)
+     *  extent of an overview; img holds the mosaic of the tiles
+     *  once they've been read (s. readTiles); a preview request
+     *  (coarse overview) shares its id with the request it precedes */
+    struct TileRequest
+    {
+        int id;
+        bool bPreview;
+        int ovidx;
+        int zidx;
+        int cols;
+        int rows;
+        int ext[6];
+        std::vector<int> bandMap;
+        otb::ImageIOBase::IOComponentType componentType;
+        unsigned int numDimensions;
+        unsigned int numBands;
+        itk::DataObject::Pointer img;
+        std::string errMsg;
+    };
+
+    /*! requests the tiles covering the given extent of the given
+     *  overview; any older request still in progress is cancelled;
+     *  if previewidx refers to a (coarser) overview, its tiles covering
+     *  pext are read and displayed first */
+    void requestTiles(int ovidx, const int ext[6],
+                      int previewidx=mNotLoaded, const int* pext=nullptr);
+
+    /*! sets up a request for the tiles covering ext of overview ovidx */
+    TileRequest createTileRequest(int ovidx, const int ext[6], bool bPreview);
+
+    /*! reads the requested tiles (unless cached) and assembles
+     *  them into a single image; runs on a worker thread, unless
+     *  the image can't be read concurrently (e.g. netCDF) */
+    TileRequest readTiles(TileRequest req);
+
+    /*! hands the tiles read for req over to the display pipeline */
+    void displayTiles(const TileRequest& req);
+
+    /*! cancels pending tile requests and empties the tile cache */
+    void clearTileCache(void);
+
     template<class T>
     void setLongScalars(T* buf, long long* out, long long numPix, long long nodata);
 
     template<class T>
-    void setLongDBScalars(T* buf, long long* out, long long start, long long end, long long nodata);
+    void setDoubleScalars(T* buf, double* out, long long numPix, double nodata);
 
     template<class T>
-    void setDoubleScalars(T* buf, double* out, long long numPix, double nodata);
+    void getUniqueKeys(T* buf, long long start, long long end, std::vector<long long>* keys);
 
     template<class T>
-    void setDoubleDBScalars(T* buf, double* out, long long start, long long end, double nodata);
+    void collectUniqueKeys(T* buf, long long numPix, std::vector<long long>& keys);
+
+    template<class T, class V>
+    void mapCachedScalars(T* buf, V* out, long long numPix, V nodata,
+                          const std::vector<long long>& keys,
+                          const std::unordered_map<long long, V>& cache);
 
     template<class T>
     void mapScalarsToRGB(T* in, unsigned char* out, int numPix, int numComp,
@@ -234,8 +301,36 @@ protected:
     double mOrigin[3];
     double mUpperLeftCorner[3];
 
+    // buffered itk image region
+    // (i.e. the loaded tiles covering the visible extent)
     int mVisibleRegion[6];
 
+    // tile based loading of the visible extent: tiles are read by
+    // mTileReader on a worker thread into an LRU cache (mTileCache,
+    // cost in KiB); only the latest request (mTileRequestId) is
+    // processed, older ones are cancelled, and only handing the
+    // tiles over to the VTK pipeline happens on the GUI thread
+    static const int mTileSize = 256;
+    static const int mTileCacheSize = 256 * 1024;
+    static const int mNotLoaded = -2;
+    int mLoadedOvIdx;
+    int mLoadedZIdx;
+    int mLoadedExtent[6];
+    int mPendingOvIdx;
+    int mPendingZIdx;
+    int mPendingExtent[6];
+
+    NMImageReader* mTileReader;
+    QMutex mTileReaderMutex;
+    QCache<QString, itk::DataObject::Pointer> mTileCache;
+    QMutex mTileCacheMutex;
+    std::atomic<int> mTileRequestId;
+    QFutureWatcher<TileRequest> mTileWatcher;
+    QQueue<TileRequest> mTileRequestQueue;
+
+    // the mosaic of tiles currently displayed (s. getImage)
+    itk::DataObject::Pointer mDisplayedImage;
+
     int mZSliceIdx;
     int mOverviewIdx;
     bool mbUpdateScalars;
@@ -278,11 +373,14 @@ protected:
     static const int mMaxLayerDimensions;
     FILE* mScalarBufferFile;
 
-    std::map<long long, long long> mScalarLongLongMap;
-    std::map<long long, double> mScalarDoubleMap;
+    // legend value cache (pixel value -> legend value)
+    std::unordered_map<long long, long long> mScalarLongLongMap;
+    std::unordered_map<long long, double> mScalarDoubleMap;
+    std::unordered_set<long long> mScalarMissingKeys;
 
 protected slots:
     int updateAttributeTable(void);
+    void tilesLoaded(void);
 };
 
 #endif // ifndef NMIMAGELAYER_H_
@@ -67,6 +67,8 @@ NMProcCompList::NMProcCompList(QWidget* parent)
     this->addItem(QString::fromLatin1("CubeSliceToImage2D"));
     this->addItem(QString::fromLatin1("Image2Table"));
     this->addItem(QString::fromLatin1("Table2NetCDF"));
+    this->addItem(QString::fromLatin1("LUAllocation"));
+    this->addItem(QString::fromLatin1("ReclassImage"));
 /*$<AddComponentToGUICompList>$*/
 
     this->sortItems();
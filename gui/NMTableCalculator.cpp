@@ -40,6 +40,13 @@
 #include <QStack>
 #include <QModelIndex>
 #include <QDateTime>
+#include <QThread>
+#include <QFuture>
+#include <QtConcurrent>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QSqlError>
 #include "muParserError.h"
 #include "itkExceptionObject.h"
 
@@ -536,6 +543,202 @@ void NMTableCalculator::clearLists()
 	this->mLstNMStrOperator.clear();
 }
 
+std::vector<int>
+NMTableCalculator::getCalcRows(void)
+{
+	std::vector<int> rows;
+	if (this->mbRowFilter)
+	{
+		foreach(const QItemSelectionRange& range, this->mInputSelection)
+		{
+			const int top = range.top();
+			const int bottom = range.bottom();
+			for (int row=top; row <= bottom; ++row)
+			{
+				if (mRaw2Source && mRaw2Source->at(row) < 0)
+					continue;
+
+				rows.push_back(row);
+			}
+		}
+	}
+	else
+	{
+		const int nrows = this->mModel->rowCount(QModelIndex());
+		rows.reserve(nrows);
+		for (int row=0; row < nrows; ++row)
+		{
+			if (mRaw2Source && mRaw2Source->at(row) < 0)
+				continue;
+
+			rows.push_back(row);
+		}
+	}
+
+	return rows;
+}
+
+bool
+NMTableCalculator::translateToSql(QSqlTableModel* sqlModel, QString& sqlExpr,
+								  QStringList& sqlCols)
+{
+	sqlExpr.clear();
+	sqlCols.clear();
+
+	// string terms are evaluated with Qt's (locale aware) string
+	// functions, so we leave them to the row-wise evaluation
+	if (!this->mslStrTerms.isEmpty())
+	{
+		return false;
+	}
+
+	// note: muParser's '^' has no SQLite equivalent; we don't
+	// translate divisions either, since muParser returns +/-inf
+	// (or nan) for a division by zero, whereas SQL returns NULL;
+	// muParser evaluates '==' and '<' etc. at the same precedence
+	// level whereas SQL doesn't, so we don't translate expressions
+	// mixing both kinds
+	QRegExp token("(\\d*\\.?\\d+(?:[eE][+-]?\\d+)?|[_a-zA-Z][_a-zA-Z\\d]*"
+				  "|&&|\\|\\||==|!=|<=|>=|[-+*<>(),])");
+	QSqlDriver* drv = sqlModel->database().driver();
+	bool bEquality = false;
+	bool bRelational = false;
+
+	const QString& func = this->mFunction;
+	int pos = 0;
+	while (pos < func.size())
+	{
+		if (func.at(pos).isSpace())
+		{
+			++pos;
+			continue;
+		}
+
+		if (token.indexIn(func, pos) != pos)
+		{
+			sqlExpr.clear();
+			return false;
+		}
+		const QString tok = token.cap(1);
+		pos += token.matchedLength();
+
+		if (tok.at(0).isLetter() || tok.at(0) == '_')
+		{
+			const int colidx = this->getColumnIndex(tok);
+			if (colidx >= 0 && this->isNumericColumn(colidx))
+			{
+				const QString colname = this->mModel->headerData(colidx,
+							Qt::Horizontal).toString();
+				const QString sqlCol = drv->escapeIdentifier(colname, QSqlDriver::FieldName);
+				sqlExpr += sqlCol;
+				if (!sqlCols.contains(sqlCol))
+				{
+					sqlCols << sqlCol;
+				}
+			}
+			else if (colidx < 0 && tok.compare("abs", Qt::CaseInsensitive) == 0)
+			{
+				sqlExpr += QStringLiteral("abs");
+			}
+			else
+			{
+				sqlExpr.clear();
+				return false;
+			}
+		}
+		else if (tok == "&&")
+			sqlExpr += QStringLiteral(" AND ");
+		else if (tok == "||")
+			sqlExpr += QStringLiteral(" OR ");
+		else if (tok == "==" || tok == "!=")
+		{
+			bEquality = true;
+			sqlExpr += tok == "==" ? QStringLiteral(" = ") : QStringLiteral(" <> ");
+		}
+		else if (tok == "<" || tok == ">" || tok == "<=" || tok == ">=")
+		{
+			bRelational = true;
+			sqlExpr += QString(" %1 ").arg(tok);
+		}
+		else
+			sqlExpr += tok;
+	}
+
+	if (bEquality && bRelational)
+	{
+		sqlExpr.clear();
+	}
+
+	return !sqlExpr.isEmpty();
+}
+
+bool
+NMTableCalculator::doSqlCalculation(QSqlTableModel* sqlModel, const QString& sqlExpr,
+									const QStringList& sqlCols)
+{
+	QSqlDatabase db = sqlModel->database();
+	QSqlDriver* drv = db.driver();
+	const QString colname = this->mModel->headerData(this->mResultColumnIndex,
+				Qt::Horizontal).toString();
+	const QString tabname = drv->escapeIdentifier(sqlModel->tableName(), QSqlDriver::TableName);
+
+	// the row-wise calculation only touches the rows passing
+	// the model's filter (e.g. 'show selected records only')
+	const QString filter = sqlModel->filter();
+
+	// muParser sees NULL (and NaN) values as 0, whereas
+	// any SQL expression involving NULL results in NULL
+	if (!sqlCols.isEmpty())
+	{
+		QString nStr = QString("select 1 from %1 where (%2 is null)")
+						.arg(tabname)
+						.arg(sqlCols.join(" is null or "));
+		if (!filter.isEmpty())
+		{
+			nStr += QString(" and (%1)").arg(filter);
+		}
+		nStr += QStringLiteral(" limit 1");
+
+		QSqlQuery qNull(db);
+		if (!qNull.exec(nStr) || qNull.next())
+		{
+			NMDebugAI(<< "SQL calculation: NULL values or failed check, "
+					  << "using row-wise calculation ..." << std::endl);
+			qNull.finish();
+			return false;
+		}
+		qNull.finish();
+	}
+
+	QString uStr = QString("update %1 set %2 = %3")
+					.arg(tabname)
+					.arg(drv->escapeIdentifier(colname, QSqlDriver::FieldName))
+					.arg(sqlExpr);
+	if (!filter.isEmpty())
+	{
+		uStr += QString(" where %1").arg(filter);
+	}
+	NMDebugAI(<< "SQL calculation: " << uStr.toStdString() << std::endl);
+
+	db.transaction();
+	QSqlQuery qUpdate(db);
+	if (!qUpdate.exec(uStr))
+	{
+		NMLogWarn(<< ctxTabCalc << ": SQL calculation failed - "
+				<< qUpdate.lastError().text().toStdString()
+				<< "; falling back to row-wise calculation ...");
+		qUpdate.finish();
+		db.rollback();
+		return false;
+	}
+	qUpdate.finish();
+	db.commit();
+
+	sqlModel->select();
+	emit signalProgress(this->mModel->rowCount(QModelIndex()));
+	return true;
+}
+
 void
 NMTableCalculator::doNumericCalcSelection()
 {
@@ -549,114 +752,157 @@ NMTableCalculator::doNumericCalcSelection()
 	}
 
 	QDateTime started = QDateTime::currentDateTime();
-	QItemSelection& isel = mOutputSelection;
-	const int maxcolidx = 0;
-	int progress=0;
-	if (this->mbRowFilter)
+
+	// if the whole column of an SQL table is to be calculated, we
+	// try and let the database do the job in one UPDATE statement
+	QSqlTableModel* sqlModel = qobject_cast<QSqlTableModel*>(this->mModel);
+	QString sqlExpr;
+	QStringList sqlCols;
+	if (	sqlModel != 0
+		&&  !this->mSelectionModeOn
+		&&  !this->mbRowFilter
+		&&  mRaw2Source == 0
+		&&  this->translateToSql(sqlModel, sqlExpr, sqlCols)
+		&&  this->doSqlCalculation(sqlModel, sqlExpr, sqlCols)
+	   )
 	{
-		foreach(const QItemSelectionRange& range, this->mInputSelection)
+		QDateTime stopped = QDateTime::currentDateTime();
+		int msec = started.msecsTo(stopped);
+		NMMsg(<< "Table calculation took (min:sec): "
+			  << QString("%1:%2").arg(msec / 60000).arg((msec % 60000) / 1000.0,0,'g',3).toStdString()
+			  << std::endl);
+		NMDebugCtx(ctxTabCalc, << "done!");
+		return;
+	}
+
+	const std::vector<int> rows = this->getCalcRows();
+	const long nrows = rows.size();
+
+	// the parser variables are the (unique) numeric fields
+	// followed by the string terms, which we replace in the
+	// function by a variable each rather than by its value
+	// for each row
+	QStringList varNames;
+	QList<int> varFields;
+	for (int v=0; v < this->mFuncVars.size(); ++v)
+	{
+		if (!varNames.contains(this->mFuncVars.at(v)))
 		{
-			const int top = range.top();
-			const int bottom = range.bottom();
-			const int nrows = bottom - top + 1;
-			int start = -1;
-			int end = -1;
-			bool selected;
-			for (int row=top; row <= bottom && !mbCanceled; ++row)
+			varNames << this->mFuncVars.at(v);
+			varFields << this->mFuncFields.at(v);
+		}
+	}
+	const int numFieldVars = varNames.size();
+
+	QString expr = this->mFunction;
+	for (int t=0; t < this->mslStrTerms.size(); ++t)
+	{
+		const QString termVar = QString("nmStrTerm%1").arg(t);
+		expr = expr.replace(this->mslStrTerms.at(t), termVar, Qt::CaseInsensitive);
+		varNames << termVar;
+	}
+
+	// fetch the values from the model ...
+	std::vector<std::vector<double> > values(varNames.size(),
+				std::vector<double>(nrows));
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	int progress = 0;
+	bool bok;
+	for (long r=0; r < nrows && !mbCanceled; ++r)
+	{
+		const int row = rows[r];
+		for (int v=0; v < numFieldVars; ++v)
+		{
+			QModelIndex fieldidx = this->mModel->index(row, varFields.at(v), QModelIndex());
+			values[v][r] = this->mModel->data(fieldidx, Qt::DisplayRole).toDouble(&bok);
+			if (!bok)
 			{
-				if (mRaw2Source && mRaw2Source->at(row) < 0)
-					continue;
+				NMLogError(<< ctxTabCalc << ": Encountered invalid numeric value in column "
+						<< varFields.at(v) << " at row " << row
+						<< "!");
+				values[v][r] = nan;
+			}
+		}
 
-				this->processNumericCalcSelection(row, &selected);
-				if (selected)
-				{
-					if (start == -1)
-					{
-						start = row;
-						end   = start;
+		for (int t=0; t < this->mslStrTerms.size(); ++t)
+		{
+			values[numFieldVars + t][r] = this->evalStringTerm(t, row);
+		}
 
-						if (row == bottom)
-						{
-							QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-							QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-							isel.append(QItemSelectionRange(sidx, eidx));
-						}
-					}
-					// expansion of selection range
-					else if (row == end + 1)
-					{
-						++end;
+		++progress;
+		if (progress % 2000 == 0)
+			emit signalProgress(progress / 2);
+	}
 
-						if (row == bottom)
-						{
-							QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-							QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-							isel.append(QItemSelectionRange(sidx, eidx));
-						}
-					}
-				}
-				else
-				{
-					if (start != -1 && end != -1)
-					{
-						QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-						QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-						isel.append(QItemSelectionRange(sidx, eidx));
+	if (mbCanceled)
+	{
+		NMDebugCtx(ctxTabCalc, << "done!");
+		return;
+	}
 
-						start = -1;
-						end   = -1;
-					}
-				}
+	// ... evaluate the function in parallel ...
+	std::vector<double> results(nrows);
+	const long minThreadRows = 10000;
+	long nthreads = QThread::idealThreadCount();
+	if (nthreads < 1 || nrows < nthreads * minThreadRows)
+	{
+		nthreads = std::max(1L, nrows / minThreadRows);
+	}
 
-				++progress;
-				if (progress % 1000 == 0)
-					emit signalProgress(progress);
-			}
+	std::vector<EvalChunk> chunks(nthreads);
+	QList<QFuture<void> > flist;
+	const long threadrows = nrows / nthreads;
+	const std::string stdExpr = expr.toStdString();
+	for (int th=0; th < nthreads; ++th)
+	{
+		chunks[th].start = th * threadrows;
+		chunks[th].end = th == nthreads-1 ? nrows : (th+1) * threadrows;
+		flist << QtConcurrent::run(this, &NMTableCalculator::evalRows,
+								   stdExpr, varNames, &values, &results, &chunks[th]);
+	}
+
+	for (int th=0; th < nthreads; ++th)
+	{
+		flist[th].waitForFinished();
+	}
+
+	for (int th=0; th < nthreads; ++th)
+	{
+		if (!chunks[th].error.empty())
+		{
+			NMLogError(<< ctxTabCalc << ": Invalid expression detected!");
+			NMDebugCtx(ctxTabCalc, << "done!");
+
+			throw mu::ParserError(chunks[th].error);
 		}
 	}
-	else
+
+	// ... and write back the results or compile the selection
+	if (this->mSelectionModeOn)
 	{
-		const int& nrows = this->mModel->rowCount();
-		const int& bottom = nrows-1;
+		QItemSelection& isel = mOutputSelection;
+		const int maxcolidx = 0;
 		int start = -1;
 		int end = -1;
-		bool selected;
-		for (int row=0; row < nrows && !mbCanceled; ++row)
+		for (long r=0; r < nrows; ++r)
 		{
-			if (mRaw2Source && mRaw2Source->at(row) < 0)
-				continue;
-
-			this->processNumericCalcSelection(row, &selected);
-			if (selected)
+			const int row = rows[r];
+			if (results[r] != 0)
 			{
+				++mNumSel;
 				if (start == -1)
 				{
 					start = row;
 					end   = start;
-
-					if (row == bottom)
-					{
-						QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-						QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-						isel.append(QItemSelectionRange(sidx, eidx));
-					}
 				}
 				// expansion of selection range
 				else if (row == end + 1)
 				{
 					++end;
-
-					if (row == bottom)
-					{
-						QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-						QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-						isel.append(QItemSelectionRange(sidx, eidx));
-					}
 				}
-				// we've effectively just jumped a hidden source row here (i.e. we're within a selection,
-				// but it doesn't cover a contiguous section of raw model rows);
-				// so we complete the previously started selection and start a new with this
-				// row as its starting point
+				// we've jumped a hidden source row or left the current input
+				// range, so we complete the previously started selection and
+				// start a new one with this row as its starting point
 				else
 				{
 					QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
@@ -665,33 +911,48 @@ NMTableCalculator::doNumericCalcSelection()
 
 					start = row;
 					end   = start;
-
-					if (row == bottom)
-					{
-						QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-						QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-						isel.append(QItemSelectionRange(sidx, eidx));
-					}
 				}
 			}
-			else
+			else if (start != -1)
 			{
-				if (start != -1 && end != -1)
-				{
-					QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
-					QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
-					isel.append(QItemSelectionRange(sidx, eidx));
+				QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
+				QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
+				isel.append(QItemSelectionRange(sidx, eidx));
 
-					start = -1;
-					end   = -1;
-				}
+				start = -1;
+				end   = -1;
 			}
+		}
+
+		if (start != -1)
+		{
+			QModelIndex sidx = this->mModel->index(start, 0, QModelIndex());
+			QModelIndex eidx = this->mModel->index(end, maxcolidx, QModelIndex());
+			isel.append(QItemSelectionRange(sidx, eidx));
+		}
+	}
+	else
+	{
+		// for SQL tables, write all rows within one transaction
+		// rather than committing each UPDATE separately
+		if (sqlModel != 0)
+		{
+			sqlModel->database().transaction();
+		}
+
+		for (long r=0; r < nrows && !mbCanceled; ++r)
+		{
+			QModelIndex resIdx = this->mModel->index(rows[r], this->mResultColumnIndex, QModelIndex());
+			this->mModel->setData(resIdx, QVariant(results[r]));
 
 			++progress;
-			if (progress % 1000 == 0)
-			{
-				emit signalProgress(progress);
-			}
+			if (progress % 2000 == 0)
+				emit signalProgress(progress / 2);
+		}
+
+		if (sqlModel != 0)
+		{
+			sqlModel->database().commit();
 		}
 	}
 
@@ -710,234 +971,180 @@ NMTableCalculator::doNumericCalcSelection()
 }
 
 void
-NMTableCalculator::processNumericCalcSelection(int row, bool* selected)
+NMTableCalculator::evalRows(const std::string& expr, const QStringList& names,
+							const std::vector<std::vector<double> >* values,
+							std::vector<double>* results, EvalChunk* chunk)
 {
-	double res;
-	QString newFunc;
-	QString strFieldVal;
-	int strExpRes;
-	*selected = false;
-
-	//NMDebug(<< "row #" << row << " ");
-
-	// feed the parser with numeric variables and values
-	bool bok = true;
-	int fcnt=0;
-	std::vector<double> funcvals(this->mFuncVars.size());
-	foreach(const QString &colName, this->mFuncVars)
+	// muParser instances must not be shared between threads
+	otb::MultiParser::Pointer parser = otb::MultiParser::New();
+	std::vector<double> vars(names.size());
+
+	try
 	{
-		QModelIndex fieldidx = this->mModel->index(row, mFuncFields.at(fcnt), QModelIndex());
-		funcvals[fcnt] = this->mModel->data(fieldidx, Qt::DisplayRole).toDouble(&bok);
-		if (bok)
+		for (int v=0; v < names.size(); ++v)
 		{
-			this->mParser->DefineVar(this->mFuncVars.at(fcnt).toStdString(), &funcvals[fcnt]);
+			parser->DefineVar(names.at(v).toStdString(), &vars[v]);
 		}
-		else
+		parser->SetExpr(expr);
+
+		for (long r=chunk->start; r < chunk->end && !mbCanceled; ++r)
 		{
-            NMLogError(<< ctxTabCalc << ": Encountered invalid numeric value in column "
-					<< mFuncFields.at(fcnt) << " at row " << row
-					<< "!");
-			break;
+			for (int v=0; v < vars.size(); ++v)
+			{
+				vars[v] = (*values)[v][r];
+			}
+			(*results)[r] = parser->Eval();
 		}
-
-		//if (row==0) {NMDebugAI(<< "setting numeric variable: "
-		//		<< this->mFuncVars.at(fcnt).toStdString() << std::endl);}
-
-		//NMDebug(<< colName.toStdString() << "=" << funcvals[fcnt] << " ");
-		++fcnt;
 	}
-	//if (!bok)
-	//{
-    //	NMLogError(<< ctxTabCalc << ": Skipping rest of invalid calculation in row " << row << "!");
-	//	CALLGRIND_STOP_INSTRUMENTATION;
-	//	CALLGRIND_DUMP_STATS;
-	//	return;
-	//}
-
-	// evaluate string expressions and replace them with numeric results (0 or 1)
-	// or cast to double, if no string operator is given) and put into function
-	newFunc = this->mFunction;
-	for (int t=0; t < this->mslStrTerms.size(); ++t)
+	catch(mu::ParserError& err)
 	{
-		if (row==0 && t==0) {NMDebugAI(<< "processing string expressions ..." << std::endl);}
+		chunk->error = err.GetMsg();
+	}
+}
 
-		QString origTerm = this->mslStrTerms.at(t);
-		if (row==0) {NMDebugAI(<< "... term: " << origTerm.toStdString() << std::endl);}
+double
+NMTableCalculator::evalStringTerm(int t, int row)
+{
+	int strExpRes = 0;
+	const QString& origTerm = this->mslStrTerms.at(t);
+	if (row==0) {NMDebugAI(<< "... term: " << origTerm.toStdString() << std::endl);}
 
-		// check whether we've got a three element string expression here or not
-		// in case not, we check for a string field and cast to double, if applicable
-		if (this->mLstLstStrFields.at(t).size() == 2)
+	// check whether we've got a three element string expression here or not
+	// in case not, we check for a string field and cast to double, if applicable
+	if (this->mLstLstStrFields.at(t).size() == 2)
+	{
+		// are both fields strings or do we have
+		// a numeric field in between?
+		int idxleft = this->mLstLstStrFields.at(t).at(0);
+		int idxright = this->mLstLstStrFields.at(t).at(1);
+		QString left;
+		QString right;
+		if (idxleft >= 0)
 		{
-			// are both fields strings or do we have
-			// a numeric field in between?
-			int idxleft = this->mLstLstStrFields.at(t).at(0);
-			int idxright = this->mLstLstStrFields.at(t).at(1);
-			QString left;
-			QString right;
-			if (idxleft >= 0)
-			{
-				QModelIndex fidx = this->mModel->index(row, idxleft, QModelIndex());
-				left = this->mModel->data(fidx, Qt::DisplayRole).toString().trimmed();
-			}
-			else
-			{
-					left = this->mLstStrLeftRight.at(t).at(0);
-			}
+			QModelIndex fidx = this->mModel->index(row, idxleft, QModelIndex());
+			left = this->mModel->data(fidx, Qt::DisplayRole).toString().trimmed();
+		}
+		else
+		{
+				left = this->mLstStrLeftRight.at(t).at(0);
+		}
 
-			if (idxright >= 0)
-			{
-				QModelIndex fidx = this->mModel->index(row, idxright, QModelIndex());
-				right = this->mModel->data(fidx, Qt::DisplayRole).toString().trimmed();
-			}
-			else
-			{
-					right = this->mLstStrLeftRight.at(t).at(1);
-			}
+		if (idxright >= 0)
+		{
+			QModelIndex fidx = this->mModel->index(row, idxright, QModelIndex());
+			right = this->mModel->data(fidx, Qt::DisplayRole).toString().trimmed();
+		}
+		else
+		{
+				right = this->mLstStrLeftRight.at(t).at(1);
+		}
 
-			// debug
-			if (row == 0)
-			{
-				NMDebugAI(<< "... evaluating: "
-						<< left.toStdString() << " "
-						<< mLstNMStrOperator.at(t) << " "
-						<< right.toStdString() << std::endl);
-			}
+		// debug
+		if (row == 0)
+		{
+			NMDebugAI(<< "... evaluating: "
+					<< left.toStdString() << " "
+					<< mLstNMStrOperator.at(t) << " "
+					<< right.toStdString() << std::endl);
+		}
 
-			// eval expression
-			switch (this->mLstNMStrOperator.at(t))
+		// eval expression
+		switch (this->mLstNMStrOperator.at(t))
+		{
+		case NM_STR_GT:
+			strExpRes = QString::localeAwareCompare(left, right) > 0 ? 1 : 0;
+			break;
+		case NM_STR_GTEQ:
+			strExpRes = (QString::localeAwareCompare(left, right) > 0) ||
+						(QString::localeAwareCompare(left, right) == 0)    ? 1 : 0;
+			break;
+		case NM_STR_LT:
+			strExpRes = QString::localeAwareCompare(left, right) < 0 ? 1 : 0;
+			break;
+		case NM_STR_LTEQ:
+			strExpRes = (QString::localeAwareCompare(left, right) < 0) ||
+						(QString::localeAwareCompare(left, right) == 0)    ? 1 : 0;
+			break;
+		case NM_STR_EQ:
+			strExpRes = QString::localeAwareCompare(left, right) == 0 ? 1 : 0;
+			break;
+		case NM_STR_NEQ:
+			strExpRes = QString::localeAwareCompare(left, right) != 0 ? 1 : 0;
+			break;
+		case NM_STR_IN:
 			{
-			case NM_STR_GT:
-				strExpRes = QString::localeAwareCompare(left, right) > 0 ? 1 : 0;
-				break;
-			case NM_STR_GTEQ:
-				strExpRes = (QString::localeAwareCompare(left, right) > 0) ||
-							(QString::localeAwareCompare(left, right) == 0)    ? 1 : 0;
-				break;
-			case NM_STR_LT:
-				strExpRes = QString::localeAwareCompare(left, right) < 0 ? 1 : 0;
-				break;
-			case NM_STR_LTEQ:
-				strExpRes = (QString::localeAwareCompare(left, right) < 0) ||
-							(QString::localeAwareCompare(left, right) == 0)    ? 1 : 0;
-				break;
-			case NM_STR_EQ:
-				strExpRes = QString::localeAwareCompare(left, right) == 0 ? 1 : 0;
-				break;
-			case NM_STR_NEQ:
-				strExpRes = QString::localeAwareCompare(left, right) != 0 ? 1 : 0;
-				break;
-			case NM_STR_IN:
+				strExpRes = 0;
+				QStringList ll = left.simplified().split(" ");
+				foreach(const QString& l, ll)
 				{
-					strExpRes = 0;
-					QStringList ll = left.simplified().split(" ");
-					foreach(const QString& l, ll)
+					if (right.contains(l, Qt::CaseInsensitive))
 					{
-						if (right.contains(l, Qt::CaseInsensitive))
-						{
-							strExpRes = 1;
-							break;
-						}
+						strExpRes = 1;
+						break;
 					}
 				}
-				break;
-			case NM_STR_NOTIN:
+			}
+			break;
+		case NM_STR_NOTIN:
+			{
+				strExpRes = 0;
+				QStringList ll = left.simplified().split(" ");
+				foreach(const QString& l, ll)
 				{
-					strExpRes = 0;
-					QStringList ll = left.simplified().split(" ");
-					foreach(const QString& l, ll)
+					if (!right.contains(l, Qt::CaseInsensitive))
 					{
-						if (!right.contains(l, Qt::CaseInsensitive))
-						{
-							strExpRes = 1;
-							break;
-						}
+						strExpRes = 1;
+						break;
 					}
 				}
-				break;
-			case NM_STR_CONTAINS:
-				strExpRes = left.contains(right, Qt::CaseInsensitive) ? 1 : 0;
-				break;
-			case NM_STR_STARTSWITH:
-				strExpRes = left.startsWith(right, Qt::CaseInsensitive) ? 1 : 0;
-				break;
-			case NM_STR_ENDSWITH:
-				strExpRes = left.endsWith(right, Qt::CaseInsensitive) ? 1 : 0;
-				break;
-			}
-
-			// replace original string expression with either 0 or 1 (int)
-			newFunc = newFunc.replace(origTerm, QString("%1").arg(strExpRes),
-					Qt::CaseInsensitive);
-		}
-		// convert single
-		else if (this->mLstLstStrFields.at(t).size() == 1)
-		{
-			int idx;
-			bool bok = false;
-			double val;
-
-			idx = this->mLstLstStrFields.at(t).at(0);
-			if (idx >=0)
-			{
-				const QModelIndex mi = this->mModel->index(row, idx, QModelIndex());
-				val = mi.data(Qt::DisplayRole).toDouble(&bok);
-			}
-
-			if (bok)
-			{
-				newFunc = newFunc.replace(origTerm, QString("%1").arg(val),
-						Qt::CaseInsensitive);
-			}
-			else
-			{
-				itk::ExceptionObject e;
-				std::stringstream msg;
-				msg << "Failed converting '" << origTerm.toStdString() << "' "
-					<< "into numeric value!";
-				e.SetDescription(msg.str());
-				msg.str("");
-				e.SetLocation(ctxTabCalc);
-				throw e;
 			}
+			break;
+		case NM_STR_CONTAINS:
+			strExpRes = left.contains(right, Qt::CaseInsensitive) ? 1 : 0;
+			break;
+		case NM_STR_STARTSWITH:
+			strExpRes = left.startsWith(right, Qt::CaseInsensitive) ? 1 : 0;
+			break;
+		case NM_STR_ENDSWITH:
+			strExpRes = left.endsWith(right, Qt::CaseInsensitive) ? 1 : 0;
+			break;
 		}
-	}
 
-	try
-	{
-		this->mParser->SetExpr(newFunc.toStdString());
-		res = this->mParser->Eval();
+		// the string expression evaluates to either 0 or 1
+		return strExpRes;
 	}
-    catch(mu::ParserError& err)
+	// convert single
+	else if (this->mLstLstStrFields.at(t).size() == 1)
 	{
-        NMLogError(<< ctxTabCalc << ": Invalid expression detected!");
-		NMDebugCtx(ctxTabCalc, << "done!");
-
-		throw err;
-		return;
-	}
-
+		int idx;
+		bool bok = false;
+		double val;
 
-	if (this->mSelectionModeOn)
-	{
-		if (res != 0)
+		idx = this->mLstLstStrFields.at(t).at(0);
+		if (idx >=0)
 		{
-			//mOutputSrcSelIndices.push_back(row);
-			++mNumSel;
-
-			//NMDebug(<< " -> = " << res << std::endl);
+			const QModelIndex mi = this->mModel->index(row, idx, QModelIndex());
+			val = mi.data(Qt::DisplayRole).toDouble(&bok);
+		}
 
-			*selected = true;
+		if (bok)
+		{
+			return val;
+		}
+		else
+		{
+			itk::ExceptionObject e;
+			std::stringstream msg;
+			msg << "Failed converting '" << origTerm.toStdString() << "' "
+				<< "into numeric value!";
+			e.SetDescription(msg.str());
+			msg.str("");
+			e.SetLocation(ctxTabCalc);
+			throw e;
 		}
 	}
-	else
-	{
-		QModelIndex resIdx = this->mModel->index(row, this->mResultColumnIndex, QModelIndex());
-		this->mModel->setData(resIdx, QVariant(res));
-	}
-	//NMDebug(<< std::endl);
 
-	//CALLGRIND_STOP_INSTRUMENTATION;
-	//CALLGRIND_DUMP_STATS;
+	return 0;
 }
 
 void
@@ -32,6 +32,10 @@
 #include <QAbstractItemModel>
 //#include <QModelIndexList>
 #include <QItemSelection>
+#include <QSqlTableModel>
+
+#include <vector>
+#include <string>
 
 #include "otbMultiParser.h"
 
@@ -125,14 +129,45 @@ protected:
 	QList<QList<int> > mLstLstStrFields;
 	QList<NMStrOperator> mLstNMStrOperator;
 
+	// row range evaluated by one thread
+	typedef struct
+	{
+		long start;
+		long end;
+		std::string error;
+	} EvalChunk;
+
 	void initCalculator();
 	void clearLists();
 	bool parseFunction();
 	void doNumericCalcSelection();
 	void doStringCalculation();
-	void processNumericCalcSelection(int row, bool* selected);
 	void processStringCalc(int row);
 
+	/*! translates the function into an SQL expression, provided
+	 *  it only refers to numeric columns and to operators and
+	 *  functions with identical semantics in SQL; sqlCols returns
+	 *  the (escaped) names of the referenced columns */
+	bool translateToSql(QSqlTableModel* sqlModel, QString& sqlExpr,
+						QStringList& sqlCols);
+	/*! runs the UPDATE on the rows passing the model's filter,
+	 *  unless any of the referenced columns holds NULL values,
+	 *  which muParser and SQL treat differently */
+	bool doSqlCalculation(QSqlTableModel* sqlModel, const QString& sqlExpr,
+						  const QStringList& sqlCols);
+
+	/*! evaluates string term t for the given row (0 or 1 for
+	 *  comparisons, otherwise the field value as double) */
+	double evalStringTerm(int t, int row);
+
+	/*! evaluates expr for the chunk's rows with a separate parser
+	 *  instance, values holding the variables' values per row */
+	void evalRows(const std::string& expr, const QStringList& names,
+				  const std::vector<std::vector<double> >* values,
+				  std::vector<double>* results, EvalChunk* chunk);
+
+	/*! model rows to be processed as per row filter and mRaw2Source */
+	std::vector<int> getCalcRows(void);
 
 	QModelIndexList getInputRows();
 	int getColumnIndex(const QString& name);
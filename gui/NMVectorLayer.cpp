@@ -255,6 +255,7 @@ void NMVectorLayer::setDataSet(vtkDataSet* dataset)
 #ifdef VTK_OPENGL2
     vtkSmartPointer<NMVtkOpenGLPolyDataMapper2> m = vtkSmartPointer<NMVtkOpenGLPolyDataMapper2>::New();
     m->SetInputData(pd);
+    m->SetSourceFileName(this->mSourceFileName.toStdString());
 #else
     vtkSmartPointer<vtkOGRLayerMapper> m = vtkSmartPointer<vtkOGRLayerMapper>::New();
     m->SetInputData(pd);
@@ -69,6 +69,12 @@ public:
 	QColor getContourColour(void) {return mContourColour;}
     void setContourColour(QColor clr);
 
+    /*! file the features were imported from (e.g. via OGR); polygon
+     *  tessellations are cached next to it; to be set before setDataSet */
+    void setSourceFileName(const QString& fileName)
+        {mSourceFileName = fileName;}
+    QString getSourceFileName(void) {return mSourceFileName;}
+
 	//	double getArea();
 	long getNumberOfFeatures(void);
 
@@ -90,6 +96,7 @@ protected:
 	QColor mContourColour;
 
     bool mContourOnly;
+    QString mSourceFileName;
 
 
 	void createTableView(void);
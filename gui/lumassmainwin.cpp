@@ -7366,6 +7366,7 @@ void LUMASSMainWin::loadVectorLayer()
     //this->ui->qvtkWidget->setRenderWindow(renWin);
     NMVectorLayer* layer = new NMVectorLayer(renWin);
     layer->setObjectName(layerName);
+    layer->setSourceFileName(fileName);
     layer->setDataSet(vtkVec);
     layer->setVisible(true);
     this->mLayerList->addLayer(layer);
@@ -7731,7 +7732,7 @@ LUMASSMainWin::addLayerToCompList()
                                          const_cast<QAbstractItemModel*>(il->getTable()));
             if (sqlMod != nullptr)
             {
-                otb::SQLiteTable::Pointer sqlTab = static_cast<otb::SQLiteTable*>(il->getRasterAttributeTable(1).GetPointer());
+                otb::SQLiteTable::Pointer sqlTab = dynamic_cast<otb::SQLiteTable*>(il->getRasterAttributeTable(1).GetPointer());
 
                 QSharedPointer<NMSqlTableView> tv(il->getSqlTableView());
                 QString viewTitle = tv->windowTitle();
@@ -8945,7 +8946,7 @@ LUMASSMainWin::displayUserModelOutput(void)
                 // =========================================================
                 else if (!comp->getOutput(0).isNull() && comp->getOutput(0)->getOTBTab().IsNotNull())
                 {
-                    otb::SQLiteTable::Pointer sqltab = static_cast<otb::SQLiteTable*>(comp->getOutput(0)->getOTBTab().GetPointer());
+                    otb::SQLiteTable::Pointer sqltab = dynamic_cast<otb::SQLiteTable*>(comp->getOutput(0)->getOTBTab().GetPointer());
 
                     if (sqltab && !sqltab->GetDbFileName().empty())
                     {
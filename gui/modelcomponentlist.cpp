@@ -1551,7 +1551,7 @@ void ModelComponentList::dropEvent(QDropEvent* event)
         // =========================================================
         else if (comp->getOutput(0)->getOTBTab().IsNotNull())
         {
-            otb::SQLiteTable::Pointer sqltab = static_cast<otb::SQLiteTable*>(comp->getOutput(0)->getOTBTab().GetPointer());
+            otb::SQLiteTable::Pointer sqltab = dynamic_cast<otb::SQLiteTable*>(comp->getOutput(0)->getOTBTab().GetPointer());
 
             if (sqltab && !sqltab->GetDbFileName().empty())
             {
@@ -31,6 +31,8 @@
 
 #include <string>
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 #include "NMModelController.h"
 #include "NMDataComponent.h"
@@ -68,6 +70,10 @@ NMDataComponent::initAttributes(void)
     mTabMinPK = itk::NumericTraits<long long>::max();
     mTabMaxPK = itk::NumericTraits<long long>::NonpositiveMin();
     mIsStreamable = false;
+    mValueIndex.clear();
+    mValueIndexTab = nullptr;
+    mValueIndexMTime = 0;
+    mValueIndexNumRows = -1;
 }
 
 void
@@ -321,38 +327,10 @@ NMDataComponent::getModelParameter(const QString &paramSpec)
         // value in column 'colidx'
         if (!bok)
         {
-            QString pkcol = tab->GetPrimaryKey().c_str();
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_SQLITE)
+            row = this->lookupRowByValue(tab.GetPointer(), colidx, specList.at(1));
+            if (row < 0)
             {
-                otb::SQLiteTable::Pointer sqltab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
-                std::stringstream wclause;
-
-                if (tab->GetColumnType(colidx) == otb::AttributeTable::ATTYPE_STRING)
-                {
-                    wclause << specList.at(0).toStdString().c_str() << " = '" << specList.at(1).toStdString().c_str() << "'";
-                }
-                else
-                {
-                    wclause << specList.at(0).toStdString().c_str() << " = " << specList.at(1).toStdString().c_str();
-                }
-
-                row = sqltab->GetIntValue(pkcol.toStdString(), wclause.str());
-            }
-            else
-            {   int rec;
-                bool bfound = false;
-                for (rec = mTabMinPK; rec <= mTabMaxPK && !bfound; ++rec)
-                {
-                    if (tab->GetStrValue(colidx, rec).compare(specList.at(1).toStdString()) == 0)
-                    {
-                        bfound = true;
-                    }
-                }
-                if (!bfound)
-                {
-                    bthrow = true;
-                }
-                row = rec;
+                bthrow = true;
             }
 
             if (!bthrow)
@@ -406,6 +384,185 @@ NMDataComponent::getModelParameter(const QString &paramSpec)
     return param;
 }
 
+long long
+NMDataComponent::lookupRowByValue(otb::AttributeTable* tab, int colidx, const QString& value)
+{
+    if (tab == nullptr || colidx < 0 || colidx >= tab->GetNumCols())
+    {
+        return -1;
+    }
+
+    // drop the index, if it doesn't reflect the table (anymore)
+    if (    tab != mValueIndexTab
+        ||  tab->GetMTime() != mValueIndexMTime
+        ||  tab->GetNumRows() != mValueIndexNumRows
+       )
+    {
+        mValueIndex.clear();
+        mValueIndexTab = tab;
+        mValueIndexMTime = tab->GetMTime();
+        mValueIndexNumRows = tab->GetNumRows();
+    }
+
+    const QString colname = tab->GetColumnName(colidx).c_str();
+    const bool bString = tab->GetColumnType(colidx) == otb::AttributeTable::ATTYPE_STRING;
+    bool bok = true;
+    const double dval = bString ? 0.0 : value.toDouble(&bok);
+    if (!bok)
+    {
+        return -1;
+    }
+
+    bool bFresh = false;
+    if (!mValueIndex.contains(colname))
+    {
+        if (!this->buildValueIndex(tab, colidx))
+        {
+            return -1;
+        }
+        bFresh = true;
+    }
+
+    // table values may have been edited without touching the table's
+    // MTime, so we double check the row found and rebuild the index
+    // once, if it doesn't match or if the value is not indexed
+    for (int pass=0; pass < 2; ++pass)
+    {
+        const ValueIndex& vi = mValueIndex[colname];
+        long long row = -1;
+        if (bString)
+        {
+            row = vi.strRows.value(value, -1);
+        }
+        else
+        {
+            std::unordered_map<double, long long>::const_iterator it = vi.numRows.find(dval);
+            row = it != vi.numRows.end() ? it->second : -1;
+        }
+
+        if (    row >= 0
+            &&  (bString ? tab->GetStrValue(colidx, row).compare(value.toStdString()) == 0
+                         : tab->GetDblValue(colidx, row) == dval)
+           )
+        {
+            return row;
+        }
+
+        if (bFresh || !this->buildValueIndex(tab, colidx))
+        {
+            break;
+        }
+        bFresh = true;
+    }
+
+    return -1;
+}
+
+bool
+NMDataComponent::buildValueIndex(otb::AttributeTable* tab, int colidx)
+{
+    const QString colname = tab->GetColumnName(colidx).c_str();
+    ValueIndex& vi = mValueIndex[colname];
+    vi.strRows.clear();
+    vi.numRows.clear();
+
+    const long long minPK = tab->GetMinPKValue();
+    const long long maxPK = tab->GetMaxPKValue();
+    if (maxPK < minPK)
+    {
+        return true;
+    }
+
+    // we only index rows actually present in the table (SQLite
+    // primary keys may have gaps) and only record the first row
+    // of any value
+    long long numIndexed = 0;
+    if (tab->GetColumnType(colidx) == otb::AttributeTable::ATTYPE_STRING)
+    {
+        if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_SQLITE)
+        {
+            otb::SQLiteTable* sqltab = static_cast<otb::SQLiteTable*>(tab);
+
+            std::vector<std::string> colnames;
+            colnames.push_back(sqltab->GetPrimaryKey());
+            colnames.push_back(colname.toStdString());
+            std::vector<otb::AttributeTable::ColumnValue> values(2);
+
+            if (!sqltab->PrepareBulkGet(colnames, "", false))
+            {
+                mValueIndex.remove(colname);
+                return false;
+            }
+
+            while (sqltab->DoBulkGet(values))
+            {
+                const QString key = QString::fromUtf8(values[1].tval);
+                if (!vi.strRows.contains(key))
+                {
+                    vi.strRows.insert(key, values[0].ival);
+                }
+                ++numIndexed;
+            }
+
+            if (sqltab->BulkGetFailed())
+            {
+                NMLogError(<< this->objectName().toStdString()
+                           << ": Failed indexing column '" << colname.toStdString()
+                           << "': " << sqltab->getLastLogMsg());
+                mValueIndex.remove(colname);
+                return false;
+            }
+        }
+        else
+        {
+            // the rows of all other tables are contiguous
+            const long long numRows = maxPK - minPK + 1;
+            std::vector<std::string> vals;
+            if (!tab->GetColumnAsArray(colidx, minPK, numRows, vals))
+            {
+                mValueIndex.remove(colname);
+                return false;
+            }
+
+            vi.strRows.reserve(numRows);
+            for (long long r=0; r < numRows; ++r)
+            {
+                const QString key = QString::fromStdString(vals[r]);
+                if (!vi.strRows.contains(key))
+                {
+                    vi.strRows.insert(key, minPK + r);
+                }
+            }
+            numIndexed = numRows;
+        }
+    }
+    else
+    {
+        std::vector<int> cols(1, colidx);
+        if (!tab->PrepareColumnScan(cols, minPK, maxPK))
+        {
+            mValueIndex.remove(colname);
+            return false;
+        }
+
+        vi.numRows.reserve(tab->GetNumRows());
+        long long row;
+        double val;
+        while (tab->NextScanRow(row, &val))
+        {
+            vi.numRows.emplace(val, row);
+            ++numIndexed;
+        }
+        tab->EndColumnScan();
+    }
+
+    NMDebugAI(<< this->objectName().toStdString() << ": indexed "
+              << numIndexed << " values of column '" << colname.toStdString()
+              << "'" << std::endl);
+
+    return true;
+}
+
 void
 NMDataComponent::fetchData(NMModelComponent* comp)
 {
@@ -569,6 +726,8 @@ NMDataComponent::reset(void)
     this->mSourceMTime.setMSecsSinceEpoch(0);
     this->mInputOutputIdx = 0;
     this->mLastInputOutputIdx = 0;
+    this->mValueIndex.clear();
+    this->mValueIndexTab = nullptr;
 
     emit NMDataComponentChanged();
 
@@ -27,7 +27,9 @@
 
 #include <string>
 #include <iostream>
+#include <unordered_map>
 #include <QMap>
+#include <QHash>
 #include <QDateTime>
 #include <QStringList>
 
@@ -85,6 +87,27 @@ protected:
     virtual void initAttributes(void);
     void fetchData(NMModelComponent* comp);
 
+    /*! Returns the primary key value of the first row whose value in
+     *  column colidx equals value, or -1 if there is no such row.
+     *  Lookups use a per-column value -> row hash index, which is built
+     *  on demand and rebuilt when the table, its MTime, or its number
+     *  of rows has changed, or when an indexed row doesn't match anymore.
+     */
+    long long lookupRowByValue(otb::AttributeTable* tab, int colidx, const QString& value);
+    bool buildValueIndex(otb::AttributeTable* tab, int colidx);
+
+    typedef struct
+    {
+        QHash<QString, long long> strRows;
+        std::unordered_map<double, long long> numRows;
+    } ValueIndex;
+
+    // column name -> value index of mValueIndexTab
+    QHash<QString, ValueIndex> mValueIndex;
+    otb::AttributeTable* mValueIndexTab;
+    itk::ModifiedTimeType mValueIndexMTime;
+    long long mValueIndexNumRows;
+
 private:
     static const std::string ctx;
 
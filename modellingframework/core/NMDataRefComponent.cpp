@@ -344,38 +344,10 @@ NMDataRefComponent::getModelParameter(const QString &paramSpec)
         // value in column 'colidx'
         if (!bok)
         {
-            QString pkcol = tab->GetPrimaryKey().c_str();
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_SQLITE)
+            row = mDataComponent->lookupRowByValue(tab.GetPointer(), colidx, specList.at(1));
+            if (row < 0)
             {
-                otb::SQLiteTable::Pointer sqltab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
-                std::stringstream wclause;
-
-                if (tab->GetColumnType(colidx) == otb::AttributeTable::ATTYPE_STRING)
-                {
-                    wclause << specList.at(0).toStdString().c_str() << " = '" << specList.at(1).toStdString().c_str() << "'";
-                }
-                else
-                {
-                    wclause << specList.at(0).toStdString().c_str() << " = " << specList.at(1).toStdString().c_str();
-                }
-
-                row = sqltab->GetIntValue(pkcol.toStdString(), wclause.str());
-            }
-            else
-            {   int rec;
-                bool bfound = false;
-                for (rec = mDataComponent->mTabMinPK; rec <= mDataComponent->mTabMaxPK && !bfound; ++rec)
-                {
-                    if (tab->GetStrValue(colidx, rec).compare(specList.at(1).toStdString()) == 0)
-                    {
-                        bfound = true;
-                    }
-                }
-                if (!bfound)
-                {
-                    bthrow = true;
-                }
-                row = rec;
+                bthrow = true;
             }
 
             if (!bthrow)
@@ -1390,7 +1390,7 @@ NMImageReader::NMImageReader(QObject * parent)
     this->mRGBMode = false;
     this->mParameterHandling = NMProcess::NM_USE_UP;
     this->mRATType = QString("ATTABLE_TYPE_RAM");
-    this->mRATEnum << "ATTABLE_TYPE_RAM" << "ATTABLE_TYPE_SQLITE";
+    this->mRATEnum << "ATTABLE_TYPE_RAM" << "ATTABLE_TYPE_SQLITE" << "ATTABLE_TYPE_COLUMNAR";
     this->mDbRATReadOnly = false;
 #ifdef BUILD_RASSUPPORT
     this->mRasconn = 0;
@@ -1554,6 +1554,10 @@ bool NMImageReader::initialise()
             {
                 gio->SetRATType(otb::AttributeTable::ATTABLE_TYPE_RAM);
             }
+            else if (mRATType.compare(QString("ATTABLE_TYPE_COLUMNAR")) == 0)
+            {
+                gio->SetRATType(otb::AttributeTable::ATTABLE_TYPE_COLUMNAR);
+            }
             else
             {
                 gio->SetRATType(otb::AttributeTable::ATTABLE_TYPE_SQLITE);
@@ -1775,6 +1779,10 @@ NMImageReader::setInternalRATType()
             {
                 ttype = otb::AttributeTable::ATTABLE_TYPE_RAM;
             }
+            else if (mRATType.compare(QString("ATTABLE_TYPE_COLUMNAR")) == 0)
+            {
+                ttype = otb::AttributeTable::ATTABLE_TYPE_COLUMNAR;
+            }
             else
             {
                 ttype = otb::AttributeTable::ATTABLE_TYPE_SQLITE;
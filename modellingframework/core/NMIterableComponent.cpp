@@ -1158,6 +1158,15 @@ NMIterableComponent::componentUpdateLogic(const QMap<QString, NMModelComponent*>
     QString actId = QString("nm:%1_Update-%2").arg(this->objectName()).arg(this->getIterationStep());
     QString agId = QString("nm:%1").arg(this->objectName());
 
+    // ==============================================================================
+    // PROFILING
+    NMProfileScope profScope(controller->getProfiler(),
+                             this->getUserID().isEmpty() ? this->objectName() : this->getUserID(),
+                             this->mProcess != nullptr ? QStringLiteral("process")
+                                                       : QStringLiteral("aggregate"));
+    profScope.setArg(QStringLiteral("component"), this->objectName());
+    profScope.setArg(QStringLiteral("step"), step+1);
+
     // ==============================================================================
     // UPDATE LOGIC
     try
@@ -1209,8 +1218,33 @@ NMIterableComponent::componentUpdateLogic(const QMap<QString, NMModelComponent*>
         controller->getLogger()->logProvN(NMLogger::NM_PROV_START, args, attrs);
 
 
-        // execute process / pipeline
-        this->mProcess->update();
+        // execute process / pipeline, unless the process' outputs
+        // of a previous execution are still up-to-date
+        if (this->mProcess->reuseCachedOutputs())
+        {
+            NMLogInfo(<< this->objectName().toStdString()
+                      << ": Outputs are up-to-date - skipped execution!");
+            profScope.setArg(QStringLiteral("cached"), true);
+        }
+        else
+        {
+            const QDateTime updateStart = QDateTime::currentDateTime();
+            this->mProcess->update();
+            this->mProcess->cacheOutputs(updateStart);
+        }
+
+        if (profScope.isActive())
+        {
+            qint64 numPix = 0;
+            qint64 numBytes = 0;
+            if (    this->mProcess->getImageRegionSize(false, false, numPix, numBytes)
+                ||  this->mProcess->getImageRegionSize(true, false, numPix, numBytes)
+               )
+            {
+                profScope.setArg(QStringLiteral("pixels"), numPix);
+            }
+            profScope.setArg(QStringLiteral("hostStep"), hostStep);
+        }
 
         // more provenenace
         endTime = QDateTime::currentDateTime();
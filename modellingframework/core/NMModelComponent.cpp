@@ -67,7 +67,9 @@ NMModelComponent::ProcessLogEvent(itk::Object* obj, const itk::EventObject& even
     {
         itk::NMLogEvent& le = dynamic_cast<itk::NMLogEvent&>(
                     const_cast<itk::EventObject&>(event));
-        if (mLogger)
+        if (    mLogger
+            &&  mLogger->isLogLevelEnabled((NMLogger::LogEventType)le.getLogType())
+           )
         {
             QString userID = this->getUserID();
             if (userID.isEmpty())
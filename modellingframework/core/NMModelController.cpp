@@ -376,6 +376,30 @@ NMModelController::executeModel(const QString& compName)
 
     this->mModelStarted = QDateTime::currentDateTime();
 
+    if (mProfiler.isProfilingOn())
+    {
+        mProfiler.start(mRank, mNumProcs);
+    }
+
+    // memoised sink outputs of previous iterations and runs
+    QString cacheFN;
+    if (this->getSetting("OutputCache").toBool())
+    {
+        const QString ws = this->getSetting("Workspace").toString();
+        if (!ws.isEmpty() && QFileInfo(ws).isDir())
+        {
+            cacheFN = mNumProcs > 1
+                    ? QString("%1/.lumass_outputcache_r%2.json").arg(ws).arg(mRank)
+                    : QString("%1/.lumass_outputcache.json").arg(ws);
+        }
+        else
+        {
+            NMLogWarn(<< "Model Controller: Output cache is switched off, "
+                      << "since no valid 'Workspace' has been specified!");
+        }
+    }
+    mOutputCache.open(cacheFN);
+
 //#ifdef LUMASS_DEBUG
 //#ifndef _WIN32
 //    int ind = nmlog::nmindent;
@@ -456,6 +480,30 @@ NMModelController::executeModel(const QString& compName)
         endProv();
     }
 
+    // ================================================
+    // write execution profile
+    if (mProfiler.isProfilingOn())
+    {
+        if (mProfiler.write())
+        {
+            NMLogInfo(<< "Model Controller: Wrote execution profile '"
+                      << mProfiler.getFileName().toStdString() << "'");
+        }
+        else
+        {
+            NMLogError(<< "Model Controller: Failed writing execution profile '"
+                       << mProfiler.getFileName().toStdString() << "'!");
+        }
+    }
+
+    // ================================================
+    // update the output cache
+    if (mOutputCache.isEnabled() && !mOutputCache.save())
+    {
+        NMLogError(<< "Model Controller: Failed writing output cache '"
+                   << mOutputCache.getFileName().toStdString() << "'!");
+    }
+
     // to be on the safe side, we reset the execution stack and
     // notify all listeners, that those components are no longer
     // running
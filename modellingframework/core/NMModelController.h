@@ -44,6 +44,8 @@
 #endif
 
 #include "NMObject.h"
+#include "NMProfiler.h"
+#include "NMOutputCache.h"
 #include "otbAttributeTable.h"
 
 #include "nmmodframecore_export.h"
@@ -375,6 +377,21 @@ public slots:
 
     void registerPythonRequest(const QString& compName);
 
+    /*! execution profiling; profiling is switched on by
+     *  specifying the name of the Chrome trace (JSON) file
+     *  to be written after each model run
+     *  (s. \ref NMProfiler); an empty name switches it off
+     */
+    void setProfileFileName(const QString& fn) {mProfiler.setFileName(fn);}
+    bool isProfilingOn(void) {return mProfiler.isProfilingOn();}
+    NMProfiler* getProfiler(void) {return &mProfiler;}
+
+    /*! output cache; switched on by the 'OutputCache' setting
+     *  (s. \ref NMOutputCache); returns nullptr if it is off
+     */
+    NMOutputCache* getOutputCache(void)
+        {return mOutputCache.isEnabled() ? &mOutputCache : nullptr;}
+
     // parallel processing
     int getRank(void){return mRank;}
     int getRank(const QString& comp);
@@ -439,6 +456,9 @@ protected:
     QString mProvFileName;
     QMap<QString, QMap<QString, int> > mMapProvIdConRev;
 
+    NMProfiler mProfiler;
+    NMOutputCache mOutputCache;
+
     // parallel processing
     int mRank;
     int mNumProcs;
@@ -0,0 +1,224 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2017 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "NMOutputCache.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+NMOutputCache::NMOutputCache()
+{
+}
+
+void
+NMOutputCache::open(const QString &fileName)
+{
+    QMutexLocker lock(&mMutex);
+    mFileName = fileName;
+    mEntries.clear();
+
+    QFile cacheFile(fileName);
+    if (fileName.isEmpty() || !cacheFile.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    const QJsonObject comps = QJsonDocument::fromJson(cacheFile.readAll()).object();
+    QJsonObject::const_iterator compIt = comps.constBegin();
+    for (; compIt != comps.constEnd(); ++compIt)
+    {
+        QList<CacheEntry>& entries = mEntries[compIt.key()];
+        foreach(const QJsonValue& ev, compIt.value().toArray())
+        {
+            const QJsonObject eo = ev.toObject();
+            CacheEntry ce;
+            ce.key = eo.value(QStringLiteral("key")).toString();
+            const QJsonObject outs = eo.value(QStringLiteral("outputs")).toObject();
+            QJsonObject::const_iterator outIt = outs.constBegin();
+            for (; outIt != outs.constEnd(); ++outIt)
+            {
+                ce.outputs.insert(outIt.key(), outIt.value().toString());
+            }
+
+            if (!ce.key.isEmpty() && !ce.outputs.isEmpty())
+            {
+                entries.push_back(ce);
+            }
+        }
+    }
+}
+
+bool
+NMOutputCache::save(void)
+{
+    QMutexLocker lock(&mMutex);
+    if (mFileName.isEmpty())
+    {
+        return false;
+    }
+
+    QJsonObject comps;
+    QMap<QString, QList<CacheEntry> >::const_iterator compIt = mEntries.constBegin();
+    for (; compIt != mEntries.constEnd(); ++compIt)
+    {
+        QJsonArray entries;
+        foreach(const CacheEntry& ce, compIt.value())
+        {
+            QJsonObject outs;
+            QMap<QString, QString>::const_iterator outIt = ce.outputs.constBegin();
+            for (; outIt != ce.outputs.constEnd(); ++outIt)
+            {
+                outs.insert(outIt.key(), outIt.value());
+            }
+
+            QJsonObject eo;
+            eo.insert(QStringLiteral("key"), ce.key);
+            eo.insert(QStringLiteral("outputs"), outs);
+            entries.append(eo);
+        }
+        comps.insert(compIt.key(), entries);
+    }
+
+    QFile cacheFile(mFileName);
+    if (!cacheFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    cacheFile.write(QJsonDocument(comps).toJson(QJsonDocument::Indented));
+    cacheFile.close();
+
+    return true;
+}
+
+bool
+NMOutputCache::isUpToDate(const QString &compName, const QString &key)
+{
+    QMutexLocker lock(&mMutex);
+    if (key.isEmpty())
+    {
+        return false;
+    }
+
+    QMap<QString, QList<CacheEntry> >::const_iterator compIt = mEntries.constFind(compName);
+    if (compIt == mEntries.constEnd())
+    {
+        return false;
+    }
+
+    foreach(const CacheEntry& ce, compIt.value())
+    {
+        if (ce.key != key)
+        {
+            continue;
+        }
+
+        QMap<QString, QString>::const_iterator outIt = ce.outputs.constBegin();
+        for (; outIt != ce.outputs.constEnd(); ++outIt)
+        {
+            if (fileStamp(outIt.key()) != outIt.value())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void
+NMOutputCache::store(const QString &compName, const QString &key,
+                     const QStringList &outputs)
+{
+    if (key.isEmpty() || outputs.isEmpty())
+    {
+        return;
+    }
+
+    CacheEntry ce;
+    ce.key = key;
+    foreach(const QString& fn, outputs)
+    {
+        const QString stamp = fileStamp(fn);
+        if (!stamp.isEmpty())
+        {
+            ce.outputs.insert(fn, stamp);
+        }
+    }
+
+    if (ce.outputs.isEmpty())
+    {
+        return;
+    }
+
+    QMutexLocker lock(&mMutex);
+    QList<CacheEntry>& entries = mEntries[compName];
+    for (int e=0; e < entries.size(); ++e)
+    {
+        if (entries.at(e).key == key)
+        {
+            entries.removeAt(e);
+            break;
+        }
+    }
+
+    entries.push_back(ce);
+    while (entries.size() > mMaxEntries)
+    {
+        entries.removeFirst();
+    }
+}
+
+QStringList
+NMOutputCache::getKnownOutputs(const QString &compName)
+{
+    QMutexLocker lock(&mMutex);
+    QStringList known;
+    foreach(const CacheEntry& ce, mEntries.value(compName))
+    {
+        foreach(const QString& fn, ce.outputs.keys())
+        {
+            if (!known.contains(fn))
+            {
+                known << fn;
+            }
+        }
+    }
+
+    return known;
+}
+
+QString
+NMOutputCache::fileStamp(const QString &fileName)
+{
+    QFileInfo fifo(fileName);
+    if (!fifo.isFile())
+    {
+        return QString();
+    }
+
+    return QString("%1:%2")
+            .arg(fifo.lastModified().toMSecsSinceEpoch())
+            .arg(fifo.size());
+}
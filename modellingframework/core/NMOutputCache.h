@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2017 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef NMOUTPUTCACHE_H
+#define NMOUTPUTCACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QList>
+#include <QMutex>
+
+#include "nmmodframecore_export.h"
+
+/*!
+ * \brief The NMOutputCache class memoises the file outputs of sink processes
+ *
+ * When the output cache is switched on (model setting 'OutputCache',
+ * s. lumassengine --cache), each process computes a key from its
+ * resolved parameters, the time stamps of the files it refers to,
+ * and the keys of its upstream processes (s. NMProcess::getOutputCacheKey).
+ * After a sink process has been executed, the files it has written are
+ * recorded together with the key. If the same sink is executed again
+ * with the same key - in a later iteration or model run - and its
+ * recorded output files haven't been touched since, the process (and
+ * thereby its upstream pipeline) is skipped.
+ *
+ * The cache index is a JSON file in the workspace, which is read at
+ * the start and written at the end of each model run.
+ */
+class NMMODFRAMECORE_EXPORT NMOutputCache
+{
+public:
+    NMOutputCache();
+
+    /*! reads the cache index from the given file and switches
+     *  the cache on; an empty name switches it off */
+    void open(const QString& fileName);
+    bool isEnabled(void) const {return !mFileName.isEmpty();}
+    QString getFileName(void) const {return mFileName;}
+
+    /*! writes the cache index */
+    bool save(void);
+
+    /*! true, if outputs have been recorded for the given component
+     *  and key and none of them has been modified since */
+    bool isUpToDate(const QString& compName, const QString& key);
+
+    /*! records the output files of the given component and key */
+    void store(const QString& compName, const QString& key,
+               const QStringList& outputs);
+
+    /*! all output files recorded for the given component */
+    QStringList getKnownOutputs(const QString& compName);
+
+    /*! modification time and size of the given file; empty if the
+     *  file doesn't exist */
+    static QString fileStamp(const QString& fileName);
+
+protected:
+    typedef struct
+    {
+        QString key;
+        // file name -> file stamp
+        QMap<QString, QString> outputs;
+    } CacheEntry;
+
+    QString mFileName;
+    QMutex mMutex;
+    QMap<QString, QList<CacheEntry> > mEntries;
+
+    // max number of keys kept per component
+    static const int mMaxEntries = 64;
+};
+
+#endif // NMOUTPUTCACHE_H
@@ -34,12 +34,15 @@
 #include "NMModelController.h"
 #include "NMMfwException.h"
 
+#include <algorithm>
+
 const std::string NMParallelIterComponent::ctx = "NMParallelIterComponent";
 
 NMParallelIterComponent::NMParallelIterComponent(QObject* parent)
 {
     this->setParent(parent);
     NMIterableComponent::initAttributes();
+    mSchedulingMode = QStringLiteral("static");
 }
 
 NMParallelIterComponent::~NMParallelIterComponent()
@@ -79,6 +82,15 @@ NMParallelIterComponent::iterativeComponentUpdate(const QMap<QString, NMModelCom
         numIterations = this->evalNumIterationsExpression(mIterationStep);
     }
 
+    if (    mSchedulingMode.compare(QStringLiteral("dynamic"), Qt::CaseInsensitive) == 0
+         && procs > 1 && comm != MPI_COMM_NULL
+       )
+    {
+        this->dynamicComponentUpdate(repo, minLevel, maxLevel, comm, rank, numIterations);
+        mController->registerParallelGroup(this->objectName(), comm);
+        return;
+    }
+
     int ntasks = numIterations - (mIterationStep - 1);
     int nsplits = std::min(ntasks, procs);
     QMap<int, QPair<int, QVector<int>>> mapTaskSplitRanks;
@@ -231,3 +243,132 @@ NMParallelIterComponent::iterativeComponentUpdate(const QMap<QString, NMModelCom
     }
 }
 
+
+void
+NMParallelIterComponent::dynamicComponentUpdate(const QMap<QString, NMModelComponent*>& repo,
+            unsigned int minLevel, unsigned int maxLevel,
+            MPI_Comm comm, int rank, int numIterations)
+{
+    // rank 0 determines the order of tasks (iterations) and
+    // lets everybody else know
+    const int firstTask = mIterationStep - 1;
+    std::vector<int> taskOrder;
+    if (rank == 0)
+    {
+        taskOrder = this->getTaskOrder(firstTask, numIterations);
+    }
+
+    int ntasks = static_cast<int>(taskOrder.size());
+    MPI_Bcast(&ntasks, 1, MPI_INT, 0, comm);
+    taskOrder.resize(ntasks);
+    if (ntasks > 0)
+    {
+        MPI_Bcast(taskOrder.data(), ntasks, MPI_INT, 0, comm);
+    }
+
+    // every rank works on its tasks on its own
+    MPI_Comm iterComm = MPI_COMM_NULL;
+    MPI_Comm_split(comm, rank, 0, &iterComm);
+    mController->registerParallelGroup(this->objectName(), iterComm);
+
+    // the task counter lives on rank 0; ranks atomically fetch
+    // and increment it whenever they're ready for the next task;
+    // we let MPI allocate the window memory, so that RMA capable
+    // transports can serve the fetch-and-ops without rank 0 having
+    // to enter MPI, which it won't while it's working on a task
+    int* taskCounter = nullptr;
+    MPI_Win win;
+    MPI_Win_allocate(rank == 0 ? sizeof(int) : 0, sizeof(int),
+                     MPI_INFO_NULL, comm, &taskCounter, &win);
+    if (rank == 0)
+    {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, win);
+        *taskCounter = 0;
+        MPI_Win_unlock(0, win);
+    }
+    MPI_Barrier(comm);
+
+    int worldRank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    const int one = 1;
+    int taskIdx = 0;
+    while (!mController->isModelAbortionRequested())
+    {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, win);
+        MPI_Fetch_and_op(&one, &taskIdx, MPI_INT, 0, 0, MPI_SUM, win);
+        MPI_Win_unlock(0, win);
+
+        if (taskIdx >= ntasks)
+        {
+            break;
+        }
+
+        const unsigned int i = taskOrder.at(taskIdx);
+        wulog(-1, " lr" << rank << ": " << this->objectName().toStdString()
+              << " step #" << i << ": dynamic task #" << taskIdx)
+
+        mIterationStepRun = i + 1;
+        emit signalProgress(mIterationStepRun);
+        this->componentUpdateLogic(repo, minLevel, maxLevel, i);
+    }
+    mIterationStepRun = mIterationStep;
+    emit signalProgress(mIterationStep);
+
+    MPI_Barrier(comm);
+    MPI_Win_free(&win);
+
+    mController->deregisterParallelGroup(this->objectName());
+    MPI_Comm_free(&iterComm);
+}
+
+std::vector<int>
+NMParallelIterComponent::getTaskOrder(int firstTask, int numIterations)
+{
+    std::vector<int> order;
+    for (int i=firstTask; i < numIterations; ++i)
+    {
+        order.push_back(i);
+    }
+
+    if (mTaskCostExpression.isEmpty() || order.empty())
+    {
+        return order;
+    }
+
+    // evaluate the cost hint in the context of each iteration
+    std::vector<double> costs(order.size(), 0);
+    for (size_t t=0; t < order.size(); ++t)
+    {
+        mIterationStepRun = order[t] + 1;
+        const QString costStr = mController->processStringParameter(this, mTaskCostExpression);
+
+        bool bok = false;
+        costs[t] = costStr.toDouble(&bok);
+        if (!bok)
+        {
+            NMLogWarn(<< this->objectName().toStdString() << ": Invalid TaskCostExpression '"
+                      << costStr.toStdString() << "' for iteration #" << order[t] + 1
+                      << " - assuming zero cost!");
+            costs[t] = 0;
+        }
+    }
+    mIterationStepRun = mIterationStep;
+
+    // big tasks first
+    std::vector<size_t> idx(order.size());
+    for (size_t t=0; t < idx.size(); ++t)
+    {
+        idx[t] = t;
+    }
+    std::stable_sort(idx.begin(), idx.end(),
+                     [&costs](size_t a, size_t b){return costs[a] > costs[b];});
+
+    std::vector<int> sorted(order.size());
+    for (size_t t=0; t < idx.size(); ++t)
+    {
+        sorted[t] = order[idx[t]];
+    }
+
+    return sorted;
+}
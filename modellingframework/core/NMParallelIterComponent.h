@@ -31,13 +31,31 @@
 #include "NMIterableComponent.h"
 
 #include <QMap>
+#include <vector>
 
 #include "nmmodframecore_export.h"
 
+/*! \brief NMParallelIterComponent distributes its iterations
+ *         across the MPI ranks assigned to it
+ *
+ *  SchedulingMode 'static' (default): iterations are assigned to
+ *  ranks round-robin; once all ranks are busy, they wait for each
+ *  other before they take on the next round of iterations.
+ *
+ *  SchedulingMode 'dynamic': ranks pull the next iteration from a
+ *  shared task counter (MPI one-sided window on rank 0) as soon as
+ *  they're done with their previous one. If a TaskCostExpression
+ *  is given (e.g. a parameter table lookup of the iteration's
+ *  catchment size), it is evaluated for each iteration and
+ *  iterations are handed out in descending order of cost.
+ */
 class NMMODFRAMECORE_EXPORT NMParallelIterComponent: public NMIterableComponent
 {
 	Q_OBJECT
 
+    Q_PROPERTY(QString SchedulingMode READ getSchedulingMode WRITE setSchedulingMode)
+    Q_PROPERTY(QString TaskCostExpression READ getTaskCostExpression WRITE setTaskCostExpression)
+
 
 public:
 	signals:
@@ -49,11 +67,25 @@ public:
 
     virtual void setProcess(NMProcess* proc){}
 
+    NMPropertyGetSet(SchedulingMode, QString)
+    NMPropertyGetSet(TaskCostExpression, QString)
+
 protected:
 
     void iterativeComponentUpdate(const QMap<QString, NMModelComponent*>& repo,
     		unsigned int minLevel, unsigned int maxLevel);
 
+    void dynamicComponentUpdate(const QMap<QString, NMModelComponent*>& repo,
+            unsigned int minLevel, unsigned int maxLevel,
+            MPI_Comm comm, int rank, int numIterations);
+
+    /*! iterations (0-based) in the order they're handed out,
+     *  i.e. descending TaskCostExpression */
+    std::vector<int> getTaskOrder(int firstTask, int numIterations);
+
+    QString mSchedulingMode;
+    QString mTaskCostExpression;
+
 private:
 	static const std::string ctx;
 
@@ -24,8 +24,13 @@
 
 #include "otbImage.h"
 #include "otbImageIOBase.h"
+#include "itkImageBase.h"
 
 #include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QMetaProperty>
+#include <QCryptographicHash>
 
 #include "nmtypeinfo.h"
 #include "NMProcess.h"
@@ -36,8 +41,30 @@
 #include "NMModelController.h"
 //#include "utils/muParser/muParserError.h"
 #include "itkNMLogEvent.h"
+#include "NMProfiler.h"
+#include "NMOutputCache.h"
 #include <algorithm>
 
+namespace
+{
+template<unsigned int Dimension>
+bool
+getImageBaseRegionSize(itk::DataObject* dobj, bool bRequested,
+                       qint64& numPixels, unsigned int& numComps)
+{
+    itk::ImageBase<Dimension>* img = dynamic_cast<itk::ImageBase<Dimension>*>(dobj);
+    if (img == nullptr)
+    {
+        return false;
+    }
+
+    numPixels = bRequested ? img->GetRequestedRegion().GetNumberOfPixels()
+                           : img->GetLargestPossibleRegion().GetNumberOfPixels();
+    numComps = img->GetNumberOfComponentsPerPixel();
+    return true;
+}
+}
+
 NMProcess::NMProcess(QObject *parent)
     : mbAbortExecution(false), mbLinked(false)
 {
@@ -58,6 +85,8 @@ NMProcess::NMProcess(QObject *parent)
     this->mStepIndex = 0;
     this->mObserver = 0;
     this->mAuxDataIdx = -1;
+    this->mProfDivStart = 0;
+    this->mProfDivCount = 0;
 
     mUserProperties.clear();
     mUserProperties.insert(QStringLiteral("NMInputComponentType"), QStringLiteral("InputPixelType"));
@@ -135,9 +164,11 @@ NMProcess::linkInPipeline(unsigned int step,
 
     // clear provenance info before this run
     mRuntimeParaProv.clear();
+    mInputCacheKeys.clear();
 
     this->linkParameters(step, repo);
     this->linkInputs(step, repo);
+    this->updateOutputCacheKey();
 
 #ifdef LUMASS_DEBUG
     if (this->mOtbProcess.IsNotNull())
@@ -509,6 +540,12 @@ void NMProcess::linkInputs(unsigned int step, const QMap<QString, NMModelCompone
                 // making sure the input component is linked-up
                 ic->linkComponents(inputstep, repo);
 
+                if (mController != nullptr && mController->getOutputCache() != nullptr)
+                {
+                    NMProcess* ip = iterComp != nullptr ? iterComp->getProcess() : nullptr;
+                    mInputCacheKeys << (ip != nullptr ? ip->getOutputCacheKey() : QString());
+                }
+
                 // note: we're linking anything here! It means the user is responsible for deciding
                 //       whether or not it is a good idea to build a pipeline across timelevels or
                 //       not! -> gives greater flexibility
@@ -665,6 +702,8 @@ void NMProcess::update(void)
 {
     NMDebugCtx(this->parent()->objectName().toStdString(), << "...");
 
+    mProfDivCount = 0;
+
     if (this->mbIsInitialised && this->mOtbProcess.IsNotNull())
     {
         try
@@ -694,6 +733,160 @@ void NMProcess::update(void)
     NMDebugCtx(this->parent()->objectName().toStdString(), << "done!");
 }
 
+void
+NMProcess::updateOutputCacheKey(void)
+{
+    mOutputCacheKey.clear();
+    mOutputCacheFiles.clear();
+
+    NMOutputCache* cache = mController != nullptr ? mController->getOutputCache() : nullptr;
+    if (cache == nullptr || mInputCacheKeys.contains(QString()))
+    {
+        return;
+    }
+
+    // the key is made up of the resolved parameters of this
+    // process, the stamps of the files referred to (except this
+    // component's own outputs), and the keys of its inputs
+    const QString compName = this->parent()->objectName();
+    const QStringList knownOutputs = cache->getKnownOutputs(compName);
+
+    QString desc = QString("%1:%2\n").arg(this->metaObject()->className()).arg(compName);
+    const QMetaObject* meta = this->metaObject();
+    for (int p=NMProcess::staticMetaObject.propertyOffset(); p < meta->propertyCount(); ++p)
+    {
+        const QString propName = meta->property(p).name();
+        const QVariant val = this->getParameter(propName);
+
+        QStringList vals;
+        if (val.type() == QVariant::StringList)
+        {
+            vals = val.toStringList();
+        }
+        else
+        {
+            vals << val.toString();
+        }
+        desc += QString("%1=%2\n").arg(propName).arg(vals.join(QStringLiteral("|")));
+
+        foreach(const QString& v, vals)
+        {
+            QFileInfo fifo(v);
+            if (v.isEmpty() || !fifo.isAbsolute() || !fifo.absoluteDir().exists())
+            {
+                continue;
+            }
+
+            const QString fn = fifo.absoluteFilePath();
+            mOutputCacheFiles << fn;
+            if (fifo.isFile() && !knownOutputs.contains(fn))
+            {
+                desc += QString("%1@%2\n").arg(fn).arg(NMOutputCache::fileStamp(fn));
+            }
+        }
+    }
+
+    foreach(const QString& ik, mInputCacheKeys)
+    {
+        desc += QString("input=%1\n").arg(ik);
+    }
+
+    mOutputCacheKey = QString::fromLatin1(
+                QCryptographicHash::hash(desc.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+bool
+NMProcess::reuseCachedOutputs(void)
+{
+    NMOutputCache* cache = mController != nullptr ? mController->getOutputCache() : nullptr;
+    if (    cache == nullptr
+         || !mIsSink
+         || mOutputCacheKey.isEmpty()
+         || !cache->isUpToDate(this->parent()->objectName(), mOutputCacheKey)
+       )
+    {
+        return false;
+    }
+
+    this->mMTime = QDateTime::currentDateTime();
+    this->mbLinked = false;
+    emit signalProgress(100);
+
+    return true;
+}
+
+void
+NMProcess::cacheOutputs(const QDateTime &updateStart)
+{
+    NMOutputCache* cache = mController != nullptr ? mController->getOutputCache() : nullptr;
+    if (cache == nullptr || !mIsSink || mOutputCacheKey.isEmpty())
+    {
+        return;
+    }
+
+    // file systems may only provide second resolution
+    const qint64 startSecs = updateStart.toMSecsSinceEpoch() / 1000;
+    QStringList outputs;
+    foreach(const QString& fn, mOutputCacheFiles)
+    {
+        QFileInfo fifo(fn);
+        if (    fifo.isFile()
+             && fifo.lastModified().toMSecsSinceEpoch() / 1000 >= startSecs
+             && !outputs.contains(fn)
+           )
+        {
+            outputs << fn;
+        }
+    }
+
+    cache->store(this->parent()->objectName(), mOutputCacheKey, outputs);
+}
+
+bool
+NMProcess::getImageRegionSize(bool bInput, bool bRequested,
+                              qint64 &numPixels, qint64 &numBytes)
+{
+    numPixels = 0;
+    numBytes = 0;
+    if (this->mOtbProcess.IsNull())
+    {
+        return false;
+    }
+
+    itk::DataObject* dobj = nullptr;
+    if (bInput)
+    {
+        if (this->mOtbProcess->GetNumberOfIndexedInputs() > 0)
+        {
+            dobj = this->mOtbProcess->GetIndexedInputs()[0].GetPointer();
+        }
+    }
+    else if (this->mOtbProcess->GetNumberOfIndexedOutputs() > 0)
+    {
+        dobj = this->mOtbProcess->GetIndexedOutputs()[0].GetPointer();
+    }
+
+    if (dobj == nullptr)
+    {
+        return false;
+    }
+
+    unsigned int numComps = 1;
+    if (    !getImageBaseRegionSize<2>(dobj, bRequested, numPixels, numComps)
+        &&  !getImageBaseRegionSize<3>(dobj, bRequested, numPixels, numComps)
+        &&  !getImageBaseRegionSize<1>(dobj, bRequested, numPixels, numComps)
+       )
+    {
+        return false;
+    }
+
+    const int compSize = NMProfiler::getComponentSize(
+                bInput ? this->mInputComponentType : this->mOutputComponentType);
+    numBytes = numPixels * numComps * compSize;
+
+    return true;
+}
+
 void
 NMProcess::abortExecution(void)
 {
@@ -738,16 +931,73 @@ NMProcess::UpdateProgressInfo(itk::Object* obj,
     if (this->mbAbortExecution)
         proc->AbortGenerateDataOn();
 
+    NMProfiler* profiler = nullptr;
+    if (    mController != nullptr
+        &&  mController->isProfilingOn()
+        &&  proc == this->mOtbProcess.GetPointer()
+       )
+    {
+        profiler = mController->getProfiler();
+    }
+
     if (typeid(event) == typeid(itk::ProgressEvent))
     {
         emit signalProgress((float)(proc->GetProgress() * 100.0));
     }
     else if (typeid(event) == typeid(itk::StartEvent))
     {
+        if (profiler != nullptr)
+        {
+            mProfDivStart = profiler->now();
+        }
         emit signalExecutionStarted(objName);
     }
     else if (typeid(event) == typeid(itk::EndEvent))
     {
+        // itk::ProcessObjects get Start/EndEvent for each
+        // stream division they're asked to produce, except for
+        // the writer (sink), which streams internally and
+        // only gets one pair for the whole image
+        if (profiler != nullptr)
+        {
+            const qint64 dur = profiler->now() - mProfDivStart;
+            QVariantMap args;
+            args.insert(QStringLiteral("component"), objName);
+            args.insert(QStringLiteral("division"), mProfDivCount);
+            args.insert(QStringLiteral("filter"), QString(proc->GetNameOfClass()));
+
+            qint64 numPix = 0;
+            qint64 numBytes = 0;
+            if (mIsSink)
+            {
+                if (this->getImageRegionSize(true, false, numPix, numBytes))
+                {
+                    args.insert(QStringLiteral("bytesWritten"), numBytes);
+                }
+            }
+            else if (this->getImageRegionSize(false, true, numPix, numBytes))
+            {
+                if (this->inherits("NMImageReader"))
+                {
+                    args.insert(QStringLiteral("bytesRead"), numBytes);
+                }
+            }
+
+            if (numPix > 0)
+            {
+                args.insert(QStringLiteral("pixels"), numPix);
+                if (dur > 0)
+                {
+                    args.insert(QStringLiteral("pixelsPerSec"), numPix / (dur / 1e6));
+                }
+            }
+
+            profiler->addEvent(userID, mIsSink ? QStringLiteral("write")
+                                               : QStringLiteral("division"),
+                               mProfDivStart, dur, args);
+            ++mProfDivCount;
+        }
+
         emit signalExecutionStopped(objName);
         emit signalProgress(0);
         this->mOtbProcess->SetAbortGenerateData(false);
@@ -860,6 +1110,15 @@ NMProcess::UpdateProgressInfo(itk::Object* obj,
                 break;
             default: // log case
                 {
+                    // errors need to reset the pipeline regardless of
+                    // whether they're actually logged or not
+                    if (    !mLogger->isLogLevelEnabled((NMLogger::LogEventType)le.getLogType())
+                        &&  le.getLogType() != itk::NMLogEvent::NM_LOG_ERROR
+                       )
+                    {
+                        break;
+                    }
+
                     QString logmsg = QString("%1: %2").arg(userID).arg(le.getLogMsg().c_str());
                     mLogger->processLogMsg(le.getLogTime().c_str(),
                                            (NMLogger::LogEventType)le.getLogType(),
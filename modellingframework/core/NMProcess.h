@@ -252,6 +252,24 @@ public:
     QStringList getRunTimeParaProvN(void){return mRuntimeParaProv;}
     void addRunTimeParaProvN(const QString& provNAttr){mRuntimeParaProv << provNAttr;}
 
+    /*! output cache key (s. \ref NMOutputCache) computed when this
+     *  process is linked into the pipeline; it is empty, if the
+     *  output cache is off or any of the upstream components' outputs
+     *  can't be identified by a key (e.g. data components)
+     */
+    QString getOutputCacheKey(void) {return mOutputCacheKey;}
+
+    /*! returns true, if this is a sink whose output files written
+     *  by a previous execution with the same key are still up-to-date;
+     *  the process is then treated as if it had been updated
+     */
+    bool reuseCachedOutputs(void);
+
+    /*! records the files written by this sink since updateStart
+     *  in the output cache
+     */
+    void cacheOutputs(const QDateTime& updateStart);
+
     int getAuxDataIdx(void)
         {return this->mAuxDataIdx;}
 
@@ -261,6 +279,14 @@ public:
         { return mUserProperties[propName]; }
     QString mapDisplayToPropertyName(const QString& propName);
 
+    /*! \brief Determines the number of pixels and the size in bytes of the
+     *         requested (bRequested=true) or largest possible region of the
+     *         first image input (bInput=true) or output of the internal
+     *         itk::ProcessObject; returns false, if there's no such image
+     */
+    bool getImageRegionSize(bool bInput, bool bRequested,
+                            qint64& numPixels, qint64& numBytes);
+
 
 public slots:
     void removeInputComponent(const QString& input);
@@ -312,6 +338,12 @@ protected:
 
     QStringList mRuntimeParaProv;
 
+    // output cache
+    void updateOutputCacheKey(void);
+    QString mOutputCacheKey;
+    QStringList mInputCacheKeys;
+    QStringList mOutputCacheFiles;
+
 //    QStringList mInputNames;
     QStringList mOutputNames;
 
@@ -356,6 +388,10 @@ private:
     unsigned int mStepIndex;
     bool mbReleaseData;
 
+    // profiling of stream divisions
+    qint64 mProfDivStart;
+    int mProfDivCount;
+
 };
 
 Q_DECLARE_METATYPE(QList<QStringList>)
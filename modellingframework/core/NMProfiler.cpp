@@ -0,0 +1,219 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2017 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "NMProfiler.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+#include "otbImageIOBase.h"
+
+NMProfiler::NMProfiler()
+    : mRank(0), mNumProcs(1)
+{
+    mTimer.start();
+}
+
+void
+NMProfiler::start(int rank, int numProcs)
+{
+    QMutexLocker lock(&mMutex);
+    mRank = rank;
+    mNumProcs = numProcs;
+    mEvents.clear();
+    mTimer.restart();
+}
+
+qint64
+NMProfiler::now(void) const
+{
+    return mTimer.nsecsElapsed() / 1000;
+}
+
+void
+NMProfiler::addEvent(const QString &name, const QString &category,
+                     qint64 start, qint64 duration, const QVariantMap &args)
+{
+    ProfileEvent pe;
+    pe.name = name;
+    pe.cat = category;
+    pe.ts = start;
+    pe.dur = duration;
+    pe.args = args;
+
+    QMutexLocker lock(&mMutex);
+    mEvents.push_back(pe);
+}
+
+bool
+NMProfiler::write(void)
+{
+    if (mFileName.isEmpty())
+    {
+        return false;
+    }
+
+    QString fileName = mFileName;
+    if (mNumProcs > 1)
+    {
+        QFileInfo fifo(mFileName);
+        fileName = QString("%1/%2_r%3.%4")
+                .arg(fifo.absolutePath())
+                .arg(fifo.completeBaseName())
+                .arg(mRank)
+                .arg(fifo.suffix().isEmpty() ? QStringLiteral("json") : fifo.suffix());
+    }
+
+    QJsonArray traceEvents;
+    {
+        QMutexLocker lock(&mMutex);
+        foreach(const ProfileEvent& pe, mEvents)
+        {
+            QJsonObject evt;
+            evt.insert(QStringLiteral("name"), pe.name);
+            evt.insert(QStringLiteral("cat"), pe.cat);
+            evt.insert(QStringLiteral("ph"), QStringLiteral("X"));
+            evt.insert(QStringLiteral("ts"), (double)pe.ts);
+            evt.insert(QStringLiteral("dur"), (double)pe.dur);
+            evt.insert(QStringLiteral("pid"), mRank);
+            evt.insert(QStringLiteral("tid"), 0);
+            if (!pe.args.isEmpty())
+            {
+                evt.insert(QStringLiteral("args"), QJsonObject::fromVariantMap(pe.args));
+            }
+            traceEvents.append(evt);
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert(QStringLiteral("traceEvents"), traceEvents);
+    trace.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ms"));
+
+    QFile profFile(fileName);
+    if (!profFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    profFile.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+    profFile.close();
+
+    return true;
+}
+
+qint64
+NMProfiler::getPeakRSS(void)
+{
+#ifndef _WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+    #ifdef __APPLE__
+        // bytes on macOS
+        return usage.ru_maxrss / 1024;
+    #else
+        return usage.ru_maxrss;
+    #endif
+    }
+#endif
+    return 0;
+}
+
+int
+NMProfiler::getComponentSize(int ioComponentType)
+{
+    switch((otb::ImageIOBase::IOComponentType)ioComponentType)
+    {
+    case otb::ImageIOBase::UCHAR:     return sizeof(unsigned char);
+    case otb::ImageIOBase::CHAR:      return sizeof(char);
+    case otb::ImageIOBase::USHORT:    return sizeof(unsigned short);
+    case otb::ImageIOBase::SHORT:     return sizeof(short);
+    case otb::ImageIOBase::UINT:      return sizeof(unsigned int);
+    case otb::ImageIOBase::INT:       return sizeof(int);
+    case otb::ImageIOBase::ULONG:     return sizeof(unsigned long);
+    case otb::ImageIOBase::LONG:      return sizeof(long);
+    case otb::ImageIOBase::ULONGLONG: return sizeof(unsigned long long);
+    case otb::ImageIOBase::LONGLONG:  return sizeof(long long);
+    case otb::ImageIOBase::FLOAT:     return sizeof(float);
+    case otb::ImageIOBase::DOUBLE:    return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+// ------------------------------------------------------------ NMProfileScope
+
+NMProfileScope::NMProfileScope(NMProfiler *profiler, const QString &name,
+                               const QString &category)
+    : mProfiler(nullptr), mStart(0), mPeakRSS(0)
+{
+    if (profiler != nullptr && profiler->isProfilingOn())
+    {
+        mProfiler = profiler;
+        mName = name;
+        mCategory = category;
+        mPeakRSS = NMProfiler::getPeakRSS();
+        mStart = mProfiler->now();
+    }
+}
+
+NMProfileScope::~NMProfileScope()
+{
+    if (mProfiler == nullptr)
+    {
+        return;
+    }
+
+    const qint64 dur = mProfiler->now() - mStart;
+    mArgs.insert(QStringLiteral("peakRSSDeltaKiB"),
+                 NMProfiler::getPeakRSS() - mPeakRSS);
+
+    // pixels/s if the component told us how many it produced
+    QVariantMap::const_iterator pixIt = mArgs.constFind(QStringLiteral("pixels"));
+    if (pixIt != mArgs.cend() && dur > 0)
+    {
+        mArgs.insert(QStringLiteral("pixelsPerSec"),
+                     pixIt.value().toDouble() / (dur / 1e6));
+    }
+
+    mProfiler->addEvent(mName, mCategory, mStart, dur, mArgs);
+}
+
+void
+NMProfileScope::setArg(const QString &key, const QVariant &value)
+{
+    if (mProfiler != nullptr)
+    {
+        mArgs.insert(key, value);
+    }
+}
+
+qint64
+NMProfileScope::elapsed(void) const
+{
+    return mProfiler != nullptr ? mProfiler->now() - mStart : 0;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2017 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef NMPROFILER_H
+#define NMPROFILER_H
+
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include "nmmodframecore_export.h"
+
+/*!
+ * \brief The NMProfiler class records execution profiles of a model run
+ *
+ * The NMModelController owns one profiler, which is switched on by
+ * giving it a file name (s. lumassengine --profile <file>). While the
+ * model is running, model components (NMIterableComponent) record
+ * one event per component and iteration step, and process components
+ * (NMProcess) record one event per stream division of their internal
+ * itk::ProcessObject. At the end of the model run, the events are
+ * written as Chrome trace event file (JSON), which can be inspected
+ * with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Event timestamps and durations are in micro seconds relative to the
+ * start of the model run; the process id of the events is the MPI rank.
+ */
+class NMMODFRAMECORE_EXPORT NMProfiler
+{
+public:
+    NMProfiler();
+
+    void setFileName(const QString& fileName) {mFileName = fileName;}
+    QString getFileName(void) const {return mFileName;}
+    bool isProfilingOn(void) const {return !mFileName.isEmpty();}
+
+    /*! clears any previously recorded events and resets the clock */
+    void start(int rank, int numProcs);
+
+    /*! writes the recorded events into the profile file; if the model
+     *  is run with more than one MPI process, the rank is appended to
+     *  the file's base name, e.g. profile_r1.json
+     */
+    bool write(void);
+
+    /*! micro seconds since start() */
+    qint64 now(void) const;
+
+    /*! records a complete event ('ph':'X') */
+    void addEvent(const QString& name, const QString& category,
+                  qint64 start, qint64 duration,
+                  const QVariantMap& args=QVariantMap());
+
+    /*! peak resident set size of this process in KiB (0 if not supported) */
+    static qint64 getPeakRSS(void);
+
+    /*! byte size of the given itk/otb::ImageIOBase::IOComponentType */
+    static int getComponentSize(int ioComponentType);
+
+protected:
+    typedef struct
+    {
+        QString name;
+        QString cat;
+        qint64 ts;
+        qint64 dur;
+        QVariantMap args;
+    } ProfileEvent;
+
+    QString mFileName;
+    QElapsedTimer mTimer;
+    QMutex mMutex;
+    QVector<ProfileEvent> mEvents;
+
+    int mRank;
+    int mNumProcs;
+};
+
+/*!
+ * \brief Records a single profile event spanning the life time of the scope object
+ *
+ * Does nothing, if the profiler is nullptr or profiling is switched off.
+ */
+class NMMODFRAMECORE_EXPORT NMProfileScope
+{
+public:
+    NMProfileScope(NMProfiler* profiler, const QString& name,
+                   const QString& category);
+    ~NMProfileScope();
+
+    bool isActive(void) const {return mProfiler != nullptr;}
+    void setArg(const QString& key, const QVariant& value);
+
+    /*! micro seconds since the scope was entered */
+    qint64 elapsed(void) const;
+
+private:
+    NMProfiler* mProfiler;
+    QString mName;
+    QString mCategory;
+    qint64 mStart;
+    qint64 mPeakRSS;
+    QVariantMap mArgs;
+};
+
+#endif // NMPROFILER_H
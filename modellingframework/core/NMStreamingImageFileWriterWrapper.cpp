@@ -635,17 +635,17 @@ public:
     if (this->mOutputNumDimensions == 1) \
     { \
         wrapName< imgType, imgType, 1 >::setStreamingSize( \
-                this->mOtbProcess, this->mOutputNumBands, mStreamingSize, mRGBMode); \
+                this->mOtbProcess, this->mOutputNumBands, streamingSize, mRGBMode); \
     } \
     else if (this->mOutputNumDimensions == 2) \
     { \
         wrapName< imgType, imgType, 2 >::setStreamingSize( \
-                this->mOtbProcess, this->mOutputNumBands, mStreamingSize, mRGBMode); \
+                this->mOtbProcess, this->mOutputNumBands, streamingSize, mRGBMode); \
     } \
     else if (this->mOutputNumDimensions == 3) \
     { \
         wrapName< imgType, imgType, 3 >::setStreamingSize( \
-                this->mOtbProcess, this->mOutputNumBands, mStreamingSize, mRGBMode); \
+                this->mOtbProcess, this->mOutputNumBands, streamingSize, mRGBMode); \
     }\
 }
 
@@ -740,7 +740,7 @@ NMStreamingImageFileWriterWrapper
 
     this->mStreamingMethodType = QString(tr("STRIPPED"));
     this->mStreamingMethodEnum.clear();
-    this->mStreamingMethodEnum << "STRIPPED" << "TILED" << "NO_STREAMING";
+    this->mStreamingMethodEnum << "STRIPPED" << "TILED" << "NO_STREAMING" << "AUTO";
 
     mbUseForcedLPR = false;
     mbUseUpdateRegion = false;
@@ -801,7 +801,7 @@ NMStreamingImageFileWriterWrapper
 
     this->mStreamingMethodType = QString(tr("STRIPPED"));
     this->mStreamingMethodEnum.clear();
-    this->mStreamingMethodEnum << "STRIPPED" << "TILED" << "NO_STREAMING";
+    this->mStreamingMethodEnum << "STRIPPED" << "TILED" << "NO_STREAMING" << "AUTO";
 
     mbUseForcedLPR = false;
     mbUseUpdateRegion = false;
@@ -938,6 +938,19 @@ NMStreamingImageFileWriterWrapper
     if (!this->mbIsInitialised)
         return;
 
+    // the global memory budget (lumassengine --max-memory) takes
+    // precedence over the component's streaming size for AUTO streaming
+    int streamingSize = mStreamingSize;
+    if (mStreamingMethodType.compare(QStringLiteral("AUTO")) == 0 && mController != nullptr)
+    {
+        bool bOk = false;
+        const int maxMemory = mController->getSetting("MaxMemory").toInt(&bOk);
+        if (bOk && maxMemory > 0)
+        {
+            streamingSize = maxMemory;
+        }
+    }
+
     switch(this->mOutputComponentType)
     {
     MacroPerType( callSetStreamingSize, NMStreamingImageFileWriterWrapper_Internal )
@@ -34,6 +34,8 @@
 
 #include "otbDEMSlopeAspectFilter.h"
 
+#include <QRegularExpression>
+
 /*! Internal templated helper class linking to the core otb/itk filter
  *  by static methods.
  */
@@ -118,6 +120,21 @@ public:
             p->addRunTimeParaProvN(provN);
         }
 
+        QVariant curTerrainAttributeListVar = p->getParameter("TerrainAttributeList");
+        std::vector<std::string> curTerrainAttributeList;
+        if (curTerrainAttributeListVar.isValid())
+        {
+            const QStringList attrList = curTerrainAttributeListVar.toString().split(
+                        QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+            foreach(const QString& attr, attrList)
+            {
+                curTerrainAttributeList.push_back(attr.toStdString());
+            }
+            f->SetTerrainAttributes(curTerrainAttributeList);
+            QString provN = QString("nm:TerrainAttributeList=\"%1\"").arg(attrList.join(' '));
+            p->addRunTimeParaProvN(provN);
+        }
+
         QVariant curTerrainAlgorithmVar = p->getParameter("TerrainAlgorithmType");
         std::string curTerrainAlgorithm;
         if (curTerrainAlgorithmVar.isValid())
@@ -221,7 +238,9 @@ NMDEMSlopeAspectFilterWrapper
     this->mAttributeUnitType = QString(tr("Degree"));
 
     this->mTerrainAttributeEnum.clear();
-    this->mTerrainAttributeEnum << "Slope" << "LS" << "Wetness" << "SedTransport";
+    this->mTerrainAttributeEnum << "Slope" << "LS" << "Wetness" << "SedTransport"
+                                << "Aspect" << "PlanCurvature" << "ProfileCurvature"
+                                << "Hillshade";
     this->mTerrainAttributeType = QString(tr("Slope"));
 
     this->mTerrainAlgorithmEnum.clear();
@@ -236,6 +255,7 @@ NMDEMSlopeAspectFilterWrapper
     mUserProperties.clear();
     mUserProperties.insert(QStringLiteral("NMInputComponentType"), QStringLiteral("PixelType"));
     mUserProperties.insert(QStringLiteral("TerrainAttributeType"), QStringLiteral("Attribute"));
+    mUserProperties.insert(QStringLiteral("TerrainAttributeList"), QStringLiteral("AttributeList"));
     mUserProperties.insert(QStringLiteral("AttributeUnitType"), QStringLiteral("Unit"));
     mUserProperties.insert(QStringLiteral("TerrainAlgorithmType"), QStringLiteral("Algorithm"));
     mUserProperties.insert(QStringLiteral("Nodata"), QStringLiteral("NodataValue"));
@@ -48,6 +48,7 @@ NMDEMSlopeAspectFilterWrapper
 
 
     Q_PROPERTY(QString TerrainAttributeType READ getTerrainAttributeType WRITE setTerrainAttributeType)
+    Q_PROPERTY(QString TerrainAttributeList READ getTerrainAttributeList WRITE setTerrainAttributeList)
     Q_PROPERTY(QString TerrainAlgorithmType READ getTerrainAlgorithmType WRITE setTerrainAlgorithmType)
     Q_PROPERTY(QString AttributeUnitType READ getAttributeUnitType WRITE setAttributeUnitType)
     Q_PROPERTY(QStringList TerrainAttributeEnum READ getTerrainAttributeEnum)
@@ -59,6 +60,7 @@ public:
 
 
     NMPropertyGetSet( TerrainAttributeType, QString )
+    NMPropertyGetSet( TerrainAttributeList, QString )
     NMPropertyGetSet( TerrainAlgorithmType, QString )
     NMPropertyGetSet( AttributeUnitType, QString )
     NMPropertyGetSet( TerrainAttributeEnum, QStringList )
@@ -88,6 +90,9 @@ protected:
             const QMap<QString, NMModelComponent*>& repo);
 
     QString mTerrainAttributeType;
+    // space separated list of attributes computed in one pass,
+    // one output per attribute; supersedes TerrainAttributeType
+    QString mTerrainAttributeList;
     QString mTerrainAlgorithmType;
     QString mAttributeUnitType;
 
@@ -165,6 +165,14 @@ public:
             }
         }
 
+        QVariant curCreateDimIndexVar = p->getParameter("CreateDimIndex");
+        int curCreateDimIndex = 0;
+        if (curCreateDimIndexVar.isValid())
+        {
+            curCreateDimIndex = curCreateDimIndexVar.toInt(&bok);
+            f->SetCreateDimIndex(bok ? curCreateDimIndex : 0);
+        }
+
         QVariant curNcImageContainerVar = p->getParameter("NcImageContainer");
         std::string curNcImageContainer;
         if (curNcImageContainerVar.isValid())
@@ -286,6 +294,7 @@ NMImage2TableFilterWrapper
     mUserProperties.insert(QStringLiteral("TableName"), QStringLiteral("TableName"));
     mUserProperties.insert(QStringLiteral("ImageVarName"), QStringLiteral("ImageVarName"));
     mUserProperties.insert(QStringLiteral("UpdateMode"), QStringLiteral("UpdateMode"));
+    mUserProperties.insert(QStringLiteral("CreateDimIndex"), QStringLiteral("CreateDimIndex"));
     mUserProperties.insert(QStringLiteral("NcImageContainer"), QStringLiteral("NcImageContainer"));
     mUserProperties.insert(QStringLiteral("NcGroupName"), QStringLiteral("NcGroupName"));
     mUserProperties.insert(QStringLiteral("StartIndex"), QStringLiteral("StartIndex"));
@@ -52,6 +52,7 @@ NMImage2TableFilterWrapper
     Q_PROPERTY(QStringList TableName READ getTableName WRITE setTableName)
     Q_PROPERTY(QStringList ImageVarName READ getImageVarName WRITE setImageVarName)
     Q_PROPERTY(QStringList UpdateMode READ getUpdateMode WRITE setUpdateMode)
+    Q_PROPERTY(QStringList CreateDimIndex READ getCreateDimIndex WRITE setCreateDimIndex)
     Q_PROPERTY(QStringList NcImageContainer READ getNcImageContainer WRITE setNcImageContainer)
     Q_PROPERTY(QStringList NcGroupName READ getNcGroupName WRITE setNcGroupName)
     Q_PROPERTY(QList<QStringList> StartIndex READ getStartIndex WRITE setStartIndex)
@@ -66,6 +67,7 @@ public:
     NMPropertyGetSet( TableName, QStringList )
     NMPropertyGetSet( ImageVarName, QStringList )
     NMPropertyGetSet( UpdateMode, QStringList )
+    NMPropertyGetSet( CreateDimIndex, QStringList )
     NMPropertyGetSet( NcImageContainer, QStringList )
     NMPropertyGetSet( NcGroupName, QStringList )
     NMPropertyGetSet( StartIndex, QList<QStringList> )
@@ -102,6 +104,7 @@ protected:
     QStringList mTableName;
     QStringList mImageVarName;
     QStringList mUpdateMode;
+    QStringList mCreateDimIndex;
     QStringList mNcImageContainer;
     QStringList mNcGroupName;
     QList<QStringList> mStartIndex;
@@ -24,11 +24,211 @@
 
 #include "NMLUAllocationWrapper.h"
 
-NMLUAllocationWrapper::NMLUAllocationWrapper()
+#include "itkProcessObject.h"
+#include "otbImage.h"
+
+#include "nmlog.h"
+#include "NMMacros.h"
+#include "NMMfwException.h"
+
+#include "otbLUAllocationFilter.h"
+
+#include <QRegularExpression>
+
+/*! Internal templated helper class linking to the core otb/itk filter
+ *  by static methods.
+ */
+template<class TInputImage, unsigned int Dimension>
+class NMLUAllocationWrapper_Internal
 {
-}
+public:
+    typedef otb::Image<TInputImage, Dimension>  InImgType;
+    typedef otb::Image<TInputImage, Dimension>  OutImgType;
+    typedef typename otb::LUAllocationFilter<InImgType, OutImgType>  FilterType;
+    typedef typename FilterType::Pointer        FilterTypePointer;
+
+    typedef typename InImgType::PixelType  InImgPixelType;
+    typedef typename OutImgType::PixelType OutImgPixelType;
+
+    static void createInstance(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands)
+    {
+        FilterTypePointer f = FilterType::New();
+        otbFilter = f;
+    }
+
+    static void setNthInput(itk::ProcessObject::Pointer& otbFilter,
+                    unsigned int numBands, unsigned int idx, itk::DataObject* dataObj, const QString& name)
+    {
+        InImgType* img = dynamic_cast<InImgType*>(dataObj);
+        FilterType* filter = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        filter->SetInput(idx, img);
+    }
+
+
+    static itk::DataObject* getOutput(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands, unsigned int idx)
+    {
+        FilterType* filter = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        return dynamic_cast<OutImgType*>(filter->GetOutput(idx));
+    }
+
+    static void throwInvalidParameter(NMLUAllocationWrapper* p, const QString& name)
+    {
+        const QString msg = QString("Invalid value for '%1'!").arg(name);
+        NMLogError(<< "NMLUAllocationWrapper_Internal: " << msg.toStdString());
+        NMMfwException e(NMMfwException::NMProcess_InvalidParameter);
+        e.setSource(p->parent()->objectName().toStdString());
+        e.setDescription(msg.toStdString());
+        throw e;
+    }
+
+    /*! splits a per-step list parameter into numbers */
+    static std::vector<double> getNumberList(NMLUAllocationWrapper* p, const QString& name)
+    {
+        std::vector<double> vals;
+        QVariant listVar = p->getParameter(name);
+        if (listVar.isValid())
+        {
+            const QStringList strList = listVar.toString().split(
+                        QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+            foreach(const QString& str, strList)
+            {
+                bool bok;
+                const double val = str.toDouble(&bok);
+                if (!bok)
+                {
+                    throwInvalidParameter(p, name);
+                }
+                vals.push_back(val);
+            }
+
+            QString provN = QString("nm:%1=\"%2\"").arg(name).arg(strList.join(' '));
+            p->addRunTimeParaProvN(provN);
+        }
+        return vals;
+    }
+
+    static void internalLinkParameters(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands, NMProcess* proc,
+            unsigned int step, const QMap<QString, NMModelComponent*>& repo)
+    {
+        NMDebugCtx("NMLUAllocationWrapper_Internal", << "...");
 
-NMLUAllocationWrapper::~NMLUAllocationWrapper()
+        FilterType* f = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        NMLUAllocationWrapper* p =
+                dynamic_cast<NMLUAllocationWrapper*>(proc);
+
+        // make sure we've got a valid filter object
+        if (f == 0)
+        {
+            NMMfwException e(NMMfwException::NMProcess_UninitialisedProcessObject);
+            e.setSource(p->parent()->objectName().toStdString());
+            e.setDescription("We're trying to link, but the filter doesn't seem to be initialised properly!");
+            throw e;
+            return;
+        }
+
+        bool bok;
+
+        f->SetDemands(getNumberList(p, QStringLiteral("Demands")));
+
+        std::vector<OutImgPixelType> codes;
+        const std::vector<double> codeList = getNumberList(p, QStringLiteral("LandUseCodes"));
+        for (int c=0; c < codeList.size(); ++c)
+        {
+            codes.push_back(static_cast<OutImgPixelType>(codeList[c]));
+        }
+        f->SetLandUseCodes(codes);
+
+        QVariant curResidualCodeVar = p->getParameter("ResidualCode");
+        if (curResidualCodeVar.isValid())
+        {
+            const double curResidualCode = curResidualCodeVar.toDouble(&bok);
+            if (!bok)
+            {
+                throwInvalidParameter(p, QStringLiteral("ResidualCode"));
+            }
+            f->SetResidualCode(static_cast<OutImgPixelType>(curResidualCode));
+            QString provN = QString("nm:ResidualCode=\"%1\"").arg(curResidualCode);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        QVariant curNodataVar = p->getParameter("Nodata");
+        if (curNodataVar.isValid())
+        {
+            const double curNodata = curNodataVar.toDouble(&bok);
+            if (!bok)
+            {
+                throwInvalidParameter(p, QStringLiteral("Nodata"));
+            }
+            f->SetNodata(static_cast<InImgPixelType>(curNodata));
+            QString provN = QString("nm:Nodata=\"%1\"").arg(curNodata);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        QVariant curToleranceVar = p->getParameter("Tolerance");
+        if (curToleranceVar.isValid())
+        {
+            const double curTolerance = curToleranceVar.toDouble(&bok);
+            if (!bok || curTolerance < 0)
+            {
+                throwInvalidParameter(p, QStringLiteral("Tolerance"));
+            }
+            f->SetTolerance(curTolerance);
+            QString provN = QString("nm:Tolerance=\"%1\"").arg(curTolerance);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        QVariant curMaxIterationsVar = p->getParameter("MaxIterations");
+        if (curMaxIterationsVar.isValid())
+        {
+            const int curMaxIterations = curMaxIterationsVar.toInt(&bok);
+            if (!bok || curMaxIterations < 1)
+            {
+                throwInvalidParameter(p, QStringLiteral("MaxIterations"));
+            }
+            f->SetMaxIterations(curMaxIterations);
+            QString provN = QString("nm:MaxIterations=\"%1\"").arg(curMaxIterations);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        NMDebugCtx("NMLUAllocationWrapper_Internal", << "done!");
+    }
+};
+
+InstantiateInputTypeObjectWrap( NMLUAllocationWrapper, NMLUAllocationWrapper_Internal )
+SetInputTypeNthInputWrap( NMLUAllocationWrapper, NMLUAllocationWrapper_Internal )
+GetInputTypeOutputWrap( NMLUAllocationWrapper, NMLUAllocationWrapper_Internal )
+LinkInputTypeInternalParametersWrap( NMLUAllocationWrapper, NMLUAllocationWrapper_Internal )
+
+NMLUAllocationWrapper
+::NMLUAllocationWrapper(QObject* parent)
 {
+    this->setParent(parent);
+    this->setObjectName("NMLUAllocationWrapper");
+    this->mParameterHandling = NMProcess::NM_USE_UP;
+    this->mInputNumBands = 1;
+    this->mOutputNumBands = 1;
+    this->mInputNumDimensions = 2;
+    this->mOutputNumDimensions = 2;
+    this->mInputComponentType = otb::ImageIOBase::FLOAT;
+
+    mResidualCode << "0";
+    mTolerance << "0.001";
+    mMaxIterations << "50";
+
+    mUserProperties.clear();
+    mUserProperties.insert(QStringLiteral("NMInputComponentType"), QStringLiteral("PixelType"));
+    mUserProperties.insert(QStringLiteral("Demands"), QStringLiteral("Demands"));
+    mUserProperties.insert(QStringLiteral("LandUseCodes"), QStringLiteral("LandUseCodes"));
+    mUserProperties.insert(QStringLiteral("ResidualCode"), QStringLiteral("ResidualCode"));
+    mUserProperties.insert(QStringLiteral("Nodata"), QStringLiteral("Nodata"));
+    mUserProperties.insert(QStringLiteral("Tolerance"), QStringLiteral("Tolerance"));
+    mUserProperties.insert(QStringLiteral("MaxIterations"), QStringLiteral("MaxIterations"));
 }
 
+NMLUAllocationWrapper
+::~NMLUAllocationWrapper()
+{
+}
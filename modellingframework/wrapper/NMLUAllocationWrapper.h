@@ -24,14 +24,73 @@
 #ifndef NMLUALLOCATIONWRAPPER_H_
 #define NMLUALLOCATIONWRAPPER_H_
 
+#include <string>
+#include <iostream>
+#include <QStringList>
+#include <QList>
+
+#include "nmlog.h"
+#include "NMMacros.h"
 #include "NMProcess.h"
+#include "NMItkDataObjectWrapper.h"
+
 #include "nmluallocationwrapper_export.h"
 
-class NMLUALLOCATIONWRAPPER_EXPORT NMLUAllocationWrapper: public NMProcess
+template<class TInputImage, unsigned int Dimension=2>
+class NMLUAllocationWrapper_Internal;
+
+/*! \brief Demand-driven land-use allocation (s. otb::LUAllocationFilter)
+ *
+ *  Inputs are one potential layer per land use; Demands and LandUseCodes
+ *  are given per iteration step as lists (separated by white space, ','
+ *  or ';') in the order of the inputs. Demands are areas in squared map
+ *  units, a negative demand leaves the respective land use unconstrained.
+ */
+class NMLUALLOCATIONWRAPPER_EXPORT NMLUAllocationWrapper
+        : public NMProcess
 {
+    Q_OBJECT
+
+    Q_PROPERTY(QStringList Demands READ getDemands WRITE setDemands)
+    Q_PROPERTY(QStringList LandUseCodes READ getLandUseCodes WRITE setLandUseCodes)
+    Q_PROPERTY(QStringList ResidualCode READ getResidualCode WRITE setResidualCode)
+    Q_PROPERTY(QStringList Nodata READ getNodata WRITE setNodata)
+    Q_PROPERTY(QStringList Tolerance READ getTolerance WRITE setTolerance)
+    Q_PROPERTY(QStringList MaxIterations READ getMaxIterations WRITE setMaxIterations)
+
+public:
+
+    NMPropertyGetSet( Demands,       QStringList )
+    NMPropertyGetSet( LandUseCodes,  QStringList )
+    NMPropertyGetSet( ResidualCode,  QStringList )
+    NMPropertyGetSet( Nodata,        QStringList )
+    NMPropertyGetSet( Tolerance,     QStringList )
+    NMPropertyGetSet( MaxIterations, QStringList )
+
 public:
-	NMLUAllocationWrapper();
-	virtual ~NMLUAllocationWrapper();
+    NMLUAllocationWrapper(QObject* parent=0);
+    virtual ~NMLUAllocationWrapper();
+
+    template<class TInputImage, unsigned int Dimension>
+    friend class NMLUAllocationWrapper_Internal;
+
+    QSharedPointer<NMItkDataObjectWrapper> getOutput(unsigned int idx);
+    void instantiateObject(void);
+
+    void setNthInput(unsigned int numInput,
+              QSharedPointer<NMItkDataObjectWrapper> imgWrapper, const QString& name);
+
+protected:
+
+    QStringList mDemands;
+    QStringList mLandUseCodes;
+    QStringList mResidualCode;
+    QStringList mNodata;
+    QStringList mTolerance;
+    QStringList mMaxIterations;
+
+    void linkParameters(unsigned int step,
+            const QMap<QString, NMModelComponent*>& repo);
 };
 
 #endif /* NMLUALLOCATIONWRAPPER_H_ */
@@ -0,0 +1,45 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * NMLUAllocationWrapperFactory.h
+ *
+ *  Created on: 2024-05-06
+ *      Author: Alex Herzig
+ */
+
+#ifndef NMLUAllocationWrapperFactory_H_
+#define NMLUAllocationWrapperFactory_H_
+
+#include <QObject>
+#include "NMWrapperFactory.h"
+
+#include "nmluallocationwrapper_export.h"
+
+class NMLUALLOCATIONWRAPPER_EXPORT NMLUAllocationWrapperFactory : public NMWrapperFactory
+{
+    Q_OBJECT
+public:
+    NMLUAllocationWrapperFactory(QObject *parent = nullptr);
+
+    NMProcess* createWrapper();
+    bool isSinkProcess(void) {return false;}
+    QString getWrapperClassName() {return "NMLUAllocationWrapper";}
+    QString getComponentAlias() {return QStringLiteral("LUAllocation");}
+};
+
+#endif // NMLUAllocationWrapperFactory_H
@@ -0,0 +1,356 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ *  NMReclassImageFilterWrapper.cpp
+ *
+ *  Created on: 2024-06-24
+ *      Author: Alexander Herzig
+ */
+
+#include "NMReclassImageFilterWrapper.h"
+
+#include "itkProcessObject.h"
+#include "otbImage.h"
+
+#include "nmlog.h"
+#include "NMMacros.h"
+#include "NMMfwException.h"
+
+#include "otbReclassImageFilter.h"
+#include "otbSQLiteTable.h"
+
+#include <limits>
+#include <QRegularExpression>
+
+/*! Internal templated helper class linking to the core otb/itk filter
+ *  by static methods.
+ */
+template<class TInputImage, class TOutputImage, unsigned int Dimension>
+class NMReclassImageFilterWrapper_Internal
+{
+public:
+    typedef otb::Image<TInputImage, Dimension>  InImgType;
+    typedef otb::Image<TOutputImage, Dimension> OutImgType;
+    typedef typename otb::ReclassImageFilter<InImgType, OutImgType>  FilterType;
+    typedef typename FilterType::Pointer        FilterTypePointer;
+
+    static void createInstance(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands)
+    {
+        FilterTypePointer f = FilterType::New();
+        otbFilter = f;
+    }
+
+    static void setNthInput(itk::ProcessObject::Pointer& otbFilter,
+                    unsigned int numBands, unsigned int idx, itk::DataObject* dataObj, const QString& name)
+    {
+        FilterType* filter = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        InImgType* img = dynamic_cast<InImgType*>(dataObj);
+        filter->SetInput(img);
+    }
+
+    /*! a table input provides the rules */
+    static void setRAT(itk::ProcessObject::Pointer& procObj,
+        unsigned int numBands, unsigned int idx,
+        otb::AttributeTable::Pointer& rat)
+    {
+        FilterType* filter = dynamic_cast<FilterType*>(procObj.GetPointer());
+        filter->SetRuleTable(rat.GetPointer());
+    }
+
+
+    static itk::DataObject* getOutput(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands, unsigned int idx)
+    {
+        FilterType* filter = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        return dynamic_cast<OutImgType*>(filter->GetOutput(idx));
+    }
+
+    static void throwInvalidParameter(NMReclassImageFilterWrapper* p, const QString& name,
+                                      const QString& detail=QString())
+    {
+        QString msg = QString("Invalid value for '%1'").arg(name);
+        msg += detail.isEmpty() ? QStringLiteral("!") : QString(": %1").arg(detail);
+        NMLogError(<< "NMReclassImageFilterWrapper_Internal: " << msg.toStdString());
+        NMMfwException e(NMMfwException::NMProcess_InvalidParameter);
+        e.setSource(p->parent()->objectName().toStdString());
+        e.setDescription(msg.toStdString());
+        throw e;
+    }
+
+    /*! splits a per-step list parameter into its items */
+    static QStringList getList(NMReclassImageFilterWrapper* p, const QString& name)
+    {
+        QStringList strList;
+        QVariant listVar = p->getParameter(name);
+        if (listVar.isValid())
+        {
+            strList = listVar.toString().split(
+                        QRegularExpression("[\\s,;]+"), Qt::SkipEmptyParts);
+            if (!strList.isEmpty())
+            {
+                QString provN = QString("nm:%1=\"%2\"").arg(name).arg(strList.join(' '));
+                p->addRunTimeParaProvN(provN);
+            }
+        }
+        return strList;
+    }
+
+    /*! parses a rule bound; an empty bound is open */
+    static double parseBound(NMReclassImageFilterWrapper* p, const QString& str,
+                             double open, const QString& rule)
+    {
+        const QString s = str.trimmed();
+        if (s.isEmpty())
+        {
+            return open;
+        }
+
+        bool bok;
+        const double val = s.toDouble(&bok);
+        if (!bok)
+        {
+            throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+        }
+        return val;
+    }
+
+    /*! parses inline rules, e.g. "1 = 10, 0.5;  2:5 = 20, 0.7" */
+    static void setInlineRules(FilterType* f, NMReclassImageFilterWrapper* p)
+    {
+        QVariant rulesVar = p->getParameter("Rules");
+        if (!rulesVar.isValid())
+        {
+            return;
+        }
+
+        const double inf = std::numeric_limits<double>::infinity();
+        const QStringList rules = rulesVar.toString().split(
+                    QRegularExpression("[;\\n]+"), Qt::SkipEmptyParts);
+        QStringList provRules;
+        foreach(const QString& rule, rules)
+        {
+            if (rule.trimmed().isEmpty())
+            {
+                continue;
+            }
+
+            const QStringList keyVals = rule.split('=');
+            if (keyVals.size() != 2)
+            {
+                throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+            }
+
+            double lower, upper;
+            const QStringList bounds = keyVals.at(0).split(':');
+            if (bounds.size() == 1)
+            {
+                lower = upper = parseBound(p, bounds.at(0), inf, rule);
+                if (lower == inf)
+                {
+                    throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+                }
+            }
+            else if (bounds.size() == 2)
+            {
+                lower = parseBound(p, bounds.at(0), -inf, rule);
+                upper = parseBound(p, bounds.at(1), inf, rule);
+            }
+            else
+            {
+                throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+            }
+
+            std::vector<double> values;
+            const QStringList valList = keyVals.at(1).split(
+                        QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts);
+            foreach(const QString& v, valList)
+            {
+                bool bok;
+                values.push_back(v.toDouble(&bok));
+                if (!bok)
+                {
+                    throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+                }
+            }
+            if (values.empty())
+            {
+                throwInvalidParameter(p, QStringLiteral("Rules"), rule);
+            }
+
+            f->AddRule(lower, upper, values);
+            provRules << rule.simplified();
+        }
+
+        if (!provRules.isEmpty())
+        {
+            QString provN = QString("nm:Rules=\"%1\"").arg(provRules.join("; "));
+            p->addRunTimeParaProvN(provN);
+        }
+    }
+
+    static void internalLinkParameters(itk::ProcessObject::Pointer& otbFilter,
+            unsigned int numBands, NMProcess* proc,
+            unsigned int step, const QMap<QString, NMModelComponent*>& repo)
+    {
+        NMDebugCtx("NMReclassImageFilterWrapper_Internal", << "...");
+
+        FilterType* f = dynamic_cast<FilterType*>(otbFilter.GetPointer());
+        NMReclassImageFilterWrapper* p =
+                dynamic_cast<NMReclassImageFilterWrapper*>(proc);
+
+        // make sure we've got a valid filter object
+        if (f == 0)
+        {
+            NMMfwException e(NMMfwException::NMProcess_UninitialisedProcessObject);
+            e.setSource(p->parent()->objectName().toStdString());
+            e.setDescription("We're trying to link, but the filter doesn't seem to be initialised properly!");
+            throw e;
+            return;
+        }
+
+        QString inputTypeStr = QString("nm:InputComponentType=\"%1\"")
+                .arg(NMItkDataObjectWrapper::getComponentTypeString(p->getInputNMComponentType()));
+        p->addRunTimeParaProvN(inputTypeStr);
+
+        QString outputTypeStr = QString("nm:OutputComponentType=\"%1\"")
+                .arg(NMItkDataObjectWrapper::getComponentTypeString(p->getOutputNMComponentType()));
+        p->addRunTimeParaProvN(outputTypeStr);
+
+        // ----------------------------------------------
+        // inline rules
+        f->ClearRules();
+        setInlineRules(f, p);
+
+        // ----------------------------------------------
+        // rule table
+        QVariant fnVar = p->getParameter("RuleTableFileName");
+        const QString ruleTableFileName = fnVar.isValid() ? fnVar.toString().trimmed() : QString();
+        if (!ruleTableFileName.isEmpty())
+        {
+            otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+            tab->SetUseSharedCache(false);
+            if (!tab->CreateFromVirtual(ruleTableFileName.toStdString(), "UTF-8", -1, true))
+            {
+                throwInvalidParameter(p, QStringLiteral("RuleTableFileName"),
+                                      QString("Failed reading '%1': %2")
+                                      .arg(ruleTableFileName)
+                                      .arg(tab->getLastLogMsg().c_str()));
+            }
+            f->SetRuleTable(tab);
+
+            QString provN = QString("nm:RuleTableFileName=\"%1\"").arg(ruleTableFileName);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        QVariant lowerVar = p->getParameter("LowerColumn");
+        if (lowerVar.isValid())
+        {
+            const QString lowerColumn = lowerVar.toString().trimmed();
+            f->SetLowerColumn(lowerColumn.toStdString());
+            QString provN = QString("nm:LowerColumn=\"%1\"").arg(lowerColumn);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        QVariant upperVar = p->getParameter("UpperColumn");
+        if (upperVar.isValid())
+        {
+            const QString upperColumn = upperVar.toString().trimmed();
+            f->SetUpperColumn(upperColumn.toStdString());
+            QString provN = QString("nm:UpperColumn=\"%1\"").arg(upperColumn);
+            p->addRunTimeParaProvN(provN);
+        }
+
+        // the number of bands is given by the value columns
+        // or otherwise by the values of the inline rules
+        std::vector<std::string> valueColumns;
+        foreach(const QString& col, getList(p, QStringLiteral("ValueColumns")))
+        {
+            valueColumns.push_back(col.toStdString());
+        }
+
+        if (f->GetRuleTable() != nullptr && valueColumns.empty())
+        {
+            throwInvalidParameter(p, QStringLiteral("ValueColumns"),
+                                  QStringLiteral("Please specify the output value column(s) of the rule table"));
+        }
+
+        if (!valueColumns.empty())
+        {
+            f->SetValueColumns(valueColumns);
+        }
+        else if (!f->GetRules().empty())
+        {
+            f->SetNumberOfBands(f->GetRules().at(0).Values.size());
+        }
+        else
+        {
+            throwInvalidParameter(p, QStringLiteral("Rules"),
+                                  QStringLiteral("Please specify reclass rules or a rule table"));
+        }
+
+        std::vector<double> defaults;
+        foreach(const QString& dv, getList(p, QStringLiteral("DefaultValues")))
+        {
+            bool bok;
+            defaults.push_back(dv.toDouble(&bok));
+            if (!bok)
+            {
+                throwInvalidParameter(p, QStringLiteral("DefaultValues"));
+            }
+        }
+        f->SetDefaultValues(defaults);
+
+        NMDebugCtx("NMReclassImageFilterWrapper_Internal", << "done!");
+    }
+};
+
+InstantiateObjectWrap( NMReclassImageFilterWrapper, NMReclassImageFilterWrapper_Internal )
+SetNthInputWrap( NMReclassImageFilterWrapper, NMReclassImageFilterWrapper_Internal )
+GetOutputWrap( NMReclassImageFilterWrapper, NMReclassImageFilterWrapper_Internal )
+LinkInternalParametersWrap( NMReclassImageFilterWrapper, NMReclassImageFilterWrapper_Internal )
+SetRATWrap( NMReclassImageFilterWrapper, NMReclassImageFilterWrapper_Internal )
+
+NMReclassImageFilterWrapper
+::NMReclassImageFilterWrapper(QObject* parent)
+{
+    this->setParent(parent);
+    this->setObjectName("NMReclassImageFilterWrapper");
+    this->mParameterHandling = NMProcess::NM_USE_UP;
+    this->mInputNumBands = 1;
+    this->mOutputNumBands = 1;
+    this->mInputNumDimensions = 2;
+    this->mOutputNumDimensions = 2;
+    this->mInputComponentType = otb::ImageIOBase::INT;
+    this->mOutputComponentType = otb::ImageIOBase::FLOAT;
+
+    mUserProperties.clear();
+    mUserProperties.insert(QStringLiteral("NMInputComponentType"), QStringLiteral("InputPixelType"));
+    mUserProperties.insert(QStringLiteral("NMOutputComponentType"), QStringLiteral("OutputPixelType"));
+    mUserProperties.insert(QStringLiteral("Rules"), QStringLiteral("Rules"));
+    mUserProperties.insert(QStringLiteral("RuleTableFileName"), QStringLiteral("RuleTableFileName"));
+    mUserProperties.insert(QStringLiteral("LowerColumn"), QStringLiteral("LowerColumn"));
+    mUserProperties.insert(QStringLiteral("UpperColumn"), QStringLiteral("UpperColumn"));
+    mUserProperties.insert(QStringLiteral("ValueColumns"), QStringLiteral("ValueColumns"));
+    mUserProperties.insert(QStringLiteral("DefaultValues"), QStringLiteral("DefaultValues"));
+}
+
+NMReclassImageFilterWrapper
+::~NMReclassImageFilterWrapper()
+{
+}
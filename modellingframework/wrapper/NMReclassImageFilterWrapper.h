@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * NMReclassImageFilterWrapper.h
+ *
+ *  Created on: 2024-06-24
+ *      Author: Alexander Herzig
+ */
+
+#ifndef NMReclassImageFilterWrapper_H_
+#define NMReclassImageFilterWrapper_H_
+
+#include <string>
+#include <iostream>
+#include <QStringList>
+#include <QList>
+
+#include "nmlog.h"
+#include "NMMacros.h"
+#include "NMProcess.h"
+#include "NMItkDataObjectWrapper.h"
+
+#include "nmreclassimagefilterwrapper_export.h"
+
+template<class TInputImage, class TOutputImage, unsigned int Dimension=2>
+class NMReclassImageFilterWrapper_Internal;
+
+/*! \brief Lookup-table reclassification (s. otb::ReclassImageFilter)
+ *
+ *  Rules are given per iteration step, either inline or by a rule
+ *  table, i.e. an input table (e.g. from a table reader) or a table
+ *  file (*.csv, *.txt, *.dbf, *.xls) given by RuleTableFileName.
+ *
+ *  Inline rules are separated by ';' or line breaks, each rule
+ *  mapping an exact value or a half-open range [lower, upper) to
+ *  one output value per band, e.g.
+ *
+ *      1 = 10, 0.5;  2:5 = 20, 0.7;  5: = 30, 0.9;  :0 = -1, 0
+ *
+ *  where an omitted bound is open. With a rule table, LowerColumn
+ *  denotes the (exact) values or lower bounds, UpperColumn the
+ *  (optional) upper bounds and ValueColumns the output values, one
+ *  column per band. Each band is written to a separate output.
+ *  Unmatched pixels are set to the DefaultValues (one per band or
+ *  one for all), or keep their value if none are given.
+ */
+class NMRECLASSIMAGEFILTERWRAPPER_EXPORT NMReclassImageFilterWrapper
+        : public NMProcess
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QStringList Rules READ getRules WRITE setRules)
+    Q_PROPERTY(QStringList RuleTableFileName READ getRuleTableFileName WRITE setRuleTableFileName)
+    Q_PROPERTY(QStringList LowerColumn READ getLowerColumn WRITE setLowerColumn)
+    Q_PROPERTY(QStringList UpperColumn READ getUpperColumn WRITE setUpperColumn)
+    Q_PROPERTY(QStringList ValueColumns READ getValueColumns WRITE setValueColumns)
+    Q_PROPERTY(QStringList DefaultValues READ getDefaultValues WRITE setDefaultValues)
+
+public:
+
+    NMPropertyGetSet( Rules,             QStringList )
+    NMPropertyGetSet( RuleTableFileName, QStringList )
+    NMPropertyGetSet( LowerColumn,       QStringList )
+    NMPropertyGetSet( UpperColumn,       QStringList )
+    NMPropertyGetSet( ValueColumns,      QStringList )
+    NMPropertyGetSet( DefaultValues,     QStringList )
+
+public:
+    NMReclassImageFilterWrapper(QObject* parent=0);
+    virtual ~NMReclassImageFilterWrapper();
+
+    template<class TInputImage, class TOutputImage, unsigned int Dimension>
+    friend class NMReclassImageFilterWrapper_Internal;
+
+    QSharedPointer<NMItkDataObjectWrapper> getOutput(unsigned int idx);
+    void instantiateObject(void);
+
+    void setNthInput(unsigned int numInput,
+              QSharedPointer<NMItkDataObjectWrapper> imgWrapper, const QString& name);
+
+    void setRAT(unsigned int idx,
+        QSharedPointer<NMItkDataObjectWrapper> imgWrapper);
+
+protected:
+
+    QStringList mRules;
+    QStringList mRuleTableFileName;
+    QStringList mLowerColumn;
+    QStringList mUpperColumn;
+    QStringList mValueColumns;
+    QStringList mDefaultValues;
+
+    void linkParameters(unsigned int step,
+            const QMap<QString, NMModelComponent*>& repo);
+};
+
+#endif /* NMReclassImageFilterWrapper_H_ */
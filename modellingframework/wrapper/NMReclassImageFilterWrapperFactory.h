@@ -0,0 +1,45 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * NMReclassImageFilterWrapperFactory.h
+ *
+ *  Created on: 2024-06-24
+ *      Author: Alex Herzig
+ */
+
+#ifndef NMReclassImageFilterWrapperFactory_H_
+#define NMReclassImageFilterWrapperFactory_H_
+
+#include <QObject>
+#include "NMWrapperFactory.h"
+
+#include "nmreclassimagefilterwrapper_export.h"
+
+class NMRECLASSIMAGEFILTERWRAPPER_EXPORT NMReclassImageFilterWrapperFactory : public NMWrapperFactory
+{
+    Q_OBJECT
+public:
+    NMReclassImageFilterWrapperFactory(QObject *parent = nullptr);
+
+    NMProcess* createWrapper();
+    bool isSinkProcess(void) {return false;}
+    QString getWrapperClassName() {return "NMReclassImageFilterWrapper";}
+    QString getComponentAlias() {return QStringLiteral("ReclassImage");}
+};
+
+#endif // NMReclassImageFilterWrapperFactory_H
@@ -134,6 +134,24 @@ public:
             p->addRunTimeParaProvN(sqlStmtProvNAttr);
         }
 
+        // values bound to the statements' parameters (?1, ?2, ...), so the
+        // filter can re-use its prepared statements across iterations
+        QVariant curSqlParamsVar = p->getParameter("SQLParameters");
+        if (curSqlParamsVar.isValid())
+        {
+            std::vector<std::string> sqlParams;
+            QStringList curSqlParams = curSqlParamsVar.toStringList();
+            foreach(const QString& vStr, curSqlParams)
+            {
+                sqlParams.push_back(vStr.toStdString());
+            }
+            f->SetSQLParameters(sqlParams);
+
+            QString sqlParamsProvNAttr = QString("nm:SQLParameters=\"%1\"")
+                                         .arg(curSqlParams.join(' '));
+            p->addRunTimeParaProvN(sqlParamsProvNAttr);
+        }
+
         step = p->mapHostIndexToPolicyIndex(givenStep, p->mInputComponents.size());
         std::vector<std::string> userIDs;
         QStringList currentInputs;
@@ -194,6 +212,7 @@ NMSQLiteProcessorWrapper
     mUserProperties.insert(QStringLiteral("NMInputComponentType"), QStringLiteral("PixelType"));
     mUserProperties.insert(QStringLiteral("InputNumDimensions"), QStringLiteral("NumDimensions"));
     mUserProperties.insert(QStringLiteral("SQLStatement"), QStringLiteral("SQLStatement"));
+    mUserProperties.insert(QStringLiteral("SQLParameters"), QStringLiteral("SQLParameters"));
 
 }
 
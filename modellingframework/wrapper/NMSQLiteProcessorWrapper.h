@@ -47,11 +47,13 @@ NMSQLiteProcessorWrapper
 
 
     Q_PROPERTY(QStringList SQLStatement READ getSQLStatement WRITE setSQLStatement)
+    Q_PROPERTY(QList<QStringList> SQLParameters READ getSQLParameters WRITE setSQLParameters)
 
 public:
 
 
     NMPropertyGetSet( SQLStatement, QStringList )
+    NMPropertyGetSet( SQLParameters, QList<QStringList> )
 
 public:
     NMSQLiteProcessorWrapper(QObject* parent=0);
@@ -79,6 +81,7 @@ protected:
 
 
     QStringList mSQLStatement;
+    QList<QStringList> mSQLParameters;
 
 };
 
@@ -43,6 +43,7 @@
 #include "otbImage.h"
 #include "otbSQLiteTable.h"
 #include "otbRAMTable.h"
+#include "otbColumnarTable.h"
 #include "vcl_numeric.h"
 #include "vcl_algorithm.h"
 #include "itkVariableLengthVector.h"
@@ -117,6 +118,7 @@ GDALRATImageIO::GDALRATImageIO()
 
   m_ImgInfoHasBeenRead = false;
   m_GDALComponentType = GDT_Byte;
+  m_ReadComponentType = UNKNOWNCOMPONENTTYPE;
 
   m_RGBMode = false;
   m_BandMap.clear();
@@ -203,6 +205,70 @@ GDALRATImageIO::SetOverviewIdx(int idx)
     }
 }
 
+GDALDataType GDALRATImageIO::GetGDALReadType(IOComponentType type, int& bytePerPixel)
+{
+  GDALDataType gtype = GDT_Unknown;
+  switch(type)
+    {
+    case UCHAR:  gtype = GDT_Byte;    bytePerPixel = sizeof(unsigned char);  break;
+    case USHORT: gtype = GDT_UInt16;  bytePerPixel = sizeof(unsigned short); break;
+    case SHORT:  gtype = GDT_Int16;   bytePerPixel = sizeof(short);          break;
+    case UINT:   gtype = GDT_UInt32;  bytePerPixel = sizeof(unsigned int);   break;
+    case INT:    gtype = GDT_Int32;   bytePerPixel = sizeof(int);            break;
+    case FLOAT:  gtype = GDT_Float32; bytePerPixel = sizeof(float);          break;
+    case DOUBLE: gtype = GDT_Float64; bytePerPixel = sizeof(double);         break;
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,7,0)
+    case CHAR:   gtype = GDT_Int8;    bytePerPixel = sizeof(char);           break;
+#endif
+    case LONG:
+      bytePerPixel = sizeof(long);
+      if (bytePerPixel == 4)
+        {
+        gtype = GDT_Int32;
+        }
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,5,0)
+      else if (bytePerPixel == 8)
+        {
+        gtype = GDT_Int64;
+        }
+#endif
+      break;
+    case ULONG:
+      bytePerPixel = sizeof(unsigned long);
+      if (bytePerPixel == 4)
+        {
+        gtype = GDT_UInt32;
+        }
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,5,0)
+      else if (bytePerPixel == 8)
+        {
+        gtype = GDT_UInt64;
+        }
+#endif
+      break;
+    default:
+      break;
+    }
+
+  return gtype;
+}
+
+bool GDALRATImageIO::CanReadAsComponentType(IOComponentType type)
+{
+  // indexed (colour table) and complex images are
+  // read as is and converted by the reader if required
+  if (    m_IsIndexed
+       || m_IsComplex
+       || GDALDataTypeIsComplex(m_GDALComponentType)
+     )
+    {
+    return false;
+    }
+
+  int bytePerPixel = 0;
+  return GetGDALReadType(type, bytePerPixel) != GDT_Unknown;
+}
+
 // Read image with GDAL
 void GDALRATImageIO::Read(void* buffer)
 {
@@ -332,9 +398,24 @@ void GDALRATImageIO::Read(void* buffer)
         }
     }
 
-    int pixelOffset = m_BytePerPixel * nbBands;
-    int lineOffset  = m_BytePerPixel * nbBands * lNbBufColumns;
-    int bandOffset  = m_BytePerPixel;
+    // let GDAL convert the pixel values into the
+    // requested buffer type, if any
+    GDALDataType bufType = m_GDALComponentType;
+    int bufBytePerPixel = m_BytePerPixel;
+    if (m_ReadComponentType != UNKNOWNCOMPONENTTYPE)
+      {
+      int readBytePerPixel = 0;
+      const GDALDataType readType = GetGDALReadType(m_ReadComponentType, readBytePerPixel);
+      if (readType != GDT_Unknown)
+        {
+        bufType = readType;
+        bufBytePerPixel = readBytePerPixel;
+        }
+      }
+
+    int pixelOffset = bufBytePerPixel * nbBands;
+    int lineOffset  = bufBytePerPixel * nbBands * lNbBufColumns;
+    int bandOffset  = bufBytePerPixel;
 
     // In some cases, we need to change some parameters for RasterIO
     if(!GDALDataTypeIsComplex(m_GDALComponentType) && m_IsComplex && m_IsVectorImage && (m_NbBands > 1))
@@ -352,6 +433,7 @@ void GDALRATImageIO::Read(void* buffer)
                    << " sizeX = " << lNbBufColumns << "\n"
                    << " sizeY = " << lNbBufLines << "\n"
                    << " GDAL Data Type = " << GDALGetDataTypeName(m_GDALComponentType) << "\n"
+                   << " Buffer Data Type = " << GDALGetDataTypeName(bufType) << "\n"
                    << " pixelOffset = " << pixelOffset << "\n"
                    << " lineOffset = " << lineOffset << "\n"
                    << " bandOffset = " << bandOffset);
@@ -366,7 +448,7 @@ void GDALRATImageIO::Read(void* buffer)
                                        p,
                                        lNbBufColumns,
                                        lNbBufLines,
-                                       m_GDALComponentType,
+                                       bufType,
                                        nbBands,
                                        // read specified bands
                                        bandMap,
@@ -1721,15 +1803,7 @@ void GDALRATImageIO::InternalWriteImageInformation(const void* buffer)
 			NMLogDebug(<< "Enabling TIFF Tiled mode")
 				papszOptions = CSLAddNameValue(papszOptions, "TILED", "YES");
 
-			// Use a fixed tile size
-			// Take as reference is a 256*256 short int 4 bands tile
-			const unsigned int ReferenceTileSizeInBytes = 256 * 256 * 4 * 2;
-
-			unsigned int nbPixelPerTile = ReferenceTileSizeInBytes / m_BytePerPixel / m_NbBands;
-			unsigned int tileDimension = static_cast<unsigned int>(vcl_sqrt(static_cast<float>(nbPixelPerTile)));
-
-			// align the tile dimension to the next multiple of 16 (needed by TIFF spec)
-			tileDimension = (tileDimension + 15) / 16 * 16;
+			const unsigned int tileDimension = ComputeTiffTileDimension(m_BytePerPixel, m_NbBands);
 
 			NMLogDebug(<< "Tile dimension : " << tileDimension << " * " << tileDimension)
 
@@ -1955,6 +2029,49 @@ void GDALRATImageIO::InternalWriteImageInformation(const void* buffer)
 
 }
 
+unsigned int GDALRATImageIO::ComputeTiffTileDimension(int bytePerPixel, unsigned int nbBands)
+{
+	// Use a fixed tile size
+	// Take as reference is a 256*256 short int 4 bands tile
+	const unsigned int ReferenceTileSizeInBytes = 256 * 256 * 4 * 2;
+
+	bytePerPixel = bytePerPixel > 0 ? bytePerPixel : 1;
+	nbBands = nbBands > 0 ? nbBands : 1;
+
+	unsigned int nbPixelPerTile = ReferenceTileSizeInBytes / bytePerPixel / nbBands;
+	unsigned int tileDimension = static_cast<unsigned int>(vcl_sqrt(static_cast<float>(nbPixelPerTile)));
+
+	// align the tile dimension to the next multiple of 16 (needed by TIFF spec)
+	tileDimension = (tileDimension + 15) / 16 * 16;
+
+	return tileDimension;
+}
+
+void GDALRATImageIO::GetWriteBlockSize(int bytePerPixel, unsigned int nbBands,
+									   unsigned int& blockX, unsigned int& blockY) const
+{
+	blockX = 0;
+	blockY = 0;
+
+	const std::string driverShortName = FilenameToGdalDriverShortName(m_FileName);
+	if (driverShortName.compare("GTiff") == 0)
+	{
+		blockX = ComputeTiffTileDimension(bytePerPixel, nbBands);
+		blockY = blockX;
+	}
+	else if (driverShortName.compare("KEA") == 0)
+	{
+		// KEA driver default IMAGEBLOCKSIZE
+		blockX = 256;
+		blockY = 256;
+	}
+	else if (driverShortName.compare("HFA") == 0)
+	{
+		blockX = 64;
+		blockY = 64;
+	}
+}
+
 std::string GDALRATImageIO::FilenameToGdalDriverShortName(const std::string& name) const
 {
   std::string extension;
@@ -2052,6 +2169,9 @@ AttributeTable::Pointer GDALRATImageIO::ReadRAT(unsigned int iBand)
         stab = InternalReadSQLiteRAT(iBand);
         tab = stab.GetPointer();//static_cast<AttributetTable*>(stab.GetPointer());
         break;
+    case AttributeTable::ATTABLE_TYPE_COLUMNAR:
+        tab = InternalReadColumnarRAT(iBand);
+        break;
     default:
         return 0;
     }
@@ -2059,6 +2179,78 @@ AttributeTable::Pointer GDALRATImageIO::ReadRAT(unsigned int iBand)
     return tab;
 }
 
+AttributeTable::Pointer GDALRATImageIO::InternalReadColumnarRAT(unsigned int iBand)
+{
+    // we re-use the columnar table file of this band, unless
+    // the image or its .ldb have been updated since it was written
+    const std::string ctabFN = ColumnarTable::GetColumnarFileName(this->m_FileName, iBand);
+
+    std::string dbFN = this->m_FileName;
+    size_t pos = dbFN.find_last_of('.');
+    if (pos > 0)
+    {
+        dbFN = dbFN.substr(0, pos);
+    }
+    dbFN += ".ldb";
+
+    bool bUpToDate = itksys::SystemTools::FileExists(ctabFN.c_str(), true);
+    int cmp = 0;
+    if (    bUpToDate
+        &&  itksys::SystemTools::FileTimeCompare(ctabFN.c_str(), this->m_FileName.c_str(), &cmp)
+        &&  cmp < 0
+       )
+    {
+        bUpToDate = false;
+    }
+
+    if (    bUpToDate
+        &&  itksys::SystemTools::FileExists(dbFN.c_str(), true)
+        &&  itksys::SystemTools::FileTimeCompare(ctabFN.c_str(), dbFN.c_str(), &cmp)
+        &&  cmp < 0
+       )
+    {
+        bUpToDate = false;
+    }
+
+    if (bUpToDate)
+    {
+        ColumnarTable::Pointer ctab = ColumnarTable::New();
+        if (ctab->OpenTable(ctabFN, m_DbRATReadOnly))
+        {
+            ctab->SetBandNumber(iBand);
+            ctab->SetImgFileName(this->m_FileName);
+            return ctab.GetPointer();
+        }
+        NMProcWarn(<< "Failed opening '" << ctabFN << "': "
+                   << ctab->getLastLogMsg() << " - Re-importing the RAT ...");
+        ctab->CloseTable();
+    }
+
+    // import the RAT via the SQLite table
+    SQLiteTable::Pointer stab = InternalReadSQLiteRAT(iBand);
+    if (stab.IsNull())
+    {
+        return nullptr;
+    }
+
+    ColumnarTable::Pointer ctab = ColumnarTable::ImportTable(stab.GetPointer(), ctabFN);
+    if (ctab.IsNull())
+    {
+        NMProcWarn(<< "Failed importing the RAT into '" << ctabFN
+                   << "' - using the SQLite table instead!");
+        return stab.GetPointer();
+    }
+    stab->CloseTable(false);
+
+    if (!m_DbRATReadOnly && !ctab->OpenTable(ctabFN, false))
+    {
+        NMProcErr(<< "Failed opening '" << ctabFN << "' for update!");
+        return nullptr;
+    }
+
+    return ctab.GetPointer();
+}
+
 
 RAMTable::Pointer GDALRATImageIO::InternalReadRAMRAT(unsigned int iBand)
 {
@@ -2886,6 +3078,10 @@ GDALRATImageIO::WriteRAT(AttributeTable::Pointer intab, unsigned int iBand)
     case AttributeTable::ATTABLE_TYPE_SQLITE:
         return InternalWriteSQLiteRAT(intab, iBand);
         break;
+    case AttributeTable::ATTABLE_TYPE_COLUMNAR:
+        NMProcWarn(<< "Writing columnar tables into the image is not supported - "
+                   << "use ColumnarTable::ExportToSQLite() instead!");
+        return;
     default:
         return;
     }
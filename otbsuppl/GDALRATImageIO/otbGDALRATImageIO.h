@@ -46,6 +46,7 @@
 #include "otbAttributeTable.h"
 #include "otbRAMTable.h"
 #include "otbSQLiteTable.h"
+#include "otbColumnarTable.h"
 
 /* GDAL Libraries */
 #include "gdal.h"
@@ -126,6 +127,18 @@ public:
   /** Get total number of components (bands) of source data set */
   int GetTotalNumberOfBands(void) {return m_NbBands;}
 
+  /** Set/Get the component type of the buffer passed to Read(), if it
+   *  differs from the file's component type; GDAL then converts the
+   *  pixel values on the fly while reading; UNKNOWNCOMPONENTTYPE
+   *  (default) reads the file's component type */
+  void SetReadComponentType(IOComponentType type)
+    {m_ReadComponentType = type;}
+  IOComponentType GetReadComponentType(void) const
+    {return m_ReadComponentType;}
+
+  /** Whether Read() can convert into the given component type */
+  bool CanReadAsComponentType(IOComponentType type);
+
   /** Set/Get whether files should be opened in update mode
    *  rather than being overridden */
   itkSetMacro(ImageUpdateMode, bool)
@@ -221,6 +234,12 @@ public:
   unsigned int* getLPR(void)
   {return this->m_LPRDimensions;}
 
+  /** Block (tile) size of the dataset created for writing, derived
+   *  from the driver's creation options (s. InternalWriteImageInformation);
+   *  blockX and blockY are 0 if the driver's layout is unknown */
+  void GetWriteBlockSize(int bytePerPixel, unsigned int nbBands,
+                         unsigned int& blockX, unsigned int& blockY) const;
+
 protected:
   /** Constructor.*/
   GDALRATImageIO();
@@ -238,6 +257,7 @@ protected:
   /** Read RAT into the desired underlying implementation of AttributeTable */
   SQLiteTable::Pointer InternalReadSQLiteRAT(unsigned int iBand);
   RAMTable::Pointer InternalReadRAMRAT(unsigned int iBand);
+  AttributeTable::Pointer InternalReadColumnarRAT(unsigned int iBand);
 
   /** Write specified RAT type into the image */
   void InternalWriteRAMRAT(AttributeTable::Pointer intab, unsigned int iBand);
@@ -313,6 +333,9 @@ private:
 
   std::string FilenameToGdalDriverShortName(const std::string& name) const;
 
+  /** square GTiff tile dimension used for streamed writing */
+  static unsigned int ComputeTiffTileDimension(int bytePerPixel, unsigned int nbBands);
+
   /** if we're editing solely the RAT, we perform this check */
   bool TableStructureChanged(AttributeTable::Pointer tab, unsigned int iBand);
 
@@ -327,6 +350,13 @@ private:
   /** Nombre d'octets par pixel */
   int m_BytePerPixel;
 
+  /** component type of the read buffer (s. SetReadComponentType) */
+  IOComponentType m_ReadComponentType;
+
+  /** GDAL type and size of the given (scalar) component type;
+   *  GDT_Unknown, if GDAL can't convert into the type */
+  static GDALDataType GetGDALReadType(IOComponentType type, int& bytePerPixel);
+
   bool GDALInfoReportCorner(const char * corner_name, double x, double y,
                             double& dfGeoX, double& dfGeoY) const;
 
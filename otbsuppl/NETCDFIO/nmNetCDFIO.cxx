@@ -209,6 +209,7 @@ NetCDFIO::NetCDFIO(void)
     this->m_NbOverviews = 0;
     this->m_OverviewIdx = - 1;
     this->m_ZSliceIdx = -1;
+    this->m_ReadComponentType = UNKNOWNCOMPONENTTYPE;
 }
 
 NetCDFIO::~NetCDFIO()
@@ -804,43 +805,7 @@ NetCDFIO::getVar(std::string vname,
         NcType::ncType type = targetType.isNull()
                                 ? imgVar.getType().getTypeClass()
                                 : targetType.getTypeClass();
-        switch(type)
-        {
-        case NcType::nc_BYTE:
-            imgVar.getVar(idx, len, static_cast<signed char*>(buf));
-            break;
-        case NcType::nc_UBYTE:
-        case NcType::nc_CHAR:
-            imgVar.getVar(idx, len, static_cast<unsigned char*>(buf));
-            break;
-        case NcType::nc_SHORT:
-            imgVar.getVar(idx, len, static_cast<short*>(buf));
-            break;
-        case NcType::nc_USHORT:
-            imgVar.getVar(idx, len, static_cast<unsigned short*>(buf));
-            break;
-        case NcType::nc_INT:
-            imgVar.getVar(idx, len, static_cast<int*>(buf));
-            break;
-        case NcType::nc_UINT:
-            imgVar.getVar(idx, len, static_cast<unsigned int*>(buf));
-            break;
-        case NcType::nc_FLOAT:
-            imgVar.getVar(idx, len, static_cast<float*>(buf));
-            break;
-        case NcType::nc_DOUBLE:
-            imgVar.getVar(idx, len, static_cast<double*>(buf));
-            break;
-        case NcType::nc_INT64:
-            imgVar.getVar(idx, len, static_cast<long long*>(buf));
-            break;
-        case NcType::nc_UINT64:
-            imgVar.getVar(idx, len, static_cast<unsigned long long*>(buf));
-            break;
-        default:
-            imgVar.getVar(idx, len, static_cast<double*>(buf));
-            break;
-        }
+        this->readVarAs(imgVar, idx, len, type, buf);
 
         nc.close();
         ret = true;
@@ -858,6 +823,78 @@ NetCDFIO::getVar(std::string vname,
 
 }
 
+void
+NetCDFIO::readVarAs(const NcVar& var, const std::vector<size_t>& start,
+                    const std::vector<size_t>& len, NcType::ncType type,
+                    void* buf)
+{
+    switch(type)
+    {
+    case NcType::nc_BYTE:
+        var.getVar(start, len, static_cast<signed char*>(buf));
+        break;
+    case NcType::nc_UBYTE:
+    case NcType::nc_CHAR:
+        var.getVar(start, len, static_cast<unsigned char*>(buf));
+        break;
+    case NcType::nc_SHORT:
+        var.getVar(start, len, static_cast<short*>(buf));
+        break;
+    case NcType::nc_USHORT:
+        var.getVar(start, len, static_cast<unsigned short*>(buf));
+        break;
+    case NcType::nc_INT:
+        var.getVar(start, len, static_cast<int*>(buf));
+        break;
+    case NcType::nc_UINT:
+        var.getVar(start, len, static_cast<unsigned int*>(buf));
+        break;
+    case NcType::nc_FLOAT:
+        var.getVar(start, len, static_cast<float*>(buf));
+        break;
+    case NcType::nc_DOUBLE:
+        var.getVar(start, len, static_cast<double*>(buf));
+        break;
+    case NcType::nc_INT64:
+        var.getVar(start, len, static_cast<long long*>(buf));
+        break;
+    case NcType::nc_UINT64:
+        var.getVar(start, len, static_cast<unsigned long long*>(buf));
+        break;
+    default:
+        var.getVar(start, len, static_cast<double*>(buf));
+        break;
+    }
+}
+
+bool NetCDFIO::CanReadAsComponentType(IOComponentType type)
+{
+    // only types getNetCDFComponentType maps onto
+    // a netCDF type of the same size
+    switch(type)
+    {
+    case UCHAR:
+    case CHAR:
+    case USHORT:
+    case SHORT:
+    case UINT:
+    case INT:
+    case FLOAT:
+    case DOUBLE:
+#if defined(_WIN32) || defined(__linux__)
+    case ULONG:
+    case LONG:
+#endif
+#if defined(_WIN32) && SIZEOF_LONGLONG >= 8
+    case ULONGLONG:
+    case LONGLONG:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
 void NetCDFIO::Read(void* buffer)
 {
     // read the specified IORegion
@@ -924,7 +961,17 @@ void NetCDFIO::Read(void* buffer)
             return;
         }
 
-        var.getVar(start, len, buffer);
+        if (m_ReadComponentType != UNKNOWNCOMPONENTTYPE)
+        {
+            // let netCDF convert the values into the buffer type
+            this->readVarAs(var, start, len,
+                            this->getNetCDFComponentType(m_ReadComponentType),
+                            buffer);
+        }
+        else
+        {
+            var.getVar(start, len, buffer);
+        }
 
         if (!m_bParallelIO)
         {
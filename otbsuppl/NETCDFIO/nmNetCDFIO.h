@@ -110,6 +110,18 @@ public:
     /** Get total number of components (bands) of source data set */
     int GetTotalNumberOfBands(void) {return m_NbBands;}
 
+    /** Set/Get the component type of the buffer passed to Read(), if it
+     *  differs from the variable's type; netCDF then converts the values
+     *  while reading (nc_get_vara_<type>); UNKNOWNCOMPONENTTYPE (default)
+     *  reads the variable's type */
+    void SetReadComponentType(IOComponentType type)
+      {m_ReadComponentType = type;}
+    IOComponentType GetReadComponentType(void) const
+      {return m_ReadComponentType;}
+
+    /** Whether Read() can convert into the given component type */
+    bool CanReadAsComponentType(IOComponentType type);
+
     /** Set/Get whether files should be opened in update mode
      *  rather than being overridden */
     itkSetMacro(ImageUpdateMode, bool)
@@ -197,6 +209,11 @@ protected:
 
     netCDF::NcType::ncType getNetCDFComponentType(otb::ImageIOBase::IOComponentType otbtype);
     netCDF::NcType::ncType getNetCDFComponentType(const std::string& typeStr);
+
+    /** reads the values of var into buf of the given type */
+    void readVarAs(const netCDF::NcVar& var, const std::vector<size_t>& start,
+                   const std::vector<size_t>& len, netCDF::NcType::ncType type,
+                   void* buf);
     void setVariableAttributes(netCDF::NcVar& var);
 
     struct DimInfo
@@ -295,6 +312,9 @@ private:
     /** Nombre d'octets par pixel */
     int m_BytePerPixel;
 
+    /** component type of the read buffer (s. SetReadComponentType) */
+    IOComponentType m_ReadComponentType;
+
     netCDF::NcFile mFile;
 
     MPI_Comm m_MPIComm;
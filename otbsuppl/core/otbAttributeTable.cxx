@@ -52,6 +52,20 @@ AttributeTable::ColumnExists(const std::string& sColName)
 {
 //    std::string colname = sColName;
 //    std::transform(sColName.begin(), sColName.end(), colname.begin(), ::tolower);
+
+    // the name index is only a hint: subclasses add, rename, and
+    // remove columns directly in m_vNames, so we double check
+    // any hit and fall back to the linear search on a miss
+    std::unordered_map<std::string, int>::const_iterator it =
+            m_mNameIndex.find(sColName);
+    if (    it != m_mNameIndex.end()
+        &&  it->second < m_vNames.size()
+        &&  m_vNames[it->second] == sColName
+       )
+    {
+        return it->second;
+    }
+
     int idx = -1;
     for (int c=0; c < m_vNames.size(); ++c)
     {
@@ -61,9 +75,231 @@ AttributeTable::ColumnExists(const std::string& sColName)
             break;
         }
     }
+
+    // the index is out of date, so rebuild it
+    if (idx >= 0)
+    {
+        m_mNameIndex.clear();
+        for (int c=0; c < m_vNames.size(); ++c)
+        {
+            m_mNameIndex.insert(std::pair<std::string, int>(m_vNames[c], c));
+        }
+    }
+
     return idx;
 }
 
+// ---------------------------------------------------------- bulk column access
+bool
+AttributeTable::GetColumnAsArray(int col, long long startRow, long long numRows, double* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    for (long long r=0; r < numRows; ++r)
+    {
+        buf[r] = this->GetDblValue(col, startRow + r);
+    }
+    return true;
+}
+
+bool
+AttributeTable::GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    for (long long r=0; r < numRows; ++r)
+    {
+        buf[r] = this->GetIntValue(col, startRow + r);
+    }
+    return true;
+}
+
+bool
+AttributeTable::GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0)
+    {
+        return false;
+    }
+
+    buf.resize(numRows);
+    for (long long r=0; r < numRows; ++r)
+    {
+        buf[r] = this->GetStrValue(col, startRow + r);
+    }
+    return true;
+}
+
+bool
+AttributeTable::SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    for (long long r=0; r < numRows; ++r)
+    {
+        this->SetValue(col, startRow + r, buf[r]);
+    }
+    return true;
+}
+
+bool
+AttributeTable::SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    for (long long r=0; r < numRows; ++r)
+    {
+        this->SetValue(col, startRow + r, buf[r]);
+    }
+    return true;
+}
+
+bool
+AttributeTable::SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf.size() < numRows)
+    {
+        return false;
+    }
+
+    for (long long r=0; r < numRows; ++r)
+    {
+        this->SetValue(col, startRow + r, buf[r]);
+    }
+    return true;
+}
+
+bool
+AttributeTable::GetColumnAsArray(const std::string& colName, std::vector<double>& values)
+{
+    const int col = this->ColumnExists(colName);
+    if (col < 0)
+    {
+        return false;
+    }
+
+    const long long minPK = this->GetMinPKValue();
+    const long long numRows = std::max(this->GetMaxPKValue() - minPK + 1, 0ll);
+    values.resize(numRows);
+    if (numRows == 0)
+    {
+        return true;
+    }
+    return this->GetColumnAsArray(col, minPK, numRows, &values[0]);
+}
+
+bool
+AttributeTable::GetColumnAsArray(const std::string& colName, std::vector<long long>& values)
+{
+    const int col = this->ColumnExists(colName);
+    if (col < 0)
+    {
+        return false;
+    }
+
+    const long long minPK = this->GetMinPKValue();
+    const long long numRows = std::max(this->GetMaxPKValue() - minPK + 1, 0ll);
+    values.resize(numRows);
+    if (numRows == 0)
+    {
+        return true;
+    }
+    return this->GetColumnAsArray(col, minPK, numRows, &values[0]);
+}
+
+bool
+AttributeTable::GetColumnAsArray(const std::string& colName, std::vector<std::string>& values)
+{
+    const int col = this->ColumnExists(colName);
+    if (col < 0)
+    {
+        return false;
+    }
+
+    const long long minPK = this->GetMinPKValue();
+    const long long numRows = std::max(this->GetMaxPKValue() - minPK + 1, 0ll);
+    return this->GetColumnAsArray(col, minPK, numRows, values);
+}
+
+bool
+AttributeTable::PrepareColumnScan(const std::vector<int>& cols, long long startRow, long long endRow)
+{
+    this->EndColumnScan();
+    for (int c=0; c < cols.size(); ++c)
+    {
+        if (cols[c] < 0 || cols[c] >= m_vNames.size())
+        {
+            return false;
+        }
+    }
+
+    m_vScanCols = cols;
+    m_ScanRow = startRow;
+    m_ScanEndRow = endRow;
+    return true;
+}
+
+bool
+AttributeTable::NextScanRow(long long& row, double* values)
+{
+    if (m_vScanCols.empty() || m_ScanRow > m_ScanEndRow || values == nullptr)
+    {
+        return false;
+    }
+
+    row = m_ScanRow++;
+    for (int c=0; c < m_vScanCols.size(); ++c)
+    {
+        values[c] = this->GetDblValue(m_vScanCols[c], row);
+    }
+    return true;
+}
+
+bool
+AttributeTable::NextScanRow(long long& row, double* dblValues, long long* intValues)
+{
+    if (    m_vScanCols.empty() || m_ScanRow > m_ScanEndRow
+         || dblValues == nullptr || intValues == nullptr
+       )
+    {
+        return false;
+    }
+
+    row = m_ScanRow++;
+    for (int c=0; c < m_vScanCols.size(); ++c)
+    {
+        if (this->GetColumnType(m_vScanCols[c]) == ATTYPE_INT)
+        {
+            intValues[c] = this->GetIntValue(m_vScanCols[c], row);
+        }
+        else
+        {
+            dblValues[c] = this->GetDblValue(m_vScanCols[c], row);
+        }
+    }
+    return true;
+}
+
+void
+AttributeTable::EndColumnScan(void)
+{
+    m_vScanCols.clear();
+    m_ScanRow = 0;
+    m_ScanEndRow = -1;
+}
+
 
 void AttributeTable::SetBandNumber(int iBand)
 {
@@ -459,7 +695,9 @@ AttributeTable::AttributeTable()
       m_iNodata(-std::numeric_limits<long>::max()),
       m_dNodata(-std::numeric_limits<double>::max()),
       m_sNodata("NULL"),
-      m_idColName("")
+      m_idColName(""),
+      m_ScanRow(0),
+      m_ScanEndRow(-1)
 {
 }
 
@@ -26,7 +26,10 @@
 #define ATTRIBUTETABLE_H_
 
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 
@@ -52,7 +55,8 @@ public:
     typedef enum
     {
         ATTABLE_TYPE_RAM = 0,
-        ATTABLE_TYPE_SQLITE
+        ATTABLE_TYPE_SQLITE,
+        ATTABLE_TYPE_COLUMNAR
     } TableType;
 
 	// supported column types
@@ -64,7 +68,9 @@ public:
 		ATTYPE_UNKNOWN
 	} TableColumnType;
 
-    // field value data structure
+    // field value data structure; string values (tval) are owned
+    // by the ColumnValue if slen > 0, otherwise tval just refers
+    // to somebody else's string
     typedef struct _ColumnValue
     {
         _ColumnValue()
@@ -74,10 +80,17 @@ public:
         {}
 
         _ColumnValue(const _ColumnValue& cv)
+            : type(ATTYPE_UNKNOWN),
+              tval(nullptr),
+              slen(0)
+        {
+            *this = cv;
+        }
+
+        _ColumnValue(_ColumnValue&& cv) noexcept
+            : type(cv.type),
+              slen(cv.slen)
         {
-            type = cv.type;
-            slen = 0;
-            tval = nullptr;
             switch(type)
             {
             case ATTYPE_INT:
@@ -86,29 +99,98 @@ public:
             case ATTYPE_DOUBLE:
                 dval = cv.dval;
                 break;
+            default:
+                tval = cv.tval;
+                break;
+            }
+            cv.tval = nullptr;
+            cv.slen = 0;
+        }
+
+        _ColumnValue& operator=(const _ColumnValue& cv)
+        {
+            if (this == &cv)
+            {
+                return *this;
+            }
+
+            switch(cv.type)
+            {
+            case ATTYPE_INT:
+                freeString();
+                ival = cv.ival;
+                break;
+            case ATTYPE_DOUBLE:
+                freeString();
+                dval = cv.dval;
+                break;
             case ATTYPE_STRING:
-                slen = cv.slen;
-                tval = new char[slen];
                 if (cv.tval != nullptr)
                 {
-                    ::sprintf(tval, "%s", cv.tval);
+                    SetString(cv.tval, ::strlen(cv.tval));
                 }
                 else
                 {
-                    ::sprintf(tval, "%s", "\0");
+                    SetString("", 0);
                 }
                 break;
             default:
-                ;
+                freeString();
+                tval = nullptr;
+                break;
+            }
+            type = cv.type;
+
+            return *this;
+        }
+
+        _ColumnValue& operator=(_ColumnValue&& cv) noexcept
+        {
+            if (this == &cv)
+            {
+                return *this;
+            }
+
+            freeString();
+            type = cv.type;
+            slen = cv.slen;
+            switch(type)
+            {
+            case ATTYPE_INT:
+                ival = cv.ival;
+                break;
+            case ATTYPE_DOUBLE:
+                dval = cv.dval;
+                break;
+            default:
+                tval = cv.tval;
+                break;
             }
+            cv.tval = nullptr;
+            cv.slen = 0;
+
+            return *this;
         }
 
         ~_ColumnValue()
         {
-            if (slen > 0)
+            freeString();
+        }
+
+        /*! copies the given string into the value's own
+         *  buffer, which is only re-allocated if it is
+         *  too small */
+        void SetString(const char* str, size_t len)
+        {
+            if (slen < len + 1)
             {
-                delete[] tval;
+                freeString();
+                slen = std::max(len + 1, static_cast<size_t>(16));
+                tval = new char[slen];
             }
+            ::memcpy(tval, str, len);
+            tval[len] = '\0';
+            type = ATTYPE_STRING;
         }
 
         TableColumnType type;
@@ -121,6 +203,17 @@ public:
 
         size_t slen;
 
+    private:
+        void freeString()
+        {
+            if (slen > 0)
+            {
+                delete[] tval;
+                tval = nullptr;
+                slen = 0;
+            }
+        }
+
     } ColumnValue;
 
 
@@ -164,6 +257,55 @@ public:
     virtual long long GetMinPKValue() = 0;
     virtual long long GetMaxPKValue() = 0;
 
+    /*!
+     * Bulk column access: copies numRows values of column col,
+     * starting at row (RAMTable: row index; SQLiteTable: primary
+     * key value) startRow, into / from the provided buffer, which
+     * must hold at least numRows values; rows not present in the
+     * table are reported as nodata. Values are converted into the
+     * type of the buffer like GetDblValue/GetIntValue/GetStrValue
+     * do. The default implementation falls back to the per-cell
+     * getters and setters, RAMTable and SQLiteTable copy (fetch)
+     * the whole range at once.
+     */
+    virtual bool GetColumnAsArray(int col, long long startRow, long long numRows, double* buf);
+    virtual bool GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf);
+    virtual bool GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf);
+
+    virtual bool SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf);
+    virtual bool SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf);
+    virtual bool SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf);
+
+    /*! convenience functions fetching the full column, i.e.
+     *  rows GetMinPKValue() to GetMaxPKValue() */
+    bool GetColumnAsArray(const std::string& colName, std::vector<double>& values);
+    bool GetColumnAsArray(const std::string& colName, std::vector<long long>& values);
+    bool GetColumnAsArray(const std::string& colName, std::vector<std::string>& values);
+
+    /*!
+     * Multi-column scan cursor: iterates over rows startRow to
+     * endRow (inclusive) and returns the values of the given
+     * columns (as double) row by row. Rows not present in the
+     * table are skipped. Only one scan can be active per table;
+     * a new call of PrepareColumnScan() ends the previous scan.
+     * The second NextScanRow() variant returns the values of
+     * integer columns exactly in intValues (and those of all other
+     * columns in dblValues), since doubles can't represent
+     * integers beyond 2^53.
+     *
+     * \code
+     *  std::vector<double> vals(cols.size());
+     *  long long row;
+     *  tab->PrepareColumnScan(cols, tab->GetMinPKValue(), tab->GetMaxPKValue());
+     *  while (tab->NextScanRow(row, &vals[0])) { ... }
+     *  tab->EndColumnScan();
+     * \endcode
+     */
+    virtual bool PrepareColumnScan(const std::vector<int>& cols, long long startRow, long long endRow);
+    virtual bool NextScanRow(long long& row, double* values);
+    virtual bool NextScanRow(long long& row, double* dblValues, long long* intValues);
+    virtual void EndColumnScan(void);
+
 
     virtual bool RemoveColumn(int col) = 0;
     virtual bool RemoveColumn(const std::string& name) = 0;
@@ -205,6 +347,15 @@ protected:
 	std::string m_sImgName;
     std::string m_idColName;
 
+    // column name lookup used by ColumnExists; lazily
+    // (re-)built from m_vNames
+    std::unordered_map<std::string, int> m_mNameIndex;
+
+    // state of the default column scan
+    std::vector<int> m_vScanCols;
+    long long m_ScanRow;
+    long long m_ScanEndRow;
+
 	// validate column name and row index; if
 	// parameters are valid then the column index
 	// is returned otherwise -1;
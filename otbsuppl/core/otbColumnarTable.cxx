@@ -0,0 +1,1553 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2010-2015 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#include "nmlog.h"
+#define _ctxotbtab "ColumnarTable"
+#include "otbColumnarTable.h"
+#include "otbSQLiteTable.h"
+#include <limits>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#else
+    #include <windows.h>
+#endif
+
+namespace
+{
+
+// columnar table file header and directory entries
+const char CTAB_MAGIC[8] = {'N', 'M', 'C', 'T', 'A', 'B', '\0', '\0'};
+const int32_t CTAB_VERSION = 1;
+const long long CTAB_DEFAULT_BLOCKSIZE = 65536;
+
+typedef struct
+{
+    char magic[8];
+    int32_t version;
+    int32_t numCols;
+    int64_t numRows;
+    int64_t minPK;
+    int64_t blockSize;
+    double dNodata;
+    int64_t iNodata;
+    int64_t pkNameOffset;
+    int64_t pkNameLength;
+} CTabHeader;
+
+typedef struct
+{
+    int32_t type;
+    int32_t reserved;
+    int64_t nameOffset;
+    int64_t nameLength;
+    int64_t dataOffset;
+    int64_t dictOffset;
+    int64_t dictCount;
+    int64_t statsOffset;
+} CTabColumnEntry;
+
+inline long long align8(long long offset)
+{
+    return (offset + 7) & ~7ll;
+}
+
+void writePadding(std::ofstream& ofs)
+{
+    static const char zeros[8] = {0};
+    const long long pos = static_cast<long long>(ofs.tellp());
+    ofs.write(zeros, align8(pos) - pos);
+}
+
+} // anonymous namespace
+
+namespace otb
+{
+
+/*! Read-only or writable memory mapping of a columnar
+ *  table file; mappings are shared by all table objects
+ *  opening the same file in the same mode
+ */
+class ColumnarTableMapping
+{
+public:
+    ~ColumnarTableMapping()
+    {
+        if (m_Data == nullptr)
+        {
+            return;
+        }
+#ifndef _WIN32
+        ::munmap(m_Data, m_Size);
+#else
+        ::UnmapViewOfFile(m_Data);
+        ::CloseHandle(m_hMap);
+        ::CloseHandle(m_hFile);
+#endif
+    }
+
+    char* GetData() {return m_Data;}
+    size_t GetSize() {return m_Size;}
+
+    static std::shared_ptr<ColumnarTableMapping> Get(const std::string& fileName,
+                                                     bool bWritable,
+                                                     std::string& errMsg)
+    {
+        static std::mutex registryMutex;
+        static std::map<std::string, std::weak_ptr<ColumnarTableMapping> > registry;
+
+        const std::string key = fileName + (bWritable ? "|rw" : "|ro");
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::shared_ptr<ColumnarTableMapping> mapping = registry[key].lock();
+        if (mapping.get() == nullptr)
+        {
+            mapping.reset(new ColumnarTableMapping());
+            if (!mapping->Map(fileName, bWritable, errMsg))
+            {
+                registry.erase(key);
+                return std::shared_ptr<ColumnarTableMapping>();
+            }
+            registry[key] = mapping;
+        }
+
+        return mapping;
+    }
+
+private:
+    ColumnarTableMapping()
+        : m_Data(nullptr), m_Size(0)
+#ifdef _WIN32
+        , m_hFile(INVALID_HANDLE_VALUE), m_hMap(nullptr)
+#endif
+    {}
+
+    bool Map(const std::string& fileName, bool bWritable, std::string& errMsg)
+    {
+#ifndef _WIN32
+        int fd = ::open(fileName.c_str(), bWritable ? O_RDWR : O_RDONLY);
+        if (fd < 0)
+        {
+            errMsg = "Failed opening '" + fileName + "'!";
+            return false;
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            errMsg = "Failed accessing '" + fileName + "'!";
+            return false;
+        }
+
+        void* data = ::mmap(nullptr, st.st_size,
+                            bWritable ? PROT_READ | PROT_WRITE : PROT_READ,
+                            MAP_SHARED, fd, 0);
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            errMsg = "Failed mapping '" + fileName + "' into memory!";
+            return false;
+        }
+
+        m_Data = static_cast<char*>(data);
+        m_Size = st.st_size;
+#else
+        m_hFile = ::CreateFileA(fileName.c_str(),
+                                bWritable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_hFile == INVALID_HANDLE_VALUE)
+        {
+            errMsg = "Failed opening '" + fileName + "'!";
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+        {
+            ::CloseHandle(m_hFile);
+            errMsg = "Failed accessing '" + fileName + "'!";
+            return false;
+        }
+
+        m_hMap = ::CreateFileMappingA(m_hFile, nullptr,
+                                      bWritable ? PAGE_READWRITE : PAGE_READONLY,
+                                      0, 0, nullptr);
+        void* data = m_hMap != nullptr
+                ? ::MapViewOfFile(m_hMap, bWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0)
+                : nullptr;
+        if (data == nullptr)
+        {
+            if (m_hMap != nullptr)
+            {
+                ::CloseHandle(m_hMap);
+            }
+            ::CloseHandle(m_hFile);
+            errMsg = "Failed mapping '" + fileName + "' into memory!";
+            return false;
+        }
+
+        m_Data = static_cast<char*>(data);
+        m_Size = static_cast<size_t>(size.QuadPart);
+#endif
+        return true;
+    }
+
+    char* m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    HANDLE m_hFile;
+    HANDLE m_hMap;
+#endif
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ---------------------  PUBLIC GETTER and SETTER functions to manage the Attribute table
+
+bool
+ColumnarTable::AddColumn(const std::string& sColName, TableColumnType eType)
+{
+    if ((    eType != ATTYPE_STRING
+         &&  eType != ATTYPE_INT
+         &&  eType != ATTYPE_DOUBLE
+        )
+        ||  this->ColumnExists(sColName) >= 0
+       )
+    {
+        return false;
+    }
+
+    if (this->IsMapped())
+    {
+        m_lastLogMsg = "Cannot add columns to a mapped table!";
+        return false;
+    }
+
+    ColumnData cd;
+    try
+    {
+        switch(eType)
+        {
+        case ATTYPE_STRING:
+            cd.vCode.resize(m_iNumRows, -1);
+            break;
+        case ATTYPE_INT:
+            cd.vInt.resize(m_iNumRows, m_iNodata);
+            break;
+        case ATTYPE_DOUBLE:
+            cd.vDbl.resize(m_iNumRows, m_dNodata);
+            break;
+        default:
+            break;
+        }
+    }
+    catch (std::exception& e)
+    {
+        NMProcErr(<< _ctxotbtab << ": Failed adding column: " << e.what());
+        return false;
+    }
+
+    m_vColumns.push_back(cd);
+    for (int c=0; c < m_vColumns.size(); ++c)
+    {
+        this->updateColumnPointers(m_vColumns[c]);
+    }
+
+    // update admin infos
+    this->m_vNames.push_back(sColName);
+    this->m_vTypes.push_back(eType);
+
+    return true;
+}
+
+bool
+ColumnarTable::AddRows(long long numRows)
+{
+    // check for presence of columns
+    if (this->m_vNames.size() == 0 || numRows < 0)
+    {
+        return false;
+    }
+
+    if (this->IsMapped())
+    {
+        m_lastLogMsg = "Cannot add rows to a mapped table!";
+        return false;
+    }
+
+    try
+    {
+        for (int colidx = 0; colidx < this->m_vNames.size(); ++colidx)
+        {
+            ColumnData& cd = m_vColumns[colidx];
+            switch (this->m_vTypes[colidx])
+            {
+            case ATTYPE_STRING:
+                cd.vCode.resize(m_iNumRows+numRows, -1);
+                break;
+            case ATTYPE_INT:
+                cd.vInt.resize(m_iNumRows+numRows, m_iNodata);
+                break;
+            case ATTYPE_DOUBLE:
+                cd.vDbl.resize(m_iNumRows+numRows, m_dNodata);
+                break;
+            default:
+                return false;
+            }
+            this->updateColumnPointers(cd);
+        }
+    }
+    catch (std::exception& e)
+    {
+        NMProcErr(<< _ctxotbtab << ": Failed adding rows: " << e.what());
+        return false;
+    }
+
+    // increase the row number counter
+    this->m_iNumRows += numRows;
+
+    return true;
+}
+
+long long
+ColumnarTable::GetMinPKValue()
+{
+    return m_MinPK;
+}
+
+long long
+ColumnarTable::GetMaxPKValue()
+{
+    return m_MinPK + m_iNumRows - 1;
+}
+
+void
+ColumnarTable::SetMinPKValue(long long minPK)
+{
+    if (!this->IsMapped())
+    {
+        m_MinPK = minPK;
+    }
+}
+
+void
+ColumnarTable::SetColumnName(int col, const std::string& name)
+{
+    if (    col < 0
+        ||  col >= this->m_vNames.size()
+        ||  name.empty()
+        ||  this->IsMapped()
+       )
+    {
+        return;
+    }
+
+    this->m_vNames[col] = name;
+}
+
+bool
+ColumnarTable::RemoveColumn(int col)
+{
+    if (col < 0 || col >= this->m_vNames.size() || this->IsMapped())
+    {
+        return false;
+    }
+
+    this->m_vColumns.erase(this->m_vColumns.begin() + col);
+    this->m_vNames.erase(this->m_vNames.begin() + col);
+    this->m_vTypes.erase(this->m_vTypes.begin() + col);
+
+    return true;
+}
+
+bool
+ColumnarTable::RemoveColumn(const std::string& name)
+{
+    int idx = this->ColumnExists(name);
+    if (idx < 0)
+    {
+        return false;
+    }
+
+    return this->RemoveColumn(idx);
+}
+
+long long
+ColumnarTable::GetRowIdx(const std::string& column, void* value)
+{
+    long long idx = -1;
+
+    int colidx = ColumnExists(column);
+    if (colidx < 0 || value == nullptr)
+    {
+        return idx;
+    }
+
+    const ColumnData& cd = m_vColumns[colidx];
+    switch(m_vTypes[colidx])
+    {
+    case ATTYPE_STRING:
+        {
+            const std::string* strVal = static_cast<std::string*>(value);
+            const int code = *strVal == m_sNodata
+                    ? -1 : this->GetDictionaryCode(colidx, *strVal);
+            if (code < 0 && *strVal != m_sNodata)
+            {
+                break;
+            }
+
+            const int* pos = std::find(cd.pCode, cd.pCode + m_iNumRows, code);
+            if (pos != cd.pCode + m_iNumRows)
+            {
+                idx = m_MinPK + (pos - cd.pCode);
+            }
+        }
+        break;
+
+    case ATTYPE_INT:
+        {
+            const long long longVal = *static_cast<long long*>(value);
+            const long long* pos = std::find(cd.pInt, cd.pInt + m_iNumRows, longVal);
+            if (pos != cd.pInt + m_iNumRows)
+            {
+                idx = m_MinPK + (pos - cd.pInt);
+            }
+        }
+        break;
+
+    case ATTYPE_DOUBLE:
+        {
+            const double doubleVal = *static_cast<double*>(value);
+            const double* pos = std::find(cd.pDbl, cd.pDbl + m_iNumRows, doubleVal);
+            if (pos != cd.pDbl + m_iNumRows)
+            {
+                idx = m_MinPK + (pos - cd.pDbl);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return idx;
+}
+
+bool
+ColumnarTable::rowValid(int col, long long row)
+{
+    return      col >= 0 && col < m_vNames.size()
+            &&  row >= m_MinPK && row < m_MinPK + m_iNumRows;
+}
+
+void
+ColumnarTable::SetValue(const std::string& sColName, long long idx, double value)
+{
+    this->SetValue(this->ColumnExists(sColName), idx, value);
+}
+
+void
+ColumnarTable::SetValue(const std::string& sColName, long long idx, long long value)
+{
+    this->SetValue(this->ColumnExists(sColName), idx, value);
+}
+
+void
+ColumnarTable::SetValue(const std::string& sColName, long long idx, std::string value)
+{
+    this->SetValue(this->ColumnExists(sColName), idx, value);
+}
+
+double
+ColumnarTable::GetDblValue(const std::string& sColName, long long idx)
+{
+    return this->GetDblValue(this->ColumnExists(sColName), idx);
+}
+
+long long
+ColumnarTable::GetIntValue(const std::string& sColName, long long idx)
+{
+    return this->GetIntValue(this->ColumnExists(sColName), idx);
+}
+
+std::string
+ColumnarTable::GetStrValue(const std::string& sColName, long long idx)
+{
+    return this->GetStrValue(this->ColumnExists(sColName), idx);
+}
+
+void
+ColumnarTable::SetValue(int col, long long row, double value)
+{
+    if (!this->rowValid(col, row) || (this->IsMapped() && m_bReadOnly))
+    {
+        return;
+    }
+
+    const long long r = row - m_MinPK;
+    ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        {
+            std::stringstream sval;
+            sval << value;
+            const int code = this->encodeString(col, sval.str());
+            if (code >= -1)
+            {
+                cd.pCode[r] = code;
+            }
+        }
+        break;
+    case ATTYPE_INT:
+        cd.pInt[r] = static_cast<long long>(value);
+        break;
+    case ATTYPE_DOUBLE:
+        cd.pDbl[r] = value;
+        break;
+    default:
+        break;
+    }
+}
+
+void
+ColumnarTable::SetValue(int col, long long row, long long value)
+{
+    if (!this->rowValid(col, row) || (this->IsMapped() && m_bReadOnly))
+    {
+        return;
+    }
+
+    const long long r = row - m_MinPK;
+    ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        {
+            std::stringstream sval;
+            sval << value;
+            const int code = this->encodeString(col, sval.str());
+            if (code >= -1)
+            {
+                cd.pCode[r] = code;
+            }
+        }
+        break;
+    case ATTYPE_INT:
+        cd.pInt[r] = value;
+        break;
+    case ATTYPE_DOUBLE:
+        cd.pDbl[r] = static_cast<double>(value);
+        break;
+    default:
+        break;
+    }
+}
+
+void
+ColumnarTable::SetValue(int col, long long row, std::string value)
+{
+    if (!this->rowValid(col, row) || (this->IsMapped() && m_bReadOnly))
+    {
+        return;
+    }
+
+    const long long r = row - m_MinPK;
+    ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        {
+            const int code = this->encodeString(col, value);
+            if (code >= -1)
+            {
+                cd.pCode[r] = code;
+            }
+        }
+        break;
+    case ATTYPE_INT:
+        cd.pInt[r] = ::strtol(value.c_str(), 0, 10);
+        break;
+    case ATTYPE_DOUBLE:
+        cd.pDbl[r] = ::strtod(value.c_str(), 0);
+        break;
+    default:
+        break;
+    }
+}
+
+double
+ColumnarTable::GetDblValue(int col, long long row)
+{
+    if (!this->rowValid(col, row))
+    {
+        return m_dNodata;
+    }
+
+    const long long r = row - m_MinPK;
+    const ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        return cd.pCode[r] < 0
+                ? m_dNodata
+                : ::strtod(this->GetDictionaryValue(col, cd.pCode[r]).c_str(), 0);
+    case ATTYPE_INT:
+        return static_cast<double>(cd.pInt[r]);
+    case ATTYPE_DOUBLE:
+        return cd.pDbl[r];
+    default:
+        break;
+    }
+
+    return m_dNodata;
+}
+
+long long
+ColumnarTable::GetIntValue(int col, long long row)
+{
+    if (!this->rowValid(col, row))
+    {
+        return m_iNodata;
+    }
+
+    const long long r = row - m_MinPK;
+    const ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        return cd.pCode[r] < 0
+                ? m_iNodata
+                : ::strtol(this->GetDictionaryValue(col, cd.pCode[r]).c_str(), 0, 10);
+    case ATTYPE_INT:
+        return cd.pInt[r];
+    case ATTYPE_DOUBLE:
+        return static_cast<long long>(cd.pDbl[r]);
+    default:
+        break;
+    }
+
+    return m_iNodata;
+}
+
+std::string
+ColumnarTable::GetStrValue(int col, long long row)
+{
+    if (!this->rowValid(col, row))
+    {
+        return m_sNodata;
+    }
+
+    const long long r = row - m_MinPK;
+    const ColumnData& cd = m_vColumns[col];
+    std::stringstream ret;
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        return this->GetDictionaryValue(col, cd.pCode[r]);
+    case ATTYPE_INT:
+        ret << cd.pInt[r];
+        break;
+    case ATTYPE_DOUBLE:
+        ret << cd.pDbl[r];
+        break;
+    default:
+        ret << m_sNodata;
+        break;
+    }
+
+    return ret.str();
+}
+
+bool
+ColumnarTable::GetColumnAsArray(int col, long long startRow, long long numRows, double* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    if (m_vTypes[col] == ATTYPE_STRING)
+    {
+        return AttributeTable::GetColumnAsArray(col, startRow, numRows, buf);
+    }
+
+    // rows outside the table are reported as nodata
+    const long long first = std::max(startRow, m_MinPK);
+    const long long last = std::min(startRow + numRows, m_MinPK + m_iNumRows);
+    std::fill(buf, buf + numRows, m_dNodata);
+    if (first >= last)
+    {
+        return true;
+    }
+
+    double* out = buf + (first - startRow);
+    const ColumnData& cd = m_vColumns[col];
+    if (m_vTypes[col] == ATTYPE_INT)
+    {
+        std::copy(cd.pInt + (first - m_MinPK), cd.pInt + (last - m_MinPK), out);
+    }
+    else
+    {
+        std::copy(cd.pDbl + (first - m_MinPK), cd.pDbl + (last - m_MinPK), out);
+    }
+
+    return true;
+}
+
+bool
+ColumnarTable::GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf)
+{
+    if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    if (m_vTypes[col] == ATTYPE_STRING)
+    {
+        return AttributeTable::GetColumnAsArray(col, startRow, numRows, buf);
+    }
+
+    const long long first = std::max(startRow, m_MinPK);
+    const long long last = std::min(startRow + numRows, m_MinPK + m_iNumRows);
+    std::fill(buf, buf + numRows, m_iNodata);
+    if (first >= last)
+    {
+        return true;
+    }
+
+    long long* out = buf + (first - startRow);
+    const ColumnData& cd = m_vColumns[col];
+    if (m_vTypes[col] == ATTYPE_INT)
+    {
+        std::copy(cd.pInt + (first - m_MinPK), cd.pInt + (last - m_MinPK), out);
+    }
+    else
+    {
+        for (long long r=first - m_MinPK; r < last - m_MinPK; ++r, ++out)
+        {
+            *out = static_cast<long long>(cd.pDbl[r]);
+        }
+    }
+
+    return true;
+}
+
+const void*
+ColumnarTable::GetColumnPointer(int col)
+{
+    if (col < 0 || col >= m_vNames.size() || m_iNumRows == 0)
+    {
+        return nullptr;
+    }
+
+    const ColumnData& cd = m_vColumns[col];
+    switch(m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        return cd.pCode;
+    case ATTYPE_INT:
+        return cd.pInt;
+    case ATTYPE_DOUBLE:
+        return cd.pDbl;
+    default:
+        break;
+    }
+
+    return nullptr;
+}
+
+long long
+ColumnarTable::GetDictionarySize(int col)
+{
+    if (    col < 0 || col >= m_vNames.size()
+        ||  m_vTypes[col] != ATTYPE_STRING
+       )
+    {
+        return 0;
+    }
+
+    const ColumnData& cd = m_vColumns[col];
+    return this->IsMapped() ? cd.dictCount : cd.vDict.size();
+}
+
+std::string
+ColumnarTable::GetDictionaryValue(int col, int code)
+{
+    if (code < 0 || code >= this->GetDictionarySize(col))
+    {
+        return m_sNodata;
+    }
+
+    const ColumnData& cd = m_vColumns[col];
+    if (this->IsMapped())
+    {
+        return std::string(cd.pDictChars + cd.pDictOffsets[code],
+                           cd.pDictOffsets[code+1] - cd.pDictOffsets[code]);
+    }
+
+    return cd.vDict[code];
+}
+
+int
+ColumnarTable::GetDictionaryCode(int col, const std::string& value)
+{
+    const long long dictSize = this->GetDictionarySize(col);
+    if (dictSize == 0)
+    {
+        return -1;
+    }
+
+    // tables built in memory and writable mapped tables
+    // maintain a dictionary index ...
+    const ColumnData& cd = m_vColumns[col];
+    if (!cd.mDictIndex.empty())
+    {
+        std::unordered_map<std::string, int>::const_iterator it =
+                cd.mDictIndex.find(value);
+        return it != cd.mDictIndex.end() ? it->second : -1;
+    }
+
+    // ... read-only mapped tables don't, since they
+    // are shared between threads
+    for (int code=0; code < dictSize; ++code)
+    {
+        const long long len = cd.pDictOffsets[code+1] - cd.pDictOffsets[code];
+        if (    len == value.size()
+            &&  ::memcmp(cd.pDictChars + cd.pDictOffsets[code], value.data(), len) == 0
+           )
+        {
+            return code;
+        }
+    }
+
+    return -1;
+}
+
+int
+ColumnarTable::encodeString(int col, const std::string& value)
+{
+    if (value == m_sNodata)
+    {
+        return -1;
+    }
+
+    ColumnData& cd = m_vColumns[col];
+    std::unordered_map<std::string, int>::const_iterator it = cd.mDictIndex.find(value);
+    if (it != cd.mDictIndex.end())
+    {
+        return it->second;
+    }
+
+    // we can't extend the dictionary of mapped tables
+    if (this->IsMapped())
+    {
+        m_lastLogMsg = "'" + value + "' is not in the dictionary of column '"
+                + m_vNames[col] + "'!";
+        return -2;
+    }
+
+    const int code = cd.vDict.size();
+    cd.vDict.push_back(value);
+    cd.mDictIndex.insert(std::pair<std::string, int>(value, code));
+    return code;
+}
+
+long long
+ColumnarTable::GetNumBlocks(void)
+{
+    return (m_iNumRows + m_BlockSize - 1) / m_BlockSize;
+}
+
+bool
+ColumnarTable::GetBlockStatistics(int col, long long block, double& min, double& max)
+{
+    if (    col < 0 || col >= m_vNames.size()
+        ||  block < 0 || block >= this->GetNumBlocks()
+       )
+    {
+        return false;
+    }
+
+    const ColumnData& cd = m_vColumns[col];
+    if (cd.pStats != nullptr)
+    {
+        min = cd.pStats[block * 2];
+        max = cd.pStats[block * 2 + 1];
+        return true;
+    }
+
+    // tables built in memory: compute on the fly
+    const long long first = block * m_BlockSize;
+    const long long last = std::min(first + m_BlockSize, m_iNumRows);
+    min = std::numeric_limits<double>::max();
+    max = -std::numeric_limits<double>::max();
+    bool bValid = false;
+    for (long long r=first; r < last; ++r)
+    {
+        double v;
+        switch(m_vTypes[col])
+        {
+        case ATTYPE_STRING:
+            if (cd.pCode[r] < 0) continue;
+            v = cd.pCode[r];
+            break;
+        case ATTYPE_INT:
+            if (cd.pInt[r] == m_iNodata) continue;
+            v = cd.pInt[r];
+            break;
+        case ATTYPE_DOUBLE:
+            if (cd.pDbl[r] == m_dNodata) continue;
+            v = cd.pDbl[r];
+            break;
+        default:
+            continue;
+        }
+        min = std::min(min, v);
+        max = std::max(max, v);
+        bValid = true;
+    }
+
+    if (!bValid)
+    {
+        min = max = m_dNodata;
+    }
+
+    return true;
+}
+
+void
+ColumnarTable::updateColumnPointers(ColumnData& cd)
+{
+    cd.pInt = cd.vInt.empty() ? nullptr : &cd.vInt[0];
+    cd.pDbl = cd.vDbl.empty() ? nullptr : &cd.vDbl[0];
+    cd.pCode = cd.vCode.empty() ? nullptr : &cd.vCode[0];
+    cd.pDictOffsets = nullptr;
+    cd.pDictChars = nullptr;
+    cd.dictCount = cd.vDict.size();
+    cd.pStats = nullptr;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ---------------------  FILE I/O
+
+std::string
+ColumnarTable::GetColumnarFileName(const std::string& imgFileName, unsigned int band)
+{
+    std::string fn = imgFileName;
+    size_t pos = fn.find_last_of('.');
+    if (pos != std::string::npos && pos > 0)
+    {
+        fn = fn.substr(0, pos);
+    }
+
+    std::stringstream ctab;
+    ctab << fn << "_" << band << ".ctab";
+    return ctab.str();
+}
+
+bool
+ColumnarTable::fetchOwnColumn(void* source, int col, long long minPK,
+                              long long numRows, ColumnData& cd)
+{
+    ColumnarTable* tab = static_cast<ColumnarTable*>(source);
+    const ColumnData& src = tab->m_vColumns[col];
+    switch(tab->m_vTypes[col])
+    {
+    case ATTYPE_STRING:
+        cd.vCode.assign(src.pCode, src.pCode + numRows);
+        cd.vDict.resize(tab->GetDictionarySize(col));
+        for (int code=0; code < cd.vDict.size(); ++code)
+        {
+            cd.vDict[code] = tab->GetDictionaryValue(col, code);
+        }
+        break;
+    case ATTYPE_INT:
+        cd.vInt.assign(src.pInt, src.pInt + numRows);
+        break;
+    case ATTYPE_DOUBLE:
+        cd.vDbl.assign(src.pDbl, src.pDbl + numRows);
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ColumnarTable::fetchTableColumn(void* source, int col, long long minPK,
+                                long long numRows, ColumnData& cd)
+{
+    AttributeTable* tab = static_cast<AttributeTable*>(source);
+    if (numRows == 0)
+    {
+        return true;
+    }
+
+    switch(tab->GetColumnType(col))
+    {
+    case ATTYPE_STRING:
+        {
+            std::vector<std::string> vals;
+            if (!tab->GetColumnAsArray(col, minPK, numRows, vals))
+            {
+                return false;
+            }
+
+            const std::string nodata = tab->GetStrNodata();
+            cd.vCode.resize(numRows);
+            for (long long r=0; r < numRows; ++r)
+            {
+                if (vals[r] == nodata)
+                {
+                    cd.vCode[r] = -1;
+                    continue;
+                }
+
+                std::unordered_map<std::string, int>::const_iterator it =
+                        cd.mDictIndex.find(vals[r]);
+                if (it != cd.mDictIndex.end())
+                {
+                    cd.vCode[r] = it->second;
+                }
+                else
+                {
+                    const int code = cd.vDict.size();
+                    cd.vDict.push_back(vals[r]);
+                    cd.mDictIndex.insert(std::pair<std::string, int>(vals[r], code));
+                    cd.vCode[r] = code;
+                }
+            }
+        }
+        break;
+    case ATTYPE_INT:
+        cd.vInt.resize(numRows);
+        return tab->GetColumnAsArray(col, minPK, numRows, &cd.vInt[0]);
+    case ATTYPE_DOUBLE:
+        cd.vDbl.resize(numRows);
+        return tab->GetColumnAsArray(col, minPK, numRows, &cd.vDbl[0]);
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ColumnarTable::writeColumnarFile(const std::string& fileName,
+                                 const std::vector<std::string>& names,
+                                 const std::vector<TableColumnType>& types,
+                                 const std::string& pkName,
+                                 long long numRows, long long minPK,
+                                 long long blockSize,
+                                 double dNodata, long long iNodata,
+                                 ColumnFetchFunc fetch, void* source,
+                                 std::string& errMsg)
+{
+    // we write into a temp file first, so tables mapped by
+    // other processes aren't pulled from under their feet
+    const std::string tmpName = fileName + ".tmp";
+    std::ofstream ofs(tmpName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!ofs.is_open())
+    {
+        errMsg = "Failed creating '" + tmpName + "'!";
+        return false;
+    }
+
+    const int ncols = names.size();
+    CTabHeader hdr;
+    ::memset(&hdr, 0, sizeof(CTabHeader));
+    ::memcpy(hdr.magic, CTAB_MAGIC, sizeof(CTAB_MAGIC));
+    hdr.version = CTAB_VERSION;
+    hdr.numCols = ncols;
+    hdr.numRows = numRows;
+    hdr.minPK = minPK;
+    hdr.blockSize = blockSize;
+    hdr.dNodata = dNodata;
+    hdr.iNodata = iNodata;
+
+    std::vector<CTabColumnEntry> dir(ncols);
+
+    // reserve space for header and directory; we fill them in at the end
+    std::vector<char> placeholder(align8(sizeof(CTabHeader) + ncols * sizeof(CTabColumnEntry)), 0);
+    ofs.write(&placeholder[0], placeholder.size());
+
+    // names
+    hdr.pkNameOffset = ofs.tellp();
+    hdr.pkNameLength = pkName.size();
+    ofs.write(pkName.data(), pkName.size());
+    writePadding(ofs);
+    for (int c=0; c < ncols; ++c)
+    {
+        dir[c].type = types[c];
+        dir[c].nameOffset = ofs.tellp();
+        dir[c].nameLength = names[c].size();
+        ofs.write(names[c].data(), names[c].size());
+        writePadding(ofs);
+    }
+
+    // column data, dictionaries, and block statistics
+    const long long nblocks = (numRows + blockSize - 1) / blockSize;
+    for (int c=0; c < ncols && ofs.good(); ++c)
+    {
+        ColumnData cd;
+        if (!fetch(source, c, minPK, numRows, cd))
+        {
+            errMsg = "Failed fetching the data of column '" + names[c] + "'!";
+            ofs.close();
+            std::remove(tmpName.c_str());
+            return false;
+        }
+
+        std::vector<double> stats(nblocks * 2, dNodata);
+        for (long long b=0; b < nblocks; ++b)
+        {
+            double min = std::numeric_limits<double>::max();
+            double max = -std::numeric_limits<double>::max();
+            bool bValid = false;
+            const long long last = std::min((b+1) * blockSize, numRows);
+            for (long long r=b * blockSize; r < last; ++r)
+            {
+                double v;
+                switch(types[c])
+                {
+                case ATTYPE_STRING:
+                    if (cd.vCode[r] < 0) continue;
+                    v = cd.vCode[r];
+                    break;
+                case ATTYPE_INT:
+                    if (cd.vInt[r] == iNodata) continue;
+                    v = cd.vInt[r];
+                    break;
+                default:
+                    if (cd.vDbl[r] == dNodata) continue;
+                    v = cd.vDbl[r];
+                    break;
+                }
+                min = std::min(min, v);
+                max = std::max(max, v);
+                bValid = true;
+            }
+
+            if (bValid)
+            {
+                stats[b*2] = min;
+                stats[b*2+1] = max;
+            }
+        }
+
+        dir[c].dataOffset = ofs.tellp();
+        switch(types[c])
+        {
+        case ATTYPE_STRING:
+            {
+                ofs.write(reinterpret_cast<const char*>(cd.vCode.data()),
+                          numRows * sizeof(int32_t));
+                writePadding(ofs);
+
+                std::vector<int64_t> offsets(cd.vDict.size() + 1, 0);
+                for (int d=0; d < cd.vDict.size(); ++d)
+                {
+                    offsets[d+1] = offsets[d] + cd.vDict[d].size();
+                }
+                dir[c].dictOffset = ofs.tellp();
+                dir[c].dictCount = cd.vDict.size();
+                ofs.write(reinterpret_cast<const char*>(&offsets[0]),
+                          offsets.size() * sizeof(int64_t));
+                for (int d=0; d < cd.vDict.size(); ++d)
+                {
+                    ofs.write(cd.vDict[d].data(), cd.vDict[d].size());
+                }
+                writePadding(ofs);
+            }
+            break;
+        case ATTYPE_INT:
+            ofs.write(reinterpret_cast<const char*>(cd.vInt.data()),
+                      numRows * sizeof(int64_t));
+            break;
+        default:
+            ofs.write(reinterpret_cast<const char*>(cd.vDbl.data()),
+                      numRows * sizeof(double));
+            break;
+        }
+
+        dir[c].statsOffset = ofs.tellp();
+        ofs.write(reinterpret_cast<const char*>(stats.data()),
+                  stats.size() * sizeof(double));
+    }
+
+    // header and directory
+    ofs.seekp(0);
+    ofs.write(reinterpret_cast<const char*>(&hdr), sizeof(CTabHeader));
+    if (ncols)
+    {
+        ofs.write(reinterpret_cast<const char*>(&dir[0]), ncols * sizeof(CTabColumnEntry));
+    }
+
+    const bool bOK = ofs.good();
+    ofs.close();
+    if (!bOK)
+    {
+        errMsg = "Failed writing '" + tmpName + "'!";
+        std::remove(tmpName.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(fileName.c_str());
+#endif
+    if (std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        errMsg = "Failed renaming '" + tmpName + "' to '" + fileName + "'!";
+        std::remove(tmpName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ColumnarTable::WriteTable(const std::string& fileName)
+{
+    if (fileName.empty())
+    {
+        return false;
+    }
+
+    std::string errMsg;
+    if (!writeColumnarFile(fileName, m_vNames, m_vTypes, m_idColName,
+                           m_iNumRows, m_MinPK, m_BlockSize,
+                           m_dNodata, m_iNodata,
+                           &ColumnarTable::fetchOwnColumn, this, errMsg))
+    {
+        m_lastLogMsg = errMsg;
+        NMProcErr(<< _ctxotbtab << ": " << errMsg);
+        return false;
+    }
+
+    return true;
+}
+
+bool
+ColumnarTable::OpenTable(const std::string& fileName, bool bReadOnly)
+{
+    this->CloseTable();
+
+    std::string errMsg;
+    std::shared_ptr<ColumnarTableMapping> mapping =
+            ColumnarTableMapping::Get(fileName, !bReadOnly, errMsg);
+    if (mapping.get() == nullptr)
+    {
+        m_lastLogMsg = errMsg;
+        return false;
+    }
+
+    char* data = mapping->GetData();
+    const long long size = mapping->GetSize();
+
+    // validate header and directory
+    if (size < sizeof(CTabHeader))
+    {
+        m_lastLogMsg = "'" + fileName + "' is not a columnar table!";
+        return false;
+    }
+
+    const CTabHeader* hdr = reinterpret_cast<const CTabHeader*>(data);
+    if (    ::memcmp(hdr->magic, CTAB_MAGIC, sizeof(CTAB_MAGIC)) != 0
+        ||  hdr->version != CTAB_VERSION
+        ||  hdr->numCols < 0 || hdr->numRows < 0 || hdr->blockSize <= 0
+        ||  size < sizeof(CTabHeader) + hdr->numCols * sizeof(CTabColumnEntry)
+        ||  hdr->pkNameOffset + hdr->pkNameLength > size
+       )
+    {
+        m_lastLogMsg = "'" + fileName + "' is not a valid columnar table!";
+        return false;
+    }
+
+    const long long nrows = hdr->numRows;
+    const long long nblocks = (nrows + hdr->blockSize - 1) / hdr->blockSize;
+    const CTabColumnEntry* dir = reinterpret_cast<const CTabColumnEntry*>(
+                data + sizeof(CTabHeader));
+
+    std::vector<ColumnData> columns(hdr->numCols);
+    std::vector<std::string> names(hdr->numCols);
+    std::vector<TableColumnType> types(hdr->numCols);
+    for (int c=0; c < hdr->numCols; ++c)
+    {
+        const CTabColumnEntry& e = dir[c];
+        long long elemSize = 0;
+        switch(e.type)
+        {
+        case ATTYPE_STRING: elemSize = sizeof(int32_t); break;
+        case ATTYPE_INT:    elemSize = sizeof(int64_t); break;
+        case ATTYPE_DOUBLE: elemSize = sizeof(double); break;
+        default: break;
+        }
+
+        bool bValid =       elemSize > 0
+                        &&  e.nameOffset + e.nameLength <= size
+                        &&  e.dataOffset + nrows * elemSize <= size
+                        &&  e.statsOffset + nblocks * 2 * sizeof(double) <= size;
+        if (bValid && e.type == ATTYPE_STRING)
+        {
+            bValid =    e.dictCount >= 0
+                     && e.dictOffset + (e.dictCount + 1) * sizeof(int64_t) <= size;
+            if (bValid)
+            {
+                const int64_t* offsets = reinterpret_cast<const int64_t*>(data + e.dictOffset);
+                bValid = e.dictOffset + (e.dictCount + 1) * sizeof(int64_t)
+                            + offsets[e.dictCount] <= size;
+            }
+        }
+
+        if (!bValid)
+        {
+            m_lastLogMsg = "'" + fileName + "' is corrupt!";
+            return false;
+        }
+
+        names[c] = std::string(data + e.nameOffset, e.nameLength);
+        types[c] = static_cast<TableColumnType>(e.type);
+
+        ColumnData& cd = columns[c];
+        cd.pStats = reinterpret_cast<const double*>(data + e.statsOffset);
+        switch(e.type)
+        {
+        case ATTYPE_STRING:
+            cd.pCode = reinterpret_cast<int*>(data + e.dataOffset);
+            cd.pDictOffsets = reinterpret_cast<const long long*>(data + e.dictOffset);
+            cd.pDictChars = data + e.dictOffset + (e.dictCount + 1) * sizeof(int64_t);
+            cd.dictCount = e.dictCount;
+            break;
+        case ATTYPE_INT:
+            cd.pInt = reinterpret_cast<long long*>(data + e.dataOffset);
+            break;
+        default:
+            cd.pDbl = reinterpret_cast<double*>(data + e.dataOffset);
+            break;
+        }
+    }
+
+    m_Mapping = mapping;
+    m_FileName = fileName;
+    m_bReadOnly = bReadOnly;
+    m_vColumns.swap(columns);
+    m_vNames.swap(names);
+    m_vTypes.swap(types);
+    m_iNumRows = nrows;
+    m_MinPK = hdr->minPK;
+    m_BlockSize = hdr->blockSize;
+    m_dNodata = hdr->dNodata;
+    m_iNodata = hdr->iNodata;
+    m_idColName = std::string(data + hdr->pkNameOffset, hdr->pkNameLength);
+
+    // mapped tables are shared between threads, so we build the
+    // column name index up front rather than lazily in ColumnExists
+    m_mNameIndex.clear();
+    for (int c=0; c < m_vNames.size(); ++c)
+    {
+        m_mNameIndex.insert(std::pair<std::string, int>(m_vNames[c], c));
+    }
+
+    // writable tables need to look up the code of new string values
+    if (!m_bReadOnly)
+    {
+        for (int c=0; c < m_vColumns.size(); ++c)
+        {
+            ColumnData& cd = m_vColumns[c];
+            for (int code=0; code < cd.dictCount; ++code)
+            {
+                cd.mDictIndex.insert(std::pair<std::string, int>(
+                                         this->GetDictionaryValue(c, code), code));
+            }
+        }
+    }
+
+    return true;
+}
+
+void
+ColumnarTable::CloseTable(void)
+{
+    m_vColumns.clear();
+    m_vNames.clear();
+    m_vTypes.clear();
+    m_iNumRows = 0;
+    m_MinPK = 0;
+    m_BlockSize = CTAB_DEFAULT_BLOCKSIZE;
+    m_FileName.clear();
+    m_Mapping.reset();
+}
+
+ColumnarTable::Pointer
+ColumnarTable::ImportTable(AttributeTable* tab, const std::string& fileName)
+{
+    if (tab == nullptr || fileName.empty())
+    {
+        return nullptr;
+    }
+
+    const long long minPK = tab->GetMinPKValue();
+    const long long maxPK = tab->GetMaxPKValue();
+    const long long nrows = tab->GetNumRows() > 0 && maxPK >= minPK
+            ? maxPK - minPK + 1 : 0;
+
+    std::vector<std::string> names;
+    std::vector<TableColumnType> types;
+    for (int c=0; c < tab->GetNumCols(); ++c)
+    {
+        names.push_back(tab->GetColumnName(c));
+        types.push_back(tab->GetColumnType(c));
+    }
+
+    std::string errMsg;
+    if (!writeColumnarFile(fileName, names, types, tab->GetPrimaryKey(),
+                           nrows, minPK, CTAB_DEFAULT_BLOCKSIZE,
+                           tab->GetDblNodata(), tab->GetIntNodata(),
+                           &ColumnarTable::fetchTableColumn, tab, errMsg))
+    {
+        NMErr(_ctxotbtab, << errMsg);
+        return nullptr;
+    }
+
+    ColumnarTable::Pointer ctab = ColumnarTable::New();
+    if (!ctab->OpenTable(fileName))
+    {
+        NMErr(_ctxotbtab, << ctab->getLastLogMsg());
+        return nullptr;
+    }
+    ctab->SetBandNumber(tab->GetBandNumber());
+    ctab->SetImgFileName(tab->GetImgFileName());
+
+    return ctab;
+}
+
+bool
+ColumnarTable::ExportToSQLite(const std::string& dbFileName, const std::string& tag)
+{
+    SQLiteTable::Pointer sqlTab = SQLiteTable::New();
+    SQLiteTable::TableCreateStatus status = sqlTab->CreateTable(dbFileName, tag);
+    if (status != SQLiteTable::ATCREATE_CREATED)
+    {
+        m_lastLogMsg = status == SQLiteTable::ATCREATE_ERROR
+                ? sqlTab->getLastLogMsg()
+                : "Table '" + sqlTab->GetTableName() + "' already exists!";
+        NMProcErr(<< _ctxotbtab << ": " << m_lastLogMsg);
+        return false;
+    }
+
+    // the primary key is derived from the row, any
+    // other column is copied
+    const std::string pk = sqlTab->GetPrimaryKey();
+    std::vector<std::string> setNames(1, pk);
+    std::vector<int> srcCols;
+    for (int c=0; c < m_vNames.size(); ++c)
+    {
+        if (m_vNames[c] == pk || m_vNames[c] == m_idColName)
+        {
+            continue;
+        }
+
+        if (!sqlTab->AddColumn(m_vNames[c], m_vTypes[c]))
+        {
+            m_lastLogMsg = sqlTab->getLastLogMsg();
+            NMProcErr(<< _ctxotbtab << ": Failed adding column '" << m_vNames[c] << "'!");
+            return false;
+        }
+        setNames.push_back(m_vNames[c]);
+        srcCols.push_back(c);
+    }
+
+    if (!sqlTab->PrepareBulkSet(setNames, true))
+    {
+        m_lastLogMsg = sqlTab->getLastLogMsg();
+        return false;
+    }
+
+    std::vector<ColumnValue> values(setNames.size());
+    std::vector<std::string> strVals(srcCols.size());
+    values[0].type = ATTYPE_INT;
+    for (int k=0; k < srcCols.size(); ++k)
+    {
+        values[k+1].type = m_vTypes[srcCols[k]];
+    }
+
+    bool bOK = sqlTab->BeginTransaction();
+    for (long long r=0; r < m_iNumRows && bOK; ++r)
+    {
+        values[0].ival = m_MinPK + r;
+        for (int k=0; k < srcCols.size(); ++k)
+        {
+            const ColumnData& cd = m_vColumns[srcCols[k]];
+            switch(m_vTypes[srcCols[k]])
+            {
+            case ATTYPE_INT:
+                values[k+1].ival = cd.pInt[r];
+                break;
+            case ATTYPE_DOUBLE:
+                values[k+1].dval = cd.pDbl[r];
+                break;
+            default:
+                // slen stays 0, so ColumnValue won't delete the string
+                strVals[k] = this->GetDictionaryValue(srcCols[k], cd.pCode[r]);
+                values[k+1].tval = const_cast<char*>(strVals[k].c_str());
+                break;
+            }
+        }
+        bOK = sqlTab->DoBulkSet(values);
+    }
+
+    sqlTab->EndTransaction();
+    if (!bOK)
+    {
+        m_lastLogMsg = sqlTab->getLastLogMsg();
+        NMProcErr(<< _ctxotbtab << ": Failed exporting the table to '"
+                  << dbFileName << "'!");
+    }
+    sqlTab->CloseTable();
+
+    return bOK;
+}
+
+ColumnarTable::ColumnarTable()
+    : m_MinPK(0),
+      m_BlockSize(CTAB_DEFAULT_BLOCKSIZE),
+      m_bReadOnly(true)
+{
+    this->m_ATType = ATTABLE_TYPE_COLUMNAR;
+}
+
+ColumnarTable::~ColumnarTable()
+{
+    this->CloseTable();
+}
+
+} // end of namespace otb
@@ -0,0 +1,238 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2010-2015 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#ifndef COLUMNARTABLE_H_
+#define COLUMNARTABLE_H_
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include "otbAttributeTable.h"
+#include "itkObject.h"
+#include "itkDataObject.h"
+#include "itkObjectFactory.h"
+
+#include "nmotbsupplcore_export.h"
+
+namespace otb
+{
+
+class ColumnarTableMapping;
+
+/** \brief Attribute table storing each column as contiguous,
+ *         typed array, optionally memory-mapped from file.
+ *
+ *  A ColumnarTable is either built in memory (AddColumn, AddRows,
+ *  SetValue, ...) and then saved with WriteTable(), or opened from
+ *  a columnar table file (*.ctab) with OpenTable(). Opened tables
+ *  are memory-mapped, i.e. their data are not copied but paged in
+ *  by the OS on demand, and the mapping is shared by all table
+ *  objects (threads) of the process opening the same file (and
+ *  by the page cache with other processes).
+ *
+ *  Integer columns are stored as int64, double columns as double,
+ *  and string columns are dictionary encoded, i.e. as int32 codes
+ *  into a table of unique strings (code -1 denotes nodata). For
+ *  each column and block of GetBlockSize() rows, the min and max
+ *  value (code) is stored, so that range queries can skip blocks.
+ *
+ *  Rows are addressed by primary key values GetMinPKValue() to
+ *  GetMaxPKValue(), i.e. rows are dense and contiguous; tables
+ *  imported from a SQLiteTable (ImportTable) take over the
+ *  primary key range of the source table.
+ *
+ *  Mapped tables are read-only, unless opened with bReadOnly=false,
+ *  in which case numeric cells and string cells (using strings
+ *  already present in the column's dictionary) can be updated
+ *  in place; the table's structure (columns, rows) can't be
+ *  changed once it's mapped.
+ *
+ *  File layout (native byte order, 8-byte aligned sections):
+ *      header:     magic "NMCTAB", version, #columns, #rows,
+ *                  min PK value, block size, primary key column
+ *      directory:  one entry per column (type, name, offsets of
+ *                  the data, dictionary, and block statistics)
+ *      sections:   names, column data, dictionaries, statistics
+ */
+class NMOTBSUPPLCORE_EXPORT ColumnarTable : public AttributeTable
+{
+public:
+    /** Standard class typedefs. */
+    typedef ColumnarTable                   Self;
+    typedef itk::DataObject                 Superclass;
+    typedef itk::SmartPointer<Self>         Pointer;
+    typedef itk::SmartPointer<const Self>   ConstPointer;
+
+    itkNewMacro(Self);
+    itkTypeMacro(ColumnarTable, Superclass);
+
+    long long GetRowIdx(const std::string& column, void* value);
+
+    // managing the attribute table's content
+    bool AddColumn(const std::string& sColName, TableColumnType type);
+    bool AddRows(long long numRows);
+    void SetValue(const std::string& sColName, long long idx, double value);
+    void SetValue(const std::string& sColName, long long idx, long long value);
+    void SetValue(const std::string& sColName, long long idx, std::string value);
+    double GetDblValue(const std::string& sColName, long long idx);
+    long long GetIntValue(const std::string& sColName, long long idx);
+    std::string GetStrValue(const std::string& sColName, long long idx);
+
+    void SetValue(int col, long long row, double value);
+    void SetValue(int col, long long row, long long value);
+    void SetValue(int col, long long row, std::string value);
+
+    void SetColumnName(int col, const std::string& name);
+
+    double GetDblValue(int col, long long row);
+    long long GetIntValue(int col, long long row);
+    std::string GetStrValue(int col, long long row);
+
+    long long GetMinPKValue();
+    long long GetMaxPKValue();
+
+    /*! sets the primary key value of the first row;
+     *  only for tables not mapped from file */
+    void SetMinPKValue(long long minPK);
+
+    bool RemoveColumn(int col);
+    bool RemoveColumn(const std::string& name);
+
+    using AttributeTable::GetColumnAsArray;
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, double* buf);
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf);
+
+    /*! Zero-copy access to a column's data: returns a pointer to
+     *  the int64 (ATTYPE_INT), double (ATTYPE_DOUBLE), or int32
+     *  dictionary codes (ATTYPE_STRING) of the first row */
+    const void* GetColumnPointer(int col);
+
+    /*! string column dictionary */
+    long long GetDictionarySize(int col);
+    std::string GetDictionaryValue(int col, int code);
+    /*! returns -1 if value is not in the dictionary */
+    int GetDictionaryCode(int col, const std::string& value);
+
+    /*! number of rows summarised by one set of block statistics */
+    long long GetBlockSize(void) {return m_BlockSize;}
+    long long GetNumBlocks(void);
+
+    /*! min and max (non-nodata) value (or dictionary code) of the
+     *  given block of rows; both are nodata if the block doesn't
+     *  hold any valid value */
+    bool GetBlockStatistics(int col, long long block, double& min, double& max);
+
+    /// FILE I/O
+    /*! writes the table into a columnar table file */
+    bool WriteTable(const std::string& fileName);
+
+    /*! maps the given columnar table file; any previous content of
+     *  this table is discarded */
+    bool OpenTable(const std::string& fileName, bool bReadOnly=true);
+    void CloseTable(void);
+
+    bool IsMapped(void) {return m_Mapping.get() != nullptr;}
+    std::string GetFileName(void) {return m_FileName;}
+    std::string getLastLogMsg(void) {return m_lastLogMsg;}
+
+    /*! Writes the content of the given table into a columnar table
+     *  file, one column at a time, and opens (maps) the file;
+     *  returns nullptr on error */
+    static Pointer ImportTable(AttributeTable* tab, const std::string& fileName);
+
+    /*! Writes the content of this table into a (new) table of the
+     *  given SQLite database (*.ldb); the table is named after the
+     *  db file's base name followed by '_tag' (s. SQLiteTable::CreateTable) */
+    bool ExportToSQLite(const std::string& dbFileName, const std::string& tag="1");
+
+    /*! file name of the columnar table for the given image and band,
+     *  i.e. <image base name>_<band>.ctab */
+    static std::string GetColumnarFileName(const std::string& imgFileName,
+                                           unsigned int band);
+
+protected:
+    ColumnarTable();
+    virtual
+    ~ColumnarTable();
+
+    /*! Per column storage: tables built in memory keep their data in
+     *  the vectors; the pointers refer to the vectors or into the
+     *  mapped file, and are what the accessors use.
+     */
+    typedef struct _ColumnData
+    {
+        _ColumnData()
+            : pInt(nullptr), pDbl(nullptr), pCode(nullptr),
+              pDictOffsets(nullptr), pDictChars(nullptr),
+              dictCount(0), pStats(nullptr)
+        {}
+
+        std::vector<long long> vInt;
+        std::vector<double> vDbl;
+        std::vector<int> vCode;
+        std::vector<std::string> vDict;
+        std::unordered_map<std::string, int> mDictIndex;
+
+        long long* pInt;
+        double* pDbl;
+        int* pCode;
+
+        const long long* pDictOffsets;
+        const char* pDictChars;
+        long long dictCount;
+
+        const double* pStats;
+    } ColumnData;
+
+    void updateColumnPointers(ColumnData& cd);
+    int encodeString(int col, const std::string& value);
+    bool rowValid(int col, long long row);
+
+    typedef bool (*ColumnFetchFunc)(void* source, int col, long long minPK,
+                                    long long numRows, ColumnData& cd);
+
+    /*! writes a columnar table file; the column data are
+     *  provided one column at a time by the fetch function */
+    static bool writeColumnarFile(const std::string& fileName,
+                                  const std::vector<std::string>& names,
+                                  const std::vector<TableColumnType>& types,
+                                  const std::string& pkName,
+                                  long long numRows, long long minPK,
+                                  long long blockSize,
+                                  double dNodata, long long iNodata,
+                                  ColumnFetchFunc fetch, void* source,
+                                  std::string& errMsg);
+
+    static bool fetchOwnColumn(void* source, int col, long long minPK,
+                               long long numRows, ColumnData& cd);
+    static bool fetchTableColumn(void* source, int col, long long minPK,
+                                 long long numRows, ColumnData& cd);
+
+    std::vector<ColumnData> m_vColumns;
+    std::shared_ptr<ColumnarTableMapping> m_Mapping;
+    std::string m_FileName;
+    std::string m_lastLogMsg;
+    long long m_MinPK;
+    long long m_BlockSize;
+    bool m_bReadOnly;
+};
+
+}
+
+#endif /* COLUMNARTABLE_H_ */
@@ -172,6 +172,10 @@ public:
    * enlarge the RequestedRegion to the size of the image on disk. */
   virtual void EnlargeOutputRequestedRegion(itk::DataObject *output);
 
+  /** Releases the conversion buffer (m_LoadBuffer), which
+   *  is otherwise only released after the last division */
+  virtual void ResetPipeline();
+
 protected:
   NMImageReader();
   virtual ~NMImageReader();
@@ -186,6 +190,28 @@ protected:
   void DoNMConvertBuffer(void* buffer, size_t numberOfPixels);
 #endif
 
+  /** The component type of the output image as ImageIO component type;
+   *  UNKNOWNCOMPONENTTYPE if there is no corresponding type */
+  static ImageIOBase::IOComponentType GetOutputIOComponentType(void);
+
+  /** Whether every value of component type 'from' is represented
+   *  exactly by component type 'to' (identical or widening types) */
+  static bool IsValuePreservingConversion(ImageIOBase::IOComponentType from,
+                                          ImageIOBase::IOComponentType to);
+
+  /** Lets the ImageIO (GDALRATImageIO, NetCDFIO) convert the pixel
+   *  values into the output component type while reading; returns
+   *  false, if the ImageIO doesn't support the conversion or if it
+   *  is a narrowing one, which is left to DoConvertBuffer (netCDF
+   *  refuses out of range values (NC_ERANGE) and GDAL rounds and
+   *  clamps, whereas DoConvertBuffer truncates) */
+  bool ReadWithIOConversion(OutputImagePixelType* buffer);
+
+  /** file type buffer reused across stream divisions for type
+   *  conversions not supported by the ImageIO; released after
+   *  the last division (s. GenerateData, ResetPipeline) */
+  std::vector<char> m_LoadBuffer;
+
   unsigned int m_DatasetNumber;
 
   AttributeTable::Pointer m_RAT;
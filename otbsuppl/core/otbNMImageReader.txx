@@ -63,6 +63,7 @@
 
 #include <itksys/SystemTools.hxx>
 #include <fstream>
+#include <typeinfo>
 
 namespace otb
 {
@@ -227,6 +228,14 @@ NMImageReader<TOutputImage>
         this->GetImageIO()->Read(buffer);
         return;
     }
+    else if (   this->GetImageIO()->GetNumberOfComponents()
+                    == ConvertIOPixelTraits::GetNumberOfComponents()
+             && this->ReadWithIOConversion(buffer)
+            )
+    {
+        // the ImageIO has converted the values while reading
+        return;
+    }
     else // a type conversion is necessary
     {
         // note: char is used here because the buffer is read in bytes
@@ -237,7 +246,12 @@ NMImageReader<TOutputImage>
         std::streamoff nbBytes = (this->GetImageIO()->GetComponentSize() * this->GetImageIO()->GetNumberOfComponents())
                 * static_cast<std::streamoff>(region.GetNumberOfPixels());
 
-        char * loadBuffer = new char[nbBytes];
+        // we keep the buffer for subsequent stream divisions, ...
+        if (static_cast<std::streamoff>(m_LoadBuffer.size()) < nbBytes)
+        {
+            m_LoadBuffer.resize(nbBytes);
+        }
+        char * loadBuffer = &m_LoadBuffer[0];
 
         otbMsgDevMacro(<< "size of Buffer to RasdamanImageIO::read = " << nbBytes << " = \n"
                        << "ComponentSize ("<< this->GetImageIO()->GetComponentSize() << ") x " \
@@ -251,8 +265,184 @@ NMImageReader<TOutputImage>
 #else
         this->DoConvertBuffer(loadBuffer, region.GetNumberOfPixels());
 #endif
-        delete[] loadBuffer;
+
+        // ... but not beyond the last one, i.e. the one
+        // reaching the end of the largest possible region
+        const ImageRegionType& lpr = output->GetLargestPossibleRegion();
+        bool bLastDivision = true;
+        for (unsigned int d=0; d < TOutputImage::ImageDimension; ++d)
+        {
+            if (    region.GetIndex(d) + static_cast<itk::OffsetValueType>(region.GetSize(d))
+                 <  lpr.GetIndex(d) + static_cast<itk::OffsetValueType>(lpr.GetSize(d))
+               )
+            {
+                bLastDivision = false;
+                break;
+            }
+        }
+
+        if (bLastDivision)
+        {
+            std::vector<char>().swap(m_LoadBuffer);
+        }
+    }
+}
+
+template <class TOutputImage>
+void
+NMImageReader<TOutputImage>
+::ResetPipeline()
+{
+    // an aborted update doesn't get to the last division
+    std::vector<char>().swap(m_LoadBuffer);
+    Superclass::ResetPipeline();
+}
+
+template <class TOutputImage>
+ImageIOBase::IOComponentType
+NMImageReader<TOutputImage>
+::GetOutputIOComponentType(void)
+{
+    typedef itk::DefaultConvertPixelTraits<typename TOutputImage::PixelType> ConvertPixelTraits;
+    const std::type_info& compType = typeid(typename ConvertPixelTraits::ComponentType);
+
+    if (compType == typeid(unsigned char))       return ImageIOBase::UCHAR;
+    else if (compType == typeid(char))           return ImageIOBase::CHAR;
+    else if (compType == typeid(unsigned short)) return ImageIOBase::USHORT;
+    else if (compType == typeid(short))          return ImageIOBase::SHORT;
+    else if (compType == typeid(unsigned int))   return ImageIOBase::UINT;
+    else if (compType == typeid(int))            return ImageIOBase::INT;
+    else if (compType == typeid(unsigned long))  return ImageIOBase::ULONG;
+    else if (compType == typeid(long))           return ImageIOBase::LONG;
+#if defined(_WIN32) && SIZEOF_LONGLONG >= 8
+    else if (compType == typeid(unsigned long long)) return ImageIOBase::ULONGLONG;
+    else if (compType == typeid(long long))          return ImageIOBase::LONGLONG;
+#endif
+    else if (compType == typeid(float))          return ImageIOBase::FLOAT;
+    else if (compType == typeid(double))         return ImageIOBase::DOUBLE;
+
+    return ImageIOBase::UNKNOWNCOMPONENTTYPE;
+}
+
+template <class TOutputImage>
+bool
+NMImageReader<TOutputImage>
+::IsValuePreservingConversion(ImageIOBase::IOComponentType from,
+                              ImageIOBase::IOComponentType to)
+{
+    if (from == to)
+    {
+        return true;
     }
+
+    // size in bytes, signedness and 'integerness' of the types
+    struct TypeInfo
+    {
+        int size;
+        bool isSigned;
+        bool isInteger;
+    };
+
+    auto info = [](ImageIOBase::IOComponentType t, TypeInfo& ti) -> bool
+    {
+        switch(t)
+        {
+        case ImageIOBase::UCHAR:     ti = {sizeof(unsigned char), false, true};      break;
+        case ImageIOBase::CHAR:      ti = {sizeof(char), true, true};                break;
+        case ImageIOBase::USHORT:    ti = {sizeof(unsigned short), false, true};     break;
+        case ImageIOBase::SHORT:     ti = {sizeof(short), true, true};               break;
+        case ImageIOBase::UINT:      ti = {sizeof(unsigned int), false, true};       break;
+        case ImageIOBase::INT:       ti = {sizeof(int), true, true};                 break;
+        case ImageIOBase::ULONG:     ti = {sizeof(unsigned long), false, true};      break;
+        case ImageIOBase::LONG:      ti = {sizeof(long), true, true};                break;
+#if defined(_WIN32) && SIZEOF_LONGLONG >= 8
+        case ImageIOBase::ULONGLONG: ti = {sizeof(unsigned long long), false, true}; break;
+        case ImageIOBase::LONGLONG:  ti = {sizeof(long long), true, true};           break;
+#endif
+        case ImageIOBase::FLOAT:     ti = {sizeof(float), true, false};              break;
+        case ImageIOBase::DOUBLE:    ti = {sizeof(double), true, false};             break;
+        default:
+            return false;
+        }
+        return true;
+    };
+
+    TypeInfo fi, ti;
+    if (!info(from, fi) || !info(to, ti))
+    {
+        return false;
+    }
+
+    if (fi.isInteger && ti.isInteger)
+    {
+        if (fi.isSigned)
+        {
+            return ti.isSigned && ti.size >= fi.size;
+        }
+        return ti.isSigned ? ti.size > fi.size : ti.size >= fi.size;
+    }
+    else if (fi.isInteger)
+    {
+        // float holds integers up to 2^24, double up to 2^53
+        return ti.size == sizeof(float) ? fi.size <= 2 : fi.size <= 4;
+    }
+    else if (!ti.isInteger)
+    {
+        return ti.size >= fi.size;
+    }
+
+    return false;
+}
+
+template <class TOutputImage>
+bool
+NMImageReader<TOutputImage>
+::ReadWithIOConversion(OutputImagePixelType* buffer)
+{
+    const ImageIOBase::IOComponentType outType = GetOutputIOComponentType();
+    if (    outType == ImageIOBase::UNKNOWNCOMPONENTTYPE
+         || !IsValuePreservingConversion(this->GetImageIO()->GetComponentType(), outType)
+       )
+    {
+        return false;
+    }
+
+    otb::GDALRATImageIO* gio = dynamic_cast<otb::GDALRATImageIO*>(this->GetImageIO());
+    otb::NetCDFIO* nio = dynamic_cast<otb::NetCDFIO*>(this->GetImageIO());
+    if (gio != nullptr && gio->CanReadAsComponentType(outType))
+    {
+        gio->SetReadComponentType(outType);
+        try
+        {
+            gio->Read(buffer);
+        }
+        catch (...)
+        {
+            // don't leave the ImageIO converting subsequent reads
+            gio->SetReadComponentType(ImageIOBase::UNKNOWNCOMPONENTTYPE);
+            throw;
+        }
+        gio->SetReadComponentType(ImageIOBase::UNKNOWNCOMPONENTTYPE);
+        return true;
+    }
+    else if (nio != nullptr && nio->CanReadAsComponentType(outType))
+    {
+        nio->SetReadComponentType(outType);
+        try
+        {
+            nio->Read(buffer);
+        }
+        catch (...)
+        {
+            // don't leave the ImageIO converting subsequent reads
+            nio->SetReadComponentType(ImageIOBase::UNKNOWNCOMPONENTTYPE);
+            throw;
+        }
+        nio->SetReadComponentType(ImageIOBase::UNKNOWNCOMPONENTTYPE);
+        return true;
+    }
+
+    return false;
 }
 
 
@@ -33,6 +33,95 @@
 namespace otb
 {
 
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ---------------------  RAMStringDictionary
+
+RAMStringDictionary::RAMStringDictionary()
+{
+	m_Offsets.push_back(0);
+	m_Buckets.resize(16, -1);
+}
+
+size_t
+RAMStringDictionary::hash(const char* str, size_t len)
+{
+	// FNV-1a
+	size_t h = static_cast<size_t>(14695981039346656037ull);
+	for (size_t i=0; i < len; ++i)
+	{
+		h ^= static_cast<unsigned char>(str[i]);
+		h *= static_cast<size_t>(1099511628211ull);
+	}
+	return h;
+}
+
+int
+RAMStringDictionary::Find(const char* str, size_t len) const
+{
+	const size_t h = hash(str, len);
+	const size_t mask = m_Buckets.size() - 1;
+	for (size_t b = h & mask; m_Buckets[b] >= 0; b = (b + 1) & mask)
+	{
+		const int code = m_Buckets[b];
+		if (	m_Hashes[code] == h
+			&&	GetLength(code) == len
+			&&	::memcmp(GetValue(code), str, len) == 0
+		   )
+		{
+			return code;
+		}
+	}
+
+	return -1;
+}
+
+int
+RAMStringDictionary::Encode(const char* str, size_t len)
+{
+	int code = this->Find(str, len);
+	if (code >= 0)
+		return code;
+
+	code = this->GetSize();
+	m_Arena.insert(m_Arena.end(), str, str + len);
+	m_Arena.push_back('\0');
+	m_Offsets.push_back(m_Arena.size());
+	m_Hashes.push_back(hash(str, len));
+
+	// keep the load factor below 0.5
+	if (m_Hashes.size() * 2 > m_Buckets.size())
+	{
+		this->rehash(m_Buckets.size() * 2);
+	}
+	else
+	{
+		const size_t mask = m_Buckets.size() - 1;
+		size_t b = m_Hashes[code] & mask;
+		while (m_Buckets[b] >= 0)
+			b = (b + 1) & mask;
+		m_Buckets[b] = code;
+	}
+
+	return code;
+}
+
+void
+RAMStringDictionary::rehash(size_t numBuckets)
+{
+	m_Buckets.assign(numBuckets, -1);
+	const size_t mask = numBuckets - 1;
+	for (int code=0; code < m_Hashes.size(); ++code)
+	{
+		size_t b = m_Hashes[code] & mask;
+		while (m_Buckets[b] >= 0)
+			b = (b + 1) & mask;
+		m_Buckets[b] = code;
+	}
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// ---------------------  RAMTable
+
 // ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // ---------------------  PUBLIC GETTER and SETTER functions to manage the Attribute table
 //int RAMTable::GetNumCols()
@@ -76,7 +165,8 @@ RAMTable::AddColumn(const std::string& sColName, TableColumnType eType)
 	}
 
 
-	std::vector<std::string>* vstr;
+	std::vector<int>* vstr;
+	RAMStringDictionary* vdict;
     std::vector<long long>* vint;
 	std::vector<double>* vdbl;
 	// create a new vector for the column's values
@@ -84,11 +174,13 @@ RAMTable::AddColumn(const std::string& sColName, TableColumnType eType)
 	{
 	case ATTYPE_STRING:
 		try{
-		vstr = new std::vector<std::string>();
-		vstr->resize(m_iNumRows, m_sNodata);
+		vdict = new RAMStringDictionary();
+		vstr = new std::vector<int>();
+		vstr->resize(m_iNumRows, vdict->Encode(m_sNodata.c_str(), m_sNodata.size()));
         } catch (std::exception& e) {NMProcErr(<< _ctxotbtab << ": Failed adding column: " << e.what());return false;}
 
 		this->m_mStringCols.push_back(vstr);
+		this->m_mStringDicts.push_back(vdict);
 		this->m_vPosition.push_back(m_mStringCols.size()-1);
 		break;
 	case ATTYPE_INT:
@@ -133,7 +225,7 @@ bool RAMTable::AddRows(long long numRows)
 		{
 		case ATTYPE_STRING:
 			{
-			m_mStringCols.at(tidx)->resize(m_iNumRows+numRows, m_sNodata);
+			m_mStringCols.at(tidx)->resize(m_iNumRows+numRows, nodataCode(tidx));
 			break;
 			}
 		case ATTYPE_INT:
@@ -170,7 +262,7 @@ bool RAMTable::AddRow()
 		{
 		case ATTYPE_STRING:
 			{
-			m_mStringCols.at(tidx)->push_back(this->m_sNodata);
+			m_mStringCols.at(tidx)->push_back(nodataCode(tidx));
 			break;
 			}
 		case ATTYPE_INT:
@@ -194,6 +286,38 @@ bool RAMTable::AddRow()
 	return true;
 }
 
+bool RAMTable::AddRow(const std::vector<ColumnValue>& values)
+{
+	// check for presence of columns and values
+	if (this->m_vNames.size() == 0 || values.size() != this->m_vNames.size())
+		return false;
+
+	if (!this->AddRow())
+		return false;
+
+	const long long row = this->m_iNumRows - 1;
+	for (int colidx = 0; colidx < this->m_vNames.size(); ++colidx)
+	{
+		const ColumnValue& cv = values[colidx];
+		switch (cv.type)
+		{
+		case ATTYPE_INT:
+			this->SetValue(colidx, row, cv.ival);
+			break;
+		case ATTYPE_DOUBLE:
+			this->SetValue(colidx, row, cv.dval);
+			break;
+		case ATTYPE_STRING:
+			this->SetValue(colidx, row, cv.tval != nullptr ? cv.tval : m_sNodata.c_str());
+			break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
 long long
 RAMTable::GetMinPKValue()
 {
@@ -221,7 +345,8 @@ RAMTable::SetValue(const std::string& sColName, long long idx, double value)
 		{
 			std::stringstream sval;
 			sval << value;
-			this->m_mStringCols.at(tidx)->at(idx) = sval.str();
+			const std::string str = sval.str();
+			this->setStrValue(tidx, idx, str.c_str(), str.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -253,7 +378,8 @@ RAMTable::SetValue(const std::string& sColName, long long idx, long long value)
 		{
 			std::stringstream sval;
 			sval << value;
-			this->m_mStringCols.at(tidx)->at(idx) = sval.str();
+			const std::string str = sval.str();
+			this->setStrValue(tidx, idx, str.c_str(), str.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -284,7 +410,7 @@ RAMTable::SetValue(const std::string& sColName, long long idx, std::string value
 	{
 		case ATTYPE_STRING:
 		{
-			this->m_mStringCols.at(tidx)->at(idx) = value;
+			this->setStrValue(tidx, idx, value.c_str(), value.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -314,7 +440,7 @@ double RAMTable::GetDblValue(const std::string& sColName, long long idx)
 	switch(m_vTypes[colidx])
 	{
 		case ATTYPE_STRING:
-			ret = ::strtod(this->m_mStringCols.at(tidx)->at(idx).c_str(),0);
+			ret = ::strtod(this->getStrValue(tidx, idx),0);
 			break;
 		case ATTYPE_INT:
 			ret = this->m_mIntCols.at(tidx)->at(idx);
@@ -343,7 +469,7 @@ RAMTable::GetIntValue(const std::string& sColName, long long idx)
 	switch(m_vTypes[colidx])
 	{
 		case ATTYPE_STRING:
-			ret = ::strtol(this->m_mStringCols.at(tidx)->at(idx).c_str(),0,10);
+			ret = ::strtol(this->getStrValue(tidx, idx),0,10);
 			break;
 		case ATTYPE_INT:
 			ret = this->m_mIntCols.at(tidx)->at(idx);
@@ -372,7 +498,7 @@ RAMTable::GetStrValue(const std::string& sColName, long long idx)
 	switch(m_vTypes[colidx])
 	{
 		case ATTYPE_STRING:
-			ret << this->m_mStringCols.at(tidx)->at(idx);
+			ret << this->getStrValue(tidx, idx);
 			break;
 		case ATTYPE_INT:
 			ret << this->m_mIntCols.at(tidx)->at(idx);
@@ -418,6 +544,36 @@ RAMTable::GetColumnPointer(int col)
 	return ret;
 }
 
+int
+RAMTable::GetDictionarySize(int col)
+{
+	if (	col < 0 || col >= m_vNames.size()
+		||	m_vTypes[col] != ATTYPE_STRING
+	   )
+		return 0;
+
+	return m_mStringDicts.at(m_vPosition[col])->GetSize();
+}
+
+std::string
+RAMTable::GetDictionaryValue(int col, int code)
+{
+	if (code < 0 || code >= this->GetDictionarySize(col))
+		return m_sNodata;
+
+	const RAMStringDictionary* dict = m_mStringDicts.at(m_vPosition[col]);
+	return std::string(dict->GetValue(code), dict->GetLength(code));
+}
+
+int
+RAMTable::GetDictionaryCode(int col, const std::string& value)
+{
+	if (this->GetDictionarySize(col) == 0)
+		return -1;
+
+	return m_mStringDicts.at(m_vPosition[col])->Find(value.c_str(), value.size());
+}
+
 long long
 RAMTable::GetRowIdx(const std::string& column, void* value)
 {
@@ -431,11 +587,16 @@ RAMTable::GetRowIdx(const std::string& column, void* value)
 	{
 	case ATTYPE_STRING:
 		{
-			std::string* strings = static_cast<std::string*>(GetColumnPointer(colidx));
 			std::string* strVal = static_cast<std::string*>(value);
+			const int code = m_mStringDicts.at(m_vPosition[colidx])->Find(
+						strVal->c_str(), strVal->size());
+			if (code < 0)
+				break;
+
+			int* codes = static_cast<int*>(GetColumnPointer(colidx));
                         for (long long r=0; r < m_iNumRows; ++r)
 			{
-				if (*strVal == strings[r])
+				if (code == codes[r])
 				{
 					idx = r;
 					break;
@@ -539,6 +700,8 @@ RAMTable::RemoveColumn(int col)
 	case ATTYPE_STRING:
 		delete this->m_mStringCols.at(tidx);
 		this->m_mStringCols.erase(this->m_mStringCols.begin()+tidx);
+		delete this->m_mStringDicts.at(tidx);
+		this->m_mStringDicts.erase(this->m_mStringDicts.begin()+tidx);
 		break;
 	default:
 		return false;
@@ -589,7 +752,8 @@ void RAMTable::SetValue(int col, long long row, double value)
 		{
 			std::stringstream sval;
 			sval << value;
-			this->m_mStringCols.at(tidx)->at(row) = sval.str();
+			const std::string str = sval.str();
+			this->setStrValue(tidx, row, str.c_str(), str.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -622,7 +786,8 @@ void RAMTable::SetValue(int col, long long row, long long value)
 		{
 			std::stringstream sval;
 			sval << value;
-			this->m_mStringCols.at(tidx)->at(row) = sval.str();
+			const std::string str = sval.str();
+			this->setStrValue(tidx, row, str.c_str(), str.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -653,7 +818,7 @@ void RAMTable::SetValue(int col, long long row, std::string value)
 	{
 		case ATTYPE_STRING:
 		{
-			this->m_mStringCols.at(tidx)->at(row) = value;
+			this->setStrValue(tidx, row, value.c_str(), value.size());
 			break;
 		}
 		case ATTYPE_INT:
@@ -671,6 +836,37 @@ void RAMTable::SetValue(int col, long long row, std::string value)
 	}
 }
 
+void RAMTable::SetValue(int col, long long row, const char* value)
+{
+	if (col < 0 || col >= m_vNames.size() || value == nullptr)
+		return;
+
+	if (row < 0 || row >= m_iNumRows)
+		return;
+
+	const int& tidx = m_vPosition[col];
+	switch (m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			this->setStrValue(tidx, row, value, ::strlen(value));
+			break;
+		}
+		case ATTYPE_INT:
+		{
+			this->m_mIntCols.at(tidx)->at(row) = ::strtol(value, 0, 10);
+			break;
+		}
+		case ATTYPE_DOUBLE:
+		{
+			this->m_mDoubleCols.at(tidx)->at(row) = ::strtod(value, 0);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
 double RAMTable::GetDblValue(int col, long long row)
 {
 	if (col < 0 || col >= m_vNames.size())
@@ -684,7 +880,7 @@ double RAMTable::GetDblValue(int col, long long row)
 	switch(m_vTypes[col])
 	{
 		case ATTYPE_STRING:
-			ret = ::strtod(this->m_mStringCols.at(tidx)->at(row).c_str(),0);
+			ret = ::strtod(this->getStrValue(tidx, row),0);
 			break;
 		case ATTYPE_INT:
 			ret = this->m_mIntCols.at(tidx)->at(row);
@@ -713,7 +909,7 @@ long long RAMTable::GetIntValue(int col, long long row)
 	switch(m_vTypes[col])
 	{
 		case ATTYPE_STRING:
-			ret = ::strtol(this->m_mStringCols.at(tidx)->at(row).c_str(),0,10);
+			ret = ::strtol(this->getStrValue(tidx, row),0,10);
 			break;
 		case ATTYPE_INT:
 			ret = this->m_mIntCols.at(tidx)->at(row);
@@ -743,7 +939,7 @@ std::string RAMTable::GetStrValue(int col, long long row)
 	switch(m_vTypes[col])
 	{
 		case ATTYPE_STRING:
-			ret << this->m_mStringCols.at(tidx)->at(row);
+			ret << this->getStrValue(tidx, row);
 			break;
 		case ATTYPE_INT:
 			ret << this->m_mIntCols.at(tidx)->at(row);
@@ -761,6 +957,267 @@ std::string RAMTable::GetStrValue(int col, long long row)
 }
 
 
+// ---------------------------------------------------------- bulk column access
+bool
+RAMTable::GetColumnAsArray(int col, long long startRow, long long numRows, double* buf)
+{
+	if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+		return false;
+
+	// rows outside the table are reported as nodata
+	const long long first = std::max(startRow, 0ll);
+	const long long last = std::min(startRow + numRows, m_iNumRows);
+	std::fill(buf, buf + numRows, m_dNodata);
+	if (first >= last)
+		return true;
+
+	double* out = buf + (first - startRow);
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			// convert each dictionary entry only once
+			const RAMStringDictionary& dict = *m_mStringDicts.at(tidx);
+			std::vector<double> dictVals(dict.GetSize());
+			for (int code=0; code < dictVals.size(); ++code)
+				dictVals[code] = ::strtod(dict.GetValue(code), 0);
+
+			const std::vector<int>& codes = *m_mStringCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+				*out = dictVals[codes[r]];
+			break;
+		}
+		case ATTYPE_INT:
+		{
+			const std::vector<long long>& vals = *m_mIntCols.at(tidx);
+			std::copy(vals.begin() + first, vals.begin() + last, out);
+			break;
+		}
+		case ATTYPE_DOUBLE:
+		{
+			const std::vector<double>& vals = *m_mDoubleCols.at(tidx);
+			std::copy(vals.begin() + first, vals.begin() + last, out);
+			break;
+		}
+		default:
+			break;
+	}
+
+	return true;
+}
+
+bool
+RAMTable::GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf)
+{
+	if (col < 0 || col >= m_vNames.size() || numRows < 0 || buf == nullptr)
+		return false;
+
+	const long long first = std::max(startRow, 0ll);
+	const long long last = std::min(startRow + numRows, m_iNumRows);
+	std::fill(buf, buf + numRows, m_iNodata);
+	if (first >= last)
+		return true;
+
+	long long* out = buf + (first - startRow);
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			const RAMStringDictionary& dict = *m_mStringDicts.at(tidx);
+			std::vector<long long> dictVals(dict.GetSize());
+			for (int code=0; code < dictVals.size(); ++code)
+				dictVals[code] = ::strtol(dict.GetValue(code), 0, 10);
+
+			const std::vector<int>& codes = *m_mStringCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+				*out = dictVals[codes[r]];
+			break;
+		}
+		case ATTYPE_INT:
+		{
+			const std::vector<long long>& vals = *m_mIntCols.at(tidx);
+			std::copy(vals.begin() + first, vals.begin() + last, out);
+			break;
+		}
+		case ATTYPE_DOUBLE:
+		{
+			const std::vector<double>& vals = *m_mDoubleCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+				*out = static_cast<long long>(vals[r]);
+			break;
+		}
+		default:
+			break;
+	}
+
+	return true;
+}
+
+bool
+RAMTable::GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf)
+{
+	if (col < 0 || col >= m_vNames.size() || numRows < 0)
+		return false;
+
+	const long long first = std::max(startRow, 0ll);
+	const long long last = std::min(startRow + numRows, m_iNumRows);
+	buf.assign(numRows, m_sNodata);
+	if (first >= last)
+		return true;
+
+	std::vector<std::string>::iterator out = buf.begin() + (first - startRow);
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			const RAMStringDictionary& dict = *m_mStringDicts.at(tidx);
+			const std::vector<int>& codes = *m_mStringCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+				out->assign(dict.GetValue(codes[r]), dict.GetLength(codes[r]));
+			break;
+		}
+		case ATTYPE_INT:
+		{
+			const std::vector<long long>& vals = *m_mIntCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+			{
+				std::stringstream sval;
+				sval << vals[r];
+				*out = sval.str();
+			}
+			break;
+		}
+		case ATTYPE_DOUBLE:
+		{
+			const std::vector<double>& vals = *m_mDoubleCols.at(tidx);
+			for (long long r=first; r < last; ++r, ++out)
+			{
+				std::stringstream sval;
+				sval << vals[r];
+				*out = sval.str();
+			}
+			break;
+		}
+		default:
+			break;
+	}
+
+	return true;
+}
+
+bool
+RAMTable::SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf)
+{
+	if (	col < 0 || col >= m_vNames.size() || buf == nullptr
+		||	numRows < 0 || startRow < 0 || startRow + numRows > m_iNumRows
+	   )
+		return false;
+
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			for (long long r=0; r < numRows; ++r)
+			{
+				std::stringstream sval;
+				sval << buf[r];
+				const std::string str = sval.str();
+				this->setStrValue(tidx, startRow + r, str.c_str(), str.size());
+			}
+			break;
+		}
+		case ATTYPE_INT:
+		{
+			std::vector<long long>& vals = *m_mIntCols.at(tidx);
+			for (long long r=0; r < numRows; ++r)
+				vals[startRow + r] = static_cast<long long>(buf[r]);
+			break;
+		}
+		case ATTYPE_DOUBLE:
+			std::copy(buf, buf + numRows, m_mDoubleCols.at(tidx)->begin() + startRow);
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool
+RAMTable::SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf)
+{
+	if (	col < 0 || col >= m_vNames.size() || buf == nullptr
+		||	numRows < 0 || startRow < 0 || startRow + numRows > m_iNumRows
+	   )
+		return false;
+
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+		{
+			for (long long r=0; r < numRows; ++r)
+			{
+				std::stringstream sval;
+				sval << buf[r];
+				const std::string str = sval.str();
+				this->setStrValue(tidx, startRow + r, str.c_str(), str.size());
+			}
+			break;
+		}
+		case ATTYPE_INT:
+			std::copy(buf, buf + numRows, m_mIntCols.at(tidx)->begin() + startRow);
+			break;
+		case ATTYPE_DOUBLE:
+			std::copy(buf, buf + numRows, m_mDoubleCols.at(tidx)->begin() + startRow);
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool
+RAMTable::SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf)
+{
+	if (	col < 0 || col >= m_vNames.size() || buf.size() < numRows
+		||	numRows < 0 || startRow < 0 || startRow + numRows > m_iNumRows
+	   )
+		return false;
+
+	const int& tidx = m_vPosition[col];
+	switch(m_vTypes[col])
+	{
+		case ATTYPE_STRING:
+			for (long long r=0; r < numRows; ++r)
+				this->setStrValue(tidx, startRow + r, buf[r].c_str(), buf[r].size());
+			break;
+		case ATTYPE_INT:
+		{
+			std::vector<long long>& vals = *m_mIntCols.at(tidx);
+			for (long long r=0; r < numRows; ++r)
+				vals[startRow + r] = ::strtol(buf[r].c_str(), 0, 10);
+			break;
+		}
+		case ATTYPE_DOUBLE:
+		{
+			std::vector<double>& vals = *m_mDoubleCols.at(tidx);
+			for (long long r=0; r < numRows; ++r)
+				vals[startRow + r] = ::strtod(buf[r].c_str(), 0);
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return true;
+}
+
 //// ------------------------------------------------------- other useful public functions
 //void RAMTable::Print(std::ostream& os, itk::Indent indent, int nrows)
 //{
@@ -869,6 +1326,9 @@ RAMTable::~RAMTable()
 	for (int v=0; v < m_mStringCols.size(); ++v)
 		delete m_mStringCols[v];
 
+	for (int v=0; v < m_mStringDicts.size(); ++v)
+		delete m_mStringDicts[v];
+
 	for (int v=0; v < m_mIntCols.size(); ++v)
 		delete m_mIntCols[v];
 
@@ -40,6 +40,40 @@
 namespace otb
 {
 
+/** \brief Unique strings of a dictionary encoded string column
+ *
+ *  The strings are stored null-terminated back to back in a single
+ *  character arena and are referred to by their code, i.e. the
+ *  order in which they were added; lookups by value use an open
+ *  addressing hash index over the codes, so no string is stored
+ *  twice. Pointers returned by GetValue() are only valid until the
+ *  next string is added.
+ */
+class NMOTBSUPPLCORE_EXPORT RAMStringDictionary
+{
+public:
+    RAMStringDictionary();
+
+    /*! returns the code of the given string; the string
+     *  is added to the dictionary if it is not yet present */
+    int Encode(const char* str, size_t len);
+    /*! returns -1 if the string is not in the dictionary */
+    int Find(const char* str, size_t len) const;
+
+    const char* GetValue(int code) const {return &m_Arena[m_Offsets[code]];}
+    size_t GetLength(int code) const {return m_Offsets[code+1] - m_Offsets[code] - 1;}
+    int GetSize(void) const {return m_Offsets.size() - 1;}
+
+protected:
+    static size_t hash(const char* str, size_t len);
+    void rehash(size_t numBuckets);
+
+    std::vector<char> m_Arena;
+    std::vector<size_t> m_Offsets;
+    std::vector<size_t> m_Hashes;
+    std::vector<int> m_Buckets;
+};
+
 class NMOTBSUPPLCORE_EXPORT RAMTable : public AttributeTable
 {
 public:
@@ -69,8 +103,17 @@ public:
         //	std::string GetColumnName(int idx);
         //	TableColumnType GetColumnType(int idx);
 
+	/*! Returns a pointer to the column's data; note: string
+	 *  columns are dictionary encoded, i.e. the pointer refers
+	 *  to the int codes of the column's values (s. GetDictionaryValue) */
 	void* GetColumnPointer(int idx);
 
+	/*! string column dictionary */
+	int GetDictionarySize(int col);
+	std::string GetDictionaryValue(int col, int code);
+	/*! returns -1 if value is not in the dictionary */
+	int GetDictionaryCode(int col, const std::string& value);
+
         long long GetRowIdx(const std::string& column, void* value);
 
 	//long GetRowIdx(const std::string& column, const double& value);
@@ -80,6 +123,10 @@ public:
 	// managing the attribute table's content
 	bool AddColumn(const std::string& sColName, TableColumnType type);
 	bool AddRow();
+	/*! appends a row and sets its values in column order;
+	 *  string values are encoded straight from the ColumnValue's
+	 *  buffer, i.e. no per-cell string is allocated */
+	bool AddRow(const std::vector<ColumnValue>& values);
         bool AddRows(long long numRows);
         void SetValue(const std::string& sColName, long long idx, double value);
         void SetValue(const std::string& sColName, long long idx, long long value);
@@ -91,6 +138,7 @@ public:
         void SetValue(int col, long long row, double value);
         void SetValue(int col, long long row, long long value);
         void SetValue(int col, long long row, std::string value);
+        void SetValue(int col, long long row, const char* value);
 
 	void SetColumnName(int col, const std::string& name);
 
@@ -101,6 +149,15 @@ public:
     long long GetMinPKValue();
     long long GetMaxPKValue();
 
+    using AttributeTable::GetColumnAsArray;
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, double* buf);
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf);
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf);
+
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf);
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf);
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf);
+
 	bool RemoveColumn(int col);
 	bool RemoveColumn(const std::string& name);
 
@@ -138,11 +195,28 @@ protected:
 	 */
 	std::vector<int> m_vPosition;
 
+	// dictionary encoding of string values
+	inline void setStrValue(int tidx, long long row, const char* value, size_t len)
+	{
+		(*m_mStringCols[tidx])[row] = m_mStringDicts[tidx]->Encode(value, len);
+	}
+
+	inline const char* getStrValue(int tidx, long long row)
+	{
+		return m_mStringDicts[tidx]->GetValue((*m_mStringCols[tidx])[row]);
+	}
+
+	inline int nodataCode(int tidx)
+	{
+		return m_mStringDicts[tidx]->Encode(m_sNodata.c_str(), m_sNodata.size());
+	}
+
 	// maps holding table columns
 	//std::map<int, std::vector<std::string> > m_mStringCols;
 	//std::map<int, std::vector<long> > m_mIntCols;
 	//std::map<int, std::vector<double> > m_mDoubleCols;
-	std::vector<std::vector<std::string>* > m_mStringCols;
+	std::vector<std::vector<int>* > m_mStringCols;
+	std::vector<RAMStringDictionary*> m_mStringDicts;
         std::vector<std::vector<long long>* > m_mIntCols;
 	std::vector<std::vector<double>* > m_mDoubleCols;
 
@@ -32,6 +32,8 @@
 #include <locale>
 #include <algorithm>
 #include <random>
+#include <mutex>
+#include <thread>
 //#include "otbMacro.h"
 #include <spatialite.h>
 #include <sys/types.h>
@@ -46,6 +48,119 @@
     //#define NM_SPATIALITE_LIB "spatialite"
 #endif
 
+namespace
+{
+
+/*! Process-wide pool of idle read-only connections (incl. their
+ *  spatialite cache), keyed by db file name and open settings;
+ *  idle connections are kept (at most m_MaxIdlePerKey per key) until
+ *  the file is deleted or replaced (s. SQLiteTable::DeleteDatabase,
+ *  SQLiteTable::deleteOldLDB) or SQLiteTable::ClearConnectionPool
+ *  is called explicitly
+ */
+class SQLiteConnectionPool
+{
+public:
+    typedef struct
+    {
+        sqlite3* db;
+        void* splCache;
+    } PooledConnection;
+
+    static SQLiteConnectionPool& Instance()
+    {
+        static SQLiteConnectionPool pool;
+        return pool;
+    }
+
+    static std::string Key(const std::string& dbFileName, bool bSharedCache,
+                           bool bSpatialite)
+    {
+        std::stringstream key;
+        key << dbFileName << '|' << bSharedCache << bSpatialite;
+        return key.str();
+    }
+
+    bool Acquire(const std::string& key, sqlite3** db, void** splCache)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::multimap<std::string, PooledConnection>::iterator it = m_Idle.find(key);
+        if (it == m_Idle.end())
+        {
+            return false;
+        }
+
+        *db = it->second.db;
+        *splCache = it->second.splCache;
+        m_Idle.erase(it);
+        return true;
+    }
+
+    bool Release(const std::string& key, sqlite3* db, void* splCache)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Idle.count(key) >= m_MaxIdlePerKey)
+        {
+            return false;
+        }
+
+        PooledConnection pc;
+        pc.db = db;
+        pc.splCache = splCache;
+        m_Idle.insert(std::pair<std::string, PooledConnection>(key, pc));
+        return true;
+    }
+
+    void Clear(const std::string& dbFileName)
+    {
+        std::vector<PooledConnection> vClose;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            const std::string prefix = dbFileName + '|';
+            std::multimap<std::string, PooledConnection>::iterator it = m_Idle.begin();
+            while (it != m_Idle.end())
+            {
+                if (dbFileName.empty() || it->first.compare(0, prefix.size(), prefix) == 0)
+                {
+                    vClose.push_back(it->second);
+                    it = m_Idle.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        for (int c=0; c < vClose.size(); ++c)
+        {
+            if (sqlite3_close(vClose[c].db) == SQLITE_OK && vClose[c].splCache != nullptr)
+            {
+                spatialite_cleanup_ex(vClose[c].splCache);
+            }
+        }
+    }
+
+private:
+    SQLiteConnectionPool()
+    {
+        // one idle connection per thread is what
+        // the (per-thread) table readers need
+        m_MaxIdlePerKey = std::max(std::thread::hardware_concurrency(), 4u);
+    }
+
+    ~SQLiteConnectionPool()
+    {
+        this->Clear("");
+    }
+
+    std::mutex m_Mutex;
+    std::multimap<std::string, PooledConnection> m_Idle;
+    size_t m_MaxIdlePerKey;
+};
+
+} // anonymous namespace
+
 namespace otb
 {
 
@@ -398,6 +513,7 @@ SQLiteTable::PrepareBulkGet(const std::vector<std::string> &colNames,
     // values
     std::string::size_type pos = 0;
     m_iStmtBulkGetNumParam = 0;
+    m_bBulkGetFailed = false;
     while ((pos = whereClause.find('?', pos)) != std::string::npos)
     {
         ++m_iStmtBulkGetNumParam;
@@ -1001,10 +1117,13 @@ bool
 SQLiteTable::DoBulkGet(std::vector< ColumnValue >& values)
 {
    //NMDebugCtx(_ctxotbtab, << "...");
+   m_bBulkGetFailed = false;
    if (    m_db == 0
         ||  m_StmtBulkGet == 0
        )
     {
+        m_lastLogMsg = "No database connection or bulk get statement!";
+        m_bBulkGetFailed = true;
         //NMDebugCtx(_ctxotbtab, << "done!");
         return false;
     }
@@ -1051,6 +1170,7 @@ SQLiteTable::DoBulkGet(std::vector< ColumnValue >& values)
                     std::stringstream errstr;
                     errstr << "UNKNOWN data type!";
                     m_lastLogMsg = errstr.str();
+                    m_bBulkGetFailed = true;
                     //this->InvokeEvent(itk::NMLogEvent(errstr.str(), itk::NMLogEvent::NM_LOG_ERROR));
                     return false;
                 }
@@ -1075,19 +1195,16 @@ SQLiteTable::DoBulkGet(std::vector< ColumnValue >& values)
                 break;
             case ATTYPE_STRING:
                 {
-                    values[col].type = ATTYPE_STRING;
-                    values[col].slen = std::max(sqlite3_column_bytes(m_StmtBulkGet, col), 1) + 1;
-                    const char* val = reinterpret_cast<char*>(
-                                        const_cast<unsigned char*>(
-                                          sqlite3_column_text(m_StmtBulkGet, col)));
-                    values[col].tval = new char[values[col].slen];
+                    // re-uses the value's buffer from previous rows
+                    const char* val = reinterpret_cast<const char*>(
+                                          sqlite3_column_text(m_StmtBulkGet, col));
                     if (val != 0)
                     {
-                        ::sprintf((values[col]).tval, "%s", sqlite3_column_text(m_StmtBulkGet, col));
+                        values[col].SetString(val, sqlite3_column_bytes(m_StmtBulkGet, col));
                     }
                     else
                     {
-                        ::sprintf(values[col].tval, "%s", "\0");
+                        values[col].SetString("", 0);
                     }
                 }
                 break;
@@ -1097,6 +1214,13 @@ SQLiteTable::DoBulkGet(std::vector< ColumnValue >& values)
     else
     {
         sqliteStepCheck(rc);
+
+        // anything but SQLITE_DONE means we haven't got all rows
+        if (rc != SQLITE_DONE)
+        {
+            sqliteError(rc, 0);
+            m_bBulkGetFailed = true;
+        }
         //NMDebugCtx(_ctxotbtab, << "done!");
         return false;
     }
@@ -1331,6 +1455,7 @@ SQLiteTable::TableDataFetch(std::vector<std::vector<ColumnValue> > &restab,
     while(sqlite3_step(stmt) == SQLITE_ROW)
     {
         std::vector<ColumnValue> nrow;
+        nrow.reserve(coltypes.size());
         for (int c=0; c < coltypes.size(); ++c)
         {
             const otb::AttributeTable::TableColumnType type = coltypes.at(c);
@@ -1346,27 +1471,24 @@ SQLiteTable::TableDataFetch(std::vector<std::vector<ColumnValue> > &restab,
                 break;
             default:
                 {
-                    cval.slen = std::max(sqlite3_column_bytes(stmt, c), 1) + 1;
-                    const char* val = reinterpret_cast<char*>(
-                                        const_cast<unsigned char*>(
-                                          sqlite3_column_text(stmt, c)));
-                    cval.tval = new char[cval.slen];
+                    const char* val = reinterpret_cast<const char*>(
+                                          sqlite3_column_text(stmt, c));
                     if (val != 0)
                     {
-                        ::sprintf(cval.tval, "%s", sqlite3_column_text(stmt, c));
+                        cval.SetString(val, sqlite3_column_bytes(stmt, c));
                     }
                     else
                     {
-                        ::sprintf(cval.tval, "%s", "\0");
+                        cval.SetString("", 0);
                     }
                 }
                 break;
             }
 
-            nrow.push_back(cval);
+            nrow.push_back(std::move(cval));
         }
 
-        restab.push_back(nrow);
+        restab.push_back(std::move(nrow));
     }
 
     // finalize the affair ...
@@ -1614,6 +1736,211 @@ SQLiteTable::DoBulkSet(std::vector< ColumnValue >& values, std::vector< ColumnVa
     return true;
 }
 
+bool
+SQLiteTable::PrepareBulkInsert(const std::vector<std::string>& colNames,
+                               int numRows)
+{
+    if (m_db == 0)
+    {
+        NMDebugAI(<< "Database is NULL!" << std::endl);
+        return false;
+    }
+
+    if (colNames.size() == 0)
+    {
+        m_lastLogMsg = "No columns specified for bulk insert!";
+        return false;
+    }
+
+    m_vNamesBulkInsert.clear();
+    m_vTypesBulkInsert.clear();
+    for (int i=0; i < colNames.size(); ++i)
+    {
+        const int idx = this->ColumnExists(colNames.at(i));
+        if (idx < 0)
+        {
+            NMLogWarn(<< "Column \"" << colNames.at(i)
+                            << "\" does not exist in the table!");
+            return false;
+        }
+        m_vNamesBulkInsert.push_back(colNames.at(i));
+        m_vTypesBulkInsert.push_back(this->GetColumnType(idx));
+    }
+
+    // we must not exceed the max number of host parameters
+    // per statement (999 for SQLite < 3.32)
+    const int maxParams = sqlite3_limit(m_db, SQLITE_LIMIT_VARIABLE_NUMBER, -1);
+    const int maxRows = std::max(1, maxParams / static_cast<int>(colNames.size()));
+    numRows = std::max(1, std::min(numRows, maxRows));
+
+    sqlite3_finalize(m_StmtBulkInsert);
+    sqlite3_finalize(m_StmtBulkInsertTail);
+    m_StmtBulkInsertTail = nullptr;
+    m_iBulkInsertTailRows = 0;
+
+    m_StmtBulkInsert = this->prepareMultiRowInsert(numRows);
+    if (m_StmtBulkInsert == nullptr)
+    {
+        m_iBulkInsertRows = 0;
+        return false;
+    }
+    m_iBulkInsertRows = numRows;
+
+    return true;
+}
+
+bool
+SQLiteTable::DoBulkInsert(const std::vector<ColumnValue>& values,
+                          const long long int& numRows)
+{
+    const long long ncols = m_vTypesBulkInsert.size();
+    if (    m_db == 0
+        ||  m_StmtBulkInsert == 0
+        ||  static_cast<long long>(values.size()) < numRows * ncols
+       )
+    {
+        std::stringstream errstr;
+        errstr << "Bulk insert not prepared or too few values provided!";
+        m_lastLogMsg = errstr.str();
+        return false;
+    }
+
+    long long row = 0;
+    while (row < numRows)
+    {
+        const long long todo = numRows - row;
+        sqlite3_stmt* stmt = m_StmtBulkInsert;
+        int nrows = m_iBulkInsertRows;
+
+        // the remaining rows go into a smaller statement which
+        // we keep as long as the remainder doesn't change
+        if (todo < m_iBulkInsertRows)
+        {
+            nrows = static_cast<int>(todo);
+            if (nrows != m_iBulkInsertTailRows)
+            {
+                sqlite3_finalize(m_StmtBulkInsertTail);
+                m_StmtBulkInsertTail = this->prepareMultiRowInsert(nrows);
+                if (m_StmtBulkInsertTail == nullptr)
+                {
+                    m_iBulkInsertTailRows = 0;
+                    return false;
+                }
+                m_iBulkInsertTailRows = nrows;
+            }
+            stmt = m_StmtBulkInsertTail;
+        }
+
+        if (!this->bindBulkInsertRows(stmt, &values[row * ncols], nrows))
+        {
+            sqlite3_clear_bindings(stmt);
+            sqlite3_reset(stmt);
+            return false;
+        }
+
+        const int rc = sqlite3_step(stmt);
+        sqlite3_clear_bindings(stmt);
+        sqlite3_reset(stmt);
+        if (rc != SQLITE_DONE)
+        {
+            std::stringstream errstr;
+            errstr << "SQLite3 ERROR #" << rc << ": " << sqlite3_errmsg(m_db);
+            m_lastLogMsg = errstr.str();
+            return false;
+        }
+
+        m_iNumRows += nrows;
+        row += nrows;
+    }
+
+    return true;
+}
+
+sqlite3_stmt*
+SQLiteTable::prepareMultiRowInsert(int numRows)
+{
+    const int ncols = m_vNamesBulkInsert.size();
+
+    std::stringstream ssql;
+    ssql << "INSERT OR REPLACE INTO main." << "\"" << m_tableName << "\"" << " (";
+    for (int c=0; c < ncols; ++c)
+    {
+        ssql << "\"" << m_vNamesBulkInsert.at(c) << "\"";
+        if (c < ncols-1)
+        {
+            ssql << ",";
+        }
+    }
+    ssql << ") VALUES ";
+    for (int r=0; r < numRows; ++r)
+    {
+        ssql << "(";
+        for (int c=0; c < ncols; ++c)
+        {
+            ssql << "?";
+            if (c < ncols-1)
+            {
+                ssql << ",";
+            }
+        }
+        ssql << ")";
+        if (r < numRows-1)
+        {
+            ssql << ",";
+        }
+    }
+    ssql << ";";
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(m_db, ssql.str().c_str(), -1, &stmt, 0);
+    if (sqliteError(rc, &stmt))
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    return stmt;
+}
+
+bool
+SQLiteTable::bindBulkInsertRows(sqlite3_stmt* stmt, const ColumnValue* values,
+                                int numRows)
+{
+    const int ncols = m_vTypesBulkInsert.size();
+    int param = 1;
+    for (int r=0; r < numRows; ++r)
+    {
+        for (int c=0; c < ncols; ++c, ++param)
+        {
+            const ColumnValue& val = values[r * ncols + c];
+            switch(m_vTypesBulkInsert[c])
+            {
+            case ATTYPE_DOUBLE:
+                sqlite3_bind_double(stmt, param, val.dval);
+                break;
+
+            case ATTYPE_INT:
+                sqlite3_bind_int64(stmt, param, val.ival);
+                break;
+
+            case ATTYPE_STRING:
+                sqlite3_bind_text(stmt, param, val.tval, -1, 0);
+                break;
+
+            default:
+                {
+                std::stringstream errstr;
+                errstr << "UNKNOWN data type!";
+                m_lastLogMsg = errstr.str();
+                return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
 bool
 SQLiteTable::BeginTransaction()
 {
@@ -2629,6 +2956,313 @@ std::string SQLiteTable::GetStrValue(int col, long long row)
     return ret.str();
 }
 
+sqlite3_stmt*
+SQLiteTable::prepareColumnRange(const std::vector<int>& cols,
+                                long long startRow, long long endRow)
+{
+    if (m_db == 0 || cols.empty())
+    {
+        return nullptr;
+    }
+
+    std::stringstream ssql;
+    ssql << "SELECT " << m_idColName;
+    for (int c=0; c < cols.size(); ++c)
+    {
+        if (cols[c] < 0 || cols[c] >= m_vNames.size())
+        {
+            return nullptr;
+        }
+        ssql << ", \"" << m_vNames[cols[c]] << "\"";
+    }
+    ssql << " FROM main.\"" << m_tableName << "\""
+         << " WHERE " << m_idColName << " BETWEEN ?1 AND ?2"
+         << " ORDER BY " << m_idColName << ";";
+
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v2(m_db, ssql.str().c_str(), -1, &stmt, 0);
+    if (sqliteError(rc, &stmt))
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    rc = sqlite3_bind_int64(stmt, 1, startRow);
+    if (!sqliteError(rc, &stmt))
+    {
+        rc = sqlite3_bind_int64(stmt, 2, endRow);
+    }
+    if (sqliteError(rc, &stmt))
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+
+    return stmt;
+}
+
+bool
+SQLiteTable::GetColumnAsArray(int col, long long startRow, long long numRows, double* buf)
+{
+    if (numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = this->prepareColumnRange(std::vector<int>(1, col),
+                                                  startRow, startRow + numRows - 1);
+    if (stmt == nullptr)
+    {
+        return false;
+    }
+
+    // rows missing in the table are reported as nodata
+    std::fill(buf, buf + numRows, m_dNodata);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const long long row = sqlite3_column_int64(stmt, 0);
+        buf[row - startRow] = sqlite3_column_double(stmt, 1);
+    }
+    sqliteStepCheck(rc);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE;
+}
+
+bool
+SQLiteTable::GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf)
+{
+    if (numRows < 0 || buf == nullptr)
+    {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = this->prepareColumnRange(std::vector<int>(1, col),
+                                                  startRow, startRow + numRows - 1);
+    if (stmt == nullptr)
+    {
+        return false;
+    }
+
+    std::fill(buf, buf + numRows, m_iNodata);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const long long row = sqlite3_column_int64(stmt, 0);
+        buf[row - startRow] = sqlite3_column_int64(stmt, 1);
+    }
+    sqliteStepCheck(rc);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE;
+}
+
+bool
+SQLiteTable::GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf)
+{
+    if (numRows < 0)
+    {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = this->prepareColumnRange(std::vector<int>(1, col),
+                                                  startRow, startRow + numRows - 1);
+    if (stmt == nullptr)
+    {
+        return false;
+    }
+
+    buf.assign(numRows, m_sNodata);
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    {
+        const long long row = sqlite3_column_int64(stmt, 0);
+        const unsigned char* sval = sqlite3_column_text(stmt, 1);
+        if (sval)
+        {
+            buf[row - startRow] = reinterpret_cast<const char*>(sval);
+        }
+    }
+    sqliteStepCheck(rc);
+    sqlite3_finalize(stmt);
+
+    return rc == SQLITE_DONE;
+}
+
+template<class BindFunc>
+bool
+SQLiteTable::updateColumnRange(int col, long long startRow, long long numRows,
+                               BindFunc bind)
+{
+    if (m_db == 0 || col < 0 || col >= m_vNames.size() || numRows < 0)
+    {
+        return false;
+    }
+
+    // only commit the transaction if we've started it
+    const bool bOwnTransaction = sqlite3_get_autocommit(m_db) != 0;
+    if (bOwnTransaction && !this->BeginTransaction())
+    {
+        return false;
+    }
+
+    sqlite3_stmt* stmt = m_vStmtUpdate.at(col);
+    bool bOK = true;
+    for (long long r=0; r < numRows && bOK; ++r)
+    {
+        int rc = bind(stmt, r);
+        if (!sqliteError(rc, &stmt))
+        {
+            rc = sqlite3_bind_int64(stmt, 2, startRow + r);
+        }
+        if (sqliteError(rc, &stmt))
+        {
+            bOK = false;
+            break;
+        }
+
+        rc = sqlite3_step(stmt);
+        sqliteStepCheck(rc);
+        bOK = rc == SQLITE_DONE;
+
+        sqlite3_clear_bindings(stmt);
+        sqlite3_reset(stmt);
+    }
+
+    if (bOwnTransaction)
+    {
+        this->EndTransaction();
+    }
+
+    return bOK;
+}
+
+bool
+SQLiteTable::SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf)
+{
+    if (buf == nullptr)
+    {
+        return false;
+    }
+
+    return this->updateColumnRange(col, startRow, numRows,
+                                   [buf](sqlite3_stmt* stmt, long long r)
+                                   {return sqlite3_bind_double(stmt, 1, buf[r]);});
+}
+
+bool
+SQLiteTable::SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf)
+{
+    if (buf == nullptr)
+    {
+        return false;
+    }
+
+    return this->updateColumnRange(col, startRow, numRows,
+                                   [buf](sqlite3_stmt* stmt, long long r)
+                                   {return sqlite3_bind_int64(stmt, 1, buf[r]);});
+}
+
+bool
+SQLiteTable::SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf)
+{
+    if (buf.size() < numRows)
+    {
+        return false;
+    }
+
+    return this->updateColumnRange(col, startRow, numRows,
+                                   [&buf](sqlite3_stmt* stmt, long long r)
+                                   {return sqlite3_bind_text(stmt, 1, buf[r].c_str(), -1, 0);});
+}
+
+bool
+SQLiteTable::PrepareColumnScan(const std::vector<int>& cols, long long startRow, long long endRow)
+{
+    this->EndColumnScan();
+
+    m_StmtColScan = this->prepareColumnRange(cols, startRow, endRow);
+    if (m_StmtColScan == nullptr)
+    {
+        return false;
+    }
+
+    m_iStmtColScanNumCols = cols.size();
+    for (int c=0; c < cols.size(); ++c)
+    {
+        m_vTypesColScan.push_back(this->GetColumnType(cols[c]));
+    }
+    return true;
+}
+
+bool
+SQLiteTable::NextScanRow(long long& row, double* values)
+{
+    if (m_StmtColScan == nullptr || values == nullptr)
+    {
+        return false;
+    }
+
+    const int rc = sqlite3_step(m_StmtColScan);
+    if (rc != SQLITE_ROW)
+    {
+        sqliteStepCheck(rc);
+        return false;
+    }
+
+    row = sqlite3_column_int64(m_StmtColScan, 0);
+    for (int c=0; c < m_iStmtColScanNumCols; ++c)
+    {
+        values[c] = sqlite3_column_double(m_StmtColScan, c+1);
+    }
+
+    return true;
+}
+
+bool
+SQLiteTable::NextScanRow(long long& row, double* dblValues, long long* intValues)
+{
+    if (m_StmtColScan == nullptr || dblValues == nullptr || intValues == nullptr)
+    {
+        return false;
+    }
+
+    const int rc = sqlite3_step(m_StmtColScan);
+    if (rc != SQLITE_ROW)
+    {
+        sqliteStepCheck(rc);
+        return false;
+    }
+
+    row = sqlite3_column_int64(m_StmtColScan, 0);
+    for (int c=0; c < m_iStmtColScanNumCols; ++c)
+    {
+        if (m_vTypesColScan[c] == ATTYPE_INT)
+        {
+            intValues[c] = sqlite3_column_int64(m_StmtColScan, c+1);
+        }
+        else
+        {
+            dblValues[c] = sqlite3_column_double(m_StmtColScan, c+1);
+        }
+    }
+
+    return true;
+}
+
+void
+SQLiteTable::EndColumnScan(void)
+{
+    if (m_StmtColScan != nullptr)
+    {
+        sqlite3_finalize(m_StmtColScan);
+        m_StmtColScan = nullptr;
+    }
+    m_iStmtColScanNumCols = 0;
+    m_vTypesColScan.clear();
+}
+
 
 //// ------------------------------------------------------- other useful public functions
 //void SQLiteTable::Print(std::ostream& os, itk::Indent indent, int nrows)
@@ -2787,6 +3421,7 @@ bool
 SQLiteTable::DeleteDatabase()
 {
     this->CloseTable(true);
+    SQLiteTable::ClearConnectionPool(m_dbFileName);
     return !remove(m_dbFileName.c_str());
 }
 
@@ -2855,6 +3490,25 @@ SQLiteTable::openConnection(void)
     // ============================================================
 
 
+    // re-use an idle read-only connection, if we've got one;
+    // note: we keep the key, since resetTableAdmin() resets
+    // the shared cache flag before the connection is closed
+    m_PoolKey.clear();
+    if (this->isPoolableConnection())
+    {
+        m_PoolKey = SQLiteConnectionPool::Key(m_dbFileName, m_bUseSharedCache,
+                                              m_bLoadSpatialite);
+    }
+
+    if (    !m_PoolKey.empty()
+        &&  SQLiteConnectionPool::Instance().Acquire(m_PoolKey, &m_db, &m_SpatialiteCache)
+       )
+    {
+        NMDebugAI( << _ctxotbtab << ": Re-using pooled connection to '"
+                   << m_dbFileName << "'" << std::endl);
+        return true;
+    }
+
     int openFlags = SQLITE_OPEN_URI;
 
     if (m_bOpenReadOnly)
@@ -2890,15 +3544,7 @@ SQLiteTable::openConnection(void)
         return false;
     }
 
-    rc = sqlite3_exec(m_db, "PRAGMA cache_size = 70000;", 0, 0, 0);
-    if (sqliteError(rc, 0))
-    {
-        //NMWarn(_ctxotbtab, << "Failed to adjust cache_size!");
-        //itkDebugMacro(<< "Failed to adjust cache_size!");
-        m_lastLogMsg = "Failed to adjust cache size!";
-        //this->InvokeEvent(itk::NMLogEvent("Failed to adjust cache_size!",
-          //                                itk::NMLogEvent::NM_LOG_ERROR));
-    }
+    this->applyConnectionPragmas();
 
     // alloc spatialite caches
     if (m_bLoadSpatialite)
@@ -2927,6 +3573,62 @@ SQLiteTable::openConnection(void)
     return true;
 }
 
+void
+SQLiteTable::applyConnectionPragmas(void)
+{
+    const bool bFileDb =    m_dbFileName.find(":memory:") == std::string::npos
+                         && m_dbFileName.find("mode=memory") == std::string::npos;
+
+    std::stringstream ssql;
+    ssql << "PRAGMA cache_size = 70000;";
+
+    // memory map (up to 256 MB of) the db file for reading
+    if (bFileDb && (m_bOpenReadOnly || m_bScratchMode))
+    {
+        ssql << "PRAGMA mmap_size = 268435456;";
+    }
+
+    if (m_bScratchMode && !m_bOpenReadOnly)
+    {
+        // page_size only takes effect for new (empty) dbs
+        ssql << "PRAGMA page_size = 65536;"
+             << "PRAGMA journal_mode = OFF;"
+             << "PRAGMA synchronous = OFF;"
+             << "PRAGMA temp_store = MEMORY;";
+    }
+    else if (m_bUseWAL && bFileDb && !m_bOpenReadOnly)
+    {
+        ssql << "PRAGMA journal_mode = WAL;"
+             << "PRAGMA synchronous = NORMAL;";
+    }
+
+    int rc = sqlite3_exec(m_db, ssql.str().c_str(), 0, 0, 0);
+    if (sqliteError(rc, 0))
+    {
+        //NMWarn(_ctxotbtab, << "Failed to adjust cache_size!");
+        //itkDebugMacro(<< "Failed to adjust cache_size!");
+        m_lastLogMsg = "Failed to adjust connection settings!";
+        //this->InvokeEvent(itk::NMLogEvent("Failed to adjust cache_size!",
+          //                                itk::NMLogEvent::NM_LOG_ERROR));
+    }
+}
+
+bool
+SQLiteTable::isPoolableConnection(void)
+{
+    return     m_bUseConnectionPool
+           &&  m_bOpenReadOnly
+           &&  !m_dbFileName.empty()
+           &&  m_dbFileName.find(":memory:") == std::string::npos
+           &&  m_dbFileName.find("mode=memory") == std::string::npos;
+}
+
+void
+SQLiteTable::ClearConnectionPool(const std::string& dbFileName)
+{
+    SQLiteConnectionPool::Instance().Clear(dbFileName);
+}
+
 int
 SQLiteTable::deleteOldLDB(const std::string& vt, const std::string& ldb)
 {
@@ -2945,7 +3647,9 @@ SQLiteTable::deleteOldLDB(const std::string& vt, const std::string& ldb)
             // vt is more recent
             if (resVt.st_mtime > resLdb.st_mtime)
             {
-                // delete old ldb
+                // delete old ldb; pooled connections must not
+                // hang on to the old file
+                SQLiteTable::ClearConnectionPool(ldb);
                 if (remove(ldb.c_str()))
                 {
                     std::stringstream errmsg;
@@ -3623,7 +4327,13 @@ SQLiteTable::SQLiteTable()
       m_StmtRollback(nullptr),
       m_StmtBulkSet(nullptr),
       m_StmtBulkGet(nullptr),
+      m_StmtBulkInsert(nullptr),
+      m_StmtBulkInsertTail(nullptr),
+      m_iBulkInsertRows(0),
+      m_iBulkInsertTailRows(0),
       m_StmtColIter(nullptr),
+      m_StmtColScan(nullptr),
+      m_iStmtColScanNumCols(0),
       m_StmtRowCount(nullptr),
       m_StmtCustomRowCount(nullptr),
       m_SpatialiteCache(nullptr),
@@ -3634,6 +4344,9 @@ SQLiteTable::SQLiteTable()
       m_bOpenReadOnly(false),
       m_lastLogMsg(""),
       m_bPersistentRowIdColName(false),
+      m_bUseConnectionPool(false),
+      m_bScratchMode(false),
+      m_bUseWAL(false),
       m_bLoadSpatialite(true)
 {
     //this->createTable("");
@@ -3645,6 +4358,22 @@ SQLiteTable::disconnectDB(void)
 {
     if (m_db != 0)
     {
+        this->InvokeEvent(SQLiteCloseEvent());
+
+        // hand idle read-only connections back to the pool
+        if (    !m_PoolKey.empty()
+            &&  sqlite3_get_autocommit(m_db) != 0
+            &&  SQLiteConnectionPool::Instance().Release(m_PoolKey, m_db, m_SpatialiteCache)
+           )
+        {
+            m_SpatialiteCache = 0;
+            m_db = 0;
+
+            NMDebugAI(<< _ctxotbtab << ": Returned connection to '"
+                       << m_dbFileName << "' to the pool" << std::endl);
+            return;
+        }
+
         if (sqlite3_close(m_db) == SQLITE_OK)
         {
             if (m_SpatialiteCache != nullptr)
@@ -3700,10 +4429,22 @@ SQLiteTable::resetTableAdmin(void)
     {
         sqlite3_finalize(m_StmtBulkGet);
     }
+    if (m_StmtBulkInsert != nullptr)
+    {
+        sqlite3_finalize(m_StmtBulkInsert);
+    }
+    if (m_StmtBulkInsertTail != nullptr)
+    {
+        sqlite3_finalize(m_StmtBulkInsertTail);
+    }
     if (m_StmtColIter != nullptr)
     {
         sqlite3_finalize(m_StmtColIter);
     }
+    if (m_StmtColScan != nullptr)
+    {
+        sqlite3_finalize(m_StmtColScan);
+    }
     if (m_StmtRowCount != nullptr)
     {
         sqlite3_finalize(m_StmtRowCount);
@@ -3740,14 +4481,18 @@ SQLiteTable::resetTableAdmin(void)
     m_vTypes.clear();
     m_vIndexNames.clear();
     m_vNames.clear();
+    m_mNameIndex.clear();
     m_vTypesBulkGet.clear();
     m_vTypesBulkSet.clear();
+    m_vNamesBulkInsert.clear();
+    m_vTypesBulkInsert.clear();
     m_vStmtUpdate.clear();
     m_vStmtSelect.clear();
     m_vStmtGetRowidx.clear();
 
     m_iNumRows = 0;
     m_iStmtBulkGetNumParam = 0;
+    m_bBulkGetFailed = false;
     m_iStmtCustomRowCountParam = 0;
     m_iBand = 1;
     m_iNodata = -std::numeric_limits<long long>::max();
@@ -3760,7 +4505,14 @@ SQLiteTable::resetTableAdmin(void)
     m_StmtRollback = nullptr;
     m_StmtBulkSet = nullptr;
     m_StmtBulkGet = nullptr;
+    m_StmtBulkInsert = nullptr;
+    m_StmtBulkInsertTail = nullptr;
+    m_iBulkInsertRows = 0;
+    m_iBulkInsertTailRows = 0;
     m_StmtColIter = nullptr;
+    m_StmtColScan = nullptr;
+    m_iStmtColScanNumCols = 0;
+    m_vTypesColScan.clear();
     m_StmtRowCount = nullptr;
     m_CurPrepStmt = "";
     m_idColName = "";
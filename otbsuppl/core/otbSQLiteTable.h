@@ -35,6 +35,7 @@
 #include "itkObject.h"
 #include "itkDataObject.h"
 #include "itkObjectFactory.h"
+#include "itkEventObject.h"
 
 #include "nmotbsupplcore_export.h"
 
@@ -50,6 +51,11 @@
 namespace otb
 {
 
+/*! invoked by SQLiteTable just before its database connection is
+ *  closed or handed back to the connection pool; observers holding
+ *  prepared statements on the connection must finalize them now */
+itkEventMacro(SQLiteCloseEvent, itk::AnyEvent)
+
 class NMOTBSUPPLCORE_EXPORT SQLiteTable : public AttributeTable
 {
 public:
@@ -131,6 +137,34 @@ public:
     void SetRowIdColNameIsPersistent(bool bPersistent)
     {m_bPersistentRowIdColName = bPersistent;}
 
+    /*! Read-only connections to on-disk databases are taken from
+     *  and returned to a process-wide pool (keyed by db file name)
+     *  instead of being opened and closed for each table object,
+     *  e.g. for per-thread read connections; needs to be set before
+     *  calling CreateTable/openConnection.
+     */
+    void SetUseConnectionPool(bool pool) {m_bUseConnectionPool = pool;}
+    bool GetUseConnectionPool(void) {return m_bUseConnectionPool;}
+
+    /*! Scratch mode for temporary (workspace) tables: no rollback
+     *  journal, no syncing to disk, large pages and temp storage
+     *  in memory; data are lost if the process crashes! Needs to
+     *  be set before calling CreateTable/openConnection.
+     */
+    void SetScratchMode(bool scratch) {m_bScratchMode = scratch;}
+    bool GetScratchMode(void) {return m_bScratchMode;}
+
+    /*! Switches writable on-disk databases into write-ahead-log
+     *  journal mode, so readers don't block writers and vice
+     *  versa; note: this is a persistent property of the db file!
+     */
+    void SetUseWAL(bool wal) {m_bUseWAL = wal;}
+    bool GetUseWAL(void) {return m_bUseWAL;}
+
+    /*! closes idle pooled connections to the given db file,
+     *  or all idle pooled connections if dbFileName is empty */
+    static void ClearConnectionPool(const std::string& dbFileName="");
+
     bool openConnection();
     void disconnectDB();
     TableCreateStatus CreateTable(std::string filename, std::string tag="");
@@ -147,6 +181,21 @@ public:
     long long GetMinPKValue();
     long long GetMaxPKValue();
 
+    /// BULK COLUMN ACCESS (one statement per column range)
+    using AttributeTable::GetColumnAsArray;
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, double* buf);
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, long long* buf);
+    bool GetColumnAsArray(int col, long long startRow, long long numRows, std::vector<std::string>& buf);
+
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const double* buf);
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const long long* buf);
+    bool SetColumnFromArray(int col, long long startRow, long long numRows, const std::vector<std::string>& buf);
+
+    bool PrepareColumnScan(const std::vector<int>& cols, long long startRow, long long endRow);
+    bool NextScanRow(long long& row, double* values);
+    bool NextScanRow(long long& row, double* dblValues, long long* intValues);
+    void EndColumnScan(void);
+
     sqlite3* GetDbConnection() {return this->m_db;}
 
     bool PrepareBulkGet(const std::vector<std::string>& colNames,
@@ -184,7 +233,30 @@ public:
      */
     bool DoBulkSet(std::vector< ColumnValue >& values, std::vector< ColumnValue>& keyValues);
 
+    /** \brief Prepares multi-row inserts of numRows rows per statement
+     *         (at most; s. GetBulkInsertRows), which cuts the per-row
+     *         statement overhead of DoBulkSet when loading large tables
+     */
+    bool PrepareBulkInsert(const std::vector<std::string>& colNames,
+                           int numRows);
+
+    /** \brief Inserts numRows rows, whose values are given row by row
+     *         (i.e. numRows x number of columns), using the statements
+     *         prepared by PrepareBulkInsert
+     */
+    bool DoBulkInsert(const std::vector< ColumnValue >& values,
+                      const long long int& numRows);
+
+    /** \brief Number of rows inserted per prepared bulk insert statement */
+    int GetBulkInsertRows(void) const {return m_iBulkInsertRows;}
+
     bool DoBulkGet(std::vector< ColumnValue >& values);
+
+    /** \brief Whether the last call of DoBulkGet returned false because
+     *         of an error (s. getLastLogMsg) rather than because all
+     *         rows of the result set had been fetched
+     */
+    bool BulkGetFailed(void) const {return m_bBulkGetFailed;}
     bool DoRowCount(std::vector<ColumnValue> & whereClausParmas,
                     long long& rowCount);
 
@@ -326,8 +398,31 @@ protected:
      */
 
     void createPreparedColumnStatements(const std::string& colname);
+
+    /*! sets the connection's pragmas according to the
+     *  read-only, scratch, and WAL settings */
+    void applyConnectionPragmas(void);
+    bool isPoolableConnection(void);
+
+    /*! prepares 'SELECT pk, col ... WHERE pk BETWEEN startRow AND endRow
+     *  ORDER BY pk' for the given columns; returns nullptr on error */
+    sqlite3_stmt* prepareColumnRange(const std::vector<int>& cols,
+                                     long long startRow, long long endRow);
+
+    /*! runs the per-column update statement for numRows rows starting
+     *  at startRow within a single transaction; bind is called as
+     *  bind(stmt, r) to bind the value of the r-th row to parameter 1 */
+    template<class BindFunc>
+    bool updateColumnRange(int col, long long startRow, long long numRows,
+                           BindFunc bind);
     void resetTableAdmin();
 
+    /*! prepares 'INSERT OR REPLACE INTO ... VALUES (...), (...), ...'
+     *  for numRows rows of the bulk insert columns */
+    sqlite3_stmt* prepareMultiRowInsert(int numRows);
+    bool bindBulkInsertRows(sqlite3_stmt* stmt, const ColumnValue* values,
+                            int numRows);
+
     /*! deletes the ldb table if the ldb file has a more recent modified data;
      *  returns 1 when ldb is deleted or did not exist
      *  returns 0 when existing ldb is kept
@@ -356,6 +451,10 @@ protected:
     bool m_bLoadSpatialite;
 
     bool m_bPersistentRowIdColName;
+    bool m_bUseConnectionPool;
+    bool m_bScratchMode;
+    bool m_bUseWAL;
+    std::string m_PoolKey;
 
     sqlite3* m_db;
     std::string m_dbFileName;
@@ -368,12 +467,23 @@ protected:
     sqlite3_stmt* m_StmtBulkSet;
     sqlite3_stmt* m_StmtBulkGet;
     int m_iStmtBulkGetNumParam;
+    bool m_bBulkGetFailed;
 
     std::vector<otb::SQLiteTable::TableColumnType> m_vTypesBulkSet;
     std::vector<otb::SQLiteTable::TableColumnType> m_vTypesBulkGet;
+
+    sqlite3_stmt* m_StmtBulkInsert;
+    sqlite3_stmt* m_StmtBulkInsertTail;
+    int m_iBulkInsertRows;
+    int m_iBulkInsertTailRows;
+    std::vector<std::string> m_vNamesBulkInsert;
+    std::vector<otb::SQLiteTable::TableColumnType> m_vTypesBulkInsert;
     std::vector<std::string> m_vIndexNames;
 
     sqlite3_stmt* m_StmtColIter;
+    sqlite3_stmt* m_StmtColScan;
+    int m_iStmtColScanNumCols;
+    std::vector<otb::SQLiteTable::TableColumnType> m_vTypesColScan;
     sqlite3_stmt* m_StmtRowCount;
     sqlite3_stmt* m_StmtCustomRowCount;
     int m_iStmtCustomRowCountParam;
@@ -233,7 +233,11 @@ public:
   itkSetStringMacro(ResamplingType)
   itkGetStringMacro(ResamplingType)
 
-  /** Set the streaming type */
+  /** Set the streaming type: STRIPPED | TILED | NO_STREAMING | AUTO;
+   *  AUTO estimates the memory footprint of the upstream pipeline
+   *  (incl. neighbourhood halos and fully buffered source images) and
+   *  streams the largest strips that fit into StreamingSize MB, aligned
+   *  to the block size of the output format */
   itkSetStringMacro(StreamingMethod)
   itkGetStringMacro(StreamingMethod)
 
@@ -341,6 +345,17 @@ protected:
   /** Does the real work. */
   virtual void GenerateData(void);
 
+  /** Block height of the output file (format), used to align
+   *  AUTO streaming strips; returns 1 if unknown */
+  unsigned int GetOutputBlockHeight(void);
+
+  /** Estimates the number of lines (along the outermost dimension)
+   *  per stream division such that the upstream pipeline's memory
+   *  footprint fits into availableRAM bytes (AUTO streaming) */
+  unsigned int EstimateAutoStreamingLines(InputImageType* inputPtr,
+                                          const OutputImageRegionType& region,
+                                          double availableRAM);
+
 
 private:
   StreamingRATImageFileWriter(const StreamingRATImageFileWriter &); //purposely not implemented
@@ -376,8 +391,9 @@ private:
   /** ImageFileWriter Parameters */
   std::vector<std::string> m_FileNames;
   std::string m_ResamplingType;
-  std::string m_StreamingMethod;  // TILED | STRIPPED
+  std::string m_StreamingMethod;  // TILED | STRIPPED | NO_STREAMING | AUTO
   int m_StreamingSize;          // MB streaming pieces
+  unsigned int m_AutoStreamingLines; // lines per division (AUTO only)
 
   std::vector<otb::ImageIOBase::Pointer> m_ImageIOs;
 
@@ -66,6 +66,9 @@
 #include "otbRAMDrivenStrippedStreamingManager.h"
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
+#include "otbPipelineMemoryPrintCalculator.h"
+
+#include <set>
 
 
 namespace otb
@@ -92,6 +95,7 @@ StreamingRATImageFileWriter<TInputImage>
     m_ResamplingType = "NEAREST";
     m_StreamingMethod = "STRIPPED";
     m_StreamingSize = 512;
+    m_AutoStreamingLines = 0;
     m_ParallelIO = false;
     m_MpiComm = MPI_COMM_NULL;
 
@@ -954,10 +958,19 @@ StreamingRATImageFileWriter<TInputImage>
     *
     * the streaming size
     */
+    m_AutoStreamingLines = 0;
+    bool bAutoStreaming = false;
     if (m_StreamingMethod.compare("STRIPPED") == 0)
     {
         this->SetAutomaticStrippedStreaming(m_StreamingSize / m_NumberOfInputs);
     }
+    else if (m_StreamingMethod.compare("AUTO") == 0)
+    {
+        // the actual split is estimated below, once we
+        // know that we're actually going to stream
+        this->SetNumberOfDivisionsStrippedStreaming(1);
+        bAutoStreaming = InputImageDimension > 1;
+    }
     else
     {
         this->SetAutomaticTiledStreaming(m_StreamingSize / m_NumberOfInputs);
@@ -976,10 +989,12 @@ StreamingRATImageFileWriter<TInputImage>
        )
     {
         this->SetNumberOfDivisionsStrippedStreaming(1);
+        bAutoStreaming = false;
     }
     else if (m_NumberOfInputs == 1 && inputPtr->GetBufferedRegion() == inputPtr->GetLargestPossibleRegion())
     {
         this->SetNumberOfDivisionsStrippedStreaming(1);
+        bAutoStreaming = false;
     }
     else if (m_StreamingMethod.compare("NO_STREAMING") == 0)// || this->m_UseForcedLPR)
     {
@@ -988,6 +1003,18 @@ StreamingRATImageFileWriter<TInputImage>
     m_StreamingManager->PrepareStreaming(inputPtr, outputRegion);
     m_NumberOfDivisions = m_StreamingManager->GetNumberOfSplits();
 
+    if (bAutoStreaming)
+    {
+        const double availableRAM = (m_StreamingSize / (double)m_NumberOfInputs) * 1024.0 * 1024.0;
+        m_AutoStreamingLines = this->EstimateAutoStreamingLines(inputPtr, outputRegion, availableRAM);
+
+        const unsigned long numLines = outputRegion.GetSize(InputImageDimension-1);
+        m_NumberOfDivisions = (numLines + m_AutoStreamingLines - 1) / m_AutoStreamingLines;
+
+        NMProcInfo(<< "AUTO streaming: " << m_AutoStreamingLines << " lines per division, "
+                   << m_NumberOfDivisions << " divisions");
+    }
+
 
     // no point in chopping up the image, if we're not
     // intrested in it (and only want to write the table)
@@ -1086,7 +1113,18 @@ StreamingRATImageFileWriter<TInputImage>
         //InputImageRegionType streamRegion = inImg->GetLargestPossibleRegion();
         //m_StreamingManager->GetSplitter()->GetSplit(m_CurrentDivision, m_NumberOfDivisions, streamRegion);
         InputImageRegionType streamRegion = outputRegion;
-        m_StreamingManager->GetSplitter()->GetSplit(m_CurrentDivision, m_NumberOfDivisions, streamRegion);
+        if (m_AutoStreamingLines > 0)
+        {
+            const unsigned int sd = InputImageDimension - 1;
+            const unsigned long start = m_CurrentDivision * static_cast<unsigned long>(m_AutoStreamingLines);
+            const unsigned long rest = outputRegion.GetSize(sd) - start;
+            streamRegion.SetIndex(sd, outputRegion.GetIndex(sd) + start);
+            streamRegion.SetSize(sd, rest < m_AutoStreamingLines ? rest : m_AutoStreamingLines);
+        }
+        else
+        {
+            m_StreamingManager->GetSplitter()->GetSplit(m_CurrentDivision, m_NumberOfDivisions, streamRegion);
+        }
 
         //DEBUG
         std::string strregstr = printRegion(streamRegion);
@@ -1295,6 +1333,164 @@ StreamingRATImageFileWriter<TInputImage>
 /**
  *
  */
+template<class TInputImage>
+unsigned int
+StreamingRATImageFileWriter<TInputImage>
+::GetOutputBlockHeight(void)
+{
+    // we only align 2D images, 3D (NetCDF) images are streamed
+    // slice by slice along the outermost dimension anyway
+    if (InputImageDimension != 2 || m_ImageIOs.size() == 0 || m_ImageIOs[0].IsNull())
+    {
+        return 1;
+    }
+
+    GDALRATImageIO* gio = dynamic_cast<GDALRATImageIO*>(m_ImageIOs[0].GetPointer());
+    if (gio == nullptr)
+    {
+        return 1;
+    }
+
+    const InputImageType* inImg = this->GetInput(0);
+    unsigned int blockX = 0;
+    unsigned int blockY = 0;
+    gio->GetWriteBlockSize(sizeof(typename InputImageType::InternalPixelType),
+                           inImg->GetNumberOfComponentsPerPixel(),
+                           blockX, blockY);
+
+    return blockY > 0 ? blockY : 1;
+}
+
+template<class TInputImage>
+unsigned int
+StreamingRATImageFileWriter<TInputImage>
+::EstimateAutoStreamingLines(InputImageType* inputPtr,
+                             const OutputImageRegionType& region,
+                             double availableRAM)
+{
+    typedef PipelineMemoryPrintCalculator MemoryCalculatorType;
+
+    const unsigned int sd = InputImageDimension - 1;
+    const unsigned long numLines = region.GetSize(sd);
+
+    unsigned int blockHeight = this->GetOutputBlockHeight();
+    if (blockHeight > numLines)
+    {
+        blockHeight = 1;
+    }
+
+    // two trial strips (centred to capture the full halo of
+    // neighbourhood filters) to fit the linear memory model
+    // mem(lines) = fixed + lines * perLine
+    const unsigned long h1 = blockHeight < 8 ? 8 : blockHeight;
+    const unsigned long h2 = 2 * h1;
+    if (h2 >= numLines)
+    {
+        return numLines;
+    }
+
+    MemoryCalculatorType::Pointer calc = MemoryCalculatorType::New();
+    calc->SetDataToWrite(inputPtr);
+    calc->SetBias(1.0);
+
+    double print[2];
+    const unsigned long trialLines[2] = {h1, h2};
+    for (int t=0; t < 2; ++t)
+    {
+        InputImageRegionType trial = region;
+        trial.SetIndex(sd, region.GetIndex(sd) + (numLines - trialLines[t]) / 2);
+        trial.SetSize(sd, trialLines[t]);
+        inputPtr->SetRequestedRegion(trial);
+        calc->Compute(true);
+        print[t] = calc->GetMemoryPrint();
+    }
+
+    // images without source (e.g. DataBuffers, in-memory images) are
+    // fully allocated whatever we request, so count them as fixed cost
+    double bufferPrint = 0;
+    std::set<itk::DataObject*> visited;
+    std::vector<itk::ProcessObject*> procs;
+    if (inputPtr->GetSource() != nullptr)
+    {
+        procs.push_back(inputPtr->GetSource());
+    }
+    while (!procs.empty())
+    {
+        itk::ProcessObject* po = procs.back();
+        procs.pop_back();
+        for (unsigned int i=0; i < po->GetNumberOfIndexedInputs(); ++i)
+        {
+            itk::DataObject* dobj = po->GetInputs()[i].GetPointer();
+            if (dobj == nullptr || !visited.insert(dobj).second)
+            {
+                continue;
+            }
+
+            if (dobj->GetSource() != nullptr)
+            {
+                procs.push_back(dobj->GetSource());
+            }
+            else
+            {
+                itk::ImageBase<2>* img2 = dynamic_cast<itk::ImageBase<2>*>(dobj);
+                itk::ImageBase<3>* img3 = dynamic_cast<itk::ImageBase<3>*>(dobj);
+                double reqPix = 0;
+                double bufPix = 0;
+                if (img2 != nullptr)
+                {
+                    reqPix = img2->GetRequestedRegion().GetNumberOfPixels();
+                    bufPix = img2->GetBufferedRegion().GetNumberOfPixels();
+                }
+                else if (img3 != nullptr)
+                {
+                    reqPix = img3->GetRequestedRegion().GetNumberOfPixels();
+                    bufPix = img3->GetBufferedRegion().GetNumberOfPixels();
+                }
+
+                if (reqPix > 0)
+                {
+                    bufferPrint += calc->EvaluateDataObjectPrint(dobj)
+                                    * (bufPix / reqPix);
+                }
+            }
+        }
+    }
+
+    const double perLine = (print[1] - print[0]) / (double)(h2 - h1);
+    double fixed = print[0] - perLine * h1;
+    fixed = fixed > 0 ? fixed : 0;
+    fixed += bufferPrint;
+
+    NMProcDebug(<< "AUTO streaming: fixed=" << fixed * MemoryCalculatorType::ByteToMegabyte
+                << " MB, per line=" << perLine / 1024.0 << " KB, budget="
+                << availableRAM * MemoryCalculatorType::ByteToMegabyte << " MB");
+
+    if (perLine <= 0)
+    {
+        return numLines;
+    }
+
+    double lines = (availableRAM - fixed) / perLine;
+    if (lines < blockHeight)
+    {
+        NMProcWarn(<< "The available memory (" << availableRAM * MemoryCalculatorType::ByteToMegabyte
+                   << " MB) is too small for the estimated pipeline footprint; "
+                   << "streaming " << blockHeight << " line(s) at a time!");
+        return blockHeight;
+    }
+
+    if (lines >= numLines)
+    {
+        return numLines;
+    }
+
+    // align to the output block size
+    unsigned long numLinesPerDiv = static_cast<unsigned long>(lines);
+    numLinesPerDiv = (numLinesPerDiv / blockHeight) * blockHeight;
+
+    return numLinesPerDiv;
+}
+
 template<class TInputImage>
 void
 StreamingRATImageFileWriter<TInputImage>
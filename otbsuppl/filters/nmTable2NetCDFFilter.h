@@ -39,6 +39,12 @@
 /*!
  *  \brief Table2NetCDFFilter copies a table into a netcdf file
  *
+ *  For each requested (output) region, the rows whose dimension variables
+ *  fall within the region are fetched and written to the pixel denoted by
+ *  their dimension values, i.e. the order of the rows in the table
+ *  doesn't matter. To avoid full table scans per stream division, a
+ *  composite index on the dimension variables is created (if not
+ *  already present) before the first region is processed.
  */
 
 namespace nm
@@ -198,7 +204,7 @@ protected:
     std::string m_NcGroupName;
     std::vector<std::string> m_DimVarNames; // x, y, z  INTEGER (0...n-1)
     std::vector<std::string> m_VarAndDimDescriptors; // var, dim1, dim2, ...
-    std::vector<int> m_DimColDimId;
+    std::vector<int> m_DimColDimId; // dimension index of m_ColNames[1..n]
 
 
 
@@ -36,6 +36,8 @@
 #include "otbSQLiteTable.h"
 #include "otbImageMetadata.h"
 
+#include <algorithm>
+
 namespace nm
 {
 
@@ -318,15 +320,36 @@ bool Table2NetCDFFilter< TInputImage, TOutputImage >
         return false;
     }
 
+    // we fetch the image variable first, followed by the
+    // (non-dummy) dimension variables, which we use to compute
+    // the pixel's offset into the output buffer, so that we
+    // neither have to rely on nor to ask for a specific
+    // order of the result set
     m_ColNames.push_back(m_ImageVarName);
-    otb::AttributeTable::ColumnValue cv;
-    m_ColValues.push_back(cv);
-
-
-    // -----------------------------------------------------
-    //          ALLOCATE OUTPUT
-
-    this->AllocateOutputs();
+    m_DimColDimId.clear();
+    std::vector<std::string> idxCols;
+    for (int d=0; d < m_WhereClauseHelper.size(); ++d)
+    {
+        if (m_WhereClauseHelper.at(d).compare("__dummy__") != 0)
+        {
+            m_ColNames.push_back(m_WhereClauseHelper.at(d));
+            m_DimColDimId.push_back(d);
+            idxCols.insert(idxCols.begin(), m_WhereClauseHelper.at(d));
+        }
+    }
+    m_ColValues.resize(m_ColNames.size());
+
+    // without a (composite) index on the dimension variables
+    // each region query results in a full table scan; the index
+    // columns are ordered from the slowest (i.e. the dimension
+    // stream divisions are split along) to the fastest varying
+    // dimension, so that a division's range predicate on the
+    // leading column narrows down the index scan
+    if (idxCols.size() > 0 && !sqltab->CreateIndex(idxCols, false))
+    {
+        NMProcWarn(<< "Failed creating an index on the dimension variables; "
+                   << "this may slow down the conversion considerably!");
+    }
 
     return true;
 }
@@ -343,87 +366,131 @@ void Table2NetCDFFilter< TInputImage, TOutputImage >
         }
     }
 
+    // (re-)allocate the output for the currently
+    // requested region (i.e. stream division)
+    this->AllocateOutputs();
+
     OutputImagePointerType outImg = this->GetOutput(0);
     OutputRegionType outRegion = outImg->GetRequestedRegion();
     OutputRegionType outLPR = outImg->GetLargestPossibleRegion();
     m_NumPixel = outLPR.GetNumberOfPixels();
 
-    std::stringstream orderBy;
-    orderBy << " order by ";
+    // pixels not covered by the table are set to zero
+    outImg->FillBuffer(itk::NumericTraits<OutputPixelType>::ZeroValue());
+
     std::stringstream strWC;
-    strWC << " where ";
-    for (int col=0, cnt=0; col < m_WhereClauseHelper.size(); ++col, ++cnt)
+    int numCrit = 0;
+    for (int col=0; col < m_WhereClauseHelper.size(); ++col)
     {
-        if (m_WhereClauseHelper.at(col).compare("__dummy__") > 0)
-        {
-            strWC << m_WhereClauseHelper.at(col) << " between "
-                  << outRegion.GetIndex(col) << " and "
-                  << (outRegion.GetIndex(col) + outRegion.GetSize(col) - 1)
-                  << " ";
-
-
-            orderBy << m_WhereClauseHelper.at(col);
-        }
-        else
+        if (m_WhereClauseHelper.at(col).compare("__dummy__") == 0)
         {
             continue;
         }
 
-        if (col < cnt-1)
-        {
-            strWC << " and ";
-            orderBy << ", ";
-        }
+        strWC << (numCrit == 0 ? " where " : " and ")
+              << "\"" << m_WhereClauseHelper.at(col) << "\" between "
+              << outRegion.GetIndex(col) << " and "
+              << (outRegion.GetIndex(col) + outRegion.GetSize(col) - 1);
+        ++numCrit;
     }
-    std::string whereClause = strWC.str() + orderBy.str();
 
-    otb::SQLiteTable::Pointer sqltab = m_vRAT.at(0);
-    if (!sqltab->PrepareBulkGet(m_ColNames, whereClause, false))
+    if (!m_SQLWhereClause.empty())
     {
-        itkExceptionMacro(<< "Fetching table values for output region failed: "
-                          << sqltab->getLastLogMsg() << endl);
-        return;
+        strWC << (numCrit == 0 ? " where (" : " and (")
+              << m_SQLWhereClause << ")";
     }
+    const std::string whereClause = strWC.str();
 
-    sqltab->BeginTransaction();
-    bool brow = sqltab->DoBulkGet(m_ColValues);
-    if (brow == false)
+    otb::SQLiteTable::Pointer sqltab = m_vRAT.at(0);
+    if (!sqltab->PrepareBulkGet(m_ColNames, whereClause, false))
     {
         itkExceptionMacro(<< "Fetching table values for output region failed: "
                           << sqltab->getLastLogMsg() << endl);
-        sqltab->EndTransaction();
         return;
     }
 
-    OutputIteratorType outIter(outImg, outRegion);
+    // the pixel's offset is computed from the dimension
+    // variables' values; dummy dimensions stay at the
+    // region's start index
+    OutputPixelType* outBuf = outImg->GetBufferPointer();
+    typename OutputImageType::IndexType pixIdx = outRegion.GetIndex();
+    const typename OutputImageType::IndexType regStart = outRegion.GetIndex();
+    const typename OutputImageType::SizeType regSize = outRegion.GetSize();
+    const int numDimCols = m_DimColDimId.size();
+
+    const SizeValueType numRegPix = outRegion.GetNumberOfPixels();
+    const SizeValueType progStep = std::max<SizeValueType>(numRegPix / 100, 1);
+    SizeValueType numRows = 0;
+    SizeValueType numSkipped = 0;
 
-    while (!outIter.IsAtEnd() && brow)
+    sqltab->BeginTransaction();
+    while (sqltab->DoBulkGet(m_ColValues))
     {
-        while (!outIter.IsAtEndOfLine() && brow)
+        bool bInRegion = true;
+        for (int dc=0; dc < numDimCols; ++dc)
         {
-            const otb::AttributeTable::TableColumnType colType = m_ColValues[0].type;
-            switch(colType)
+            const otb::AttributeTable::ColumnValue& dv = m_ColValues[dc+1];
+            const int d = m_DimColDimId[dc];
+            const long long di = dv.type == otb::AttributeTable::ATTYPE_INT
+                                 ? dv.ival
+                                 : static_cast<long long>(dv.dval);
+
+            if (    di < regStart[d]
+                 || di >= static_cast<long long>(regStart[d] + regSize[d])
+               )
             {
-                case otb::AttributeTable::ATTYPE_INT:
-                    outIter.Set(static_cast<OutputPixelType>(m_ColValues[0].ival));
-                    break;
-                case otb::AttributeTable::ATTYPE_DOUBLE:
-                    outIter.Set(static_cast<OutputPixelType>(m_ColValues[0].dval));
-                    break;
-                default: break;
+                bInRegion = false;
+                break;
             }
+            pixIdx[d] = di;
+        }
 
-            ++outIter;
-            ++m_PixelCounter;
-            this->UpdateProgress(m_PixelCounter / m_NumPixel);
+        if (!bInRegion)
+        {
+            ++numSkipped;
+            continue;
+        }
 
-            brow = sqltab->DoBulkGet(m_ColValues);
+        const otb::AttributeTable::ColumnValue& iv = m_ColValues[0];
+        switch(iv.type)
+        {
+            case otb::AttributeTable::ATTYPE_INT:
+                outBuf[outImg->ComputeOffset(pixIdx)] = static_cast<OutputPixelType>(iv.ival);
+                break;
+            case otb::AttributeTable::ATTYPE_DOUBLE:
+                outBuf[outImg->ComputeOffset(pixIdx)] = static_cast<OutputPixelType>(iv.dval);
+                break;
+            default: break;
+        }
+
+        ++numRows;
+        if (numRows % progStep == 0)
+        {
+            this->UpdateProgress(static_cast<double>(m_PixelCounter + numRows)
+                                 / static_cast<double>(m_NumPixel));
         }
-        outIter.NextLine();
     }
     sqltab->EndTransaction();
 
-    this->UpdateProgress(1.0);
+    // DoBulkGet returns false at the end of the result set as well as
+    // on errors, so we make sure we haven't just got part of the rows
+    if (sqltab->BulkGetFailed())
+    {
+        itkExceptionMacro(<< "Fetching table values for output region failed after "
+                          << numRows + numSkipped << " rows: "
+                          << sqltab->getLastLogMsg() << endl);
+        return;
+    }
+
+    if (numSkipped > 0)
+    {
+        NMProcWarn(<< "Skipped " << numSkipped << " table rows with "
+                   << "dimension values outside the output region!");
+    }
+
+    m_PixelCounter += numRegPix;
+    this->UpdateProgress(static_cast<double>(m_PixelCounter)
+                         / static_cast<double>(m_NumPixel));
 }
 
 
@@ -212,6 +212,7 @@ void CombineTwoFilter< TInputImage, TOutputImage >
         if (m_OutputTableFileName.empty() && !m_Workspace.empty())
         {
             m_OutputTableFileName = m_Workspace + "/" + otb::SQLiteTable::GetRandomString(10) + ".ldb";
+            m_ComboTable->SetScratchMode(true);
         }
 
         if (m_ComboTable->CreateTable(m_OutputTableFileName, "1")
@@ -37,6 +37,7 @@
 #include <string>
 #include <iostream>
 #include "itkImageToImageFilter.h"
+#include "otbSharedBufferImageContainer.h"
 #include "nmlog.h"
 #define ctxCubeSliceToImage2DFilter "CubeSliceToImage2DFilter"
 
@@ -94,6 +95,17 @@ public:
   void SetInputIndex(std::vector<long long>& vec) {m_InputIndex = vec;}
   std::vector<long long> GetInputIndex(std::vector<long long>& vec) {return m_InputIndex;}
 
+  /*! Whether the output may share the input's buffer rather than
+   *  copying the slice, which only happens, if both have the same
+   *  pixel type, the dimensions keep their order and the slice is a
+   *  contiguous block of the input buffer (e.g. when slicing along
+   *  the slowest axis); note: if the input's source re-executes
+   *  while the output is still in use, it may overwrite the shared
+   *  pixels (default: false) */
+  itkSetMacro(ShareInputBuffer, bool)
+  itkGetMacro(ShareInputBuffer, bool)
+  itkBooleanMacro(ShareInputBuffer)
+
   void GenerateOutputInformation(void);
   void GenerateInputRequestedRegion(void);
 
@@ -102,11 +114,25 @@ protected:
   CubeSliceToImage2DFilter();
   ~CubeSliceToImage2DFilter();
 
+  /*! shares the input buffer, if requested and possible,
+   *  and copies the slice otherwise */
+  void GenerateData(void);
+
+  /*! the input region corresponding to the given output region */
+  InputRegionType GetInputRegion(const OutputRegionType& outRegion) const;
+
+  /*! whether the input dimensions remaining in the output keep their order */
+  bool KeepsDimOrder(void) const;
+
   void
   ThreadedGenerateData(
           const OutputRegionType& outputRegionForThread,
           itk::ThreadIdType threadId );
 
+  /*! copies (and casts) a scanline of num contiguous pixels */
+  static void CopyLine(const InputImagePixelType* in,
+                       OutputImagePixelType* out, long num);
+
 
   std::vector<int> m_DimMapping;
 
@@ -117,6 +143,8 @@ protected:
   int m_CollapsedDimIndex;
   std::vector<int> m_In2OutIdxMap;
 
+  bool m_ShareInputBuffer;
+
 
 
 }; // end of class definition
@@ -29,15 +29,21 @@
 #include "itkImageRegionIterator.h"
 //#include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkImageScanlineConstIterator.h"
 //#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 
+#include <cstring>
+#include <type_traits>
+
 namespace otb {
 
 template <class TInputImage, class TOutputImage>
 CubeSliceToImage2DFilter<TInputImage, TOutputImage>
 ::CubeSliceToImage2DFilter()
-    : m_CollapsedDimIndex(-1)
+    : m_CollapsedDimIndex(-1),
+      m_ShareInputBuffer(false)
 {
     //this->SetNumberOfThreads(1);
 }
@@ -152,9 +158,9 @@ void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
 }
 
 template <class TInputImage, class TOutputImage>
-void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
-::ThreadedGenerateData(const OutputRegionType &outputRegionForThread,
-          itk::ThreadIdType threadId )
+typename CubeSliceToImage2DFilter<TInputImage, TOutputImage>::InputRegionType
+CubeSliceToImage2DFilter<TInputImage, TOutputImage>
+::GetInputRegion(const OutputRegionType& outRegion) const
 {
     InputRegionType inRegion;
     // cover the output's two dimensions (x, y)
@@ -167,10 +173,56 @@ void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
         }
         else
         {
-            inRegion.SetSize(d, outputRegionForThread.GetSize(m_In2OutIdxMap[d]));
-            inRegion.SetIndex(d, outputRegionForThread.GetIndex(m_In2OutIdxMap[d]));
+            inRegion.SetSize(d, outRegion.GetSize(m_In2OutIdxMap[d]));
+            inRegion.SetIndex(d, outRegion.GetIndex(m_In2OutIdxMap[d]));
         }
     }
+    return inRegion;
+}
+
+template <class TInputImage, class TOutputImage>
+bool CubeSliceToImage2DFilter<TInputImage, TOutputImage>
+::KeepsDimOrder(void) const
+{
+    for (int d=0, last=-1; d < InputImageDimension; ++d)
+    {
+        if (d != m_CollapsedDimIndex)
+        {
+            if (m_In2OutIdxMap[d] < last)
+            {
+                return false;
+            }
+            last = m_In2OutIdxMap[d];
+        }
+    }
+    return true;
+}
+
+template <class TInputImage, class TOutputImage>
+void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
+::GenerateData(void)
+{
+    if (m_ShareInputBuffer && this->KeepsDimOrder())
+    {
+        TOutputImage* out = this->GetOutput();
+        const OutputRegionType outRegion = out->GetRequestedRegion();
+        if (ShareContiguousBlock(this->GetInput(), this->GetInputRegion(outRegion),
+                                 out, outRegion))
+        {
+            this->UpdateProgress(1.0);
+            return;
+        }
+    }
+
+    Superclass::GenerateData();
+}
+
+template <class TInputImage, class TOutputImage>
+void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputRegionType &outputRegionForThread,
+          itk::ThreadIdType threadId )
+{
+    const InputRegionType inRegion = this->GetInputRegion(outputRegionForThread);
 
     //const long inputNumPix = inRegion.GetNumberOfPixels();
     //const long outputNumPix = outputRegionForThread.GetNumberOfPixels();
@@ -181,6 +233,36 @@ void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
     //                          << "inRegion=" << inputNumPix << " | outRegion=" << outputNumPix);
     //    }
 
+    // if the remaining input dimensions keep their order in the
+    // output and the x-axis isn't collapsed, input and output
+    // scanlines correspond one to one and are contiguous in memory,
+    // so we copy them as a whole rather than pixel by pixel
+    if (m_CollapsedDimIndex != 0 && this->KeepsDimOrder())
+    {
+        const TInputImage* in = this->GetInput();
+        TOutputImage* out = this->GetOutput();
+        const InputImagePixelType* inBuf = in->GetBufferPointer();
+        OutputImagePixelType* outBuf = out->GetBufferPointer();
+        const long lineLength = outputRegionForThread.GetSize(0);
+
+        itk::ProgressReporter progress(this, threadId,
+                    outputRegionForThread.GetNumberOfPixels() / lineLength);
+
+        itk::ImageScanlineConstIterator<TInputImage> inIter(in, inRegion);
+        itk::ImageScanlineIterator<TOutputImage> outIter(out, outputRegionForThread);
+        while (!inIter.IsAtEnd())
+        {
+            CopyLine(inBuf + in->ComputeOffset(inIter.GetIndex()),
+                     outBuf + out->ComputeOffset(outIter.GetIndex()),
+                     lineLength);
+
+            inIter.NextLine();
+            outIter.NextLine();
+            progress.CompletedPixel();
+        }
+        return;
+    }
+
     using InIterType  = itk::ImageRegionConstIterator<TInputImage>;
     using OutIterType = itk::ImageRegionIterator<TOutputImage>;
 
@@ -199,6 +281,22 @@ void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
 }
 
 
+template <class TInputImage, class TOutputImage>
+void CubeSliceToImage2DFilter<TInputImage, TOutputImage>
+::CopyLine(const InputImagePixelType* in, OutputImagePixelType* out, long num)
+{
+    if (std::is_same<InputImagePixelType, OutputImagePixelType>::value)
+    {
+        std::memcpy(out, in, num * sizeof(OutputImagePixelType));
+    }
+    else
+    {
+        for (long i=0; i < num; ++i)
+        {
+            out[i] = static_cast<OutputImagePixelType>(in[i]);
+        }
+    }
+}
 
 } // end of namespace
 
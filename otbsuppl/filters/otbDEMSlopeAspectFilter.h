@@ -32,7 +32,14 @@
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionIterator.h"
 
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "vnl/vnl_math.h"
+
 #include "nmlog.h"
+#include "otbHaloRowCache.h"
 // ToDo: check, if really required
 //#include "itkConceptChecking.h"
 
@@ -40,6 +47,61 @@
 
 namespace otb {
 
+/*! Gradient policies of the DEMSlopeAspectFilter kernel: compute
+ *  dZ/dX and dZ/dY for n consecutive pixels from three row buffers
+ *  (z0: row above, z1: centre row, z2: row below), each padded by
+ *  one pixel on either side (i.e. pixel c is centred at z1[c+1])
+ */
+struct DEMHornGradient
+{
+    enum {IsHorn = 1};
+
+    // after Horn 1981; dZ/dY is positive downwards (south)
+    static inline void Compute(const double* z0, const double* z1, const double* z2,
+                               long n, double xdist, double ydist,
+                               double* zx, double* zy)
+    {
+        for (long c=0; c < n; ++c)
+        {
+            zx[c] = ((z0[c+2] + 2*z1[c+2] + z2[c+2]) - (z0[c] + 2*z1[c] + z2[c])) / (8*xdist);
+            zy[c] = ((z2[c+2] + 2*z2[c+1] + z2[c]) - (z0[c+2] + 2*z0[c+1] + z0[c])) / (8*ydist);
+        }
+    }
+
+    static inline double North(const double& zy) {return -zy;}
+    static inline double Aspect(const double& zx, const double& zy)
+        {return std::atan2(zy, zx) - vnl_math::pi / 2.0;}
+};
+
+struct DEMZevenbergenGradient
+{
+    enum {IsHorn = 0};
+
+    // after Zevenbergen & Thorne 1987; dZ/dY is positive upwards (north)
+    static inline void Compute(const double* z0, const double* z1, const double* z2,
+                               long n, double xdist, double ydist,
+                               double* zx, double* zy)
+    {
+        for (long c=0; c < n; ++c)
+        {
+            zx[c] = (z1[c+2] - z1[c]) / (2*xdist);
+            zy[c] = (z0[c+1] - z2[c+1]) / (2*ydist);
+        }
+    }
+
+    static inline double North(const double& zy) {return zy;}
+    static inline double Aspect(const double& zx, const double& zy)
+        {return std::atan2(zx, zy) - vnl_math::pi;}
+};
+
+/*! Computes terrain attributes from a DEM (and a flow accumulation
+ *  image for LS, Wetness, and SedTransport). The filter works on
+ *  three row buffers per output row rather than neighbourhood
+ *  iterators; the gradient algorithm is selected once per region
+ *  (template policy) rather than per pixel. When several attributes
+ *  are requested (SetTerrainAttributes), they're all computed in a
+ *  single pass over the DEM, one output per attribute.
+ */
 template <class TInputImage, class TOutputImage=TInputImage >
 class NMOTBSUPPLFILTERS_EXPORT DEMSlopeAspectFilter
 			: public itk::ImageToImageFilter<TInputImage, TOutputImage>
@@ -74,7 +136,8 @@ public:
   using KernelIterType = itk::ConstNeighborhoodIterator<InputImageType>;
   using RegionIterType = itk::ImageRegionIterator<OutputImageType>;
 
-  typedef enum {TERRAIN_SLOPE, TERRAIN_LS, TERRAIN_WETNESS, TERRAIN_SEDTRANS} TerrainAttribute;
+  typedef enum {TERRAIN_SLOPE, TERRAIN_LS, TERRAIN_WETNESS, TERRAIN_SEDTRANS,
+                TERRAIN_ASPECT, TERRAIN_PLANCURV, TERRAIN_PROFCURV, TERRAIN_HILLSHADE} TerrainAttribute;
   typedef enum {GRADIENT_DEGREE, GRADIENT_PERCENT, GRADIENT_ASPECT, GRADIENT_DIMLESS} AttributeUnit;
   typedef enum {ALGO_HORN, ALGO_ZEVEN} TerrainAlgorithm;
 
@@ -89,13 +152,26 @@ public:
   itkSetStringMacro( TerrainAlgorithm )
 
   /*! supported terrain attributes
-   * Slope          // slope angle
-   * LS             // (R)USLE LS factor (Desmet & Govers)
-   * Wetness        // topographic wetness index
-   * SedTransport   // Moore & Burch 1986 (cited in Mitasova et al. 1996)
+   * Slope              // slope angle
+   * LS                 // (R)USLE LS factor (Desmet & Govers)
+   * Wetness            // topographic wetness index
+   * SedTransport       // Moore & Burch 1986 (cited in Mitasova et al. 1996)
+   * Aspect             // 0-360 (north=0 deg., clockwise)
+   * PlanCurvature      // Zevenbergen & Thorne 1987 (1/m)
+   * ProfileCurvature   // Zevenbergen & Thorne 1987 (1/m)
+   * Hillshade          // 0-255
    */
   itkSetStringMacro( TerrainAttribute )
 
+  /*! computes all given terrain attributes in one pass, one output
+   *  per attribute (in the given order); supersedes TerrainAttribute
+   *  unless the list is empty */
+  void SetTerrainAttributes(const std::vector<std::string>& attributes);
+
+  /*! illumination for Hillshade (degrees; azimuth clockwise from north) */
+  itkSetMacro(HillshadeAzimuth, double)
+  itkSetMacro(HillshadeAltitude, double)
+
   /*! supported units for slope
    * Dim.less   // tan(angle)
    * Degree     // 0-90
@@ -124,14 +200,20 @@ protected:
     void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                            itk::ThreadIdType threadId);
 
-    void Slope(const NeighborhoodType& nh, double* val);
-	void dZdX(const NeighborhoodType& nh, double* val);
-	void dZdY(const NeighborhoodType& nh, double* val);
-    void LS(const NeighborhoodType& nDem, const InputImagePixelType& flowacc,
-            double* val);
-    void Wetness(const NeighborhoodType& nDem, const InputImagePixelType& flowacc,
+    template <class TGradient>
+    void FusedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                           itk::ThreadIdType threadId);
+
+    void loadRow(const InputImageType* img, long y, long x0, long n, double* row);
+
+    template <class TGradient>
+    void Slope(const double& zx, const double& zy, double* val);
+    template <class TGradient>
+    void LS(const double& zx, const double& zy, bool equalelev,
+            const double& flowacc, double* val);
+    void Wetness(const double& zx, const double& zy, const double& flowacc,
                  double* val);
-    void SedTrans(const NeighborhoodType& nDem, const InputImagePixelType& flowacc,
+    void SedTrans(const double& zx, const double& zy, const double& flowacc,
                   double* val);
 
 
@@ -145,15 +227,25 @@ private:
     std::string m_TerrainAlgorithm;
     std::string m_TerrainAttribute;
     std::string m_AttributeUnit;
+    std::vector<std::string> m_TerrainAttributes;
 
     TerrainAlgorithm m_eTerrainAlgorithm;
-    TerrainAttribute m_eTerrainAttribute;
+    std::vector<TerrainAttribute> m_eTerrainAttributes;
     AttributeUnit    m_eAttributeUnit;
+    bool m_bNeedsFlowAcc;
+
+    double m_HillshadeAzimuth;
+    double m_HillshadeAltitude;
 
 
     std::vector<std::string> m_IMGNames;
     std::vector<std::string> m_DataNames;
 
+    // the DEM rows of the previous stream division
+    // we need for the current one
+    HaloRowCache<InputImageType> m_HaloCache;
+    const InputImageType* m_DEMInput;
+
     static const double RtoD;
     static const double DegToRad;
     static const double Pi;
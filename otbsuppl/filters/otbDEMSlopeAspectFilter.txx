@@ -54,12 +54,16 @@ DEMSlopeAspectFilter<TInputImage, TOutputImage>
 ::DEMSlopeAspectFilter()
     : m_TerrainAlgorithm("Zevenbergen"),
       m_TerrainAttribute("Slope"),
-      m_AttributeUnit("Degree")
+      m_AttributeUnit("Degree"),
+      m_bNeedsFlowAcc(false),
+      m_HillshadeAzimuth(315.0),
+      m_HillshadeAltitude(45.0)
 {
     this->SetNumberOfRequiredInputs(1);
     this->SetNumberOfRequiredOutputs(1);
 
     this->m_Pixcounter = 0;
+    this->m_DEMInput = nullptr;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -88,6 +92,25 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
     this->Modified();
 }
 
+template <class TInputImage, class TOutputImage>
+void DEMSlopeAspectFilter<TInputImage, TOutputImage>
+::SetTerrainAttributes(const std::vector<std::string>& attributes)
+{
+    m_TerrainAttributes = attributes;
+
+    const unsigned int numOutputs = std::max<size_t>(1, attributes.size());
+    this->SetNumberOfIndexedOutputs(numOutputs);
+    this->SetNumberOfRequiredOutputs(numOutputs);
+    for (unsigned int o=1; o < numOutputs; ++o)
+    {
+        if (this->GetOutput(o) == nullptr)
+        {
+            this->SetNthOutput(o, this->MakeOutput(o));
+        }
+    }
+    this->Modified();
+}
+
 template <class TInputImage, class TOutputImage>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 ::SetNthInput(itk::DataObject::DataObjectPointerArraySizeType num, itk::DataObject* input)
@@ -187,7 +210,12 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
   // crop the input requested region at the input's largest possible region
   if ( inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()) )
     {
-    inputPtr->SetRequestedRegion( inputRequestedRegion );
+    // don't request again the DEM rows we've kept from the
+    // previous stream division (we only pad the first input)
+    m_HaloCache.ResetOnFirstDivision(outputPtr.GetPointer());
+    m_HaloCache.SetHaloRows(inputPtr.GetPointer() == this->GetDEMImage() ? 2 : 0);
+    inputPtr->SetRequestedRegion(
+          m_HaloCache.GetRegionToRequest(inputPtr, inputRequestedRegion) );
     return;
     }
   else
@@ -211,6 +239,7 @@ template <class TInputImage, class TOutputImage>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 ::BeforeThreadedGenerateData()
 {
+    m_DEMInput = nullptr;
     InputImageType* dem = this->GetDEMImage();
     if (dem == nullptr)
     {
@@ -218,6 +247,8 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
         return;
     }
 
+    m_DEMInput = dem == this->GetInput() ? m_HaloCache.Assemble(dem) : dem;
+
     InputImageType* flowacc = this->GetFlowAccImage();
 
     // assign enums for controlling processing
@@ -230,38 +261,66 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
         m_eTerrainAlgorithm = ALGO_ZEVEN;
     }
 
-    if (m_TerrainAttribute.compare("Slope") == 0)
+    // one attribute per output
+    std::vector<std::string> attributes = m_TerrainAttributes;
+    if (attributes.empty())
     {
-        m_eTerrainAttribute = TERRAIN_SLOPE;
+        attributes.push_back(m_TerrainAttribute);
     }
-    else if (m_TerrainAttribute.compare("LS") == 0)
+
+    m_eTerrainAttributes.clear();
+    m_bNeedsFlowAcc = false;
+    for (size_t a=0; a < attributes.size(); ++a)
     {
-        m_eTerrainAttribute = TERRAIN_LS;
-        if (flowacc == nullptr)
+        const std::string& attr = attributes.at(a);
+        if (attr.compare("Slope") == 0)
         {
-            NMProcErr(<< "No flow accumulation input layer specified!");
-            return;
+            m_eTerrainAttributes.push_back(TERRAIN_SLOPE);
         }
-    }
-    else if (m_TerrainAttribute.compare("Wetness") == 0)
-    {
-        m_eTerrainAttribute = TERRAIN_WETNESS;
-        if (flowacc == nullptr)
+        else if (attr.compare("LS") == 0)
         {
-            NMProcErr(<< "No flow accumulation input layer specified!");
-            return;
+            m_eTerrainAttributes.push_back(TERRAIN_LS);
+            m_bNeedsFlowAcc = true;
         }
-    }
-    else if (m_TerrainAttribute.compare("SedTransport") == 0)
-    {
-        m_eTerrainAttribute = TERRAIN_SEDTRANS;
-        if (flowacc == nullptr)
+        else if (attr.compare("Wetness") == 0)
+        {
+            m_eTerrainAttributes.push_back(TERRAIN_WETNESS);
+            m_bNeedsFlowAcc = true;
+        }
+        else if (attr.compare("SedTransport") == 0)
+        {
+            m_eTerrainAttributes.push_back(TERRAIN_SEDTRANS);
+            m_bNeedsFlowAcc = true;
+        }
+        else if (attr.compare("Aspect") == 0)
         {
-            NMProcErr(<< "No flow accumulation input layer specified!");
+            m_eTerrainAttributes.push_back(TERRAIN_ASPECT);
+        }
+        else if (attr.compare("PlanCurvature") == 0)
+        {
+            m_eTerrainAttributes.push_back(TERRAIN_PLANCURV);
+        }
+        else if (attr.compare("ProfileCurvature") == 0)
+        {
+            m_eTerrainAttributes.push_back(TERRAIN_PROFCURV);
+        }
+        else if (attr.compare("Hillshade") == 0)
+        {
+            m_eTerrainAttributes.push_back(TERRAIN_HILLSHADE);
+        }
+        else
+        {
+            NMProcErr(<< "Unknown terrain attribute '" << attr << "'!");
             return;
         }
     }
 
+    if (m_bNeedsFlowAcc && flowacc == nullptr)
+    {
+        NMProcErr(<< "No flow accumulation input layer specified!");
+        return;
+    }
+
     if (m_AttributeUnit.compare("Degree") == 0)
     {
         m_eAttributeUnit = GRADIENT_DEGREE;
@@ -278,6 +337,11 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
     {
         m_eAttributeUnit = GRADIENT_DIMLESS;
     }
+
+    // get pixel size in x and y direction
+    InputImageSpacingType spacing = dem->GetSpacing();
+    m_xdist = spacing[0];
+    m_ydist = spacing[1];
 }
 
 
@@ -286,146 +350,228 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                        itk::ThreadIdType threadId)
 {
-    OutputImagePointer pOutImg = this->GetOutput();
-    InputImageConstPointer pInImg = this->GetDEMImage();
-    InputImageConstPointer pFaImg = this->GetFlowAccImage();
+    // pick the gradient kernel once rather than per pixel
+    if (m_eTerrainAlgorithm == ALGO_HORN)
+    {
+        this->template FusedGenerateData<DEMHornGradient>(outputRegionForThread, threadId);
+    }
+    else
+    {
+        this->template FusedGenerateData<DEMZevenbergenGradient>(outputRegionForThread, threadId);
+    }
 
-    // Find the data-set boundary "faces"
-    InputImageSizeType radius;
-    radius.Fill(1);
+    NMProcDebug(<< "num pix: " << m_Pixcounter);
+}
 
-    typename itk::NeighborhoodAlgorithm
-            ::ImageBoundaryFacesCalculator<InputImageType>::FaceListType faceList;
-    itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType> bC;
-    faceList = bC(pInImg, outputRegionForThread, radius);
+template <class TInputImage, class TOutputImage>
+void DEMSlopeAspectFilter<TInputImage, TOutputImage>
+::loadRow(const InputImageType* img, long y, long x0, long n, double* row)
+{
+    // zero flux Neumann boundary condition, i.e. we
+    // repeat the pixels at the edge of the buffered region
+    const InputImageRegionType& bufReg = img->GetBufferedRegion();
+    const long bx0 = bufReg.GetIndex(0);
+    const long bx1 = bx0 + static_cast<long>(bufReg.GetSize(0)) - 1;
+    const long by0 = bufReg.GetIndex(1);
+    const long by1 = by0 + static_cast<long>(bufReg.GetSize(1)) - 1;
+
+    y = std::min(std::max(y, by0), by1);
+    const InputImagePixelType* src = img->GetBufferPointer()
+            + (y - by0) * static_cast<long>(bufReg.GetSize(0));
+
+    for (long c=0; c < n; ++c)
+    {
+        const long x = std::min(std::max(x0 + c, bx0), bx1);
+        row[c] = static_cast<double>(src[x - bx0]);
+    }
+}
 
-    typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType>
-            ::FaceListType::iterator fit;
+template <class TInputImage, class TOutputImage>
+template <class TGradient>
+void DEMSlopeAspectFilter<TInputImage, TOutputImage>
+::FusedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                    itk::ThreadIdType threadId)
+{
+    const InputImageType* pDem = m_DEMInput;
+    const InputImageType* pFa = m_bNeedsFlowAcc ? this->GetFlowAccImage() : nullptr;
+    if (pDem == nullptr || (m_bNeedsFlowAcc && pFa == nullptr))
+    {
+        return;
+    }
 
     // support progress methods/callbacks
     itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+    const long nx = outputRegionForThread.GetSize(0);
+    const long ny = outputRegionForThread.GetSize(1);
+    const long ox0 = outputRegionForThread.GetIndex(0);
+    const long oy0 = outputRegionForThread.GetIndex(1);
 
-	// get pixel size in x and y direction
-    InputImageSpacingType spacing = pInImg->GetSpacing();
-	m_xdist = spacing[0];
-    m_ydist = spacing[1];
+    // the rows above, at, and below the current output row, each
+    // padded by one pixel on either side; the buffers are rotated
+    // as we move down, so every DEM row is read only once
+    std::vector<double> rowBuf(3 * (nx+2));
+    double* z0 = &rowBuf[0];
+    double* z1 = z0 + (nx+2);
+    double* z2 = z1 + (nx+2);
+
+    std::vector<double> zx(nx), zy(nx), fa(nx), val(nx);
+
+    const size_t numAttr = m_eTerrainAttributes.size();
+    std::vector<OutputImageType*> outImgs(numAttr);
+    for (size_t a=0; a < numAttr; ++a)
+    {
+        outImgs[a] = this->GetOutput(a);
+    }
 
-    itk::ZeroFluxNeumannBoundaryCondition<TInputImage> bndCond;
+    // hillshade illumination vector (x: east, y: north, z: up)
+    const double zenith = (90.0 - m_HillshadeAltitude) * DegToRad;
+    const double azimuth = m_HillshadeAzimuth * DegToRad;
+    const double lx = std::sin(zenith) * std::sin(azimuth);
+    const double ly = std::sin(zenith) * std::cos(azimuth);
+    const double lz = std::cos(zenith);
 
-    KernelIterType inIter;
-    RegionIterType outIter;
-    InputRegionConstIterType faIter;
+    // curvature denominators
+    const double dxx = m_xdist * m_xdist;
+    const double dyy = m_ydist * m_ydist;
+    const double dxy = 4 * m_xdist * m_ydist;
 
     typedef typename itk::PixelTraits< OutputImagePixelType >::ValueType OutputValueType;
-    OutputValueType nodata = itk::NumericTraits< OutputValueType >::ZeroValue();
-    switch (m_eTerrainAttribute)
+    const double slopeNodata = static_cast<double>(itk::NumericTraits< OutputValueType >::ZeroValue());
+
+    for (long r=0; r < ny; ++r)
     {
-    case TERRAIN_SLOPE:
-        for (fit = faceList.begin(); fit != faceList.end(); ++fit)
+        const long y = oy0 + r;
+        if (r == 0)
         {
-            inIter = KernelIterType(radius, pInImg, *fit);
-            inIter.OverrideBoundaryCondition(&bndCond);
-            outIter = RegionIterType(pOutImg, *fit);
-
-            for (inIter.GoToBegin(), outIter.GoToBegin(); !inIter.IsAtEnd(); ++inIter, ++outIter)
-            {
-                double val;
-                NeighborhoodType nh = inIter.GetNeighborhood();
-                this->Slope(nh, &val);
-                val = std::isnan(val) ? nodata : val;
-                outIter.Set(val);
-
-                progress.CompletedPixel();
-            }
+            this->loadRow(pDem, y-1, ox0-1, nx+2, z0);
+            this->loadRow(pDem, y  , ox0-1, nx+2, z1);
         }
-        break;
-
-    case TERRAIN_LS:
-        for (fit = faceList.begin(); fit != faceList.end(); ++fit)
+        else
         {
-            inIter = KernelIterType(radius, pInImg, *fit);
-            inIter.OverrideBoundaryCondition(&bndCond);
-
-            faIter = InputRegionConstIterType(pFaImg, *fit);
-            outIter = RegionIterType(pOutImg, *fit);
-
-            for (inIter.GoToBegin(), outIter.GoToBegin(), faIter.GoToBegin();
-                 !inIter.IsAtEnd();
-                 ++inIter, ++outIter, ++faIter
-                 )
-            {
-                double val;
-                NeighborhoodType nh = inIter.GetNeighborhood();
-                InputImagePixelType fa = faIter.Get();
-                this->LS(nh, fa, &val);
-                val = std::isnan(val) ? m_Nodata : val;
-                outIter.Set(val);
-
-                ++m_Pixcounter;
-                progress.CompletedPixel();
-            }
+            double* tmp = z0;
+            z0 = z1;
+            z1 = z2;
+            z2 = tmp;
         }
-        break;
+        this->loadRow(pDem, y+1, ox0-1, nx+2, z2);
 
-     case TERRAIN_WETNESS:
-        for (fit = faceList.begin(); fit != faceList.end(); ++fit)
+        TGradient::Compute(z0, z1, z2, nx, m_xdist, m_ydist, &zx[0], &zy[0]);
+        if (pFa != nullptr)
         {
-            inIter = KernelIterType(radius, pInImg, *fit);
-            inIter.OverrideBoundaryCondition(&bndCond);
+            this->loadRow(pFa, y, ox0, nx, &fa[0]);
+        }
 
-            faIter = InputRegionConstIterType(pFaImg, *fit);
-            outIter = RegionIterType(pOutImg, *fit);
+        for (size_t a=0; a < numAttr; ++a)
+        {
+            double nodata = m_Nodata;
+            switch (m_eTerrainAttributes[a])
+            {
+            case TERRAIN_SLOPE:
+                nodata = slopeNodata;
+                for (long c=0; c < nx; ++c)
+                {
+                    this->template Slope<TGradient>(zx[c], zy[c], &val[c]);
+                }
+                break;
+
+            case TERRAIN_ASPECT:
+                for (long c=0; c < nx; ++c)
+                {
+                    double asp = TGradient::Aspect(zx[c], zy[c]) * 180 / vnl_math::pi;
+                    val[c] = asp < 0 ? asp + 360 : asp;
+                }
+                break;
+
+            case TERRAIN_PLANCURV:
+            case TERRAIN_PROFCURV:
+                {
+                    const bool bPlan = m_eTerrainAttributes[a] == TERRAIN_PLANCURV;
+                    for (long c=0; c < nx; ++c)
+                    {
+                        // Zevenbergen & Thorne 1987
+                        const double z5 = z1[c+1];
+                        const double D = ((z1[c] + z1[c+2]) / 2 - z5) / dxx;
+                        const double E = ((z0[c+1] + z2[c+1]) / 2 - z5) / dyy;
+                        const double F = (-z0[c] + z0[c+2] + z2[c] - z2[c+2]) / dxy;
+                        const double G = zx[c];
+                        const double H = TGradient::North(zy[c]);
+                        const double gh = G*G + H*H;
+                        if (gh == 0)
+                        {
+                            val[c] = 0;
+                        }
+                        else if (bPlan)
+                        {
+                            val[c] = 2 * (D*H*H + E*G*G - F*G*H) / gh;
+                        }
+                        else
+                        {
+                            val[c] = -2 * (D*G*G + E*H*H + F*G*H) / gh;
+                        }
+                    }
+                }
+                break;
+
+            case TERRAIN_HILLSHADE:
+                for (long c=0; c < nx; ++c)
+                {
+                    // cos of the angle between surface normal and light
+                    const double G = zx[c];
+                    const double H = TGradient::North(zy[c]);
+                    const double cosi = (-G*lx - H*ly + lz) / std::sqrt(1 + G*G + H*H);
+                    val[c] = cosi > 0 ? 255 * cosi : 0;
+                }
+                break;
+
+            case TERRAIN_LS:
+                for (long c=0; c < nx; ++c)
+                {
+                    //check planar slope (i.e. the neighbouring cells show equal elevation)
+                    const bool equalelev =    z0[c]   == z0[c+1] && z0[c+1] == z0[c+2]
+                                           && z0[c+2] == z1[c]   && z1[c]   == z1[c+1]
+                                           && z1[c+1] == z1[c+2] && z1[c+2] == z2[c]
+                                           && z2[c]   == z2[c+1];
+                    this->template LS<TGradient>(zx[c], zy[c], equalelev, fa[c], &val[c]);
+                }
+                break;
+
+            case TERRAIN_WETNESS:
+                for (long c=0; c < nx; ++c)
+                {
+                    this->Wetness(zx[c], zy[c], fa[c], &val[c]);
+                }
+                break;
+
+            case TERRAIN_SEDTRANS:
+                for (long c=0; c < nx; ++c)
+                {
+                    this->SedTrans(zx[c], zy[c], fa[c], &val[c]);
+                }
+                break;
+            }
 
-            for (inIter.GoToBegin(), outIter.GoToBegin(), faIter.GoToBegin();
-                 !inIter.IsAtEnd();
-                 ++inIter, ++outIter, ++faIter
-                 )
+            OutputImageIndexType outIdx;
+            outIdx[0] = ox0;
+            outIdx[1] = y;
+            OutputImagePixelType* outRow = outImgs[a]->GetBufferPointer()
+                                            + outImgs[a]->ComputeOffset(outIdx);
+            for (long c=0; c < nx; ++c)
             {
-                double val;
-                NeighborhoodType nh = inIter.GetNeighborhood();
-                InputImagePixelType fa = faIter.Get();
-                this->Wetness(nh, fa, &val);
-                val = std::isnan(val) ? m_Nodata : val;
-                outIter.Set(val);
-
-                ++m_Pixcounter;
-                progress.CompletedPixel();
+                outRow[c] = static_cast<OutputImagePixelType>(std::isnan(val[c]) ? nodata : val[c]);
             }
         }
-        break;
 
-     case TERRAIN_SEDTRANS:
-        for (fit = faceList.begin(); fit != faceList.end(); ++fit)
+        if (m_bNeedsFlowAcc)
         {
-            inIter = KernelIterType(radius, pInImg, *fit);
-            inIter.OverrideBoundaryCondition(&bndCond);
-
-            faIter = InputRegionConstIterType(pFaImg, *fit);
-            outIter = RegionIterType(pOutImg, *fit);
-
-            for (inIter.GoToBegin(), outIter.GoToBegin(), faIter.GoToBegin();
-                 !inIter.IsAtEnd();
-                 ++inIter, ++outIter, ++faIter
-                 )
-            {
-                double val;
-                NeighborhoodType nh = inIter.GetNeighborhood();
-                InputImagePixelType fa = faIter.Get();
-                this->SedTrans(nh, fa, &val);
-                val = std::isnan(val) ? m_Nodata : val;
-                outIter.Set(val);
-
-                ++m_Pixcounter;
-                progress.CompletedPixel();
-            }
+            m_Pixcounter += nx;
         }
 
+        for (long c=0; c < nx; ++c)
+        {
+            progress.CompletedPixel();
+        }
     }
-
-    NMProcDebug(<< "num pix: " << m_Pixcounter);
-
-    //NMDebug(<< "Leave FlowAcc::GenerateData" << std::endl);
 }
 
 template <class TInputImage, class TOutputImage>
@@ -468,39 +614,7 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 
 template <class TInputImage, class TOutputImage>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::dZdX(const NeighborhoodType& nh, double* val)
-{
-    switch (m_eTerrainAlgorithm)
-	{
-    case ALGO_ZEVEN:
-        *val = (-nh[3] + nh[5]) / (2*m_xdist);
-		break;
-    case ALGO_HORN:
-	default:
-        *val = ((nh[2] + 2*nh[5] + nh[8]) - (nh[0] + 2*nh[3] + nh[6])) / (8*m_xdist);
-		break;
-	}
-}
-
-template <class TInputImage, class TOutputImage>
-void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::dZdY(const NeighborhoodType& nh, double* val)
-{
-    switch (m_eTerrainAlgorithm)
-	{
-    case ALGO_ZEVEN:
-        *val = (nh[1] - nh[7]) / (2*m_ydist);
-		break;
-    case ALGO_HORN:
-	default:
-        *val = ((nh[8] + 2*nh[7] + nh[6]) - (nh[2] + 2*nh[1] + nh[0])) / (8*m_ydist);
-		break;
-	}
-}
-
-template <class TInputImage, class TOutputImage>
-void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::Wetness(const NeighborhoodType& nDem, const InputImagePixelType& flowacc,
+::Wetness(const double& zx, const double& zy, const double& flowacc,
           double* val)
 {
     const double cellarea = m_xdist * m_ydist;
@@ -512,11 +626,7 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
     // as the diameter of a circle with area D^2 = 'cellarea'
     const double bigD = sqrt(cellarea/Pi) * 2;
 
-    double dzNdx, dzNdy;
-    dZdX(nDem, &dzNdx);
-    dZdY(nDem, &dzNdy);
-
-    const double tanbeta = sqrt(dzNdx*dzNdx + dzNdy*dzNdy);
+    const double tanbeta = sqrt(zx*zx + zy*zy);
     if (tanbeta != 0)
     {
         *val = log((flaccx/bigD) / tanbeta);
@@ -529,38 +639,27 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 
 template <class TInputImage, class TOutputImage>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::SedTrans(const NeighborhoodType& nDem, const InputImagePixelType& flowacc,
+::SedTrans(const double& zx, const double& zy, const double& flowacc,
               double* val)
 {
     const double cellarea = m_xdist * m_ydist;
     const double flaccx = static_cast<double>(flowacc * cellarea);
     //const double bigD = sqrt(cellarea/Pi) * 2;
 
-    double dzNdx, dzNdy;
-    dZdX(nDem, &dzNdx);
-    dZdY(nDem, &dzNdy);
-
-    const double sinbeta = sin(atan(sqrt(dzNdx*dzNdx + dzNdy*dzNdy)));
+    const double sinbeta = sin(atan(sqrt(zx*zx + zy*zy)));
     *val = pow((flaccx/22.13), 0.6) * pow((sinbeta/0.0896), 1.3);
 }
 
 
 template <class TInputImage, class TOutputImage>
+template <class TGradient>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::Slope(const NeighborhoodType& nh, double* val)
+::Slope(const double& zx, const double& zy, double* val)
 {
-	double zx, zy;
-	dZdX(nh, &zx);
-	dZdY(nh, &zy);
-
     switch (m_eAttributeUnit)
 	{
 	case GRADIENT_ASPECT:
-        if (m_eTerrainAlgorithm == ALGO_HORN)
-			*val = atan2(zy,zx) - vnl_math::pi / 2.0;
-		else
-			*val = atan2(zx,zy) - vnl_math::pi;
-
+        *val = TGradient::Aspect(zx, zy);
 		*val *= 180 / vnl_math::pi;
 		if (*val < 0)
 			*val += 360;
@@ -579,9 +678,10 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
 }
 
 template <class TInputImage, class TOutputImage>
+template <class TGradient>
 void DEMSlopeAspectFilter<TInputImage, TOutputImage>
-::LS(const NeighborhoodType& nDem, const InputImagePixelType &flowacc,
-     double* val)
+::LS(const double& zx, const double& zy, bool equalelev,
+     const double& flowacc, double* val)
 {
     const double cellarea = m_xdist * m_ydist;
     const double flaccx = static_cast<double>(flowacc * cellarea);
@@ -595,46 +695,31 @@ void DEMSlopeAspectFilter<TInputImage, TOutputImage>
     const int THAWINGSOIL = 0;
 
     double rise_run, sx, ax, xij, sij, lij, m, beta;
-    double dzNdx, dzNdy;
+    const double dzNdx = zx;
+    const double dzNdy = zy;
     double sinsx, sinax, cosax;
 
     // ----------------------------------------------------------------------
     *val = m_Nodata;
 
 
-    this->dZdY(nDem, &dzNdy);
-    this->dZdX(nDem, &dzNdx);
-
     rise_run = pow(((dzNdx*dzNdx) + (dzNdy*dzNdy)), 0.5);
     sx = atan(rise_run) * RtoD;
 
     //adjust aspect depending on chosen algorithm
-    switch (m_eTerrainAlgorithm)
+    if (TGradient::IsHorn) //HORN('81)-Method
     {
-    case ALGO_HORN : //HORN('81)-Method
         ax = (atan2(dzNdy,dzNdx)-1.5707963) * RtoD;
-        break;
-
-    default : //Zevenbergen & Thorne('87)-Method
+    }
+    else //Zevenbergen & Thorne('87)-Method
+    {
         ax = (atan2(dzNdx,dzNdy)-3.1415927) * RtoD;
-        break;
     }
 
     //Aspect nachbearbeiten
     if (ax < 0)
         ax +=360;
 
-    //check planar slope (i.e. the neighbouring cells show equal elevation)
-    bool equalelev = true;
-    for (int b=0; b < 7; ++b)
-    {
-        if (nDem[b] != nDem[b+1])
-        {
-            equalelev = false;
-            break;
-        }
-    }
-
     //Berechnung versch. Sinuswerte/Cosinuswerte
     sinsx = sin(sx * DegToRad);
     sinax = sin(ax * DegToRad);
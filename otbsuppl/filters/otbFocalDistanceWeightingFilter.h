@@ -42,12 +42,14 @@
 #define __otbFocalDistanceWeightingFilter_h
 
 #include <vector>
+#include <complex>
 
 #include "nmlog.h"
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkNumericTraits.h"
 #include "itkArray2D.h"
+#include "otbHaloRowCache.h"
 
 #include "nmotbsupplfilters_export.h"
 
@@ -77,6 +79,14 @@ namespace otb
  *         ordered std::vector<InputPixelType> Values (i.e. Weights(i,0) represents
  *         the weight of pixel value Values[i] for the smallest distance class.
  *
+ *         Since the weighting is a linear convolution of each value's
+ *         indicator image with a radially symmetric kernel, the filter
+ *         convolves in the frequency domain for radii >= FFTMinRadius:
+ *         each thread's region is processed in tiles (overlap-save, i.e.
+ *         tiles are read with a halo of 'radius' pixels), for which the
+ *         spectra of all values' indicator images are multiplied with the
+ *         respective kernel spectra and summed before a single inverse FFT.
+ *
  */
 template <class TInputImage, class TOutputImage>
 class NMOTBSUPPLFILTERS_EXPORT FocalDistanceWeightingFilter :
@@ -122,6 +132,12 @@ public:
   /** Get the radius of the neighbourhood used to compute the mean */
   itkGetConstReferenceMacro(Radius, unsigned int);
 
+  /** Radius from which on the filter convolves in the frequency
+   *  domain (FFT) rather than iterating the circular neighbourhood
+   *  of each pixel; 0 disables the FFT path (default: 16) */
+  itkSetMacro(FFTMinRadius, unsigned int);
+  itkGetConstMacro(FFTMinRadius, unsigned int);
+
   /** Sets the distance depending weights for user defined pixel values */
   itkSetMacro(Weights, WeightMatrixType);
 
@@ -165,17 +181,48 @@ protected:
 
   /** Before we do the real work, we just check the
    *  input data for consistency, at least partly ...
+   *  and join the input rows of this stream division
+   *  with the halo rows kept from the previous one
    */
   void BeforeThreadedGenerateData(void);
 
+  /** direct method: iterates the circular neighbourhood of each pixel */
+  void DirectGenerateData(const OutputImageRegionType& outputRegionForThread,
+                          itk::ThreadIdType threadId);
+
+  /** FFT (overlap-save) method for large radii */
+  void FFTGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId);
+
+  /** sorted unique (non-zero) distances within the radius,
+   *  i.e. the distance classes of the weights matrix columns */
+  void GetDistanceClasses(std::vector<float>& distClasses);
+
+  /** converts a pixel's weighted sum into the output pixel type;
+   *  integer outputs are truncated (as they always were), but sums
+   *  within a small epsilon of the next integer (away from zero) are
+   *  moved onto it to absorb the FFT's round-off; used by both
+   *  methods, so they produce the same output */
+  static OutputPixelType SumToOutputPixel(double sum);
+
+  /** in-place radix-2 FFT of a nx * ny (powers of 2) complex image */
+  static void FFT2D(std::vector<std::complex<double> >& data,
+                    unsigned int nx, unsigned int ny, bool inverse);
+  static void FFT1D(std::complex<double>* data, unsigned int n,
+                    unsigned int stride, bool inverse);
+
 private:
   FocalDistanceWeightingFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
   unsigned int m_Radius;
+  unsigned int m_FFTMinRadius;
   WeightMatrixType m_Weights;
   std::vector<InputPixelType> m_Values;
 
+  HaloRowCache<InputImageType> m_HaloCache;
+  const InputImageType* m_NeighbourhoodInput;
+
 };
   
 } // end namespace itk
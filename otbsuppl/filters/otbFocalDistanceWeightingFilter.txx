@@ -35,6 +35,8 @@
 #define __otbFocalDistanceWeightingFilter_txx
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include "otbFocalDistanceWeightingFilter.h"
 #include "itkConstShapedNeighborhoodIterator.h"
 #include "itkImageRegionIterator.h"
@@ -43,6 +45,7 @@
 #include "itkProgressReporter.h"
 #include "itkNeighborhoodAlgorithm.h"
 #include "itkExceptionObject.h"
+#include "vnl/vnl_math.h"
 
 
 namespace otb
@@ -53,6 +56,8 @@ FocalDistanceWeightingFilter<TInputImage, TOutputImage>
 ::FocalDistanceWeightingFilter()
 {
 	m_Radius = 6;
+	m_FFTMinRadius = 16;
+	m_NeighbourhoodInput = 0;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -87,7 +92,12 @@ FocalDistanceWeightingFilter<TInputImage, TOutputImage>
   // crop the input requested region at the input's largest possible region
   if ( inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()) )
     {
-    inputPtr->SetRequestedRegion( inputRequestedRegion );
+    // don't request again the halo rows we've kept from the
+    // previous stream division
+    m_HaloCache.ResetOnFirstDivision(outputPtr.GetPointer());
+    m_HaloCache.SetHaloRows(2 * m_Radius);
+    inputPtr->SetRequestedRegion(
+          m_HaloCache.GetRegionToRequest(inputPtr, inputRequestedRegion) );
     return;
     }
   else
@@ -150,6 +160,7 @@ FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 		throw e;
 	}
 
+	m_NeighbourhoodInput = m_HaloCache.Assemble(this->GetInput());
 }
 
 template< class TInputImage, class TOutputImage>
@@ -157,6 +168,275 @@ void
 FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                        itk::ThreadIdType threadId)
+{
+	// the direct method is O(r^2) per pixel, so we switch to
+	// the frequency domain for larger radii
+	if (m_FFTMinRadius > 0 && m_Radius >= m_FFTMinRadius)
+	{
+		this->FFTGenerateData(outputRegionForThread, threadId);
+	}
+	else
+	{
+		this->DirectGenerateData(outputRegionForThread, threadId);
+	}
+}
+
+template< class TInputImage, class TOutputImage>
+void
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::GetDistanceClasses(std::vector<float>& distClasses)
+{
+	const int radius = m_Radius;
+	distClasses.clear();
+	for (int x = radius; x >= -radius; --x)
+	{
+		for (int y = radius; y >= -radius; --y)
+		{
+			float dist = ::sqrt((double)(x * x + y * y));
+			if (dist <= radius && dist > 0
+				&& std::find(distClasses.begin(), distClasses.end(), dist) == distClasses.end())
+			{
+				distClasses.push_back(dist);
+			}
+		}
+	}
+	std::sort(distClasses.begin(), distClasses.end());
+}
+
+template< class TInputImage, class TOutputImage>
+void
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::FFT1D(std::complex<double>* data, unsigned int n, unsigned int stride, bool inverse)
+{
+	// bit reversal permutation
+	for (unsigned int i=1, j=0; i < n; ++i)
+	{
+		unsigned int bit = n >> 1;
+		for (; j & bit; bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j)
+		{
+			std::swap(data[i*stride], data[j*stride]);
+		}
+	}
+
+	// twiddle factors
+	const double sign = inverse ? 1.0 : -1.0;
+	std::vector<std::complex<double> > tw(n/2);
+	for (unsigned int k=0; k < n/2; ++k)
+	{
+		tw[k] = std::polar(1.0, sign * 2.0 * vnl_math::pi * k / n);
+	}
+
+	// butterflies
+	for (unsigned int len=2; len <= n; len <<= 1)
+	{
+		const unsigned int half = len >> 1;
+		const unsigned int step = n / len;
+		for (unsigned int i=0; i < n; i += len)
+		{
+			for (unsigned int k=0; k < half; ++k)
+			{
+				std::complex<double>& a = data[(i+k)*stride];
+				std::complex<double>& b = data[(i+k+half)*stride];
+				const std::complex<double> t = b * tw[k*step];
+				b = a - t;
+				a += t;
+			}
+		}
+	}
+}
+
+template< class TInputImage, class TOutputImage>
+void
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::FFT2D(std::vector<std::complex<double> >& data, unsigned int nx, unsigned int ny, bool inverse)
+{
+	for (unsigned int y=0; y < ny; ++y)
+	{
+		FFT1D(&data[y*nx], nx, 1, inverse);
+	}
+	for (unsigned int x=0; x < nx; ++x)
+	{
+		FFT1D(&data[x], ny, nx, inverse);
+	}
+}
+
+template< class TInputImage, class TOutputImage>
+void
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::FFTGenerateData(const OutputImageRegionType& outputRegionForThread,
+                  itk::ThreadIdType threadId)
+{
+	typename OutputImageType::Pointer output = this->GetOutput();
+	typename InputImageType::ConstPointer input = m_NeighbourhoodInput;
+
+	itk::ProgressReporter progress(this, threadId,
+			outputRegionForThread.GetNumberOfPixels());
+
+	const long radius = m_Radius;
+	const long kdim = 2 * radius + 1;
+
+	// FFT tile size (power of 2) per dimension: room for a few
+	// kernel widths, but not (much) larger than our region + halo;
+	// only the inner (n - 2*radius) pixels of a tile are valid
+	long fftSize[2];
+	long validSize[2];
+	for (int d=0; d < 2; ++d)
+	{
+		const long want = std::min<long>(outputRegionForThread.GetSize(d) + 2*radius, 4*kdim);
+		long n = 2;
+		while (n < want)
+		{
+			n <<= 1;
+		}
+		fftSize[d] = n;
+		validSize[d] = n - 2*radius;
+	}
+	const long nx = fftSize[0];
+	const long ny = fftSize[1];
+	const size_t npix = nx * ny;
+
+	// spectra of the kernels, one per value (row of the weights matrix);
+	// the kernel is radially symmetric, so convolution == correlation
+	std::vector<float> distClasses;
+	this->GetDistanceClasses(distClasses);
+
+	const size_t nvals = m_Values.size();
+	std::vector<std::vector<std::complex<double> > > kernelSpec(nvals,
+			std::vector<std::complex<double> >(npix, std::complex<double>(0, 0)));
+	for (long y = -radius; y <= radius; ++y)
+	{
+		for (long x = -radius; x <= radius; ++x)
+		{
+			float dist = ::sqrt((double)(x * x + y * y));
+			if (dist > radius || dist == 0)
+			{
+				continue;
+			}
+
+			const size_t col = std::lower_bound(distClasses.begin(), distClasses.end(), dist)
+								- distClasses.begin();
+			if (col >= m_Weights.cols())
+			{
+				continue;
+			}
+
+			const size_t kidx = ((y + ny) % ny) * nx + ((x + nx) % nx);
+			for (size_t v=0; v < nvals; ++v)
+			{
+				kernelSpec[v][kidx] = m_Weights(v, col);
+			}
+		}
+	}
+	for (size_t v=0; v < nvals; ++v)
+	{
+		FFT2D(kernelSpec[v], nx, ny, false);
+	}
+
+	// pixels outside the buffered region are zero (cf. the direct
+	// method's constant boundary condition)
+	const InputImageRegionType bufReg = input->GetBufferedRegion();
+	const long bx0 = bufReg.GetIndex(0);
+	const long bx1 = bx0 + static_cast<long>(bufReg.GetSize(0));
+	const long by0 = bufReg.GetIndex(1);
+	const long by1 = by0 + static_cast<long>(bufReg.GetSize(1));
+	const InputPixelType* inBuf = input->GetBufferPointer();
+
+	const long ox0 = outputRegionForThread.GetIndex(0);
+	const long oy0 = outputRegionForThread.GetIndex(1);
+	const long ox1 = ox0 + static_cast<long>(outputRegionForThread.GetSize(0));
+	const long oy1 = oy0 + static_cast<long>(outputRegionForThread.GetSize(1));
+
+	std::vector<int> valIdx(npix);
+	std::vector<std::complex<double> > indSpec(npix);
+	std::vector<std::complex<double> > sumSpec(npix);
+	std::vector<char> valPresent(nvals);
+
+	for (long ty = oy0; ty < oy1 && !this->GetAbortGenerateData(); ty += validSize[1])
+	{
+		for (long tx = ox0; tx < ox1 && !this->GetAbortGenerateData(); tx += validSize[0])
+		{
+			// map the tile's (incl. halo) pixels onto rows of the weights matrix
+			std::fill(valPresent.begin(), valPresent.end(), 0);
+			for (long y=0; y < ny; ++y)
+			{
+				const long iy = ty - radius + y;
+				for (long x=0; x < nx; ++x)
+				{
+					const long ix = tx - radius + x;
+					float v = 0;
+					if (ix >= bx0 && ix < bx1 && iy >= by0 && iy < by1)
+					{
+						v = inBuf[(iy - by0) * (bx1 - bx0) + (ix - bx0)];
+					}
+
+					int row = -1;
+					for (size_t r=0; r < nvals; ++r)
+					{
+						if (v == static_cast<float>(m_Values[r]))
+						{
+							row = r;
+							valPresent[r] = 1;
+							break;
+						}
+					}
+					valIdx[y*nx + x] = row;
+				}
+			}
+
+			// sum of the values' indicator spectra times kernel spectra
+			std::fill(sumSpec.begin(), sumSpec.end(), std::complex<double>(0, 0));
+			for (size_t r=0; r < nvals; ++r)
+			{
+				if (!valPresent[r])
+				{
+					continue;
+				}
+
+				for (size_t i=0; i < npix; ++i)
+				{
+					indSpec[i] = valIdx[i] == static_cast<int>(r) ? 1.0 : 0.0;
+				}
+				FFT2D(indSpec, nx, ny, false);
+
+				const std::vector<std::complex<double> >& ks = kernelSpec[r];
+				for (size_t i=0; i < npix; ++i)
+				{
+					sumSpec[i] += indSpec[i] * ks[i];
+				}
+			}
+			FFT2D(sumSpec, nx, ny, true);
+
+			// copy the valid part of the tile into the output
+			const long wx = std::min(validSize[0], ox1 - tx);
+			const long wy = std::min(validSize[1], oy1 - ty);
+			typename OutputImageType::IndexType outIdx;
+			for (long y=0; y < wy; ++y)
+			{
+				outIdx[0] = tx;
+				outIdx[1] = ty + y;
+				OutputPixelType* outRow = output->GetBufferPointer()
+											+ output->ComputeOffset(outIdx);
+				const std::complex<double>* res = &sumSpec[(y + radius) * nx + radius];
+				for (long x=0; x < wx; ++x)
+				{
+					outRow[x] = SumToOutputPixel(res[x].real() / npix);
+					progress.CompletedPixel();
+				}
+			}
+		}
+	}
+}
+
+template< class TInputImage, class TOutputImage>
+void
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::DirectGenerateData(const OutputImageRegionType& outputRegionForThread,
+                     itk::ThreadIdType threadId)
 {
 	unsigned int i;
 	itk::ConstantBoundaryCondition<InputImageType> nbc;
@@ -172,7 +452,7 @@ FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 
 	// Allocate output
 	typename OutputImageType::Pointer output = this->GetOutput();
-	typename InputImageType::ConstPointer input = this->GetInput();
+	typename InputImageType::ConstPointer input = m_NeighbourhoodInput;
 
 	// Find the data-set boundary "faces"
 	typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<
@@ -232,7 +512,7 @@ FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 		int cnt=0;
 		while (!inIt.IsAtEnd() && !this->GetAbortGenerateData())
 		{
-			float sum = 0;
+			double sum = 0;
 			for (size_t i=0; i < neighidx.size(); ++i)
 			{
 				float v = inIt.GetPixel(neighidx[i]);
@@ -255,13 +535,13 @@ FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 				{
 					if (distcl_sorted[col] == distcl[i])
 					{
-						sum += (float)m_Weights(row, col);
+						sum += m_Weights(row, col);
 						break;
 					}
 				}
 			}
 
-			outIt.Set(static_cast<OutputPixelType>(sum));
+			outIt.Set(SumToOutputPixel(sum));
 
 			++inIt;
 			++outIt;
@@ -270,6 +550,27 @@ FocalDistanceWeightingFilter< TInputImage, TOutputImage>
 	}
 }
 
+template< class TInputImage, class TOutputImage>
+typename FocalDistanceWeightingFilter< TInputImage, TOutputImage>::OutputPixelType
+FocalDistanceWeightingFilter< TInputImage, TOutputImage>
+::SumToOutputPixel(double sum)
+{
+	if (!std::numeric_limits<OutputPixelType>::is_integer)
+	{
+		return static_cast<OutputPixelType>(sum);
+	}
+
+	// the inverse FFT is only exact up to round-off, i.e. a sum
+	// of e.g. 3 may come out as 2.9999999999, which mustn't be
+	// truncated to 2
+	const double SumEpsilon = 1e-6;
+	const double tval = sum < 0 ? std::ceil(sum - SumEpsilon) : std::floor(sum + SumEpsilon);
+
+	const double outMin = static_cast<double>(itk::NumericTraits<OutputPixelType>::NonpositiveMin());
+	const double outMax = static_cast<double>(itk::NumericTraits<OutputPixelType>::max());
+	return static_cast<OutputPixelType>(std::max(outMin, std::min(outMax, tval)));
+}
+
 /**
  * Standard "PrintSelf" method
  */
@@ -283,6 +584,7 @@ FocalDistanceWeightingFilter<TInputImage, TOutput>
 	Superclass::PrintSelf(os, indent);
 	os << indent << "Parameters for the focal neighbourhood weighting:" << std::endl;
 	os << indent << "Radius of focal neighbourhood: " << m_Radius << std::endl;
+	os << indent << "Min. radius for FFT convolution: " << m_FFTMinRadius << std::endl;
 	os << indent << "Values of influence in the neigbourhood: " << std::endl;
 	for (int i = 0; i < m_Values.size(); ++i)
 	{
@@ -0,0 +1,115 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbHaloRowCache.h
+ *
+ *  Created on: 2024-06-18
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbHaloRowCache_h
+#define __otbHaloRowCache_h
+
+#include "itkImage.h"
+#include "itkImageRegion.h"
+
+namespace otb
+{
+
+/*! \brief Keeps the halo rows of a neighbourhood filter's input
+ *         between consecutive stream divisions
+ *
+ *  Neighbourhood filters pad their input requested region by the
+ *  kernel radius, so when the output is streamed in stripes, the
+ *  padded regions of two consecutive divisions overlap by 2*radius
+ *  rows, which are read (and computed upstream) twice. The cache keeps
+ *  the trailing rows of the last input region a filter has processed;
+ *  if the next padded region starts within those rows, only the rows
+ *  below them are requested from upstream and the filter's input is
+ *  re-assembled from the cached and the new rows before it is
+ *  processed. Rows are counted along the last (i.e. the slowest)
+ *  image dimension, which is the one stripes are split along.
+ *
+ *  Usage (s. NeighbourhoodCountingFilter):
+ *  - GenerateInputRequestedRegion: call ResetOnFirstDivision() with
+ *    the output and pass the padded and cropped input requested
+ *    region through GetRegionToRequest()
+ *  - BeforeThreadedGenerateData: fetch the image to process
+ *    from Assemble() and use it instead of GetInput() in
+ *    ThreadedGenerateData
+ *
+ *  The cache is invalidated whenever the input's pipeline MTime
+ *  changes or a new update starts at the output's top row (s.
+ *  ResetOnFirstDivision), and is never used when the regions of two
+ *  divisions differ other than in their row range (e.g. when tiling).
+ */
+template <class TImage>
+class HaloRowCache
+{
+public:
+    typedef TImage                              ImageType;
+    typedef typename ImageType::Pointer         ImagePointer;
+    typedef typename ImageType::RegionType      RegionType;
+    typedef typename RegionType::IndexValueType IndexValueType;
+
+    itkStaticConstMacro(RowDimension, unsigned int, TImage::ImageDimension - 1);
+
+    HaloRowCache();
+
+    /*! number of rows to keep, i.e. 2*radius along the last
+     *  dimension; 0 switches the cache off */
+    void SetHaloRows(itk::SizeValueType rows);
+    itk::SizeValueType GetHaloRows(void) const
+        {return m_HaloRows;}
+
+    /*! returns the part of the (padded) input requested region
+     *  which is not held by the cache */
+    RegionType GetRegionToRequest(const ImageType* input,
+                                  const RegionType& paddedRegion);
+
+    /*! returns the image covering the full (padded) input requested
+     *  region, i.e. either the input itself or the input's new rows
+     *  joined with the cached rows, and updates the cache */
+    const ImageType* Assemble(const ImageType* input);
+
+    /*! drops cached rows */
+    void Reset(void);
+
+    /*! drops cached rows, if the output's requested region starts at
+     *  the top row of its largest possible region, i.e. with the first
+     *  division of a new update */
+    template <class TOutputImage>
+    void ResetOnFirstDivision(const TOutputImage* output);
+
+protected:
+    itk::SizeValueType m_HaloRows;
+    itk::SizeValueType m_NumCachedRows;
+    itk::ModifiedTimeType m_InputTime;
+    RegionType m_FullRegion;
+
+    ImagePointer m_Cache;
+    ImagePointer m_Assembled;
+};
+
+} // end namespace otb
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "otbHaloRowCache.txx"
+#endif
+
+#endif // __otbHaloRowCache_h
@@ -0,0 +1,235 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbHaloRowCache.txx
+ *
+ *  Created on: 2024-06-18
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbHaloRowCache_txx
+#define __otbHaloRowCache_txx
+
+#include <algorithm>
+
+#include "otbHaloRowCache.h"
+#include "itkImageAlgorithm.h"
+#include "itkExceptionObject.h"
+
+namespace otb
+{
+
+template <class TImage>
+HaloRowCache<TImage>
+::HaloRowCache()
+    : m_HaloRows(0),
+      m_NumCachedRows(0),
+      m_InputTime(0)
+{
+}
+
+template <class TImage>
+void
+HaloRowCache<TImage>
+::SetHaloRows(itk::SizeValueType rows)
+{
+    if (rows != m_HaloRows)
+    {
+        m_HaloRows = rows;
+        this->Reset();
+    }
+}
+
+template <class TImage>
+void
+HaloRowCache<TImage>
+::Reset(void)
+{
+    m_Cache = nullptr;
+    m_Assembled = nullptr;
+    m_NumCachedRows = 0;
+    m_InputTime = 0;
+}
+
+template <class TImage>
+template <class TOutputImage>
+void
+HaloRowCache<TImage>
+::ResetOnFirstDivision(const TOutputImage* output)
+{
+    if (output == nullptr)
+    {
+        return;
+    }
+
+    const unsigned int rowDim = TOutputImage::ImageDimension - 1;
+    if (    output->GetRequestedRegion().GetIndex(rowDim)
+         <= output->GetLargestPossibleRegion().GetIndex(rowDim)
+       )
+    {
+        this->Reset();
+    }
+}
+
+template <class TImage>
+typename HaloRowCache<TImage>::RegionType
+HaloRowCache<TImage>
+::GetRegionToRequest(const ImageType* input, const RegionType& paddedRegion)
+{
+    m_FullRegion = paddedRegion;
+    m_NumCachedRows = 0;
+
+    if (    m_HaloRows == 0
+         || m_Cache.IsNull()
+         || input == nullptr
+         || input->GetPipelineMTime() != m_InputTime
+         || input->GetBufferedRegion().IsInside(paddedRegion)
+       )
+    {
+        return paddedRegion;
+    }
+
+    // we only deal with stripes, i.e. all but the
+    // row dimension must match exactly
+    const RegionType& cacheRegion = m_Cache->GetBufferedRegion();
+    for (unsigned int d=0; d < RowDimension; ++d)
+    {
+        if (    cacheRegion.GetIndex(d) != paddedRegion.GetIndex(d)
+             || cacheRegion.GetSize(d) != paddedRegion.GetSize(d)
+           )
+        {
+            return paddedRegion;
+        }
+    }
+
+    // the cached rows have to cover the top rows of the
+    // padded region, but not all of it
+    const IndexValueType cs = cacheRegion.GetIndex(RowDimension);
+    const IndexValueType ce = cs + static_cast<IndexValueType>(cacheRegion.GetSize(RowDimension));
+    const IndexValueType ps = paddedRegion.GetIndex(RowDimension);
+    const IndexValueType pe = ps + static_cast<IndexValueType>(paddedRegion.GetSize(RowDimension));
+    if (!(cs <= ps && ps < ce && ce < pe))
+    {
+        return paddedRegion;
+    }
+
+    m_NumCachedRows = ce - ps;
+
+    RegionType newRows = paddedRegion;
+    newRows.SetIndex(RowDimension, ce);
+    newRows.SetSize(RowDimension, pe - ce);
+
+    return newRows;
+}
+
+template <class TImage>
+const TImage*
+HaloRowCache<TImage>
+::Assemble(const ImageType* input)
+{
+    if (input == nullptr)
+    {
+        return input;
+    }
+
+    const ImageType* src = input;
+    if (m_NumCachedRows > 0 && !input->GetBufferedRegion().IsInside(m_FullRegion))
+    {
+        RegionType cachedRows = m_FullRegion;
+        cachedRows.SetSize(RowDimension, m_NumCachedRows);
+
+        RegionType newRows = m_FullRegion;
+        newRows.SetIndex(RowDimension, m_FullRegion.GetIndex(RowDimension) + m_NumCachedRows);
+        newRows.SetSize(RowDimension, m_FullRegion.GetSize(RowDimension) - m_NumCachedRows);
+
+        if (!input->GetBufferedRegion().IsInside(newRows))
+        {
+            itk::ExceptionObject e(__FILE__, __LINE__,
+                    "Input doesn't cover the rows requested beyond the cached halo!",
+                    ITK_LOCATION);
+            throw e;
+        }
+
+        if (m_Assembled.IsNull())
+        {
+            m_Assembled = ImageType::New();
+        }
+        m_Assembled->CopyInformation(input);
+        if (m_Assembled->GetBufferedRegion().GetSize() != m_FullRegion.GetSize())
+        {
+            m_Assembled->SetBufferedRegion(m_FullRegion);
+            m_Assembled->Allocate();
+        }
+        else
+        {
+            // same size, just shift the buffer along
+            m_Assembled->SetBufferedRegion(m_FullRegion);
+        }
+        m_Assembled->SetRequestedRegion(m_FullRegion);
+
+        itk::ImageAlgorithm::Copy(m_Cache.GetPointer(), m_Assembled.GetPointer(),
+                                  cachedRows, cachedRows);
+        itk::ImageAlgorithm::Copy(input, m_Assembled.GetPointer(),
+                                  newRows, newRows);
+        src = m_Assembled.GetPointer();
+    }
+    m_NumCachedRows = 0;
+
+    if (m_HaloRows == 0)
+    {
+        return src;
+    }
+
+    // keep the trailing rows for the next division
+    RegionType tail = m_FullRegion;
+    if (!tail.Crop(src->GetBufferedRegion()))
+    {
+        m_Cache = nullptr;
+        return src;
+    }
+
+    const itk::SizeValueType nrows = std::min(m_HaloRows, tail.GetSize(RowDimension));
+    tail.SetIndex(RowDimension, tail.GetIndex(RowDimension)
+                  + static_cast<IndexValueType>(tail.GetSize(RowDimension) - nrows));
+    tail.SetSize(RowDimension, nrows);
+
+    if (m_Cache.IsNull())
+    {
+        m_Cache = ImageType::New();
+    }
+    m_Cache->CopyInformation(src);
+    if (m_Cache->GetBufferedRegion().GetSize() != tail.GetSize())
+    {
+        m_Cache->SetBufferedRegion(tail);
+        m_Cache->Allocate();
+    }
+    else
+    {
+        m_Cache->SetBufferedRegion(tail);
+    }
+    m_Cache->SetRequestedRegion(tail);
+
+    itk::ImageAlgorithm::Copy(src, m_Cache.GetPointer(), tail, tail);
+    m_InputTime = input->GetPipelineMTime();
+
+    return src;
+}
+
+} // end namespace otb
+
+#endif // __otbHaloRowCache_txx
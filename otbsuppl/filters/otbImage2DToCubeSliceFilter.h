@@ -29,6 +29,7 @@
 #include <string>
 #include <iostream>
 #include "itkImageToImageFilter.h"
+#include "otbSharedBufferImageContainer.h"
 #include "nmlog.h"
 #define ctxImage2DToCubeSliceFilter "Image2DToCubeSliceFilter"
 
@@ -88,6 +89,16 @@ public:
   void SetOutputIndex(std::vector<long long>& vec) {m_OutputIndex = vec;}
   std::vector<long long> GetOutputIndex(std::vector<long long>& vec) {return m_OutputIndex;}
 
+  /*! Whether the output slice may share the input's buffer rather
+   *  than copying it, which only happens, if both have the same pixel
+   *  type, the dimensions keep their order and the requested region
+   *  is a contiguous block of the input buffer; note: if the input's
+   *  source re-executes while the output is still in use, it may
+   *  overwrite the shared pixels (default: false) */
+  itkSetMacro(ShareInputBuffer, bool)
+  itkGetMacro(ShareInputBuffer, bool)
+  itkBooleanMacro(ShareInputBuffer)
+
   void GenerateOutputInformation(void);
   void GenerateInputRequestedRegion(void);
 
@@ -96,11 +107,25 @@ protected:
   Image2DToCubeSliceFilter();
   ~Image2DToCubeSliceFilter();
 
+  /*! shares the input buffer, if requested and possible,
+   *  and copies the image otherwise */
+  void GenerateData(void);
+
+  /*! the input region corresponding to the given output region */
+  InputRegionType GetInputRegion(const OutputRegionType& outRegion) const;
+
+  /*! whether the input dimensions keep their order in the output */
+  bool KeepsDimOrder(void) const;
+
   void
   ThreadedGenerateData(
           const OutputRegionType& outputRegionForThread,
           itk::ThreadIdType threadId );
 
+  /*! copies (and casts) a scanline of num contiguous pixels */
+  static void CopyLine(const InputImagePixelType* in,
+                       OutputImagePixelType* out, long num);
+
 
   std::vector<int> m_DimMapping;
 
@@ -109,6 +134,8 @@ protected:
   std::vector<double> m_OutputSpacing;
   std::vector<double> m_OutputOrigin;
 
+  bool m_ShareInputBuffer;
+
 
 
 }; // end of class definition
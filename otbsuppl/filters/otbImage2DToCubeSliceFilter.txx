@@ -29,14 +29,20 @@
 #include "itkImageRegionIterator.h"
 //#include "itkImageRegionIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineIterator.h"
+#include "itkImageScanlineConstIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 
+#include <cstring>
+#include <type_traits>
+
 namespace otb {
 
 template <class TInputImage, class TOutputImage>
 Image2DToCubeSliceFilter<TInputImage, TOutputImage>
 ::Image2DToCubeSliceFilter()
+    : m_ShareInputBuffer(false)
 {
     //this->SetNumberOfThreads(1);
 }
@@ -110,16 +116,88 @@ void Image2DToCubeSliceFilter<TInputImage, TOutputImage>
     in->SetRequestedRegion(inRegion);
 }
 
+template <class TInputImage, class TOutputImage>
+typename Image2DToCubeSliceFilter<TInputImage, TOutputImage>::InputRegionType
+Image2DToCubeSliceFilter<TInputImage, TOutputImage>
+::GetInputRegion(const OutputRegionType& outRegion) const
+{
+    InputRegionType inRegion;
+    for (int d=0; d < InputImageType::ImageDimension; ++d)
+    {
+        inRegion.SetSize(d, outRegion.GetSize(m_DimMapping[d]-1));
+        inRegion.SetIndex(d, outRegion.GetIndex(m_DimMapping[d]-1));
+    }
+    return inRegion;
+}
+
+template <class TInputImage, class TOutputImage>
+bool Image2DToCubeSliceFilter<TInputImage, TOutputImage>
+::KeepsDimOrder(void) const
+{
+    for (int d=1; d < InputImageDimension; ++d)
+    {
+        if (m_DimMapping[d] < m_DimMapping[d-1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class TInputImage, class TOutputImage>
+void Image2DToCubeSliceFilter<TInputImage, TOutputImage>
+::GenerateData(void)
+{
+    if (m_ShareInputBuffer && this->KeepsDimOrder())
+    {
+        TOutputImage* out = this->GetOutput();
+        const OutputRegionType outRegion = out->GetRequestedRegion();
+        if (ShareContiguousBlock(this->GetInput(), this->GetInputRegion(outRegion),
+                                 out, outRegion))
+        {
+            this->UpdateProgress(1.0);
+            return;
+        }
+    }
+
+    Superclass::GenerateData();
+}
+
 template <class TInputImage, class TOutputImage>
 void Image2DToCubeSliceFilter<TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputRegionType &outputRegionForThread,
           itk::ThreadIdType threadId )
 {
-    InputRegionType inRegion;
-    for (int d=0; d < InputImageType::ImageDimension; ++d)
+    const InputRegionType inRegion = this->GetInputRegion(outputRegionForThread);
+
+    // if the input dimensions keep their order in the output and
+    // the x-axis is mapped onto the output's x-axis, input and output
+    // scanlines correspond one to one and are contiguous in memory,
+    // so we copy them as a whole rather than pixel by pixel
+    if (m_DimMapping[0] == 1 && this->KeepsDimOrder())
     {
-        inRegion.SetSize(d, outputRegionForThread.GetSize(m_DimMapping[d]-1));
-        inRegion.SetIndex(d, outputRegionForThread.GetIndex(m_DimMapping[d]-1));
+        const TInputImage* in = this->GetInput();
+        TOutputImage* out = this->GetOutput();
+        const InputImagePixelType* inBuf = in->GetBufferPointer();
+        OutputImagePixelType* outBuf = out->GetBufferPointer();
+        const long lineLength = outputRegionForThread.GetSize(0);
+
+        itk::ProgressReporter progress(this, threadId,
+                    outputRegionForThread.GetNumberOfPixels() / lineLength);
+
+        itk::ImageScanlineConstIterator<TInputImage> inIter(in, inRegion);
+        itk::ImageScanlineIterator<TOutputImage> outIter(out, outputRegionForThread);
+        while (!inIter.IsAtEnd())
+        {
+            CopyLine(inBuf + in->ComputeOffset(inIter.GetIndex()),
+                     outBuf + out->ComputeOffset(outIter.GetIndex()),
+                     lineLength);
+
+            inIter.NextLine();
+            outIter.NextLine();
+            progress.CompletedPixel();
+        }
+        return;
     }
 
     using InIterType  = itk::ImageRegionConstIterator<TInputImage>;
@@ -140,6 +218,22 @@ void Image2DToCubeSliceFilter<TInputImage, TOutputImage>
 }
 
 
+template <class TInputImage, class TOutputImage>
+void Image2DToCubeSliceFilter<TInputImage, TOutputImage>
+::CopyLine(const InputImagePixelType* in, OutputImagePixelType* out, long num)
+{
+    if (std::is_same<InputImagePixelType, OutputImagePixelType>::value)
+    {
+        std::memcpy(out, in, num * sizeof(OutputImagePixelType));
+    }
+    else
+    {
+        for (long i=0; i < num; ++i)
+        {
+            out[i] = static_cast<OutputImagePixelType>(in[i]);
+        }
+    }
+}
 
 } // end of namespace
 
@@ -24,6 +24,7 @@
 
 #include "itkMacro.h"
 #include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
 #include "otbImage.h"
 #include "otbSQLiteTable.h"
 #include "nmotbsupplfilters_export.h"
@@ -89,6 +90,20 @@ public:
     itkSetMacro(NcGroupName   , std::string)
     itkSetMacro(UpdateMode, int)
 
+    /** Whether to create an index on the dimension columns (DimVarNames)
+     *  of the output table; the index is only built once all pixels
+     *  have been written, since maintaining it while loading slows
+     *  down the inserts considerably (ignored in UpdateMode, which
+     *  indexes the key columns up front for looking up the rows to update)
+     */
+    itkSetMacro(CreateDimIndex, int)
+    itkGetMacro(CreateDimIndex, int)
+
+    /** The number of pixels (rows) converted (in parallel) and
+     *  written per batch */
+    itkSetMacro(BatchSize, unsigned long)
+    itkGetMacro(BatchSize, unsigned long)
+
     /** The start index of the image region to be extracted from the image */
     void SetStartIndex(std::vector<int> sindex){m_StartIndex = sindex;}
     /** The size of the image region to be extracted from the image*/
@@ -113,11 +128,37 @@ protected:
     ~Image2TableFilter();
     void operator=(const Self&);
 
+    /*! table rows of a run of consecutive pixels of the
+     *  requested region (in region order) */
+    struct RowBatch
+    {
+        SizeValueType Start;
+        SizeValueType NumRows;
+        std::vector<otb::AttributeTable::ColumnValue> Values;     // NumRows x m_ColNames
+        std::vector<otb::AttributeTable::ColumnValue> KeyValues;  // NumRows x m_KeyColNames
+    };
+
+    struct ThreadStruct
+    {
+        Pointer Filter;
+        const InputImageType* Input;
+        InputImageRegionType Region;
+        RowBatch* Batch;
+    };
+
     bool PrepTable(void);
     void GenerateData(void) override;
     void ResetPipeline();
 
+    static ITK_THREAD_RETURN_TYPE CalledFromThreader(void* arg);
+    void ConvertRows(const ThreadStruct* str, SizeValueType offset,
+                     SizeValueType length);
+    void WriteBatch(RowBatch* batch);
+    void IndexDimColumns(void);
+
     int m_UpdateMode;
+    int m_CreateDimIndex;
+    unsigned long m_BatchSize;
     std::string m_TableFileName;
     std::string m_TableName;
     std::string m_ImageVarName;
@@ -152,6 +193,10 @@ protected:
 
     SizeValueType m_NumPixel;
     SizeValueType m_PixelCounter;
+
+    // set by the writer thread
+    bool m_bWriteFailed;
+    std::string m_WriteError;
 };
 
 } // end of namespace otb
@@ -22,8 +22,9 @@
 #include "otbImageIOBase.h"
 #include "nmNetCDFIO.h"
 #include "otbNMTableReader.h"
-#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkProgressReporter.h"
+#include <algorithm>
+#include <thread>
 
 namespace otb
 {
@@ -35,9 +36,11 @@ Image2TableFilter<TInputImage>
     m_PixelCounter(0),
     m_NumPixel(0),
     m_bInsertValues(true),
-    m_UpdateMode(0)
+    m_UpdateMode(0),
+    m_CreateDimIndex(0),
+    m_BatchSize(65536),
+    m_bWriteFailed(false)
 {
-    this->SetNumberOfThreads(1);
 }
 
 template<class TInputImage>
@@ -54,6 +57,8 @@ void Image2TableFilter<TInputImage>
        << indent << "Dimension: " << InputImageDimension << std::endl
        << indent << "PixelType: " << typeid(InputImagePixelType).name() << std::endl
        << indent << "UpdateMode: " << m_UpdateMode << std::endl
+       << indent << "CreateDimIndex: " << m_CreateDimIndex << std::endl
+       << indent << "BatchSize: " << m_BatchSize << std::endl
        << indent << "TableFileName: " << m_TableFileName << std::endl
        << indent << "TableName: " << m_TableName << std::endl
        << indent << "ImageVarName: " << m_ImageVarName << std::endl
@@ -577,105 +582,104 @@ void Image2TableFilter<TInputImage>
     //                  WRTIE IMAGE & DIMS & AUX BUFFERS TO TABLE
     // ================================================================================
 
-    using IterType      = itk::ImageRegionConstIteratorWithIndex<InputImageType>;
-    using IterIndexType = typename IterType::IndexType;
-
-    IterType imgIter(input, inregion);
-    IterIndexType iterIndex;
-    itk::ProgressReporter progress(this, 0, inregion.GetNumberOfPixels());
-
+    // pixels are converted into rows by the worker threads batch by batch;
+    // while the workers fill the next batch, the writer thread inserts
+    // the previous one, so we keep two batches and swap them around
+    const SizeValueType numPix = inregion.GetNumberOfPixels();
+    const SizeValueType batchSize = std::max(static_cast<SizeValueType>(1),
+                                             std::min(static_cast<SizeValueType>(m_BatchSize), numPix));
+    const SizeValueType numBatches = (numPix + batchSize - 1) / batchSize;
+    itk::ProgressReporter progress(this, 0, numBatches);
 
     if (!this->GetAbortGenerateData())
     {
         // ToDo -> always insert or not ?
+        bool bPrepared = false;
         if (m_UpdateMode)
         {
-            m_Tab->PrepareBulkSet(m_ColNames, m_KeyColNames);
+            bPrepared = m_Tab->PrepareBulkSet(m_ColNames, m_KeyColNames);
         }
         else
         {
-            m_Tab->PrepareBulkSet(m_ColNames, true);
+            bPrepared = m_Tab->PrepareBulkInsert(m_ColNames, 512);
         }
-        m_Tab->BeginTransaction();
 
-        imgIter.GoToBegin();
-        while(!imgIter.IsAtEnd())
+        if (!bPrepared)
         {
-            // main variable value
-            if (m_ColValues[0].type == otb::AttributeTable::ATTYPE_DOUBLE)
-            {
-                m_ColValues[0].dval = static_cast<double>(imgIter.Get());
-            }
-            else
-            {
-                m_ColValues[0].ival = static_cast<long long>(imgIter.Get());
-            }
+            NMProcErr(<< "Failed preparing the insertion of values into '"
+                      << m_TableName << "'! " << m_Tab->getLastLogMsg());
+            this->AbortGenerateDataOn();
+        }
+    }
 
-            // dimension indices (always of integer type)
-            iterIndex = imgIter.GetIndex();
-            if (m_UpdateMode)
+    if (!this->GetAbortGenerateData())
+    {
+        RowBatch batches[2];
+        for (int b=0; b < 2; ++b)
+        {
+            batches[b].Start = 0;
+            batches[b].NumRows = 0;
+            batches[b].Values.resize(batchSize * m_ColNames.size());
+            batches[b].KeyValues.resize(batchSize * m_KeyColNames.size());
+            for (SizeValueType r=0; r < batchSize; ++r)
             {
-                for (int k=0; k < m_KeyColDimId.size(); ++k)
+                for (int c=0; c < m_ColValues.size(); ++c)
                 {
-                    const long long llval = static_cast<long long>(iterIndex[m_KeyColDimId[k]]);
-                    m_KeyColValues[k].ival = llval;
+                    batches[b].Values[r * m_ColValues.size() + c] = m_ColValues[c];
                 }
-            }
-            else
-            {
-                for (int d=0; d < m_DimColDimId.size(); ++d)
+                for (int k=0; k < m_KeyColValues.size(); ++k)
                 {
-                    const long long llval = static_cast<long long>(iterIndex[m_DimColDimId[d]]);
-                    m_ColValues[d+1].ival = llval;
+                    batches[b].KeyValues[r * m_KeyColValues.size() + k] = m_KeyColValues[k];
                 }
             }
+        }
 
+        ThreadStruct str;
+        str.Filter = this;
+        str.Input = input;
+        str.Region = inregion;
 
-            // auxillary variables (e.g. coordinate variables for nc files)
-            const int idoff = m_UpdateMode ? 1 : m_DimColDimId.size() + 1;
-            for (int v=0; v < m_AuxVarNames.size(); ++v)
-            {
-                //size_t boff = iterIndex[m_AuxVarDimMap[v][0]] - m_StartIndex[m_AuxVarDimMap[v][0]];
-                size_t boff = iterIndex[m_AuxVarDimMap[v][0]] - inputIndex[m_AuxVarDimMap[v][0]];
-                for (int bd=1; bd < m_AuxVarDimMap[v].size(); ++bd)
-                {
-                    //boff += (iterIndex[m_AuxVarDimMap[v][bd]] - m_StartIndex[m_AuxVarDimMap[v][bd]]) * m_Size[m_AuxVarDimMap[v][bd-1]];
-                    boff += (iterIndex[m_AuxVarDimMap[v][bd]] - inputIndex[m_AuxVarDimMap[v][bd]]) * inputSize[m_AuxVarDimMap[v][bd-1]];
-                }
+        m_bWriteFailed = false;
+        m_WriteError.clear();
+        std::thread writer;
 
-                if (m_ColValues[v+idoff].type == otb::AttributeTable::ATTYPE_DOUBLE)
-                {
-                    m_ColValues[v+idoff].dval = static_cast<double*>(m_AuxBuffer[v])[boff];
-                }
-                else
-                {
-                    m_ColValues[v+idoff].ival = static_cast<long long*>(m_AuxBuffer[v])[boff];
-                }
-            }
+        m_Tab->BeginTransaction();
+        for (SizeValueType bn=0; bn < numBatches && !this->GetAbortGenerateData(); ++bn)
+        {
+            RowBatch& batch = batches[bn % 2];
+            batch.Start = bn * batchSize;
+            batch.NumRows = std::min(batchSize, numPix - batch.Start);
 
-            // write values to table
-            if (m_UpdateMode)
+            str.Batch = &batch;
+            this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+            this->GetMultiThreader()->SetSingleMethod(this->CalledFromThreader, &str);
+            this->GetMultiThreader()->SingleMethodExecute();
+
+            // only one thread at a time is talking to the database
+            if (writer.joinable())
             {
-                if (!m_Tab->DoBulkSet(m_ColValues, m_KeyColValues))
-                {
-                    NMProcErr(<< m_Tab->getLastLogMsg());
-                    m_Tab->EndTransaction();
-                    return;
-                }
+                writer.join();
             }
-            else
+            if (m_bWriteFailed)
             {
-                if (!m_Tab->DoBulkSet(m_ColValues))
-                {
-                    NMProcErr(<< m_Tab->getLastLogMsg());
-                    m_Tab->EndTransaction();
-                    return;
-                }
+                break;
             }
+            writer = std::thread(&Self::WriteBatch, this, &batch);
 
-            ++imgIter;
             progress.CompletedPixel();
         }
+
+        if (writer.joinable())
+        {
+            writer.join();
+        }
+
+        if (m_bWriteFailed)
+        {
+            NMProcErr(<< m_WriteError);
+            m_Tab->EndTransaction();
+            return;
+        }
         m_Tab->EndTransaction();
     }
 
@@ -700,10 +704,194 @@ void Image2TableFilter<TInputImage>
     // tidy up
     if (m_PixelCounter == m_NumPixel)
     {
+        if (m_CreateDimIndex && !m_UpdateMode)
+        {
+            this->IndexDimColumns();
+        }
         ResetPipeline();
     }
 }
 
+template<class TInputImage>
+ITK_THREAD_RETURN_TYPE
+Image2TableFilter<TInputImage>
+::CalledFromThreader(void* arg)
+{
+    const long threadId = ((itk::MultiThreader::ThreadInfoStruct *)(arg))->ThreadID;
+    const long threadCount = ((itk::MultiThreader::ThreadInfoStruct *)(arg))->NumberOfThreads;
+    ThreadStruct* str = (ThreadStruct *)(((itk::MultiThreader::ThreadInfoStruct *)(arg))->UserData);
+
+    const SizeValueType numRows = str->Batch->NumRows;
+    const SizeValueType chunk = (numRows + threadCount - 1) / threadCount;
+    const SizeValueType offset = threadId * chunk;
+
+    if (offset < numRows)
+    {
+        str->Filter->ConvertRows(str, offset, std::min(chunk, numRows - offset));
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+}
+
+template<class TInputImage>
+void Image2TableFilter<TInputImage>
+::ConvertRows(const ThreadStruct* str, SizeValueType offset, SizeValueType length)
+{
+    using IndexValueType = typename InputImageIndexType::IndexValueType;
+
+    const InputImageType* input = str->Input;
+    const InputImageRegionType& region = str->Region;
+    const InputImageSizeType& inputSize = region.GetSize();
+    const InputImageIndexType& inputIndex = region.GetIndex();
+    RowBatch* batch = str->Batch;
+
+    // index of the first pixel of this chunk
+    InputImageIndexType iterIndex;
+    SizeValueType rem = batch->Start + offset;
+    for (unsigned int d=0; d < InputImageDimension; ++d)
+    {
+        iterIndex[d] = inputIndex[d] + static_cast<IndexValueType>(rem % inputSize[d]);
+        rem /= inputSize[d];
+    }
+
+    const InputImagePixelType* buf = input->GetBufferPointer();
+    const InputImagePixelType* pix = buf + input->ComputeOffset(iterIndex);
+    const IndexValueType lineEnd = inputIndex[0] + static_cast<IndexValueType>(inputSize[0]);
+
+    const bool bDoubleVal = m_ColValues[0].type == otb::AttributeTable::ATTYPE_DOUBLE;
+    const int numCols = m_ColNames.size();
+    const int numKeys = m_KeyColNames.size();
+    const int idoff = m_UpdateMode ? 1 : m_DimColDimId.size() + 1;
+
+    for (SizeValueType r=offset; r < offset + length; ++r)
+    {
+        otb::AttributeTable::ColumnValue* row = &batch->Values[r * numCols];
+
+        // main variable value
+        if (bDoubleVal)
+        {
+            row[0].dval = static_cast<double>(*pix);
+        }
+        else
+        {
+            row[0].ival = static_cast<long long>(*pix);
+        }
+
+        // dimension indices (always of integer type)
+        if (m_UpdateMode)
+        {
+            otb::AttributeTable::ColumnValue* keys = &batch->KeyValues[r * numKeys];
+            for (int k=0; k < m_KeyColDimId.size(); ++k)
+            {
+                keys[k].ival = static_cast<long long>(iterIndex[m_KeyColDimId[k]]);
+            }
+        }
+        else
+        {
+            for (int d=0; d < m_DimColDimId.size(); ++d)
+            {
+                row[d+1].ival = static_cast<long long>(iterIndex[m_DimColDimId[d]]);
+            }
+        }
+
+        // auxillary variables (e.g. coordinate variables for nc files)
+        for (int v=0; v < m_AuxVarNames.size(); ++v)
+        {
+            size_t boff = iterIndex[m_AuxVarDimMap[v][0]] - inputIndex[m_AuxVarDimMap[v][0]];
+            for (int bd=1; bd < m_AuxVarDimMap[v].size(); ++bd)
+            {
+                boff += (iterIndex[m_AuxVarDimMap[v][bd]] - inputIndex[m_AuxVarDimMap[v][bd]]) * inputSize[m_AuxVarDimMap[v][bd-1]];
+            }
+
+            if (row[v+idoff].type == otb::AttributeTable::ATTYPE_DOUBLE)
+            {
+                row[v+idoff].dval = static_cast<double*>(m_AuxBuffer[v])[boff];
+            }
+            else
+            {
+                row[v+idoff].ival = static_cast<long long*>(m_AuxBuffer[v])[boff];
+            }
+        }
+
+        // move on to the next pixel in region order
+        ++pix;
+        if (++iterIndex[0] >= lineEnd)
+        {
+            iterIndex[0] = inputIndex[0];
+            for (unsigned int d=1; d < InputImageDimension; ++d)
+            {
+                if (++iterIndex[d] < inputIndex[d] + static_cast<IndexValueType>(inputSize[d]))
+                {
+                    break;
+                }
+                iterIndex[d] = inputIndex[d];
+            }
+
+            if (r + 1 < offset + length)
+            {
+                pix = buf + input->ComputeOffset(iterIndex);
+            }
+        }
+    }
+}
+
+template<class TInputImage>
+void Image2TableFilter<TInputImage>
+::WriteBatch(RowBatch* batch)
+{
+    if (!m_UpdateMode)
+    {
+        if (!m_Tab->DoBulkInsert(batch->Values, batch->NumRows))
+        {
+            m_WriteError = m_Tab->getLastLogMsg();
+            m_bWriteFailed = true;
+        }
+        return;
+    }
+
+    // updates can't be batched into a single statement, so
+    // we just run the prepared update row by row
+    const int numCols = m_ColNames.size();
+    const int numKeys = m_KeyColNames.size();
+    std::vector<otb::AttributeTable::ColumnValue> values(numCols);
+    std::vector<otb::AttributeTable::ColumnValue> keyValues(numKeys);
+    for (SizeValueType r=0; r < batch->NumRows; ++r)
+    {
+        for (int c=0; c < numCols; ++c)
+        {
+            values[c] = batch->Values[r * numCols + c];
+        }
+        for (int k=0; k < numKeys; ++k)
+        {
+            keyValues[k] = batch->KeyValues[r * numKeys + k];
+        }
+
+        if (!m_Tab->DoBulkSet(values, keyValues))
+        {
+            m_WriteError = m_Tab->getLastLogMsg();
+            m_bWriteFailed = true;
+            return;
+        }
+    }
+}
+
+template<class TInputImage>
+void Image2TableFilter<TInputImage>
+::IndexDimColumns(void)
+{
+    std::vector<std::string> dimCols;
+    for (int d=0; d < m_DimColDimId.size(); ++d)
+    {
+        dimCols.push_back(m_ColNames.at(d+1));
+    }
+
+    if (dimCols.size() > 0 && !m_Tab->CreateIndex(dimCols, false))
+    {
+        NMProcWarn(<< "Failed creating an index on the dimension columns of '"
+                   << m_TableName << "'! " << m_Tab->getLastLogMsg());
+    }
+}
+
 template<class TInputImage>
 void Image2TableFilter<TInputImage>
 ::ResetPipeline()
@@ -0,0 +1,219 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbLUAllocationFilter.h
+ *
+ *  Created on: 2024-05-06
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbLUAllocationFilter_h
+#define __otbLUAllocationFilter_h
+
+#include <vector>
+
+#include "nmlog.h"
+#include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkTimeStamp.h"
+#include "itkNumericTraits.h"
+
+#include "nmotbsupplfilters_export.h"
+
+namespace otb
+{
+
+/*! \brief Demand-driven, competitive land-use allocation
+ *
+ *  The filter takes one potential (suitability) raster per land use
+ *  (indexed inputs 0 .. N-1) and allocates each pixel to the land use
+ *  with the highest score P_k + e_k, where e_k is an elasticity
+ *  determined per land use such that the allocated area matches the
+ *  land use's demand. Pixels whose best score is negative, or for which
+ *  none of the potentials is valid (i.e. neither nodata nor NaN), are
+ *  assigned the ResidualCode.
+ *
+ *  Elasticities are solved for by Gauss-Seidel sweeps over the land uses:
+ *  given the current elasticities of the competitors, the elasticity of
+ *  land use k is set between the D_k-th and (D_k+1)-th smallest margin
+ *  max(0, max_{j!=k}(P_j + e_j)) - P_k over all pixels (D_k being the
+ *  demand in pixels), which is found by a partial sort (nth_element).
+ *  For each pixel only the best and second best score is kept and updated
+ *  in parallel after each elasticity change, so a sweep takes
+ *  O(N * #pixels). Sweeps are repeated until the largest relative
+ *  deviation between allocated area and demand falls below the
+ *  Tolerance or MaxIterations sweeps have been done. Land uses with a
+ *  negative demand are not constrained (e_k = 0).
+ *
+ *  Since demands are global, the potential rasters are always requested
+ *  in full, while the solved elasticities are kept as long as neither
+ *  the inputs nor the filter parameters change; hence the output can be
+ *  streamed without re-solving for each stream division.
+ */
+template <class TInputImage, class TOutputImage>
+class NMOTBSUPPLFILTERS_EXPORT LUAllocationFilter
+        : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+    /** Standard class typedefs. */
+    typedef LUAllocationFilter                                  Self;
+    typedef itk::ImageToImageFilter<TInputImage, TOutputImage>  Superclass;
+    typedef itk::SmartPointer<Self>                             Pointer;
+    typedef itk::SmartPointer<const Self>                       ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self);
+
+    /** Run-time type information (and related methods). */
+    itkTypeMacro(LUAllocationFilter, itk::ImageToImageFilter);
+
+    typedef TInputImage                                 InputImageType;
+    typedef typename InputImageType::Pointer            InputImagePointer;
+    typedef typename InputImageType::RegionType         InputImageRegionType;
+    typedef typename InputImageType::PixelType          InputPixelType;
+
+    typedef TOutputImage                                OutputImageType;
+    typedef typename OutputImageType::Pointer           OutputImagePointer;
+    typedef typename OutputImageType::RegionType        OutputImageRegionType;
+    typedef typename OutputImageType::PixelType         OutputPixelType;
+
+    /*! Area demand per land use (input) in squared map units;
+     *  a negative demand denotes an unconstrained land use */
+    void SetDemands(const std::vector<double>& demands)
+        {m_Demands = demands; this->Modified();}
+    std::vector<double> GetDemands(void) const
+        {return m_Demands;}
+
+    /*! Output codes of the land uses, in the order of the inputs;
+     *  defaults to 1 .. N */
+    void SetLandUseCodes(const std::vector<OutputPixelType>& codes)
+        {m_LandUseCodes = codes; this->Modified();}
+    std::vector<OutputPixelType> GetLandUseCodes(void) const
+        {return m_LandUseCodes;}
+
+    /*! Code of pixels not allocated to any land use */
+    itkSetMacro(ResidualCode, OutputPixelType)
+    itkGetMacro(ResidualCode, OutputPixelType)
+
+    /*! Potential value denoting 'not suitable / nodata' */
+    itkSetMacro(Nodata, InputPixelType)
+    itkGetMacro(Nodata, InputPixelType)
+
+    /*! Max relative deviation of allocated areas from demands */
+    itkSetMacro(Tolerance, double)
+    itkGetMacro(Tolerance, double)
+
+    /*! Max number of Gauss-Seidel sweeps */
+    itkSetMacro(MaxIterations, int)
+    itkGetMacro(MaxIterations, int)
+
+    /// convergence diagnostics of the last solve
+    std::vector<double> GetElasticities(void) const {return m_Elasticities;}
+    /*! allocated area per land use (squared map units) */
+    std::vector<double> GetAllocatedAreas(void) const {return m_AllocatedAreas;}
+    int GetNumberOfSweeps(void) const {return m_NumSweeps;}
+    double GetMaxDeviation(void) const {return m_MaxDeviation;}
+    bool GetConverged(void) const {return m_Converged;}
+
+protected:
+    LUAllocationFilter();
+    virtual ~LUAllocationFilter() {}
+    void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+    void GenerateInputRequestedRegion(void);
+    void BeforeThreadedGenerateData(void);
+    void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                              itk::ThreadIdType threadId);
+
+    /*! solver phases executed in parallel over pixel ranges */
+    typedef enum
+    {
+        LUA_INIT_RANKS = 0,
+        LUA_MARGINS,
+        LUA_UPDATE_RANKS,
+        LUA_COUNT
+    } SolverPhase;
+
+    struct ThreadStruct
+    {
+        Pointer Filter;
+        SolverPhase Phase;
+        int LandUse;
+        double Delta;
+    };
+
+    static ITK_THREAD_RETURN_TYPE CalledFromThreader(void* arg);
+    void ProcessThreaded(const ThreadStruct* str, long threadId,
+                         long offset, long length);
+    void RunPhase(SolverPhase phase, int lu=-1, double delta=0.0);
+
+    void SolveElasticities(void);
+
+    /*! potential of land use lu at pixel idx or NaN if invalid */
+    inline double Potential(int lu, long idx) const
+    {
+        const double v = static_cast<double>(m_Buffers[lu][idx]);
+        return (v == m_dNodata || v != v) ? m_NaN : v;
+    }
+
+    /*! re-ranks the given pixel across all land uses */
+    void RankPixel(long idx);
+
+private:
+    LUAllocationFilter(const Self&); //purposely not implemented
+    void operator=(const Self&); //purposely not implemented
+
+    std::vector<double> m_Demands;
+    std::vector<OutputPixelType> m_LandUseCodes;
+    OutputPixelType m_ResidualCode;
+    InputPixelType m_Nodata;
+    double m_Tolerance;
+    int m_MaxIterations;
+
+    // diagnostics
+    std::vector<double> m_Elasticities;
+    std::vector<double> m_AllocatedAreas;
+    int m_NumSweeps;
+    double m_MaxDeviation;
+    bool m_Converged;
+
+    // solver state
+    itk::TimeStamp m_SolveTime;
+    long m_NumThreadsUsed;
+    long m_NumPixels;
+    double m_dNodata;
+    double m_NaN;
+    std::vector<const InputPixelType*> m_Buffers;
+    std::vector<double> m_Margins;
+    std::vector<long> m_NumValid;
+    std::vector<std::vector<long> > m_ThreadCounts;
+
+    // best and second best land use (-1 = residual) and score per pixel
+    std::vector<short> m_Best;
+    std::vector<short> m_Second;
+    std::vector<double> m_BestScore;
+    std::vector<double> m_SecondScore;
+};
+
+} // end namespace otb
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "otbLUAllocationFilter.txx"
+#endif
+
+#endif // __otbLUAllocationFilter_h
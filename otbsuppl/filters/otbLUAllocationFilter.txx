@@ -0,0 +1,545 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbLUAllocationFilter.txx
+ *
+ *  Created on: 2024-05-06
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbLUAllocationFilter_txx
+#define __otbLUAllocationFilter_txx
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "otbLUAllocationFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TOutputImage>
+LUAllocationFilter<TInputImage, TOutputImage>
+::LUAllocationFilter()
+    : m_ResidualCode(0),
+      m_Nodata(itk::NumericTraits<InputPixelType>::NonpositiveMin()),
+      m_Tolerance(0.001),
+      m_MaxIterations(50),
+      m_NumSweeps(0),
+      m_MaxDeviation(0),
+      m_Converged(false),
+      m_NumThreadsUsed(1),
+      m_NumPixels(0),
+      m_dNodata(0),
+      m_NaN(std::numeric_limits<double>::quiet_NaN())
+{
+    this->SetNumberOfRequiredInputs(1);
+    this->SetNumberOfRequiredOutputs(1);
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Land uses: " << this->GetNumberOfIndexedInputs() << std::endl;
+    os << indent << "Sweeps: " << m_NumSweeps
+       << ", max deviation: " << m_MaxDeviation
+       << ", converged: " << (m_Converged ? "yes" : "no") << std::endl;
+    for (int k=0; k < m_Elasticities.size(); ++k)
+    {
+        os << indent << "  #" << k << ": demand=" << (k < m_Demands.size() ? m_Demands[k] : -1)
+           << " allocated=" << (k < m_AllocatedAreas.size() ? m_AllocatedAreas[k] : 0)
+           << " elasticity=" << m_Elasticities[k] << std::endl;
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::GenerateInputRequestedRegion(void)
+{
+    Superclass::GenerateInputRequestedRegion();
+
+    // demands are global, so we need all of the potentials
+    for (unsigned int i=0; i < this->GetNumberOfIndexedInputs(); ++i)
+    {
+        InputImageType* in = const_cast<InputImageType*>(this->GetInput(i));
+        if (in != nullptr)
+        {
+            in->SetRequestedRegionToLargestPossibleRegion();
+        }
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::BeforeThreadedGenerateData(void)
+{
+    const unsigned int nlu = this->GetNumberOfIndexedInputs();
+    if (nlu > static_cast<unsigned int>(std::numeric_limits<short>::max()))
+    {
+        itkExceptionMacro(<< "Too many land uses: " << nlu);
+    }
+
+    if (m_Demands.size() != nlu)
+    {
+        itkExceptionMacro(<< "Number of demands (" << m_Demands.size()
+                          << ") doesn't match the number of potential layers ("
+                          << nlu << ")!");
+    }
+
+    if (m_LandUseCodes.size() != nlu)
+    {
+        if (!m_LandUseCodes.empty())
+        {
+            NMProcWarn(<< "Number of land use codes (" << m_LandUseCodes.size()
+                       << ") doesn't match the number of potential layers ("
+                       << nlu << ") - using codes 1 to " << nlu << " instead!");
+        }
+        m_LandUseCodes.clear();
+        for (unsigned int k=0; k < nlu; ++k)
+        {
+            m_LandUseCodes.push_back(static_cast<OutputPixelType>(k+1));
+        }
+    }
+
+    const InputImageType* in0 = this->GetInput(0);
+    m_Buffers.clear();
+    for (unsigned int k=0; k < nlu; ++k)
+    {
+        const InputImageType* in = this->GetInput(k);
+        if (in == nullptr)
+        {
+            itkExceptionMacro(<< "Potential layer #" << k << " is missing!");
+        }
+        if (in->GetBufferedRegion() != in0->GetBufferedRegion())
+        {
+            itkExceptionMacro(<< "Potential layer #" << k << " doesn't "
+                              << "match the extent of layer #0!");
+        }
+        m_Buffers.push_back(in->GetBufferPointer());
+    }
+    m_dNodata = static_cast<double>(m_Nodata);
+    m_NumPixels = in0->GetBufferedRegion().GetNumberOfPixels();
+
+    // re-use elasticities as long as neither inputs nor
+    // parameters have changed, e.g. while the output is streamed
+    bool bSolve = m_Elasticities.size() != nlu
+                  || this->GetMTime() > m_SolveTime.GetMTime();
+    for (unsigned int k=0; k < nlu && !bSolve; ++k)
+    {
+        const InputImageType* in = this->GetInput(k);
+        if (    in->GetMTime() > m_SolveTime.GetMTime()
+            ||  in->GetUpdateMTime() > m_SolveTime.GetMTime()
+           )
+        {
+            bSolve = true;
+        }
+    }
+
+    if (bSolve)
+    {
+        this->SolveElasticities();
+        m_SolveTime.Modified();
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::SolveElasticities(void)
+{
+    const int nlu = static_cast<int>(m_Buffers.size());
+    const typename InputImageType::SpacingType spacing = this->GetInput(0)->GetSpacing();
+    const double pixArea = std::abs(spacing[0] * spacing[1]);
+
+    // demands in number of pixels; -1 denotes unconstrained
+    std::vector<long> pixDemands(nlu, -1);
+    int numConstrained = 0;
+    for (int k=0; k < nlu; ++k)
+    {
+        if (m_Demands[k] >= 0)
+        {
+            pixDemands[k] = static_cast<long>(std::floor(m_Demands[k] / pixArea + 0.5));
+            ++numConstrained;
+        }
+    }
+
+    m_Elasticities.assign(nlu, 0.0);
+    m_AllocatedAreas.assign(nlu, 0.0);
+    m_NumValid.assign(nlu, 0);
+    m_NumSweeps = 0;
+    m_MaxDeviation = 0;
+    m_Converged = false;
+
+    m_Best.resize(m_NumPixels);
+    m_Second.resize(m_NumPixels);
+    m_BestScore.resize(m_NumPixels);
+    m_SecondScore.resize(m_NumPixels);
+    m_Margins.resize(numConstrained > 0 ? m_NumPixels : 0);
+
+    NMProcDebug(<< "LUAllocation - " << nlu << " land uses ("
+                << numConstrained << " constrained), " << m_NumPixels << " pixels");
+
+    this->RunPhase(LUA_INIT_RANKS);
+    this->RunPhase(LUA_COUNT);
+
+    const int maxSweeps = numConstrained > 0 ? std::max(1, m_MaxIterations) : 0;
+    for (int sweep=1; sweep <= maxSweeps; ++sweep)
+    {
+        for (int k=0; k < nlu; ++k)
+        {
+            if (pixDemands[k] < 0)
+            {
+                continue;
+            }
+
+            // margins e_k has to beat for each pixel, i.e. land use k is
+            // allocated where e_k > margin; invalid pixels get +inf
+            this->RunPhase(LUA_MARGINS, k);
+            const long numValid = m_NumValid[k];
+            if (numValid == 0)
+            {
+                continue;
+            }
+
+            const long dk = pixDemands[k];
+            double ek;
+            if (dk == 0)
+            {
+                ek = *std::min_element(m_Margins.begin(), m_Margins.end());
+            }
+            else if (dk >= numValid)
+            {
+                std::nth_element(m_Margins.begin(), m_Margins.begin() + (numValid-1),
+                                 m_Margins.end());
+                ek = std::nextafter(m_Margins[numValid-1],
+                                    std::numeric_limits<double>::infinity());
+            }
+            else
+            {
+                // D_k-th smallest margin is the largest of the
+                // lower partition left by nth_element
+                std::nth_element(m_Margins.begin(), m_Margins.begin() + dk,
+                                 m_Margins.end());
+                const double upper = m_Margins[dk];
+                const double lower = *std::max_element(m_Margins.begin(),
+                                                       m_Margins.begin() + dk);
+                ek = lower + (upper - lower) * 0.5;
+            }
+
+            const double delta = ek - m_Elasticities[k];
+            m_Elasticities[k] = ek;
+            if (delta != 0)
+            {
+                this->RunPhase(LUA_UPDATE_RANKS, k, delta);
+            }
+        }
+
+        this->RunPhase(LUA_COUNT);
+        m_NumSweeps = sweep;
+
+        m_MaxDeviation = 0;
+        for (int k=0; k < nlu; ++k)
+        {
+            if (pixDemands[k] >= 0)
+            {
+                const double dev = std::abs(m_AllocatedAreas[k] / pixArea - pixDemands[k])
+                                   / std::max(pixDemands[k], 1L);
+                m_MaxDeviation = std::max(m_MaxDeviation, dev);
+            }
+        }
+
+        NMProcInfo(<< "LUAllocation - sweep #" << sweep
+                   << ": max relative area deviation = " << m_MaxDeviation);
+        this->UpdateProgress(0.8 * sweep / static_cast<float>(maxSweeps));
+
+        if (m_MaxDeviation <= m_Tolerance)
+        {
+            break;
+        }
+    }
+    m_Converged = m_MaxDeviation <= m_Tolerance;
+
+    for (int k=0; k < nlu; ++k)
+    {
+        NMProcDebug(<< "LUAllocation - land use " << m_LandUseCodes[k]
+                    << ": demand=" << m_Demands[k]
+                    << " allocated=" << m_AllocatedAreas[k]
+                    << " elasticity=" << m_Elasticities[k]);
+    }
+
+    if (!m_Converged)
+    {
+        NMProcWarn(<< "LUAllocation - demands not met within tolerance ("
+                   << m_Tolerance << ") after " << m_NumSweeps << " sweeps; "
+                   << "max relative area deviation = " << m_MaxDeviation);
+    }
+
+    // the final allocation is re-computed from the elasticities
+    // per output region, so we don't need to keep the ranks
+    std::vector<short>().swap(m_Best);
+    std::vector<short>().swap(m_Second);
+    std::vector<double>().swap(m_BestScore);
+    std::vector<double>().swap(m_SecondScore);
+    std::vector<double>().swap(m_Margins);
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::RunPhase(SolverPhase phase, int lu, double delta)
+{
+    ThreadStruct str;
+    str.Filter = this;
+    str.Phase = phase;
+    str.LandUse = lu;
+    str.Delta = delta;
+
+    m_NumThreadsUsed = this->GetNumberOfThreads();
+    m_ThreadCounts.assign(m_NumThreadsUsed,
+                          std::vector<long>(m_Buffers.size() + 1, 0));
+
+    this->GetMultiThreader()->SetNumberOfThreads(m_NumThreadsUsed);
+    this->GetMultiThreader()->SetSingleMethod(this->CalledFromThreader, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    // gather per thread results
+    if (phase == LUA_MARGINS)
+    {
+        m_NumValid[lu] = 0;
+        for (int t=0; t < m_ThreadCounts.size(); ++t)
+        {
+            m_NumValid[lu] += m_ThreadCounts[t][lu+1];
+        }
+    }
+    else if (phase == LUA_COUNT)
+    {
+        const double pixArea = std::abs(this->GetInput(0)->GetSpacing()[0]
+                                        * this->GetInput(0)->GetSpacing()[1]);
+        for (int k=0; k < m_AllocatedAreas.size(); ++k)
+        {
+            long cnt = 0;
+            for (int t=0; t < m_ThreadCounts.size(); ++t)
+            {
+                cnt += m_ThreadCounts[t][k+1];
+            }
+            m_AllocatedAreas[k] = cnt * pixArea;
+        }
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+LUAllocationFilter<TInputImage, TOutputImage>
+::CalledFromThreader(void* arg)
+{
+    const long threadId = ((itk::MultiThreader::ThreadInfoStruct *)(arg))->ThreadID;
+    const long threadCount = ((itk::MultiThreader::ThreadInfoStruct *)(arg))->NumberOfThreads;
+    ThreadStruct* str = (ThreadStruct *)(((itk::MultiThreader::ThreadInfoStruct *)(arg))->UserData);
+
+    const long numPix = str->Filter->m_NumPixels;
+    const long chunk = (numPix + threadCount - 1) / threadCount;
+    const long offset = threadId * chunk;
+    const long length = std::min(chunk, numPix - offset);
+
+    if (length > 0 && threadId < str->Filter->m_ThreadCounts.size())
+    {
+        str->Filter->ProcessThreaded(str, threadId, offset, length);
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::RankPixel(long idx)
+{
+    // the residual (-1) competes with a constant score of 0
+    short best = -1;
+    short second = -2;
+    double bestScore = 0;
+    double secondScore = -std::numeric_limits<double>::infinity();
+
+    const int nlu = static_cast<int>(m_Buffers.size());
+    for (int k=0; k < nlu; ++k)
+    {
+        const double p = this->Potential(k, idx);
+        if (p != p)
+        {
+            continue;
+        }
+
+        const double s = p + m_Elasticities[k];
+        if (s > bestScore)
+        {
+            second = best;
+            secondScore = bestScore;
+            best = k;
+            bestScore = s;
+        }
+        else if (s > secondScore)
+        {
+            second = k;
+            secondScore = s;
+        }
+    }
+
+    m_Best[idx] = best;
+    m_BestScore[idx] = bestScore;
+    m_Second[idx] = second;
+    m_SecondScore[idx] = secondScore;
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::ProcessThreaded(const ThreadStruct* str, long threadId, long offset, long length)
+{
+    std::vector<long>& counts = m_ThreadCounts[threadId];
+    const long end = offset + length;
+    const int k = str->LandUse;
+
+    switch (str->Phase)
+    {
+    case LUA_INIT_RANKS:
+        for (long idx=offset; idx < end; ++idx)
+        {
+            this->RankPixel(idx);
+        }
+        break;
+
+    case LUA_MARGINS:
+        for (long idx=offset; idx < end; ++idx)
+        {
+            const double p = this->Potential(k, idx);
+            if (p != p)
+            {
+                m_Margins[idx] = std::numeric_limits<double>::infinity();
+                continue;
+            }
+
+            const double compScore = m_Best[idx] == k ? m_SecondScore[idx] : m_BestScore[idx];
+            m_Margins[idx] = compScore - p;
+            ++counts[k+1];
+        }
+        break;
+
+    case LUA_UPDATE_RANKS:
+        {
+            const double ek = m_Elasticities[k];
+            const bool bDecrease = str->Delta < 0;
+            for (long idx=offset; idx < end; ++idx)
+            {
+                const double p = this->Potential(k, idx);
+                if (p != p)
+                {
+                    continue;
+                }
+
+                const double s = p + ek;
+                if (m_Best[idx] == k)
+                {
+                    if (!bDecrease || s > m_SecondScore[idx])
+                    {
+                        m_BestScore[idx] = s;
+                    }
+                    else
+                    {
+                        this->RankPixel(idx);
+                    }
+                }
+                else if (m_Second[idx] == k)
+                {
+                    if (bDecrease)
+                    {
+                        // a third land use might have moved up
+                        this->RankPixel(idx);
+                    }
+                    else if (s > m_BestScore[idx])
+                    {
+                        m_Second[idx] = m_Best[idx];
+                        m_SecondScore[idx] = m_BestScore[idx];
+                        m_Best[idx] = k;
+                        m_BestScore[idx] = s;
+                    }
+                    else
+                    {
+                        m_SecondScore[idx] = s;
+                    }
+                }
+                else if (s > m_BestScore[idx])
+                {
+                    m_Second[idx] = m_Best[idx];
+                    m_SecondScore[idx] = m_BestScore[idx];
+                    m_Best[idx] = k;
+                    m_BestScore[idx] = s;
+                }
+                else if (s > m_SecondScore[idx])
+                {
+                    m_Second[idx] = k;
+                    m_SecondScore[idx] = s;
+                }
+            }
+        }
+        break;
+
+    case LUA_COUNT:
+        for (long idx=offset; idx < end; ++idx)
+        {
+            ++counts[m_Best[idx]+1];
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void LUAllocationFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+    const InputImageType* in0 = this->GetInput(0);
+    OutputImageType* out = this->GetOutput();
+    const int nlu = static_cast<int>(m_Buffers.size());
+
+    itk::ImageRegionIteratorWithIndex<OutputImageType> outIt(out, outputRegionForThread);
+    for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+    {
+        const long idx = in0->ComputeOffset(outIt.GetIndex());
+
+        int best = -1;
+        double bestScore = 0;
+        for (int k=0; k < nlu; ++k)
+        {
+            const double p = this->Potential(k, idx);
+            if (p == p && p + m_Elasticities[k] > bestScore)
+            {
+                best = k;
+                bestScore = p + m_Elasticities[k];
+            }
+        }
+
+        outIt.Set(best < 0 ? m_ResidualCode : m_LandUseCodes[best]);
+    }
+}
+
+} // end namespace otb
+
+#endif // __otbLUAllocationFilter_txx
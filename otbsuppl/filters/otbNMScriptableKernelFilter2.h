@@ -59,6 +59,7 @@
 #include "otbMultiParser.h"
 #include "otbAttributeTable.h"
 #include "otbSQLiteTable.h"
+#include "otbHaloRowCache.h"
 
 #include "nmotbsupplfilters_export.h"
 
@@ -496,6 +497,8 @@ private:
   std::map<MultiParser*, std::string> m_mapParserName;
   // the link between input images and their user defined names
   std::map<std::string, InputImageType*> m_mapNameImg;
+  // the halo rows of the previous stream division per (indexed) input
+  std::vector<HaloRowCache<InputImageType> > m_vHaloCache;
   // the length of each script block; note a block is either a single statement/expression,
   // or a for loop including the test and counter variables
   std::vector<int> m_vecBlockLen;
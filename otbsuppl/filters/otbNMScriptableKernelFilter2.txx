@@ -414,6 +414,19 @@ NMScriptableKernelFilter2<TInputImage, TOutputImage>
         this->SetNthOutput(1, this->MakeOutput(1));
     }
 
+    // process the images joined with the halo
+    // rows kept from the previous stream division
+    for (int i=0; i < m_IMGNames.size() && i < m_vHaloCache.size(); ++i)
+    {
+        InputImageType* img = dynamic_cast<InputImageType*>(this->GetIndexedInputs().at(i).GetPointer());
+        typename std::map<std::string, InputImageType*>::iterator imgIt =
+                m_mapNameImg.find(m_IMGNames.at(i));
+        if (img != 0 && imgIt != m_mapNameImg.end())
+        {
+            imgIt->second = const_cast<InputImageType*>(m_vHaloCache[i].Assemble(img));
+        }
+    }
+
     m_vthPixelCounter.clear();
     m_vthPixelCounter.resize(this->GetNumberOfThreads(), 0);
 
@@ -864,36 +877,49 @@ NMScriptableKernelFilter2<TInputImage, TOutputImage>
             // note: access is rows, columns
             std::vector<std::vector<ParserValue> > tableCache(ncols);
 
+            // fetch each column in one go rather than cell by cell
+            std::vector<long long> intBuf;
+            std::vector<double> dblBuf;
             for (int col = 0; col < ncols; ++col)
             {
                 std::vector<ParserValue> colCache(nrows);
-                for (int row = minrow, rowidx=0; row <= maxrow; ++row, ++rowidx)
+                switch(tab->GetColumnType(col))
                 {
-                    switch(tab->GetColumnType(col))
+                case AttributeTable::ATTYPE_INT:
+                {
+                    intBuf.resize(nrows);
+                    if (nrows > 0)
                     {
-                    case AttributeTable::ATTYPE_INT:
+                        tab->GetColumnAsArray(col, minrow, nrows, &intBuf[0]);
+                    }
+                    for (int rowidx=0; rowidx < nrows; ++rowidx)
                     {
-                        const double lv = static_cast<ParserValue>(tab->GetIntValue(col, row));
+                        const double lv = static_cast<ParserValue>(intBuf[rowidx]);
                         if (lv < (itk::NumericTraits<ParserValue>::NonpositiveMin()))
                         {
                             ++underflows;
                         }
                         else if (lv > (std::numeric_limits<ParserValue>::max()))
                         {
-                            //long long lmax = static_cast<long long>(std::numeric_limits<ParserValue>::max());
-                            //if (lv > lmax)
-                                ++overflows;
-                            //else
+                            ++overflows;
                         }
                         else
                         {
                             colCache[rowidx] = static_cast<ParserValue>(lv);
                         }
                     }
-                        break;
-                    case AttributeTable::ATTYPE_DOUBLE:
+                }
+                    break;
+                case AttributeTable::ATTYPE_DOUBLE:
+                {
+                    dblBuf.resize(nrows);
+                    if (nrows > 0)
+                    {
+                        tab->GetColumnAsArray(col, minrow, nrows, &dblBuf[0]);
+                    }
+                    for (int rowidx=0; rowidx < nrows; ++rowidx)
                     {
-                        const double dv = tab->GetDblValue(col, row);
+                        const double dv = dblBuf[rowidx];
                         if (dv < static_cast<double>(itk::NumericTraits<ParserValue>::NonpositiveMin()))
                         {
                             ++underflows;
@@ -907,13 +933,15 @@ NMScriptableKernelFilter2<TInputImage, TOutputImage>
                             colCache[rowidx] = static_cast<ParserValue>(dv);
                         }
                     }
-                        break;
-                    case AttributeTable::ATTYPE_STRING:
-                        colCache[rowidx] = nv;
-                        break;
-                    }
                 }
-                tableCache[col] = colCache;
+                    break;
+                case AttributeTable::ATTYPE_STRING:
+                    std::fill(colCache.begin(), colCache.end(), nv);
+                    break;
+                default:
+                    break;
+                }
+                tableCache[col].swap(colCache);
             }
 
             // report conversion errors
@@ -1043,9 +1071,11 @@ NMScriptableKernelFilter2<TInputImage, TOutputImage>
     // if we're not operating on a kernel
     if (!m_NumNeighbourPixel)
     {
+        m_vHaloCache.clear();
         return;
     }
 
+    m_vHaloCache.resize(this->GetNumberOfIndexedInputs());
     for (int ip=0; ip < this->GetNumberOfIndexedInputs(); ++ip)
     {
         inputPtr = dynamic_cast<InputImageType*>(
@@ -1067,7 +1097,12 @@ NMScriptableKernelFilter2<TInputImage, TOutputImage>
         // crop the input requested region at the input's largest possible region
         if ( inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()) )
         {
-            inputPtr->SetRequestedRegion( inputRequestedRegion );
+            // don't request again the halo rows we've kept
+            // from the previous stream division
+            m_vHaloCache[ip].ResetOnFirstDivision(this->GetOutput());
+            m_vHaloCache[ip].SetHaloRows(2 * m_Radius[TInputImage::ImageDimension-1]);
+            inputPtr->SetRequestedRegion(
+                        m_vHaloCache[ip].GetRegionToRequest(inputPtr, inputRequestedRegion) );
         }
         else
         {
@@ -55,6 +55,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkNumericTraits.h"
+#include "otbHaloRowCache.h"
 
 #include "nmotbsupplfilters_export.h"
 
@@ -141,12 +142,19 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                             itk::ThreadIdType threadId );
 
+  /** Joins the input rows fetched for this stream division with
+   * the halo rows kept from the previous one. */
+  void BeforeThreadedGenerateData();
+
 private:
   NeighbourhoodCountingFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
   InputSizeType m_Radius;
   int m_Testvalue;
+
+  HaloRowCache<InputImageType> m_HaloCache;
+  const InputImageType* m_NeighbourhoodInput;
 };
   
 } // end namespace itk
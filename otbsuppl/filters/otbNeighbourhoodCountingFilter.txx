@@ -62,6 +62,7 @@ NeighbourhoodCountingFilter<TInputImage, TOutputImage>
 ::NeighbourhoodCountingFilter()
 {
   m_Radius.Fill(1);
+  m_NeighbourhoodInput = 0;
 }
 
 template <class TInputImage, class TOutputImage>
@@ -93,7 +94,12 @@ NeighbourhoodCountingFilter<TInputImage, TOutputImage>
   // crop the input requested region at the input's largest possible region
   if ( inputRequestedRegion.Crop(inputPtr->GetLargestPossibleRegion()) )
     {
-    inputPtr->SetRequestedRegion( inputRequestedRegion );
+    // don't request again the halo rows we've kept from the
+    // previous stream division
+    m_HaloCache.ResetOnFirstDivision(outputPtr.GetPointer());
+    m_HaloCache.SetHaloRows(2 * m_Radius[InputImageType::ImageDimension - 1]);
+    inputPtr->SetRequestedRegion(
+          m_HaloCache.GetRegionToRequest(inputPtr, inputRequestedRegion) );
     return;
     }
   else
@@ -113,6 +119,13 @@ NeighbourhoodCountingFilter<TInputImage, TOutputImage>
     }
 }
 
+template< class TInputImage, class TOutputImage>
+void
+NeighbourhoodCountingFilter< TInputImage, TOutputImage>
+::BeforeThreadedGenerateData()
+{
+  m_NeighbourhoodInput = m_HaloCache.Assemble(this->GetInput());
+}
 
 template< class TInputImage, class TOutputImage>
 void
@@ -128,7 +141,7 @@ NeighbourhoodCountingFilter< TInputImage, TOutputImage>
   
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
-  typename  InputImageType::ConstPointer input  = this->GetInput();
+  typename  InputImageType::ConstPointer input  = m_NeighbourhoodInput;
   
   // Find the data-set boundary "faces"
   typename itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator<InputImageType>::FaceListType faceList;
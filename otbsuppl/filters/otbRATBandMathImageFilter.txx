@@ -255,7 +255,7 @@ void RATBandMathImageFilter<TImage>
         this->m_VRAT[0].push_back(tab);
         for (int t=1; t < nt; ++t)
         {
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
+            if (tab->GetTableType() != otb::AttributeTable::ATTABLE_TYPE_SQLITE)
             {
                 this->m_VRAT[t].push_back(tab);
             }
@@ -265,6 +265,7 @@ void RATBandMathImageFilter<TImage>
                 otb::SQLiteTable::Pointer thtab = otb::SQLiteTable::New();
                 thtab->SetUseSharedCache(false);
                 thtab->SetOpenReadOnly(true);
+                thtab->SetUseConnectionPool(true);
                 if (thtab->CreateTable(sqlTab->GetDbFileName(), "1") != otb::SQLiteTable::ATCREATE_READ)
                 {
                     itkExceptionMacro(<< "Failed creating table connection for thread: "
@@ -284,7 +285,7 @@ void RATBandMathImageFilter<TImage>
         this->m_VRAT[0][idx] = tab;
         for (int t=1; t < nt; ++t)
         {
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
+            if (tab->GetTableType() != otb::AttributeTable::ATTABLE_TYPE_SQLITE)
             {
                 this->m_VRAT[t][idx] = tab;
             }
@@ -294,6 +295,7 @@ void RATBandMathImageFilter<TImage>
                 otb::SQLiteTable::Pointer thtab = otb::SQLiteTable::New();
                 thtab->SetUseSharedCache(false);
                 thtab->SetOpenReadOnly(true);
+                thtab->SetUseConnectionPool(true);
                 if (thtab->CreateTable(sqlTab->GetDbFileName(), "1") != otb::SQLiteTable::ATCREATE_READ)
                 {
                     itkExceptionMacro(<< "Failed creating table connection for thread: "
@@ -347,8 +349,8 @@ void RATBandMathImageFilter<TImage>
         otb::AttributeTable::Pointer tab = m_VRAT[0].at(t);
 
         // there's no point in using a cache for an already cached
-        // RAM-based table, really
-        if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
+        // RAM-based or memory-mapped (columnar) table, really
+        if (tab->GetTableType() != otb::AttributeTable::ATTABLE_TYPE_SQLITE)
         {
             m_UseTableColumnCache = false;
             m_TableColumnCache.clear();
@@ -43,6 +43,9 @@
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkArray.h"
+#include "itkTimeStamp.h"
+
+#include <unordered_map>
 
 #include "otbAttributeTable.h"
 
@@ -51,7 +54,19 @@
 namespace otb
 {
 /** \class RATValExtractor
-  *
+ *
+ * Maps the pixel values of the input images, interpreted as row ids
+ * (primary key values) of the associated attribute tables, onto the
+ * values of one or more table columns. Each column of each table
+ * becomes one output, in the order of the inputs and, per input,
+ * in the order of the attribute names, so that all columns of a table
+ * are extracted in a single pass over the input image.
+ *
+ * Before the first region is processed, the columns are copied into an
+ * array indexed by (row id - min row id), or into a hash map, if the row
+ * ids are too sparse for a dense array. Pixels whose value doesn't
+ * denote a table row are set to zero.
+ *
  * \ingroup Streamed
  * \ingroup Threaded
  */
@@ -93,7 +108,8 @@ public:
   void SetNthInput( unsigned int idx, const ImageType * image);
   void SetNthInput( unsigned int idx, const ImageType * image, const std::string& varName);
 
-  /** Set the attribute table of the nth filter input */
+  /** Set the attribute table of the nth filter input and the names
+   *  of the columns to be extracted (defaults to the expression) */
   void SetNthAttributeTable( unsigned int idx, const AttributeTable::Pointer,
           std::vector<std::string> vAttrNames);
 
@@ -116,6 +132,7 @@ public:
   AttributeTable::Pointer GetNthAttributeTable(unsigned int idx);
   std::vector<std::string> GetNthTableAttributes(unsigned int idx);
 
+  /** obsolete: table columns are always cached now */
   itkSetMacro(UseTableColumnCache, bool)
   itkGetMacro(UseTableColumnCache, bool)
   itkBooleanMacro(UseTableColumnCache)
@@ -127,9 +144,40 @@ protected :
   virtual ~RATValExtractor();
   virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
+  void BeforeThreadedGenerateData();
   void ThreadedGenerateData(const ImageRegionType& outputRegionForThread, itk::ThreadIdType threadId );
+
+  /** (Re-)sizes the outputs according to the number of columns to be extracted */
+  void UpdateOutputs(void);
   void CacheTableColumns(int idx);
 
+  /** table column values of one input, row-major, i.e.
+   *  NumCols consecutive values per row */
+  typedef struct
+  {
+      int NumCols;
+      int FirstOutput;
+      bool Dense;
+      long long MinPK;
+      long long NumKeys;
+      std::vector<PixelType> Values;
+      std::unordered_map<long long, long long> Slots;
+  } ValueCache;
+
+  /** returns the values of the given row or NULL, if the
+   *  row doesn't exist */
+  inline const PixelType* LookupRow(const ValueCache& vc, const long long& row) const
+  {
+      if (vc.Dense)
+      {
+          const long long off = row - vc.MinPK;
+          return off >= 0 && off < vc.NumKeys ? &vc.Values[off * vc.NumCols] : nullptr;
+      }
+
+      typename std::unordered_map<long long, long long>::const_iterator it = vc.Slots.find(row);
+      return it != vc.Slots.end() ? &vc.Values[it->second * vc.NumCols] : nullptr;
+  }
+
 private :
   RATValExtractor(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
@@ -148,15 +196,15 @@ private :
   OriginType                            m_Origin;
 
   bool                                  m_UseTableColumnCache;
-  std::vector<std::map<int, std::map<long long, double> > >  m_TableColumnDblCache;
-  std::vector<std::map<int, std::map<long long, long long> > >  m_TableColumnLLongCache;
+  std::vector<ValueCache>               m_ValueCache;
+  itk::TimeStamp                        m_CacheTime;
   long                                  m_UnderflowCount;
   long                                  m_OverflowCount;
   itk::Array<long>                      m_ThreadUnderflow;
   itk::Array<long>                      m_ThreadOverflow;
 
   /** Attribute Table support */
-  std::vector<std::vector<TablePointer > > m_VRAT; //m_VThreadRAT;
+  std::vector<TablePointer>             m_VRAT;
   std::vector< std::vector<int> > 	m_VTabAttr;
   std::vector< std::vector< ColumnType > > m_VAttrTypes;
   std::vector< std::vector< std::vector<double> > >	m_VAttrValues;
@@ -71,6 +71,7 @@
 
 #include "nmlog.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -94,12 +95,6 @@ RATValExtractor<TImage>
     m_ThreadOverflow.SetSize(1);
     m_ConcatChar = "__";
     m_UseTableColumnCache = false;
-
-    for (int t=0; t < this->GetNumberOfThreads(); ++t)
-    {
-        std::vector<TablePointer> vT;
-        m_VRAT.push_back(vT);
-    }
 }
 
 /** Destructor */
@@ -130,17 +125,15 @@ void RATValExtractor<TImage>
 ::SetNthAttributeTable(unsigned int idx, AttributeTable::Pointer tab,
                        std::vector<std::string> vAttrNames	)
 {
-    // exclude invalid settings
-    if (idx < 0)// || tab.IsNull() || tab.GetPointer() == 0)
+    if (tab.IsNull())
     {
-        itkExceptionMacro(<< "Invalid index for ::SetNthAttributeTable()!");
+        itkExceptionMacro(<< "Invalid attribute table for ::SetNthAttributeTable()!");
         return;
     }
 
-    otb::SQLiteTable::Pointer sqlTab = 0;
     if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_SQLITE)
     {
-        sqlTab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
+        otb::SQLiteTable::Pointer sqlTab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
         if (sqlTab->GetDbConnection() == 0)
         {
             if (!sqlTab->openConnection() || !sqlTab->PopulateTableAdmin())
@@ -153,208 +146,178 @@ void RATValExtractor<TImage>
         }
     }
 
+    std::vector<std::string> extrcols = vAttrNames;
+    if (extrcols.empty() && !m_Expression.empty())
+    {
+        extrcols.push_back(m_Expression);
+    }
+
+    if (extrcols.empty())
+    {
+        itkExceptionMacro(<< "Please provide the column(s) to be extracted as 'MapExpression' or 'Attribute Names'!");
+        return;
+    }
 
     std::vector<int> columns;
     std::vector<ColumnType> types;
-    if (tab.IsNotNull())
+    for (int n=0; n < extrcols.size(); ++n)
     {
-        std::string extrcol = m_Expression;
-        if (extrcol.empty() && vAttrNames.size() > 0)
-        {
-            extrcol = vAttrNames[0];
-        }
-
-        int c = -1;
-        if ((c = tab->ColumnExists(extrcol) >= 0))
-        {
-                columns.push_back(c);
-
-                if (tab->GetColumnType(c) == otb::AttributeTable::ATTYPE_STRING)
-                {
-                    itkExceptionMacro(<< "Don't support extraction of STRING values!");
-                }
-                types.push_back(tab->GetColumnType(c));
-        }
-        else
+        const int c = tab->ColumnExists(extrcols.at(n));
+        if (c < 0)
         {
-            itkExceptionMacro(<< "Please provide the column to be extracted as 'MapExpression' or 'Attribute Names'!");
+            itkExceptionMacro(<< "Couldn't find column '" << extrcols.at(n) << "'!");
+            return;
         }
-    }
 
-    int nt = this->GetNumberOfThreads();
-
-    for (int i=this->m_VRAT[0].size(); i < idx; ++i)
-    {
-        for (int t=0; t < nt; ++t)
+        if (tab->GetColumnType(c) == otb::AttributeTable::ATTYPE_STRING)
         {
-            this->m_VRAT[t].push_back(0);
+            itkExceptionMacro(<< "Don't support extraction of STRING values!");
+            return;
         }
 
-        std::vector<int> columns;
-        this->m_VTabAttr.push_back(columns);
-        std::vector<ColumnType> types;
-        this->m_VAttrTypes.push_back(types);
+        columns.push_back(c);
+        types.push_back(tab->GetColumnType(c));
     }
 
-    if (this->m_VAttrTypes.size() == idx)
+    if (idx >= m_VRAT.size())
     {
-        this->m_VRAT[0].push_back(tab);
-        for (int t=1; t < nt; ++t)
-        {
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
-            {
-                this->m_VRAT[t].push_back(tab);
-            }
-            else
-            {
-                //otb::SQLiteTable::Pointer stab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
-                otb::SQLiteTable::Pointer thtab = otb::SQLiteTable::New();
-                thtab->SetUseSharedCache(false);
-                thtab->SetOpenReadOnly(true);
-                if (thtab->CreateTable(sqlTab->GetDbFileName(), "1") != otb::SQLiteTable::ATCREATE_READ)
-                {
-                    itkExceptionMacro(<< "Failed creating table connection for thread: "
-                                      << thtab->getLastLogMsg());
-                    return;
-                }
-                otb::AttributeTable::Pointer ctp = static_cast<otb::AttributeTable*>(thtab.GetPointer());
-                this->m_VRAT[t].push_back(ctp);
-            }
-        }
-
-        this->m_VAttrTypes.push_back(types);
-        this->m_VTabAttr.push_back(columns);
+        m_VRAT.resize(idx+1);
+        m_VTabAttr.resize(idx+1);
+        m_VAttrTypes.resize(idx+1);
     }
-    else
-    {
-        this->m_VRAT[0][idx] = tab;
-        for (int t=1; t < nt; ++t)
-        {
-            if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
-            {
-                this->m_VRAT[t][idx] = tab;
-            }
-            else
-            {
-                otb::SQLiteTable::Pointer thtab = otb::SQLiteTable::New();
-                thtab->SetUseSharedCache(false);
-                thtab->SetOpenReadOnly(true);
-                if (thtab->CreateTable(sqlTab->GetDbFileName(), "1") != otb::SQLiteTable::ATCREATE_READ)
-                {
-                    itkExceptionMacro(<< "Failed creating table connection for thread: "
-                                      << thtab->getLastLogMsg());
-                    return;
-                }
-                this->m_VRAT[t][idx] = thtab;
-            }
-        }
 
-        this->m_VAttrTypes[idx] = types;
-        this->m_VTabAttr[idx] = columns;
-    }
+    m_VRAT[idx] = tab;
+    m_VTabAttr[idx] = columns;
+    m_VAttrTypes[idx] = types;
 
+    this->UpdateOutputs();
+    this->Modified();
+}
 
-    if (m_UseTableColumnCache)
+template<class TImage>
+void RATValExtractor<TImage>
+::UpdateOutputs(void)
+{
+    unsigned int numOutputs = 0;
+    for (int i=0; i < m_VTabAttr.size(); ++i)
     {
-        CacheTableColumns(idx);
+        numOutputs += m_VTabAttr.at(i).size();
     }
+    numOutputs = std::max<unsigned int>(1, numOutputs);
 
-    this->Modified();
+    this->SetNumberOfIndexedOutputs(numOutputs);
+    this->SetNumberOfRequiredOutputs(numOutputs);
+    for (unsigned int o=1; o < numOutputs; ++o)
+    {
+        if (this->GetOutput(o) == nullptr)
+        {
+            this->SetNthOutput(o, this->MakeOutput(o));
+        }
+    }
 }
 
 template<class TImage>
 void RATValExtractor<TImage>
 ::ResetPipeline()
 {
-    m_TableColumnDblCache.clear();
-    m_TableColumnLLongCache.clear();
+    m_ValueCache.clear();
     m_VAttrTypes.clear();
     m_VTabAttr.clear();
     m_VRAT.clear();
 }
 
-
 template<class TImage>
 void RATValExtractor<TImage>
 ::CacheTableColumns(int idx)
 {
-    if (idx < m_VRAT[0].size())
+    ValueCache& vc = m_ValueCache.at(idx);
+    vc.NumCols = m_VTabAttr.at(idx).size();
+    vc.Dense = true;
+    vc.MinPK = 0;
+    vc.NumKeys = 0;
+    vc.Values.clear();
+    vc.Slots.clear();
+
+    otb::AttributeTable::Pointer tab = m_VRAT.at(idx);
+    if (tab.IsNull() || vc.NumCols == 0 || tab->GetNumRows() <= 0)
     {
-        int t = idx;
-        otb::AttributeTable::Pointer tab = m_VRAT[0].at(t);
-
-        // there's no point in using a cache for an already cached
-        // RAM-based table, really
-        if (tab->GetTableType() == otb::AttributeTable::ATTABLE_TYPE_RAM)
-        {
-            m_UseTableColumnCache = false;
-            m_TableColumnDblCache.clear();
-            m_TableColumnLLongCache.clear();
-            return;
-        }
-
-
-        otb::SQLiteTable::Pointer dbtab = static_cast<otb::SQLiteTable*>(tab.GetPointer());
+        return;
+    }
 
-        std::map<int, std::map<long long, double> > tab_Dblmap;
-        std::map<int, std::map<long long, long long> > tab_LLongmap;
+    const long long minPK = tab->GetMinPKValue();
+    const long long maxPK = tab->GetMaxPKValue();
+    const long long numRows = tab->GetNumRows();
+    const long long range = maxPK - minPK + 1;
+
+    // we use a dense array unless the row ids are
+    // really sparse, e.g. unique combination ids
+    static const long long minDenseRange = 1 << 16;
+    vc.MinPK = minPK;
+    vc.Dense = range > 0 && range <= std::max(4 * numRows, minDenseRange);
+    if (vc.Dense)
+    {
+        vc.NumKeys = range;
+        vc.Values.assign(range * vc.NumCols, itk::NumericTraits<PixelType>::ZeroValue());
+    }
+    else
+    {
+        vc.NumKeys = numRows;
+        vc.Values.reserve(numRows * vc.NumCols);
+        vc.Slots.reserve(numRows);
+    }
 
-        std::vector<std::string> colnames;
-        colnames.push_back(dbtab->GetPrimaryKey());
+    // integer columns are scanned as such, since large
+    // values (e.g. ids) don't survive the trip via double
+    std::vector<double> rowVals(vc.NumCols);
+    std::vector<long long> rowIntVals(vc.NumCols);
+    std::vector<bool> isInt(vc.NumCols);
+    for (int c=0; c < vc.NumCols; ++c)
+    {
+        isInt[c] = tab->GetColumnType(m_VTabAttr.at(idx).at(c)) == otb::AttributeTable::ATTYPE_INT;
+    }
+    long long row;
+    if (!tab->PrepareColumnScan(m_VTabAttr.at(idx), minPK, maxPK))
+    {
+        itkExceptionMacro(<< "Failed reading the attribute table of input #"
+                          << idx << "!");
+        return;
+    }
 
-        for (int c=0; c < m_VTabAttr.at(t).size(); ++c)
+    while (tab->NextScanRow(row, &rowVals[0], &rowIntVals[0]))
+    {
+        PixelType* vals = nullptr;
+        if (vc.Dense)
         {
-            std::string col_name = tab->GetColumnName(m_VTabAttr.at(t).at(c));
-            if (col_name.compare(colnames[0]) != 0)
-            {
-                colnames.push_back(col_name);
-            }
-
-            if (m_VAttrTypes.at(t).at(c) == otb::AttributeTable::ATTYPE_INT)
-            {
-                std::map<long long, long long> llong_map;
-                tab_LLongmap.insert(std::pair<int, std::map<long long, long long> >(
-                                   m_VTabAttr.at(t).at(c), llong_map));
-            }
-            else
-            {
-                std::map<long long, double> dbl_map;
-                tab_Dblmap.insert(std::pair<int, std::map<long long, double> >(
-                                   m_VTabAttr.at(t).at(c), dbl_map));
-            }
+            vals = &vc.Values[(row - minPK) * vc.NumCols];
         }
-
-        if (m_VAttrTypes.at(0).at(0) == otb::AttributeTable::ATTYPE_INT)
+        else
         {
-            if (!dbtab->GreedyNumericFetch(colnames, tab_LLongmap))
-            {
-                m_UseTableColumnCache = false;
-                m_TableColumnLLongCache.clear();
-                return;
-            }
-            m_TableColumnLLongCache.push_back(tab_LLongmap);
+            const long long slot = vc.Values.size() / vc.NumCols;
+            vc.Slots[row] = slot;
+            vc.Values.resize((slot + 1) * vc.NumCols);
+            vals = &vc.Values[slot * vc.NumCols];
         }
-        else
+
+        for (int c=0; c < vc.NumCols; ++c)
         {
-            if (!dbtab->GreedyNumericFetch(colnames, tab_Dblmap))
-            {
-                m_UseTableColumnCache = false;
-                m_TableColumnDblCache.clear();
-                return;
-            }
-            m_TableColumnDblCache.push_back(tab_Dblmap);
+            vals[c] = isInt[c] ? static_cast<PixelType>(rowIntVals[c])
+                               : static_cast<PixelType>(rowVals[c]);
         }
     }
+    tab->EndColumnScan();
+
+    NMProcDebug(<< "Cached " << vc.NumCols << " column(s) of input #"
+                << idx << (vc.Dense ? " (dense)" : " (hashed)"));
 }
 
 template<class TImage>
 AttributeTable::Pointer RATValExtractor<TImage>
 ::GetNthAttributeTable(unsigned int idx)
 {
-    if (idx < 0 || idx >= m_VRAT[0].size())
+    if (idx >= m_VRAT.size())
         return 0;
 
-    return m_VRAT[0][idx];
+    return m_VRAT[idx];
 }
 
 template<class TImage>
@@ -368,7 +331,7 @@ std::vector<std::string> RATValExtractor<TImage>
     }
 
     for (int i=0; i < m_VTabAttr[idx].size(); ++i)
-        ret.push_back(m_VRAT[0][idx]->GetColumnName(m_VTabAttr[idx][i]));
+        ret.push_back(m_VRAT[idx]->GetColumnName(m_VTabAttr[idx][i]));
 
     return ret;
 }
@@ -397,17 +360,11 @@ void RATValExtractor<TImage>
 
     // increase the RAT related vectors according to the
     // given idx, if necessary
-    for (int i=this->m_VRAT[0].size(); i <= idx; ++i)
+    if (idx >= m_VRAT.size())
     {
-        for (int t=0; t < this->GetNumberOfThreads(); ++t)
-        {
-            this->m_VRAT[t].push_back(0);
-        }
-
-        std::vector<int> columns;
-        this->m_VTabAttr.push_back(columns);
-        std::vector<ColumnType> types;
-        this->m_VAttrTypes.push_back(types);
+        m_VRAT.resize(idx+1);
+        m_VTabAttr.resize(idx+1);
+        m_VAttrTypes.resize(idx+1);
     }
 
     this->Modified();
@@ -425,7 +382,7 @@ void RATValExtractor<TImage>
         this->RemoveInput(this->GetNumberOfInputs()-1);
     }
 
-    m_VVarName.resize(nbInput);
+    m_VVarName.resize(nbInput+4);
     m_VVarName[idx] = varName;
     m_VVarName[idx+1] = "idxX";
     m_VVarName[idx+2] = "idxY";
@@ -434,16 +391,11 @@ void RATValExtractor<TImage>
 
     // increase the RAT related vectors according to the
     // given idx, if necessary
-    for (int i=this->m_VRAT[0].size(); i <= idx; ++i)
+    if (idx >= m_VRAT.size())
     {
-        for (int t=0; t < this->GetNumberOfThreads(); ++t)
-        {
-            this->m_VRAT[t].push_back(0);
-        }
-        std::vector<int> columns;
-        this->m_VTabAttr.push_back(columns);
-        std::vector<ColumnType> types;
-        this->m_VAttrTypes.push_back(types);
+        m_VRAT.resize(idx+1);
+        m_VTabAttr.resize(idx+1);
+        m_VAttrTypes.resize(idx+1);
     }
 
     this->Modified();
@@ -488,24 +440,67 @@ std::string RATValExtractor<TImage>
     return idx < m_VVarName.size() ? m_VVarName.at(idx) : "";
 }
 
+template< typename TImage >
+void RATValExtractor<TImage>
+::BeforeThreadedGenerateData()
+{
+    // the cached columns are kept across stream divisions
+    // and only refreshed when the filter has been modified
+    if (m_ValueCache.size() == m_VTabAttr.size() && m_CacheTime > this->GetMTime())
+    {
+        return;
+    }
+
+    const unsigned int nbInputImages = this->GetNumberOfInputs();
+
+    m_ValueCache.clear();
+    m_ValueCache.resize(m_VTabAttr.size());
+    int firstOutput = 0;
+    for (int i=0; i < m_VTabAttr.size(); ++i)
+    {
+        if (m_VTabAttr.at(i).size() > 0 && i >= nbInputImages)
+        {
+            itkExceptionMacro(<< "There's no input image associated with "
+                              << "attribute table #" << i << "!");
+            return;
+        }
+
+        this->CacheTableColumns(i);
+        m_ValueCache[i].FirstOutput = firstOutput;
+        firstOutput += m_ValueCache[i].NumCols;
+    }
+
+    if (firstOutput == 0)
+    {
+        itkExceptionMacro(<< "No table columns to extract!");
+        return;
+    }
+
+    m_CacheTime.Modified();
+}
+
 template< typename TImage >
 void RATValExtractor<TImage>
 ::ThreadedGenerateData(const ImageRegionType& outputRegionForThread,
                        itk::ThreadIdType threadId)
 {
     unsigned int j, r;
-    unsigned int nbInputImages = this->GetNumberOfInputs();
-    unsigned int nbOutputImages = this->GetNumberOfOutputs();
+    const unsigned int nbOutputImages = this->GetNumberOfOutputs();
 
     typedef itk::ImageRegionConstIterator<TImage> ImageRegionConstIteratorType;
     typedef itk::ImageRegionIterator<TImage> ImageRegionIteratorType;
 
+    // we only iterate over inputs with columns to extract
+    std::vector<int> vInputs;
     std::vector<ImageRegionConstIteratorType> Vit;
-    Vit.resize(nbInputImages);
-    for (j = 0; j < nbInputImages; j++)
+    for (j = 0; j < m_ValueCache.size(); j++)
     {
-        Vit[j] = ImageRegionConstIteratorType(this->GetNthInput(j),
-                                              outputRegionForThread);
+        if (m_ValueCache[j].NumCols > 0)
+        {
+            vInputs.push_back(j);
+            Vit.push_back(ImageRegionConstIteratorType(this->GetNthInput(j),
+                                                       outputRegionForThread));
+        }
     }
 
     std::vector<ImageRegionIteratorType> Vot;
@@ -520,32 +515,31 @@ void RATValExtractor<TImage>
     itk::ProgressReporter progress(this, threadId,
                                    outputRegionForThread.GetNumberOfPixels());
 
-    PixelType theVal;
+    const PixelType zero = itk::NumericTraits<PixelType>::ZeroValue();
+    const unsigned int nbIn = vInputs.size();
 
-    while (!Vit.at(0).IsAtEnd())
+    while (!Vot[0].IsAtEnd())
     {
-        const ColumnType t = m_VAttrTypes[0][0];
-        const int colidx = m_VTabAttr[0][0];
-        const long long rowidx = static_cast<long long>(Vit[0].Get());
-        switch(t)
+        for (j = 0; j < nbIn; ++j)
         {
-        case otb::AttributeTable::ATTYPE_INT:
-            theVal = static_cast<PixelType>(m_TableColumnLLongCache[0][colidx][rowidx]);
-            break;
-        case otb::AttributeTable::ATTYPE_DOUBLE:
-            theVal = static_cast<PixelType>(m_TableColumnDblCache[0][colidx][rowidx]);
-            break;
-        default:
-            ;
-        }
+            const ValueCache& vc = m_ValueCache[vInputs[j]];
+            const long long rowidx = static_cast<long long>(Vit[j].Get());
+            const PixelType* vals = this->LookupRow(vc, rowidx);
 
-        Vot.at(0).Set(theVal);
+            for (int c = 0; c < vc.NumCols; ++c)
+            {
+                Vot[vc.FirstOutput + c].Set(vals != nullptr ? vals[c] : zero);
+            }
+            ++Vit[j];
+        }
 
-        ++(Vot.at(0));
-        ++(Vit.at(0));
+        for (r = 0; r < nbOutputImages; ++r)
+        {
+            ++Vot[r];
+        }
 
         progress.CompletedPixel();
-   }
+    }
 }
 
 }// end namespace otb
@@ -0,0 +1,195 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbReclassImageFilter.h
+ *
+ *  Created on: 2024-06-24
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbReclassImageFilter_h
+#define __otbReclassImageFilter_h
+
+#include <string>
+#include <vector>
+
+#include "nmlog.h"
+#include "itkImageToImageFilter.h"
+#include "itkNumericTraits.h"
+#include "otbAttributeTable.h"
+
+#include "nmotbsupplfilters_export.h"
+
+namespace otb
+{
+
+/*! \brief Lookup-table based reclassification
+ *
+ *  Maps input values to one or several output values (bands), one
+ *  output image per band. Rules are either exact (Lower == Upper) or
+ *  half-open ranges [Lower, Upper), whose bounds may be +/-infinity.
+ *  Exact rules take precedence over ranges; duplicate exact values
+ *  and overlapping ranges are rejected. Pixels not matching any rule
+ *  are set to the DefaultValues, or keep their (cast) input value if
+ *  no defaults are given.
+ *
+ *  Rules are either added directly (AddRule), or read from a
+ *  RuleTable, which provides the lower bound (exact value) in the
+ *  LowerColumn, the (optional) upper bound in the UpperColumn and
+ *  the output values in the ValueColumns (one per band).
+ *
+ *  Before processing, the rules are compiled once into a dense lookup
+ *  array covering the matching input values (integer input types, as
+ *  long as the array doesn't exceed MaxLookupSize entries), or into
+ *  sorted value and range tables searched by bisection. Pixels are
+ *  then reclassified scanline by scanline: we look up the matching rule
+ *  for each pixel of a line first, and then fill the line of each
+ *  output band from the rule's values.
+ */
+template <class TInputImage, class TOutputImage>
+class NMOTBSUPPLFILTERS_EXPORT ReclassImageFilter
+        : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+    /** Standard class typedefs. */
+    typedef ReclassImageFilter                                  Self;
+    typedef itk::ImageToImageFilter<TInputImage, TOutputImage>  Superclass;
+    typedef itk::SmartPointer<Self>                             Pointer;
+    typedef itk::SmartPointer<const Self>                       ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self);
+
+    /** Run-time type information (and related methods). */
+    itkTypeMacro(ReclassImageFilter, itk::ImageToImageFilter);
+
+    typedef TInputImage                                 InputImageType;
+    typedef typename InputImageType::RegionType         InputImageRegionType;
+    typedef typename InputImageType::PixelType          InputPixelType;
+
+    typedef TOutputImage                                OutputImageType;
+    typedef typename OutputImageType::RegionType        OutputImageRegionType;
+    typedef typename OutputImageType::PixelType         OutputPixelType;
+
+    /*! output values for input values in [Lower, Upper),
+     *  or for Lower only, if Lower == Upper */
+    typedef struct
+    {
+        double Lower;
+        double Upper;
+        std::vector<double> Values;
+    } ReclassRule;
+
+    /*! number of output values per rule, i.e. number of outputs */
+    void SetNumberOfBands(unsigned int numBands);
+    unsigned int GetNumberOfBands(void)
+        {return this->GetNumberOfIndexedOutputs();}
+
+    void AddRule(double lower, double upper, const std::vector<double>& values);
+    void AddRule(double value, const std::vector<double>& values)
+        {this->AddRule(value, value, values);}
+    void ClearRules(void);
+    const std::vector<ReclassRule>& GetRules(void) const
+        {return m_Rules;}
+
+    /*! table providing (additional) rules */
+    void SetRuleTable(AttributeTable* tab)
+        {m_RuleTable = tab; this->Modified();}
+    AttributeTable* GetRuleTable(void)
+        {return m_RuleTable.GetPointer();}
+
+    itkSetStringMacro(LowerColumn)
+    itkGetStringMacro(LowerColumn)
+
+    /*! optional; if not given, the table provides exact rules only */
+    itkSetStringMacro(UpperColumn)
+    itkGetStringMacro(UpperColumn)
+
+    /*! output values per band; sets the number of bands */
+    void SetValueColumns(const std::vector<std::string>& cols);
+    std::vector<std::string> GetValueColumns(void) const
+        {return m_ValueColumns;}
+
+    /*! output values of unmatched pixels, one per band (or one
+     *  for all); if empty, unmatched pixels keep their value */
+    void SetDefaultValues(const std::vector<double>& values)
+        {m_DefaultValues = values; this->Modified();}
+    std::vector<double> GetDefaultValues(void) const
+        {return m_DefaultValues;}
+
+    /*! max number of entries of the dense lookup array */
+    itkSetMacro(MaxLookupSize, long long)
+    itkGetMacro(MaxLookupSize, long long)
+
+protected:
+    ReclassImageFilter();
+    virtual ~ReclassImageFilter() {}
+    void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+    void BeforeThreadedGenerateData(void);
+    void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                              itk::ThreadIdType threadId);
+
+    /*! compiles inline and table rules into the lookup structures */
+    void CompileRules(void);
+    void ReadTableRules(std::vector<ReclassRule>& rules);
+
+    /*! index (1-based) of the rule matching the given
+     *  value in the sorted tables; 0 if there's none */
+    inline int FindRule(double v) const;
+
+private:
+    ReclassImageFilter(const Self&); //purposely not implemented
+    void operator=(const Self&); //purposely not implemented
+
+    std::vector<ReclassRule> m_Rules;
+    AttributeTable::Pointer m_RuleTable;
+    std::string m_LowerColumn;
+    std::string m_UpperColumn;
+    std::vector<std::string> m_ValueColumns;
+    std::vector<double> m_DefaultValues;
+    long long m_MaxLookupSize;
+
+    // compiled rules
+    itk::ModifiedTimeType m_CompileTime;
+    bool m_bPassThrough;
+
+    // dense lookup: input value - m_LookupMin -> rule
+    bool m_bDenseLookup;
+    long long m_LookupMin;
+    std::vector<int> m_Lookup;
+
+    // sorted exact values and ranges -> rule
+    std::vector<double> m_ExactValues;
+    std::vector<int> m_ExactRules;
+    std::vector<double> m_RangeLower;
+    std::vector<double> m_RangeUpper;
+    std::vector<int> m_RangeRules;
+
+    // output value per band and rule; index 0
+    // holds the default value
+    std::vector<std::vector<OutputPixelType> > m_BandValues;
+};
+
+} // end namespace otb
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "otbReclassImageFilter.txx"
+#endif
+
+#endif // __otbReclassImageFilter_h
@@ -0,0 +1,449 @@
+ /******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2024 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbReclassImageFilter.txx
+ *
+ *  Created on: 2024-06-24
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbReclassImageFilter_txx
+#define __otbReclassImageFilter_txx
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "otbReclassImageFilter.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TOutputImage>
+ReclassImageFilter<TInputImage, TOutputImage>
+::ReclassImageFilter()
+    : m_MaxLookupSize(1 << 24),
+      m_CompileTime(0),
+      m_bPassThrough(true),
+      m_bDenseLookup(false),
+      m_LookupMin(0)
+{
+    this->SetNumberOfRequiredInputs(1);
+    this->SetNumberOfRequiredOutputs(1);
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Bands: " << this->GetNumberOfIndexedOutputs() << std::endl;
+    os << indent << "Rules: " << m_Rules.size() << std::endl;
+    os << indent << "RuleTable: " << (m_RuleTable.IsNotNull() ? "yes" : "no") << std::endl;
+    os << indent << "Lookup: " << (m_bDenseLookup ? "dense" : "sorted") << std::endl;
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::SetNumberOfBands(unsigned int numBands)
+{
+    const unsigned int numOutputs = std::max<unsigned int>(1, numBands);
+    this->SetNumberOfIndexedOutputs(numOutputs);
+    this->SetNumberOfRequiredOutputs(numOutputs);
+    for (unsigned int o=1; o < numOutputs; ++o)
+    {
+        if (this->GetOutput(o) == nullptr)
+        {
+            this->SetNthOutput(o, this->MakeOutput(o));
+        }
+    }
+    this->Modified();
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::SetValueColumns(const std::vector<std::string>& cols)
+{
+    m_ValueColumns = cols;
+    this->SetNumberOfBands(cols.size());
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::AddRule(double lower, double upper, const std::vector<double>& values)
+{
+    ReclassRule rule;
+    rule.Lower = lower;
+    rule.Upper = upper;
+    rule.Values = values;
+    m_Rules.push_back(rule);
+    this->Modified();
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::ClearRules(void)
+{
+    m_Rules.clear();
+    this->Modified();
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::ReadTableRules(std::vector<ReclassRule>& rules)
+{
+    if (m_ValueColumns.empty())
+    {
+        itkExceptionMacro(<< "No value columns specified for the rule table!");
+    }
+
+    std::vector<double> lower;
+    if (m_LowerColumn.empty() || !m_RuleTable->GetColumnAsArray(m_LowerColumn, lower))
+    {
+        itkExceptionMacro(<< "Failed reading the lower bounds (values) from column '"
+                          << m_LowerColumn << "' of the rule table!");
+    }
+
+    std::vector<double> upper;
+    if (!m_UpperColumn.empty() && !m_RuleTable->GetColumnAsArray(m_UpperColumn, upper))
+    {
+        itkExceptionMacro(<< "Failed reading the upper bounds from column '"
+                          << m_UpperColumn << "' of the rule table!");
+    }
+
+    std::vector<std::vector<double> > values(m_ValueColumns.size());
+    for (size_t b=0; b < m_ValueColumns.size(); ++b)
+    {
+        if (!m_RuleTable->GetColumnAsArray(m_ValueColumns.at(b), values[b]))
+        {
+            itkExceptionMacro(<< "Failed reading the output values from column '"
+                              << m_ValueColumns.at(b) << "' of the rule table!");
+        }
+    }
+
+    for (size_t r=0; r < lower.size(); ++r)
+    {
+        ReclassRule rule;
+        rule.Lower = lower[r];
+        rule.Upper = r < upper.size() && upper[r] == upper[r] ? upper[r] : lower[r];
+        for (size_t b=0; b < values.size(); ++b)
+        {
+            rule.Values.push_back(r < values[b].size() ? values[b][r] : 0);
+        }
+        rules.push_back(rule);
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::CompileRules(void)
+{
+    const unsigned int nb = this->GetNumberOfIndexedOutputs();
+
+    std::vector<ReclassRule> rules = m_Rules;
+    if (m_RuleTable.IsNotNull())
+    {
+        this->ReadTableRules(rules);
+    }
+
+    if (rules.size() >= static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        itkExceptionMacro(<< "Too many reclass rules: " << rules.size());
+    }
+
+    // output values per band; index 0 = unmatched
+    if (!m_DefaultValues.empty() && m_DefaultValues.size() != 1 && m_DefaultValues.size() != nb)
+    {
+        itkExceptionMacro(<< "Number of default values (" << m_DefaultValues.size()
+                          << ") doesn't match the number of bands (" << nb << ")!");
+    }
+    m_bPassThrough = m_DefaultValues.empty();
+
+    m_BandValues.assign(nb, std::vector<OutputPixelType>(rules.size()+1, 0));
+    for (unsigned int b=0; b < nb && !m_bPassThrough; ++b)
+    {
+        const double dv = m_DefaultValues.size() == 1 ? m_DefaultValues[0] : m_DefaultValues[b];
+        m_BandValues[b][0] = static_cast<OutputPixelType>(dv);
+    }
+
+    // sort exact values and ranges
+    std::vector<std::pair<double, int> > exact;
+    std::vector<std::pair<double, int> > ranges;
+    for (size_t r=0; r < rules.size(); ++r)
+    {
+        const ReclassRule& rule = rules[r];
+        if (rule.Values.size() != nb)
+        {
+            itkExceptionMacro(<< "Rule #" << r << " provides " << rule.Values.size()
+                              << " instead of " << nb << " output values!");
+        }
+
+        for (unsigned int b=0; b < nb; ++b)
+        {
+            m_BandValues[b][r+1] = static_cast<OutputPixelType>(rule.Values[b]);
+        }
+
+        if (rule.Lower != rule.Lower || rule.Upper != rule.Upper)
+        {
+            NMProcWarn(<< "Reclass - skipped rule #" << r << ": undefined bounds!");
+        }
+        else if (rule.Lower == rule.Upper)
+        {
+            exact.push_back(std::pair<double, int>(rule.Lower, r+1));
+        }
+        else if (rule.Lower < rule.Upper)
+        {
+            ranges.push_back(std::pair<double, int>(rule.Lower, r+1));
+        }
+        else
+        {
+            itkExceptionMacro(<< "Rule #" << r << ": lower bound " << rule.Lower
+                              << " exceeds upper bound " << rule.Upper << "!");
+        }
+    }
+    std::stable_sort(exact.begin(), exact.end());
+    std::stable_sort(ranges.begin(), ranges.end());
+
+    m_ExactValues.clear();
+    m_ExactRules.clear();
+    for (size_t e=0; e < exact.size(); ++e)
+    {
+        if (e > 0 && exact[e].first == exact[e-1].first)
+        {
+            itkExceptionMacro(<< "Duplicate reclass value: " << exact[e].first);
+        }
+        m_ExactValues.push_back(exact[e].first);
+        m_ExactRules.push_back(exact[e].second);
+    }
+
+    m_RangeLower.clear();
+    m_RangeUpper.clear();
+    m_RangeRules.clear();
+    for (size_t g=0; g < ranges.size(); ++g)
+    {
+        const ReclassRule& rule = rules[ranges[g].second-1];
+        if (g > 0 && rule.Lower < m_RangeUpper.back())
+        {
+            itkExceptionMacro(<< "Overlapping reclass ranges: ["
+                              << m_RangeLower.back() << ", " << m_RangeUpper.back()
+                              << ") and [" << rule.Lower << ", " << rule.Upper << ")!");
+        }
+        m_RangeLower.push_back(rule.Lower);
+        m_RangeUpper.push_back(rule.Upper);
+        m_RangeRules.push_back(ranges[g].second);
+    }
+
+    // for integer input, we turn the rules into a dense
+    // lookup array, if it isn't too big
+    m_bDenseLookup = false;
+    m_Lookup.clear();
+    if (std::numeric_limits<InputPixelType>::is_integer)
+    {
+        const double tmin = static_cast<double>(std::numeric_limits<InputPixelType>::min());
+        const double tmax = std::min(static_cast<double>(std::numeric_limits<InputPixelType>::max()),
+                                     static_cast<double>(std::numeric_limits<long long>::max() / 2));
+        double lo = std::numeric_limits<double>::infinity();
+        double hi = -std::numeric_limits<double>::infinity();
+
+        std::vector<std::pair<double, double> > spans;
+        for (size_t e=0; e < m_ExactValues.size(); ++e)
+        {
+            const double v = m_ExactValues[e];
+            spans.push_back(v == std::floor(v) && v >= tmin && v <= tmax
+                            ? std::pair<double, double>(v, v)
+                            : std::pair<double, double>(1, 0));
+        }
+        for (size_t g=0; g < m_RangeLower.size(); ++g)
+        {
+            // integers k with lower <= k < upper
+            spans.push_back(std::pair<double, double>(
+                                std::max(std::ceil(m_RangeLower[g]), tmin),
+                                std::min(std::ceil(m_RangeUpper[g]) - 1, tmax)));
+        }
+        for (size_t s=0; s < spans.size(); ++s)
+        {
+            if (spans[s].first <= spans[s].second)
+            {
+                lo = std::min(lo, spans[s].first);
+                hi = std::max(hi, spans[s].second);
+            }
+        }
+
+        if (lo <= hi && hi - lo + 1 <= static_cast<double>(m_MaxLookupSize))
+        {
+            m_bDenseLookup = true;
+            m_LookupMin = static_cast<long long>(lo);
+            m_Lookup.assign(static_cast<size_t>(hi - lo + 1), 0);
+
+            // ranges first, so exact values take precedence
+            const size_t ne = m_ExactValues.size();
+            for (size_t s=spans.size(); s > 0; --s)
+            {
+                const std::pair<double, double>& span = spans[s-1];
+                if (span.first > span.second)
+                {
+                    continue;
+                }
+
+                const int rule = s-1 < ne ? m_ExactRules[s-1] : m_RangeRules[s-1-ne];
+                const long long kend = static_cast<long long>(span.second);
+                for (long long k = static_cast<long long>(span.first); k <= kend; ++k)
+                {
+                    m_Lookup[k - m_LookupMin] = rule;
+                }
+            }
+        }
+    }
+
+    NMProcDebug(<< "Reclass - " << rules.size() << " rules ("
+                << m_ExactValues.size() << " values, " << m_RangeLower.size()
+                << " ranges) compiled into a "
+                << (m_bDenseLookup ? "dense lookup array" : "sorted lookup table")
+                << " for " << nb << " band(s)");
+}
+
+template <class TInputImage, class TOutputImage>
+inline int ReclassImageFilter<TInputImage, TOutputImage>
+::FindRule(double v) const
+{
+    if (v != v)
+    {
+        return 0;
+    }
+
+    std::vector<double>::const_iterator it =
+            std::lower_bound(m_ExactValues.begin(), m_ExactValues.end(), v);
+    if (it != m_ExactValues.end() && *it == v)
+    {
+        return m_ExactRules[it - m_ExactValues.begin()];
+    }
+
+    it = std::upper_bound(m_RangeLower.begin(), m_RangeLower.end(), v);
+    if (it != m_RangeLower.begin())
+    {
+        const size_t g = (it - m_RangeLower.begin()) - 1;
+        if (v < m_RangeUpper[g])
+        {
+            return m_RangeRules[g];
+        }
+    }
+
+    return 0;
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::BeforeThreadedGenerateData(void)
+{
+    itk::ModifiedTimeType mtime = this->GetMTime();
+    if (m_RuleTable.IsNotNull())
+    {
+        mtime = std::max(mtime, m_RuleTable->GetMTime());
+    }
+
+    // rules are only compiled once, unless they've changed
+    if (mtime != m_CompileTime || m_BandValues.size() != this->GetNumberOfIndexedOutputs())
+    {
+        this->CompileRules();
+        m_CompileTime = mtime;
+    }
+}
+
+template <class TInputImage, class TOutputImage>
+void ReclassImageFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+    const InputImageType* input = this->GetInput();
+    const InputPixelType* inBuf = input->GetBufferPointer();
+
+    const unsigned int nb = m_BandValues.size();
+    std::vector<OutputImageType*> outputs(nb);
+    for (unsigned int b=0; b < nb; ++b)
+    {
+        outputs[b] = this->GetOutput(b);
+    }
+
+    const long lineLength = outputRegionForThread.GetSize(0);
+    if (lineLength == 0)
+    {
+        return;
+    }
+    std::vector<int> lineRules(lineLength);
+    int* rules = &lineRules[0];
+
+    const int* lut = m_bDenseLookup ? &m_Lookup[0] : nullptr;
+    const long long lutSize = m_Lookup.size();
+
+    itk::ProgressReporter progress(this, threadId,
+                outputRegionForThread.GetNumberOfPixels() / lineLength);
+
+    itk::ImageScanlineConstIterator<InputImageType> inIter(input, outputRegionForThread);
+    while (!inIter.IsAtEnd())
+    {
+        const InputPixelType* in = inBuf + input->ComputeOffset(inIter.GetIndex());
+
+        // look up the rule for each pixel of this line ...
+        if (m_bDenseLookup)
+        {
+            for (long x=0; x < lineLength; ++x)
+            {
+                const long long k = static_cast<long long>(in[x]) - m_LookupMin;
+                rules[x] = k >= 0 && k < lutSize ? lut[k] : 0;
+            }
+        }
+        else
+        {
+            for (long x=0; x < lineLength; ++x)
+            {
+                rules[x] = this->FindRule(static_cast<double>(in[x]));
+            }
+        }
+
+        // ... and fill the output lines
+        for (unsigned int b=0; b < nb; ++b)
+        {
+            OutputPixelType* out = outputs[b]->GetBufferPointer()
+                    + outputs[b]->ComputeOffset(inIter.GetIndex());
+            const OutputPixelType* vals = &m_BandValues[b][0];
+            if (m_bPassThrough)
+            {
+                for (long x=0; x < lineLength; ++x)
+                {
+                    out[x] = rules[x] ? vals[rules[x]] : static_cast<OutputPixelType>(in[x]);
+                }
+            }
+            else
+            {
+                for (long x=0; x < lineLength; ++x)
+                {
+                    out[x] = vals[rules[x]];
+                }
+            }
+        }
+
+        inIter.NextLine();
+        progress.CompletedPixel();
+    }
+}
+
+} // end namespace otb
+
+#endif // __otbReclassImageFilter_txx
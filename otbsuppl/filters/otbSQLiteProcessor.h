@@ -28,8 +28,11 @@
 #define OTBSQLITEPROCESSOR_H_
 
 #include <string>
+#include <vector>
+#include <map>
 
 #include "itkImageToImageFilter.h"
+#include "itkCommand.h"
 #include "otbImage.h"
 #include "otbSQLiteTable.h"
 
@@ -38,6 +41,20 @@
 /*!
  *  \brief SQLiteProcessor enables SQL processing with otb::SQLiteTable's
  *
+ *  The tables 1 .. N are attached to the database of table 0 under the
+ *  given image names. Since the filter is typically executed many times
+ *  within an iterative model, attachments are kept alive across
+ *  invocations as long as an alias refers to the same database file, and
+ *  the statements of SQLStatement are prepared only once and then
+ *  re-executed with the current SQLParameters bound. The statement batch
+ *  runs within one transaction (unless it contains its own transaction
+ *  control) and the main table's admin structures are only repopulated
+ *  when the batch has changed the database schema.
+ *
+ *  Cached statements and attachments are released by ResetPipeline(),
+ *  when SQLStatement or the main table's connection changes, before
+ *  the main table's connection is closed, and when the filter is
+ *  destroyed.
  */
 
 namespace otb
@@ -81,7 +98,24 @@ public:
     typedef typename OutputImageType::RegionType OutputImageRegionType;
 
 
-    itkSetMacro(SQLStatement, std::string)
+    /*! Sets the SQL statement(s) to be executed; statements
+     *  prepared for a previous SQLStatement are finalized */
+    void SetSQLStatement(const std::string& sql)
+    {
+        if (sql.compare(m_SQLStatement) != 0)
+        {
+            this->FinalizeStatements();
+            m_SQLStatement = sql;
+            this->Modified();
+        }
+    }
+
+    /*! Values bound to the parameters of each statement of SQLStatement:
+     *  the n-th value is bound to parameter ?n (or the n-th '?', ':name',
+     *  etc.); values parsing as numbers are bound as INTEGER or REAL,
+     *  all others as TEXT, and missing values as NULL */
+    void SetSQLParameters(const std::vector<std::string>& params)
+        {m_SQLParameters = params; this->Modified();}
 
     void SetImageNames(std::vector<std::string> names) {m_ImageNames = names;}
 
@@ -91,9 +125,12 @@ public:
 
     void GenerateInputRequestedRegion();
 
+    void ResetPipeline();
+
 
 protected:
     SQLiteProcessor();
+    virtual ~SQLiteProcessor();
     SQLiteProcessor(const Self&);
     void operator=(const Self&);
 
@@ -101,11 +138,66 @@ protected:
 
     void GenerateData();
 
+    /*! identifies an attached input database by its file name
+     *  and the file's identity on disk at the time of attachment */
+    struct AttachedDb
+    {
+        AttachedDb() : dev(0), ino(0) {}
+
+        bool operator==(const AttachedDb& other) const
+        {
+            return     fileName == other.fileName
+                    && dev == other.dev
+                    && ino == other.ino;
+        }
+
+        std::string fileName;
+        long long dev;
+        long long ino;
+    };
+
+    /*! attaches the input databases to the main table's connection
+     *  unless the same database file is already attached under the
+     *  same name */
+    void UpdateAttachments(void);
+    void DetachAll(void);
+    void FinalizeStatements(void);
+
+    /*! sets the table whose connection hosts the attachments and
+     *  prepared statements and observes it for SQLiteCloseEvent */
+    void SetConnTable(SQLiteTable* tab);
+    void ConnTableClosing(itk::Object* caller, const itk::EventObject& event);
+
+    /*! binds m_SQLParameters to the given statement */
+    void BindParameters(sqlite3_stmt* stmt);
+
+    /*! true, if any statement of sql starts with a keyword that must
+     *  not be run within the processor's transaction */
+    static bool HasTransactionControl(const std::string& sql);
+    static int GetSchemaVersion(sqlite3* db);
+    static AttachedDb GetAttachedDbInfo(SQLiteTable* tab);
+
     std::vector<std::string>  m_ImageNames;
     std::string m_SQLStatement;
+    std::vector<std::string>  m_SQLParameters;
 
     std::vector<SQLiteTable::Pointer> m_vRAT;
 
+    // connection state kept across invocations
+    typedef itk::MemberCommand<Self> CloseObserverType;
+    SQLiteTable::Pointer m_ConnTable;
+    sqlite3* m_Db;
+    std::map<std::string, AttachedDb> m_AttachedDbs;
+    typename CloseObserverType::Pointer m_CloseObserver;
+    unsigned long m_CloseObserverTag;
+
+    // prepared statements of m_PreparedSQL kept across
+    // invocations; m_PreparedTail is the offset of the
+    // first statement not prepared yet
+    std::string m_PreparedSQL;
+    std::vector<sqlite3_stmt*> m_vStmts;
+    size_t m_PreparedTail;
+
 
 private:
     static const std::string ctx;
@@ -28,6 +28,12 @@
 #ifndef __otbSQLiteProcessor_txx
 #define __otbSQLiteProcessor_txx
 
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+
 #include "nmlog.h"
 #include "otbSQLiteProcessor.h"
 #include "itkSmartPointerForwardReference.h"
@@ -39,8 +45,14 @@ namespace otb
 template< class TInputImage, class TOutputImage >
 SQLiteProcessor< TInputImage, TOutputImage >
 ::SQLiteProcessor()
-    : m_SQLStatement("")
+    : m_SQLStatement(""),
+      m_Db(nullptr),
+      m_CloseObserverTag(0),
+      m_PreparedTail(0)
 {
+    m_CloseObserver = CloseObserverType::New();
+    m_CloseObserver->SetCallbackFunction(this, &Self::ConnTableClosing);
+
     this->SetNumberOfRequiredInputs(1);
         this->SetNumberOfRequiredOutputs(1);
 
@@ -64,6 +76,315 @@ SQLiteProcessor< TInputImage, TOutputImage >
 
 }
 
+template< class TInputImage, class TOutputImage >
+SQLiteProcessor< TInputImage, TOutputImage >
+::~SQLiteProcessor()
+{
+    this->FinalizeStatements();
+    this->DetachAll();
+    this->SetConnTable(nullptr);
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::ResetPipeline()
+{
+    this->FinalizeStatements();
+    this->DetachAll();
+    this->SetConnTable(nullptr);
+
+    Superclass::ResetPipeline();
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::SetConnTable(SQLiteTable* tab)
+{
+    if (m_ConnTable.IsNotNull())
+    {
+        m_ConnTable->RemoveObserver(m_CloseObserverTag);
+    }
+
+    m_ConnTable = tab;
+    m_Db = nullptr;
+    if (m_ConnTable.IsNotNull())
+    {
+        m_Db = m_ConnTable->GetDbConnection();
+        m_CloseObserverTag = m_ConnTable->AddObserver(SQLiteCloseEvent(), m_CloseObserver);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::ConnTableClosing(itk::Object* caller, const itk::EventObject& event)
+{
+    // statements still prepared would prevent the connection from
+    // being closed (or end up in the pool with it), and the
+    // attachments die with the connection anyway
+    this->FinalizeStatements();
+    m_AttachedDbs.clear();
+    m_Db = nullptr;
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::FinalizeStatements()
+{
+    for (int s=0; s < m_vStmts.size(); ++s)
+    {
+        sqlite3_finalize(m_vStmts.at(s));
+    }
+    m_vStmts.clear();
+    m_PreparedSQL.clear();
+    m_PreparedTail = 0;
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::DetachAll()
+{
+    // only detach, if the connection we've attached
+    // the databases to is still alive
+    if (    m_ConnTable.IsNotNull()
+        &&  m_Db != nullptr
+        &&  m_ConnTable->GetDbConnection() == m_Db
+       )
+    {
+        typename std::map<std::string, AttachedDb>::const_iterator it =
+                m_AttachedDbs.begin();
+        for (; it != m_AttachedDbs.end(); ++it)
+        {
+            if (!m_ConnTable->DetachDatabase(it->first))
+            {
+                // s. UpdateAttachments
+                NMProcWarn(<< "Failed detaching database '" << it->first
+                           << "' - " << m_ConnTable->getLastLogMsg());
+            }
+        }
+    }
+    m_AttachedDbs.clear();
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::UpdateAttachments()
+{
+    SQLiteTable::Pointer mainTab = m_vRAT.at(0);
+    sqlite3* db = mainTab->GetDbConnection();
+
+    // the main table or its connection has changed since the last
+    // invocation, so we start afresh
+    if (mainTab != m_ConnTable || db != m_Db)
+    {
+        this->FinalizeStatements();
+        this->DetachAll();
+        this->SetConnTable(mainTab);
+    }
+
+    std::map<std::string, AttachedDb> curDbs;
+    for (int i=1; i < m_vRAT.size(); ++i)
+    {
+        if (m_vRAT.at(i).GetPointer() != nullptr)
+        {
+            curDbs[m_ImageNames.at(i)] = GetAttachedDbInfo(m_vRAT.at(i).GetPointer());
+        }
+        else
+        {
+            NMProcWarn(<< "Input table at idx=" << i
+                            << " is NULL in this iteration! Attaching database failed!");
+        }
+    }
+
+    // detach what has been dropped or changed since the last invocation,
+    // i.e. a different file or a file that has been replaced on disk
+    // in the meantime; statements referring to it are re-prepared;
+    // we just warn here, because we had problems with detaching the
+    // db for unknown reasons; no harm done, because we'll get
+    // a proper exception when we try to use the this db
+    // and it is still locked; attachement should be released
+    // once the otbSQLiteTable pointer goes out of scope and
+    // the host database is closed anyway ...
+    typename std::map<std::string, AttachedDb>::iterator ait = m_AttachedDbs.begin();
+    while (ait != m_AttachedDbs.end())
+    {
+        typename std::map<std::string, AttachedDb>::const_iterator cit =
+                curDbs.find(ait->first);
+        if (    cit != curDbs.end()
+            &&  cit->second == ait->second
+            &&  sqlite3_db_filename(db, ait->first.c_str()) != nullptr
+           )
+        {
+            ++ait;
+            continue;
+        }
+
+        this->FinalizeStatements();
+        if (    sqlite3_db_filename(db, ait->first.c_str()) != nullptr
+            &&  !mainTab->DetachDatabase(ait->first)
+           )
+        {
+            NMProcWarn(<< "Failed detaching databases - "
+                       << mainTab->getLastLogMsg());
+        }
+        ait = m_AttachedDbs.erase(ait);
+    }
+
+    typename std::map<std::string, AttachedDb>::const_iterator cit = curDbs.begin();
+    for (; cit != curDbs.end(); ++cit)
+    {
+        if (m_AttachedDbs.find(cit->first) != m_AttachedDbs.end())
+        {
+            continue;
+        }
+
+        if (!mainTab->AttachDatabase(cit->second.fileName, cit->first))
+        {
+            if (mainTab->getLastLogMsg().find("already attached") != std::string::npos)
+            {
+                NMProcInfo(<< "Database '" << cit->second.fileName << "' "
+                    << "is already attached.");
+                continue;
+            }
+            else
+            {
+                itkExceptionMacro(<< "Failed attaching input databases - "
+                    << mainTab->getLastLogMsg());
+                return;
+            }
+        }
+        m_AttachedDbs[cit->first] = cit->second;
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+typename SQLiteProcessor< TInputImage, TOutputImage >::AttachedDb
+SQLiteProcessor< TInputImage, TOutputImage >
+::GetAttachedDbInfo(SQLiteTable* tab)
+{
+    AttachedDb info;
+    info.fileName = tab->GetDbFileName();
+
+#ifdef _WIN32
+    struct _stat64 res;
+    if (_stat64(info.fileName.c_str(), &res) == 0)
+#else
+    struct stat64 res;
+    if (stat64(info.fileName.c_str(), &res) == 0)
+#endif
+    {
+        info.dev = static_cast<long long>(res.st_dev);
+        info.ino = static_cast<long long>(res.st_ino);
+    }
+
+    return info;
+}
+
+template< class TInputImage, class TOutputImage >
+void SQLiteProcessor< TInputImage, TOutputImage >
+::BindParameters(sqlite3_stmt* stmt)
+{
+    const int numParams = sqlite3_bind_parameter_count(stmt);
+    if (numParams > m_SQLParameters.size())
+    {
+        NMProcWarn(<< "The statement '" << sqlite3_sql(stmt) << "' "
+                   << "has " << numParams << " parameters, but only "
+                   << m_SQLParameters.size() << " values were provided; "
+                   << "missing values are set to NULL!");
+    }
+
+    for (int p=0; p < numParams && p < m_SQLParameters.size(); ++p)
+    {
+        const std::string& val = m_SQLParameters.at(p);
+        const char* str = val.c_str();
+        char* end = nullptr;
+
+        if (!val.empty() && !std::isspace(static_cast<unsigned char>(val[0])))
+        {
+            const long long lval = std::strtoll(str, &end, 10);
+            if (*end == '\0')
+            {
+                sqlite3_bind_int64(stmt, p+1, lval);
+                continue;
+            }
+
+            const double dval = std::strtod(str, &end);
+            if (*end == '\0')
+            {
+                sqlite3_bind_double(stmt, p+1, dval);
+                continue;
+            }
+        }
+
+        sqlite3_bind_text(stmt, p+1, str, val.size(), SQLITE_TRANSIENT);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+bool SQLiteProcessor< TInputImage, TOutputImage >
+::HasTransactionControl(const std::string& sql)
+{
+    static const char* keywords[] = {"BEGIN", "COMMIT", "END", "ROLLBACK",
+                                     "SAVEPOINT", "RELEASE", "VACUUM",
+                                     "ATTACH", "DETACH", "PRAGMA"};
+    static const int numKeywords = sizeof(keywords) / sizeof(keywords[0]);
+
+    // note: we're not parsing string literals or comments here,
+    // so we might get false positives which only means we'd
+    // run the statements without our own transaction
+    size_t pos = 0;
+    while (pos < sql.size())
+    {
+        const size_t start = sql.find_first_not_of(" \t\r\n;", pos);
+        if (start == std::string::npos)
+        {
+            break;
+        }
+
+        size_t end = sql.find_first_of(" \t\r\n;", start);
+        if (end == std::string::npos)
+        {
+            end = sql.size();
+        }
+
+        std::string token = sql.substr(start, end - start);
+        std::transform(token.begin(), token.end(), token.begin(), ::toupper);
+        for (int k=0; k < numKeywords; ++k)
+        {
+            if (token.compare(keywords[k]) == 0)
+            {
+                return true;
+            }
+        }
+
+        pos = sql.find(';', start);
+        if (pos == std::string::npos)
+        {
+            break;
+        }
+        ++pos;
+    }
+
+    return false;
+}
+
+template< class TInputImage, class TOutputImage >
+int SQLiteProcessor< TInputImage, TOutputImage >
+::GetSchemaVersion(sqlite3* db)
+{
+    int version = -1;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, "PRAGMA main.schema_version;", -1, &stmt, 0) == SQLITE_OK)
+    {
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            version = sqlite3_column_int(stmt, 0);
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    return version;
+}
+
 template< class TInputImage, class TOutputImage >
 void SQLiteProcessor< TInputImage, TOutputImage >
 ::setRAT(unsigned int idx, AttributeTable::Pointer tab)
@@ -196,88 +517,134 @@ void SQLiteProcessor< TInputImage, TOutputImage >
         return;
     }
 
-    for (int i=1; i < m_vRAT.size(); ++i)
+    SQLiteTable::Pointer mainTab = m_vRAT.at(0);
+    sqlite3* db = mainTab->GetDbConnection();
+    if (db == nullptr)
     {
-        if (m_vRAT.at(i).GetPointer() != nullptr)
+        itkExceptionMacro(<< "Input table #0 is not connected to a database!")
+        return;
+    }
+
+    this->UpdateAttachments();
+
+    // statements are kept prepared across runs; they're finalized
+    // when SQLStatement changes or the connection is closed
+    if (m_PreparedSQL.compare(m_SQLStatement) != 0)
+    {
+        this->FinalizeStatements();
+        m_PreparedSQL = m_SQLStatement;
+    }
+
+    this->UpdateProgress(0.2);
+
+    const int schemaVersion = GetSchemaVersion(db);
+    const bool bTransaction =    sqlite3_get_autocommit(db) != 0
+                              && !HasTransactionControl(m_PreparedSQL)
+                              && mainTab->BeginTransaction();
+
+    // statements are prepared one after another just before they are
+    // executed for the first time, since they may refer to tables
+    // created by any of the preceding statements
+    int rc = SQLITE_OK;
+    std::string errmsg;
+    for (int s=0; rc == SQLITE_OK; ++s)
+    {
+        sqlite3_stmt* stmt = nullptr;
+        if (s < m_vStmts.size())
+        {
+            stmt = m_vStmts.at(s);
+        }
+        else if (m_PreparedTail < m_PreparedSQL.size())
         {
-            if (!m_vRAT.at(0)->AttachDatabase(m_vRAT.at(i)->GetDbFileName(),
-                                              m_ImageNames.at(i)))
+            const char* sql = m_PreparedSQL.c_str();
+            const char* tail = nullptr;
+            rc = sqlite3_prepare_v2(db, sql + m_PreparedTail, -1, &stmt, &tail);
+            if (rc != SQLITE_OK)
             {
-                if (m_vRAT.at(0)->getLastLogMsg().find("already attached") != std::string::npos)
-                {
-                    NMProcInfo(<< "Database '" << m_vRAT.at(i)->GetDbFileName() << "' "
-                        << "is already attached.");
-                }
-                else
-                {
-                    itkExceptionMacro(<< "Failed attaching input databases - "
-                        << m_vRAT.at(0)->getLastLogMsg());
-                    return;
+                errmsg = sqlite3_errmsg(db);
+                sqlite3_finalize(stmt);
+                break;
+            }
 
-                }
+            m_PreparedTail = tail != nullptr ? tail - sql : m_PreparedSQL.size();
+            if (stmt == nullptr)
+            {
+                // only comments or white space left
+                m_PreparedTail = m_PreparedSQL.size();
+                break;
             }
+            m_vStmts.push_back(stmt);
         }
         else
         {
-            NMProcWarn(<< "Input table at idx=" << i
-                            << " is NULL in this iteration! Attaching database failed!");
+            break;
         }
-    }
 
+        this->BindParameters(stmt);
+        do
+        {
+            rc = sqlite3_step(stmt);
+        } while (rc == SQLITE_ROW);
 
-    this->UpdateProgress(0.2);
-    if (!m_vRAT.at(0)->SqlExec(m_SQLStatement))
-    {
-        // we only report an error for the following
-        // conditions:
-        // - database is locked
-        // - database is readonly
-        //
-        // all other conditions are treated as OK; for instance
-        // we just give a warning if try to a add a column that
-        // is already present and in general doesn't affect the
-        // overall modelling run
-
-
-        std::string lastlog = m_vRAT.at(0)->getLastLogMsg();
-        if (    lastlog.find("database is locked") != std::string::npos
-            ||  lastlog.find("database is readonly") != std::string::npos
-           )
+        if (rc == SQLITE_DONE)
         {
-            NMProcErr(<< "SQL processing failed - "
-                      << lastlog);
-            itkExceptionMacro(<< "SQL processing failed - "
-                              << lastlog);
+            rc = SQLITE_OK;
         }
         else
         {
-            NMProcWarn(<< "SQL processing failed - "
-                       << lastlog);
+            errmsg = sqlite3_errmsg(db);
         }
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
     }
 
-    for (int i=1; i < m_vRAT.size(); ++i)
+    // we only report an error for the following
+    // conditions:
+    // - database is locked
+    // - database is readonly
+    //
+    // all other conditions are treated as OK; for instance
+    // we just give a warning if try to a add a column that
+    // is already present and in general doesn't affect the
+    // overall modelling run; as before, the statements executed
+    // up to the failing one are committed
+    const int errcode = rc & 0xff;
+    bool bFatal =    errcode == SQLITE_BUSY
+                  || errcode == SQLITE_LOCKED
+                  || errcode == SQLITE_READONLY;
+
+    if (rc != SQLITE_OK && !bFatal)
+    {
+        NMProcWarn(<< "SQL processing failed - SQLite3 ERROR: "
+                   << errmsg);
+    }
+
+    if (!bFatal && bTransaction && !mainTab->EndTransaction())
     {
-        if (!m_vRAT.at(0)->DetachDatabase(m_ImageNames.at(i)))
+        errmsg = mainTab->getLastLogMsg();
+        bFatal = true;
+    }
+
+    if (bFatal)
+    {
+        if (sqlite3_get_autocommit(db) == 0)
         {
-            //NMDebugCtx(ctx, << "done!");
-            // we just warn here, because we had problems with detaching the
-            // db for unknown reasons; no harm done, because we'll get
-            // a proper exception when we try to use the this db
-            // and it is still locked; attachement should be released
-            // once the otbSQLiteTable pointer goes out of scope and
-            // the host database is closed anyway ...
-            NMProcWarn(<< "Failed detaching databases - "
-                       << m_vRAT.at(0)->getLastLogMsg());
-           // return;
+            mainTab->SqlExec("ROLLBACK;");
         }
+        NMProcErr(<< "SQL processing failed - SQLite3 ERROR: "
+                  << errmsg);
+        itkExceptionMacro(<< "SQL processing failed - SQLite3 ERROR: "
+                          << errmsg);
     }
+
     this->UpdateProgress(0.8);
 
-    if (!m_vRAT.at(0)->PopulateTableAdmin())
+    if (    GetSchemaVersion(db) != schemaVersion
+        &&  !mainTab->PopulateTableAdmin()
+       )
     {
         NMProcWarn(<< "Failed repopulating the main table's admin structures! "
-                          << m_vRAT.at(0)->getLastLogMsg());
+                          << mainTab->getLastLogMsg());
     }
 
     this->UpdateProgress(1.0);
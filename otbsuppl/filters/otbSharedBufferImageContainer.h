@@ -0,0 +1,134 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * otbSharedBufferImageContainer.h
+ *
+ *  Created on: 2026-10-19
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __otbSharedBufferImageContainer_h
+#define __otbSharedBufferImageContainer_h
+
+#include <type_traits>
+
+#include "itkImportImageContainer.h"
+#include "itkImage.h"
+
+namespace otb
+{
+
+/*! \brief Pixel container referring to a block of another
+ *         image's pixel buffer rather than owning its pixels
+ *
+ *  The container keeps a reference to the pixel container it
+ *  refers to, so the block stays valid, even if the other image
+ *  releases its data (e.g. ReleaseDataFlag). However, the pixels
+ *  are shared: if the other image's source re-executes, it may
+ *  reuse (i.e. overwrite) the buffer. Filters therefore only share
+ *  buffers on request (s. CubeSliceToImage2DFilter::ShareInputBuffer).
+ */
+template <typename TElementIdentifier, typename TElement>
+class SharedBufferImageContainer
+        : public itk::ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+    typedef SharedBufferImageContainer                                  Self;
+    typedef itk::ImportImageContainer<TElementIdentifier, TElement>     Superclass;
+    typedef itk::SmartPointer<Self>                                     Pointer;
+    typedef itk::SmartPointer<const Self>                               ConstPointer;
+
+    itkNewMacro(Self)
+    itkTypeMacro(SharedBufferImageContainer, ImportImageContainer)
+
+    /*! the container owning the shared block */
+    void SetOwner(const itk::LightObject* owner)
+        {m_Owner = owner;}
+
+protected:
+    SharedBufferImageContainer() {}
+    virtual ~SharedBufferImageContainer() {}
+
+private:
+    SharedBufferImageContainer(const Self&); //purposely not implemented
+    void operator=(const Self&); //purposely not implemented
+
+    itk::LightObject::ConstPointer m_Owner;
+};
+
+/*! \brief Makes inRegion of in's buffer the buffer of out (covering
+ *         outRegion), without copying any pixels
+ *
+ *  The caller makes sure that the dimensions of inRegion map onto
+ *  those of outRegion in the same order. Returns false, if the pixel
+ *  types differ or inRegion isn't a contiguous block of in's buffer,
+ *  i.e. if, below its last dimension of size > 1, it doesn't span
+ *  in's buffered region entirely.
+ */
+template <class TInputImage, class TOutputImage>
+bool ShareContiguousBlock(const TInputImage* in,
+                          const typename TInputImage::RegionType& inRegion,
+                          TOutputImage* out,
+                          const typename TOutputImage::RegionType& outRegion)
+{
+    typedef typename TInputImage::PixelType     InputPixelType;
+    typedef typename TOutputImage::PixelType    OutputPixelType;
+    typedef SharedBufferImageContainer<itk::SizeValueType, OutputPixelType> ContainerType;
+
+    if (    !std::is_same<InputPixelType, OutputPixelType>::value
+         || inRegion.GetNumberOfPixels() != outRegion.GetNumberOfPixels()
+         || !in->GetBufferedRegion().IsInside(inRegion)
+       )
+    {
+        return false;
+    }
+
+    const typename TInputImage::RegionType& bufRegion = in->GetBufferedRegion();
+    int lastDim = TInputImage::ImageDimension - 1;
+    while (lastDim > 0 && inRegion.GetSize(lastDim) == 1)
+    {
+        --lastDim;
+    }
+
+    for (int d=0; d < lastDim; ++d)
+    {
+        if (    inRegion.GetIndex(d) != bufRegion.GetIndex(d)
+             || inRegion.GetSize(d) != bufRegion.GetSize(d)
+           )
+        {
+            return false;
+        }
+    }
+
+    InputPixelType* block = const_cast<InputPixelType*>(in->GetBufferPointer())
+                            + in->ComputeOffset(inRegion.GetIndex());
+
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->SetImportPointer(reinterpret_cast<OutputPixelType*>(block),
+                                outRegion.GetNumberOfPixels(), false);
+    container->SetOwner(in->GetPixelContainer());
+
+    out->SetBufferedRegion(outRegion);
+    out->SetPixelContainer(container);
+
+    return true;
+}
+
+} // end namespace otb
+
+#endif // __otbSharedBufferImageContainer_h
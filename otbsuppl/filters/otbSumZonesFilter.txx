@@ -208,6 +208,7 @@ void SumZonesFilter< TInputImage, TOutputImage >
             // if we're using a temp data base, we want to know the name for
             // to open the same table again during sequential processing
             m_dropTmpDBs = true;
+            mZoneTable->SetScratchMode(true);
         }
 
         NMDebugAI( << "Creating the zone table ..." << std::endl);
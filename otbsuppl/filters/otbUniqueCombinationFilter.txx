@@ -327,6 +327,7 @@ UniqueCombinationFilter< TInputImage, TOutputImage >
 
     otb::SQLiteTable::Pointer uvTable = otb::SQLiteTable::New();
     uvTable->SetUseSharedCache(false);
+    uvTable->SetScratchMode(true);
 
 
     std::string temppath = "";
@@ -0,0 +1,252 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  ColumnarTableBenchmark
+ *
+ *  usage: ColumnarTableBenchmark [workspace dir] [number of rows]
+ *
+ *  Compares the SQLite and the columnar (memory-mapped) attribute
+ *  table backends for what a RAT is mostly used for in a model, i.e.
+ *  - opening the table (per thread),
+ *  - random per-pixel value lookups (numeric and string columns),
+ *  and reports the time it takes to import the SQLite table into
+ *  the columnar format. The values read from both backends are
+ *  compared, so the benchmark fails, if they don't match.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+#include "otbSQLiteTable.h"
+#include "otbColumnarTable.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+const char* LandUse[] = {"forest", "pasture", "cropland", "urban", "water",
+                         "wetland", "scrub", "bare"};
+const int NumLandUse = sizeof(LandUse) / sizeof(LandUse[0]);
+
+/*! creates a RAT-like table with numRows rows of
+ *  (rowidx, class, val, landuse) */
+bool CreateSQLiteTable(const std::string& fileName, long long numRows)
+{
+    otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+    tab->SetScratchMode(true);
+    if (tab->CreateTable(fileName, "1") != otb::SQLiteTable::ATCREATE_CREATED)
+    {
+        std::cout << "Failed creating '" << fileName << "': "
+                  << tab->getLastLogMsg() << std::endl;
+        return false;
+    }
+
+    tab->BeginTransaction();
+    tab->AddColumn("class", otb::AttributeTable::ATTYPE_INT);
+    tab->AddColumn("val", otb::AttributeTable::ATTYPE_DOUBLE);
+    tab->AddColumn("landuse", otb::AttributeTable::ATTYPE_STRING);
+
+    std::vector<std::string> colnames;
+    colnames.push_back(tab->GetPrimaryKey());
+    colnames.push_back("class");
+    colnames.push_back("val");
+    colnames.push_back("landuse");
+
+    std::vector<otb::AttributeTable::ColumnValue> values(4);
+    values[0].type = otb::AttributeTable::ATTYPE_INT;
+    values[1].type = otb::AttributeTable::ATTYPE_INT;
+    values[2].type = otb::AttributeTable::ATTYPE_DOUBLE;
+    values[3].type = otb::AttributeTable::ATTYPE_STRING;
+
+    tab->PrepareBulkSet(colnames, true);
+    for (long long r=0; r < numRows; ++r)
+    {
+        values[0].ival = r;
+        values[1].ival = r % 97;
+        values[2].dval = r * 0.25;
+        const char* lu = LandUse[(r * 7) % NumLandUse];
+        values[3].SetString(lu, std::strlen(lu));
+        tab->DoBulkSet(values);
+    }
+    tab->EndTransaction();
+    tab->CloseTable();
+
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const std::string workspace = argc > 1 ? argv[1] : ".";
+    const long long numRows = argc > 2 ? std::atoll(argv[2]) : 1000000;
+
+    const int numOpen = 64;
+    const long long numLookups = 2000000;
+
+    const std::string ldbFile = workspace + "/bench_columnar.ldb";
+    const std::string ctabFile = workspace + "/bench_columnar.ctab";
+    std::remove(ldbFile.c_str());
+    std::remove(ctabFile.c_str());
+
+    std::cout << "ColumnarTable benchmark: " << numRows << " rows" << std::endl;
+
+    if (!CreateSQLiteTable(ldbFile, numRows))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // ------------------------------------------- import
+    otb::SQLiteTable::Pointer sqlTab = otb::SQLiteTable::New();
+    sqlTab->SetOpenReadOnly(true);
+    if (sqlTab->CreateTable(ldbFile, "1") != otb::SQLiteTable::ATCREATE_READ)
+    {
+        std::cout << "Failed opening '" << ldbFile << "': "
+                  << sqlTab->getLastLogMsg() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    otb::ColumnarTable::Pointer colTab = otb::ColumnarTable::ImportTable(sqlTab, ctabFile);
+    if (colTab.IsNull())
+    {
+        std::cout << "Failed importing the table into '" << ctabFile << "'!" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "import SQLite -> columnar: " << SecondsSince(start) << " s" << std::endl;
+
+    // ------------------------------------------- open
+    start = BenchClock::now();
+    for (int o=0; o < numOpen; ++o)
+    {
+        otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+        tab->SetOpenReadOnly(true);
+        tab->SetUseSharedCache(false);
+        tab->CreateTable(ldbFile, "1");
+        tab->CloseTable();
+    }
+    std::cout << "open x " << numOpen << ", SQLite:   "
+              << SecondsSince(start) << " s" << std::endl;
+
+    start = BenchClock::now();
+    for (int o=0; o < numOpen; ++o)
+    {
+        otb::ColumnarTable::Pointer tab = otb::ColumnarTable::New();
+        tab->OpenTable(ctabFile);
+        tab->CloseTable();
+    }
+    std::cout << "open x " << numOpen << ", columnar: "
+              << SecondsSince(start) << " s" << std::endl;
+
+    // ------------------------------------------- random lookups
+    const int sqlValCol = sqlTab->ColumnExists("val");
+    const int sqlLuCol = sqlTab->ColumnExists("landuse");
+    const int colValCol = colTab->ColumnExists("val");
+    const int colLuCol = colTab->ColumnExists("landuse");
+
+    const long long minPK = colTab->GetMinPKValue();
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<long long> rowDist(minPK, minPK + numRows - 1);
+    std::vector<long long> rows(numLookups);
+    for (long long l=0; l < numLookups; ++l)
+    {
+        rows[l] = rowDist(rng);
+    }
+
+    // SQLite lookups are a lot slower, so we only
+    // do a fraction of them and extrapolate
+    const long long numSqlLookups = numLookups / 20;
+    std::vector<double> sqlVals(numSqlLookups);
+    std::vector<std::string> sqlStrs(numSqlLookups);
+    start = BenchClock::now();
+    for (long long l=0; l < numSqlLookups; ++l)
+    {
+        sqlVals[l] = sqlTab->GetDblValue(sqlValCol, rows[l]);
+        sqlStrs[l] = sqlTab->GetStrValue(sqlLuCol, rows[l]);
+    }
+    const double sqlSecs = SecondsSince(start);
+
+    double checksum = 0;
+    long long nstr = 0;
+    start = BenchClock::now();
+    for (long long l=0; l < numLookups; ++l)
+    {
+        checksum += colTab->GetDblValue(colValCol, rows[l]);
+        nstr += colTab->GetStrValue(colLuCol, rows[l]).size();
+    }
+    const double colSecs = SecondsSince(start);
+
+    const double* pVal = static_cast<const double*>(colTab->GetColumnPointer(colValCol));
+    start = BenchClock::now();
+    for (long long l=0; l < numLookups; ++l)
+    {
+        checksum += pVal[rows[l] - minPK];
+    }
+    const double ptrSecs = SecondsSince(start);
+
+    std::cout << "random lookups (double + string), SQLite:   "
+              << numSqlLookups / sqlSecs << " lookups/s" << std::endl;
+    std::cout << "random lookups (double + string), columnar: "
+              << numLookups / colSecs << " lookups/s" << std::endl;
+    std::cout << "random lookups (double), column pointer:    "
+              << numLookups / ptrSecs << " lookups/s" << std::endl;
+
+    // ------------------------------------------- check
+    int nerr = 0;
+    for (long long l=0; l < numSqlLookups; ++l)
+    {
+        if (    sqlVals[l] != colTab->GetDblValue(colValCol, rows[l])
+            ||  sqlStrs[l] != colTab->GetStrValue(colLuCol, rows[l])
+           )
+        {
+            ++nerr;
+        }
+    }
+
+    // keep the lookups from being optimised away
+    if (checksum < 0 || nstr < 0)
+    {
+        std::cout << checksum << nstr << std::endl;
+    }
+
+    sqlTab->CloseTable();
+    colTab->CloseTable();
+    std::remove(ldbFile.c_str());
+    std::remove(ctabFile.c_str());
+
+    if (nerr > 0)
+    {
+        std::cout << nerr << " values differ between the backends - FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
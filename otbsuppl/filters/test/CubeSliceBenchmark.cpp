@@ -0,0 +1,245 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  CubeSliceBenchmark
+ *
+ *  usage: CubeSliceBenchmark [image size (pixel)] [number of slices]
+ *
+ *  Iterates over the time slices of a float cube (default: 512 x 512
+ *  x 365), as a daily climate model does, with
+ *  - a pixel by pixel copy using region iterators (what the filters
+ *    did before they copied whole scanlines),
+ *  - CubeSliceToImage2DFilter (scanline copy), and
+ *  - CubeSliceToImage2DFilter sharing the input buffer,
+ *  and writes a 2D image into each time slice of a cube with the same
+ *  three variants of Image2DToCubeSliceFilter.
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "otbCubeSliceToImage2DFilter.h"
+#include "otbImage2DToCubeSliceFilter.h"
+
+typedef itk::Image<float, 3>    CubeType;
+typedef itk::Image<float, 2>    ImageType;
+
+typedef otb::CubeSliceToImage2DFilter<CubeType, ImageType> SliceFilterType;
+typedef otb::Image2DToCubeSliceFilter<ImageType, CubeType> CubeFilterType;
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+template <class TImage>
+typename TImage::Pointer CreateImage(const typename TImage::SizeType& size)
+{
+    typename TImage::IndexType idx;
+    idx.Fill(0);
+
+    typename TImage::Pointer img = TImage::New();
+    img->SetRegions(typename TImage::RegionType(idx, size));
+    img->Allocate();
+
+    float v = 0;
+    itk::ImageRegionIterator<TImage> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it, v += 0.5f)
+    {
+        it.Set(v);
+    }
+
+    return img;
+}
+
+/*! copies inRegion of in into outRegion of out pixel by pixel */
+template <class TInputImage, class TOutputImage>
+void IteratorCopy(const TInputImage* in, const typename TInputImage::RegionType& inRegion,
+                  TOutputImage* out, const typename TOutputImage::RegionType& outRegion)
+{
+    itk::ImageRegionConstIterator<TInputImage> inIt(in, inRegion);
+    itk::ImageRegionIterator<TOutputImage> outIt(out, outRegion);
+    for (; !inIt.IsAtEnd(); ++inIt, ++outIt)
+    {
+        outIt.Set(inIt.Get());
+    }
+}
+
+/*! sums the first pixel of each slice, so the work can't be optimised away */
+double g_Checksum = 0;
+
+double SliceIterator(CubeType* cube, long long size, long long numSlices)
+{
+    ImageType::SizeType isize;
+    isize.Fill(size);
+    ImageType::Pointer img = CreateImage<ImageType>(isize);
+
+    const BenchClock::time_point start = BenchClock::now();
+    for (long long t=0; t < numSlices; ++t)
+    {
+        CubeType::RegionType inRegion = cube->GetBufferedRegion();
+        inRegion.SetIndex(2, t);
+        inRegion.SetSize(2, 1);
+        IteratorCopy<CubeType, ImageType>(cube, inRegion, img, img->GetBufferedRegion());
+        g_Checksum += img->GetBufferPointer()[0];
+    }
+    return SecondsSince(start);
+}
+
+double SliceFilter(CubeType* cube, long long size, long long numSlices, bool bShare)
+{
+    std::vector<int> mapping = {1, 2};
+    std::vector<double> origin(3, 0.0);
+    std::vector<long long> isize = {size, size, 1};
+    std::vector<long long> index(3, 0);
+
+    SliceFilterType::Pointer filter = SliceFilterType::New();
+    filter->SetInput(cube);
+    filter->SetDimMapping(mapping);
+    filter->SetInputOrigin(origin);
+    filter->SetInputSize(isize);
+    filter->SetShareInputBuffer(bShare);
+
+    const BenchClock::time_point start = BenchClock::now();
+    for (long long t=0; t < numSlices; ++t)
+    {
+        index[2] = t;
+        filter->SetInputIndex(index);
+        filter->Modified();
+        filter->Update();
+        g_Checksum += filter->GetOutput()->GetBufferPointer()[0];
+    }
+    return SecondsSince(start);
+}
+
+double CubeIterator(ImageType* img, long long size, long long numSlices)
+{
+    CubeType::SizeType csize;
+    csize[0] = size;
+    csize[1] = size;
+    csize[2] = 1;
+
+    CubeType::Pointer slice = CreateImage<CubeType>(csize);
+
+    const BenchClock::time_point start = BenchClock::now();
+    for (long long t=0; t < numSlices; ++t)
+    {
+        IteratorCopy<ImageType, CubeType>(img, img->GetBufferedRegion(),
+                                          slice, slice->GetBufferedRegion());
+        g_Checksum += slice->GetBufferPointer()[0];
+    }
+    return SecondsSince(start);
+}
+
+double CubeFilter(ImageType* img, long long size, long long numSlices, bool bShare)
+{
+    std::vector<int> mapping = {1, 2};
+    std::vector<double> origin(3, 0.0);
+    std::vector<double> spacing(3, 1.0);
+    std::vector<long long> csize = {size, size, 1};
+    std::vector<long long> index(3, 0);
+
+    CubeFilterType::Pointer filter = CubeFilterType::New();
+    filter->SetInput(img);
+    filter->SetDimMapping(mapping);
+    filter->SetOutputOrigin(origin);
+    filter->SetOutputSpacing(spacing);
+    filter->SetOutputSize(csize);
+    filter->SetShareInputBuffer(bShare);
+
+    const BenchClock::time_point start = BenchClock::now();
+    for (long long t=0; t < numSlices; ++t)
+    {
+        index[2] = t;
+        filter->SetOutputIndex(index);
+        filter->Modified();
+        filter->Update();
+        g_Checksum += filter->GetOutput()->GetBufferPointer()[0];
+    }
+    return SecondsSince(start);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const long long size = argc > 1 ? std::atoll(argv[1]) : 512;
+    const long long numSlices = argc > 2 ? std::atoll(argv[2]) : 365;
+
+    std::cout << "CubeSlice benchmark: " << size << " x " << size << " x "
+              << numSlices << " float cube" << std::endl;
+
+    CubeType::SizeType csize;
+    csize[0] = size;
+    csize[1] = size;
+    csize[2] = numSlices;
+    CubeType::Pointer cube = CreateImage<CubeType>(csize);
+
+    ImageType::SizeType isize;
+    isize.Fill(size);
+    ImageType::Pointer img = CreateImage<ImageType>(isize);
+
+    const double mpix = size * size * numSlices / 1e6;
+    try
+    {
+        double secs = SliceIterator(cube, size, numSlices);
+        std::cout << "cube -> 2D, iterators:     " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+        secs = SliceFilter(cube, size, numSlices, false);
+        std::cout << "cube -> 2D, scanline copy: " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+        secs = SliceFilter(cube, size, numSlices, true);
+        std::cout << "cube -> 2D, shared buffer: " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+
+        secs = CubeIterator(img, size, numSlices);
+        std::cout << "2D -> cube, iterators:     " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+        secs = CubeFilter(img, size, numSlices, false);
+        std::cout << "2D -> cube, scanline copy: " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+        secs = CubeFilter(img, size, numSlices, true);
+        std::cout << "2D -> cube, shared buffer: " << secs << " s, "
+                  << mpix / secs << " Mpix/s" << std::endl;
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << eo.GetDescription() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // keep the copies from being optimised away
+    if (g_Checksum < 0)
+    {
+        std::cout << g_Checksum << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
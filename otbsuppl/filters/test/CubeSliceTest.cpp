@@ -0,0 +1,346 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  CubeSliceTest
+ *
+ *  Checks CubeSliceToImage2DFilter and Image2DToCubeSliceFilter against
+ *  a reference copying pixel by pixel with region iterators (i.e. what
+ *  the filters do when they can't copy whole scanlines) for
+ *  - dimension mappings taking the scanline copy path and mappings
+ *    taking the iterator path,
+ *  - identical and different (casting) pixel types,
+ *  - unstreamed and streamed updates, and
+ *  - with and without sharing the input buffer (ShareInputBuffer).
+ *  Outputs have to be identical to the reference.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+
+#include "otbCubeSliceToImage2DFilter.h"
+#include "otbImage2DToCubeSliceFilter.h"
+
+typedef itk::Image<float, 3>    CubeType;
+typedef itk::Image<float, 2>    ImageType;
+typedef itk::Image<double, 3>   DblCubeType;
+typedef itk::Image<double, 2>   DblImageType;
+
+namespace
+{
+
+const long long CubeSize[] = {23, 17, 9};
+
+CubeType::Pointer CreateCube(void)
+{
+    CubeType::IndexType idx;
+    idx.Fill(0);
+    CubeType::SizeType size;
+    for (int d=0; d < 3; ++d)
+    {
+        size[d] = CubeSize[d];
+    }
+
+    CubeType::Pointer cube = CubeType::New();
+    cube->SetRegions(CubeType::RegionType(idx, size));
+    cube->Allocate();
+
+    itk::ImageRegionIterator<CubeType> it(cube, cube->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const CubeType::IndexType& i = it.GetIndex();
+        it.Set(i[0] + 100.0f * i[1] + 10000.0f * i[2] + 0.25f);
+    }
+
+    return cube;
+}
+
+ImageType::Pointer CreateImage(void)
+{
+    ImageType::IndexType idx;
+    idx.Fill(0);
+    ImageType::SizeType size;
+    size[0] = CubeSize[0];
+    size[1] = CubeSize[1];
+
+    ImageType::Pointer img = ImageType::New();
+    img->SetRegions(ImageType::RegionType(idx, size));
+    img->Allocate();
+
+    itk::ImageRegionIterator<ImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const ImageType::IndexType& i = it.GetIndex();
+        it.Set(i[0] - 100.0f * i[1] + 0.5f);
+    }
+
+    return img;
+}
+
+/*! copies inRegion of in into outRegion of out pixel by pixel */
+template <class TInputImage, class TOutputImage>
+void ReferenceCopy(const TInputImage* in, const typename TInputImage::RegionType& inRegion,
+                   TOutputImage* out, const typename TOutputImage::RegionType& outRegion)
+{
+    itk::ImageRegionConstIterator<TInputImage> inIt(in, inRegion);
+    itk::ImageRegionIterator<TOutputImage> outIt(out, outRegion);
+    for (; !inIt.IsAtEnd(); ++inIt, ++outIt)
+    {
+        outIt.Set(static_cast<typename TOutputImage::PixelType>(inIt.Get()));
+    }
+}
+
+template <class TImage>
+int CompareImages(const TImage* ref, const TImage* test, const std::string& label)
+{
+    if (ref->GetBufferedRegion() != test->GetBufferedRegion())
+    {
+        std::cout << label << ": region mismatch - FAILED!" << std::endl;
+        return 1;
+    }
+
+    itk::ImageRegionConstIterator<TImage> refIt(ref, ref->GetBufferedRegion());
+    itk::ImageRegionConstIterator<TImage> testIt(test, test->GetBufferedRegion());
+    int nerr = 0;
+    for (; !refIt.IsAtEnd(); ++refIt, ++testIt)
+    {
+        if (refIt.Get() != testIt.Get())
+        {
+            if (nerr < 5)
+            {
+                std::cout << label << ": pixel " << refIt.GetIndex() << " ref="
+                          << refIt.Get() << " test=" << testIt.Get() << std::endl;
+            }
+            ++nerr;
+        }
+    }
+
+    if (nerr > 0)
+    {
+        std::cout << label << ": " << nerr << " pixel differ - FAILED!" << std::endl;
+        return 1;
+    }
+
+    std::cout << label << ": passed" << std::endl;
+    return 0;
+}
+
+/*! slices the cube along the input dimension not in dimMapping
+ *  (1-based input dimension of each output dimension) at sliceIdx */
+template <class TOutputImage>
+int TestCubeSlice(CubeType* cube, const std::vector<int>& dimMapping, long long sliceIdx)
+{
+    typedef otb::CubeSliceToImage2DFilter<CubeType, TOutputImage> FilterType;
+    typedef itk::StreamingImageFilter<TOutputImage, TOutputImage> StreamerType;
+
+    int collapsed = 3 - (dimMapping[0] - 1) - (dimMapping[1] - 1);
+
+    std::vector<int> mapping = dimMapping;
+    std::vector<double> origin(3, 0.0);
+    std::vector<long long> size(CubeSize, CubeSize + 3);
+    std::vector<long long> index(3, 0);
+    index[collapsed] = sliceIdx;
+    size[collapsed] = 1;
+
+    // reference
+    typename CubeType::RegionType inRegion;
+    typename TOutputImage::RegionType outRegion;
+    for (int d=0; d < 3; ++d)
+    {
+        inRegion.SetIndex(d, index[d]);
+        inRegion.SetSize(d, size[d]);
+    }
+    for (int d=0; d < 2; ++d)
+    {
+        outRegion.SetIndex(d, index[dimMapping[d]-1]);
+        outRegion.SetSize(d, size[dimMapping[d]-1]);
+    }
+    typename TOutputImage::Pointer ref = TOutputImage::New();
+    ref->SetRegions(outRegion);
+    ref->Allocate();
+    ReferenceCopy<CubeType, TOutputImage>(cube, inRegion, ref, outRegion);
+
+    std::stringstream name;
+    name << "CubeSliceToImage2DFilter mapping=" << dimMapping[0] << "," << dimMapping[1]
+         << (sizeof(typename TOutputImage::PixelType) == sizeof(float) ? " float" : " double");
+
+    int nfailed = 0;
+    for (int share=0; share < 2; ++share)
+    {
+        for (int divisions=1; divisions <= 3; divisions += 2)
+        {
+            std::stringstream label;
+            label << name.str() << " share=" << share << " divisions=" << divisions;
+
+            typename FilterType::Pointer filter = FilterType::New();
+            filter->SetInput(cube);
+            filter->SetDimMapping(mapping);
+            filter->SetInputOrigin(origin);
+            filter->SetInputSize(size);
+            filter->SetInputIndex(index);
+            filter->SetShareInputBuffer(share == 1);
+
+            typename StreamerType::Pointer streamer = StreamerType::New();
+            streamer->SetInput(filter->GetOutput());
+            streamer->SetNumberOfStreamDivisions(divisions);
+
+            try
+            {
+                streamer->Update();
+                nfailed += CompareImages<TOutputImage>(ref, streamer->GetOutput(), label.str());
+            }
+            catch (itk::ExceptionObject& eo)
+            {
+                std::cout << label.str() << ": " << eo.GetDescription() << " - FAILED!" << std::endl;
+                ++nfailed;
+            }
+        }
+    }
+
+    return nfailed;
+}
+
+/*! writes the image into a slice of a cube, whose dimension
+ *  dimMapping[d] (1-based) corresponds to image dimension d */
+template <class TOutputImage>
+int TestImageToCube(ImageType* img, const std::vector<int>& dimMapping, long long sliceIdx)
+{
+    typedef otb::Image2DToCubeSliceFilter<ImageType, TOutputImage> FilterType;
+    typedef itk::StreamingImageFilter<TOutputImage, TOutputImage> StreamerType;
+
+    const int sliceDim = 3 - (dimMapping[0] - 1) - (dimMapping[1] - 1);
+
+    std::vector<int> mapping = dimMapping;
+    std::vector<double> origin(3, 0.0);
+    std::vector<double> spacing(3, 1.0);
+    std::vector<long long> size(3, 1);
+    std::vector<long long> index(3, 0);
+    for (int d=0; d < 2; ++d)
+    {
+        size[dimMapping[d]-1] = img->GetBufferedRegion().GetSize(d);
+    }
+    index[sliceDim] = sliceIdx;
+
+    typename TOutputImage::RegionType outRegion;
+    for (int d=0; d < 3; ++d)
+    {
+        outRegion.SetIndex(d, index[d]);
+        outRegion.SetSize(d, size[d]);
+    }
+    typename ImageType::RegionType inRegion;
+    for (int d=0; d < 2; ++d)
+    {
+        inRegion.SetIndex(d, index[dimMapping[d]-1]);
+        inRegion.SetSize(d, size[dimMapping[d]-1]);
+    }
+    typename TOutputImage::Pointer ref = TOutputImage::New();
+    ref->SetRegions(outRegion);
+    ref->Allocate();
+    ReferenceCopy<ImageType, TOutputImage>(img, inRegion, ref, outRegion);
+
+    std::stringstream name;
+    name << "Image2DToCubeSliceFilter mapping=" << dimMapping[0] << "," << dimMapping[1]
+         << (sizeof(typename TOutputImage::PixelType) == sizeof(float) ? " float" : " double");
+
+    int nfailed = 0;
+    for (int share=0; share < 2; ++share)
+    {
+        for (int divisions=1; divisions <= 3; divisions += 2)
+        {
+            std::stringstream label;
+            label << name.str() << " share=" << share << " divisions=" << divisions;
+
+            typename FilterType::Pointer filter = FilterType::New();
+            filter->SetInput(img);
+            filter->SetDimMapping(mapping);
+            filter->SetOutputOrigin(origin);
+            filter->SetOutputSpacing(spacing);
+            filter->SetOutputSize(size);
+            filter->SetOutputIndex(index);
+            filter->SetShareInputBuffer(share == 1);
+
+            typename StreamerType::Pointer streamer = StreamerType::New();
+            streamer->SetInput(filter->GetOutput());
+            streamer->SetNumberOfStreamDivisions(divisions);
+
+            try
+            {
+                streamer->Update();
+                nfailed += CompareImages<TOutputImage>(ref, streamer->GetOutput(), label.str());
+            }
+            catch (itk::ExceptionObject& eo)
+            {
+                std::cout << label.str() << ": " << eo.GetDescription() << " - FAILED!" << std::endl;
+                ++nfailed;
+            }
+        }
+    }
+
+    return nfailed;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    CubeType::Pointer cube = CreateCube();
+    ImageType::Pointer img = CreateImage();
+
+    // {1,2}: collapse z (scanline copy, contiguous slice)
+    // {1,3}: collapse y (scanline copy)
+    // {2,3}: collapse x (iterators)
+    // {2,1}: collapse z, swap x and y (iterators)
+    const int cubeMappings[][2] = {{1, 2}, {1, 3}, {2, 3}, {2, 1}};
+    const long long sliceIdx[] = {4, 5, 11, 0};
+
+    int nfailed = 0;
+    for (int m=0; m < 4; ++m)
+    {
+        std::vector<int> mapping(cubeMappings[m], cubeMappings[m] + 2);
+        nfailed += TestCubeSlice<ImageType>(cube, mapping, sliceIdx[m]);
+        nfailed += TestCubeSlice<DblImageType>(cube, mapping, sliceIdx[m]);
+    }
+
+    // {1,2}: z slice (scanline copy, contiguous slice)
+    // {1,3}: y slice (scanline copy)
+    // {2,1}: z slice, swap x and y (iterators)
+    const int imgMappings[][2] = {{1, 2}, {1, 3}, {2, 1}};
+    for (int m=0; m < 3; ++m)
+    {
+        std::vector<int> mapping(imgMappings[m], imgMappings[m] + 2);
+        nfailed += TestImageToCube<CubeType>(img, mapping, 3);
+        nfailed += TestImageToCube<DblCubeType>(img, mapping, 3);
+    }
+
+    if (nfailed > 0)
+    {
+        std::cout << nfailed << " test(s) FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
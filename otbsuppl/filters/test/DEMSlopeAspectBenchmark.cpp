@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  DEMSlopeAspectBenchmark
+ *
+ *  usage: DEMSlopeAspectBenchmark [image size (pixel)]
+ *
+ *  Computes Slope, Aspect, LS, Wetness and SedTransport from a float
+ *  DEM (default: 2048 x 2048), for the Horn and the Zevenbergen
+ *  algorithm, with
+ *  - the neighbourhood iterator implementation DEMSlopeAspectFilter
+ *    used before (s. DEMSlopeAspectReference.h), one pass per attribute,
+ *  - DEMSlopeAspectFilter, one run per attribute, and
+ *  - DEMSlopeAspectFilter, all attributes in one (fused) run.
+ *  The filter runs single threaded, as does the reference.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+
+#include "otbDEMSlopeAspectFilter.h"
+#include "DEMSlopeAspectReference.h"
+
+typedef float                               PixelType;
+typedef itk::Image<PixelType, 2>            ImageType;
+
+typedef otb::DEMSlopeAspectFilter<ImageType, ImageType>  SlopeFilterType;
+typedef DEMSlopeAspectReference<ImageType>               ReferenceType;
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+const char* Attributes[] = {"Slope", "Aspect", "LS", "Wetness", "SedTransport"};
+const int NumAttributes = sizeof(Attributes) / sizeof(Attributes[0]);
+
+ImageType::Pointer CreateImage(long size, bool bDem)
+{
+    ImageType::IndexType idx;
+    idx.Fill(0);
+    ImageType::SizeType isize;
+    isize.Fill(size);
+
+    ImageType::SpacingType spacing;
+    spacing.Fill(10);
+
+    ImageType::Pointer img = ImageType::New();
+    img->SetRegions(ImageType::RegionType(idx, isize));
+    img->SetSpacing(spacing);
+    img->Allocate();
+
+    itk::ImageRegionIterator<ImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const ImageType::IndexType& i = it.GetIndex();
+        it.Set(bDem ? static_cast<PixelType>(100.0 + 3.0 * std::sin(i[0] * 0.3)
+                                             + 2.0 * std::cos(i[1] * 0.2) + 0.001 * i[0] * i[1])
+                    : static_cast<PixelType>(1 + (i[0] * 3 + i[1] * 5) % 50));
+    }
+
+    return img;
+}
+
+double RunReference(ImageType* dem, ImageType* flowacc, bool bHorn)
+{
+    ImageType::Pointer out = ImageType::New();
+    out->CopyInformation(dem);
+    out->SetRegions(dem->GetLargestPossibleRegion());
+    out->Allocate();
+
+    const BenchClock::time_point start = BenchClock::now();
+    for (int a=0; a < NumAttributes; ++a)
+    {
+        // the old filter computed aspect as slope unit
+        const std::string attr = Attributes[a];
+        ReferenceType ref(bHorn, attr == "Aspect" ? "Aspect" : "Degree", -9999);
+        ref.Run(dem, flowacc, attr == "Aspect" ? "Slope" : attr, out);
+    }
+    return SecondsSince(start);
+}
+
+double RunFilter(ImageType* dem, ImageType* flowacc, bool bHorn, bool bFused)
+{
+    std::vector<std::string> names;
+    names.push_back("dem");
+    names.push_back("flowacc");
+
+    const BenchClock::time_point start = BenchClock::now();
+    const int numRuns = bFused ? 1 : NumAttributes;
+    for (int r=0; r < numRuns; ++r)
+    {
+        SlopeFilterType::Pointer filter = SlopeFilterType::New();
+        filter->SetNumberOfThreads(1);
+        filter->SetInputNames(names);
+        filter->SetNthInput(0, dem);
+        filter->SetNthInput(1, flowacc);
+        filter->SetTerrainAlgorithm(bHorn ? "Horn" : "Zevenbergen");
+        filter->SetNodata(-9999);
+        if (bFused)
+        {
+            filter->SetTerrainAttributes(
+                        std::vector<std::string>(Attributes, Attributes + NumAttributes));
+        }
+        else
+        {
+            filter->SetTerrainAttribute(Attributes[r]);
+        }
+        filter->Update();
+    }
+    return SecondsSince(start);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const long size = argc > 1 ? std::atol(argv[1]) : 2048;
+
+    std::cout << "DEMSlopeAspect benchmark: " << size << " x " << size
+              << " float DEM, " << NumAttributes << " attributes" << std::endl;
+
+    ImageType::Pointer dem = CreateImage(size, true);
+    ImageType::Pointer flowacc = CreateImage(size, false);
+
+    // pixel throughput, i.e. DEM pixels x attributes per second
+    const double mpix = size * static_cast<double>(size) * NumAttributes / 1e6;
+    try
+    {
+        for (int h=0; h < 2; ++h)
+        {
+            const bool bHorn = h == 0;
+            const std::string algo = bHorn ? "Horn:        " : "Zevenbergen: ";
+
+            double secs = RunReference(dem, flowacc, bHorn);
+            std::cout << algo << "neighbourhood iterator: " << secs << " s, "
+                      << mpix / secs << " Mpix/s" << std::endl;
+            secs = RunFilter(dem, flowacc, bHorn, false);
+            std::cout << algo << "row buffer, per attr.:  " << secs << " s, "
+                      << mpix / secs << " Mpix/s" << std::endl;
+            secs = RunFilter(dem, flowacc, bHorn, true);
+            std::cout << algo << "row buffer, fused:      " << secs << " s, "
+                      << mpix / secs << " Mpix/s" << std::endl;
+        }
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << eo.GetDescription() << " - FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,274 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+/*
+ * DEMSlopeAspectReference.h
+ *
+ *  Created on: 2026-10-19
+ *      Author: Alexander Herzig
+ */
+
+#ifndef __DEMSlopeAspectReference_h
+#define __DEMSlopeAspectReference_h
+
+#include <string>
+#include <cmath>
+
+#include "itkImage.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "vnl/vnl_math.h"
+
+/*! \brief DEMSlopeAspectFilter as it was before the fused row buffer
+ *         kernel, i.e. one attribute per pass, using a neighbourhood
+ *         iterator and switching the gradient algorithm per pixel
+ *
+ *  Used by DEMSlopeAspectTest and DEMSlopeAspectBenchmark as reference
+ *  for the single attribute results (Slope, LS, Wetness, SedTransport)
+ *  of the filter.
+ */
+template <class TImage>
+class DEMSlopeAspectReference
+{
+public:
+    typedef typename TImage::PixelType  PixelType;
+    typedef itk::ConstNeighborhoodIterator<TImage> KernelIterType;
+    typedef typename KernelIterType::NeighborhoodType NeighborhoodType;
+
+    DEMSlopeAspectReference(bool bHorn, const std::string& unit, double nodata)
+        : m_bHorn(bHorn), m_Unit(unit),
+          m_Nodata(static_cast<PixelType>(nodata)),
+          m_xdist(1), m_ydist(1)
+    {}
+
+    /*! computes attribute (Slope, LS, Wetness or SedTransport)
+     *  for the largest possible region of dem into out */
+    void Run(const TImage* dem, const TImage* flowacc,
+             const std::string& attribute, TImage* out)
+    {
+        m_xdist = dem->GetSpacing()[0];
+        m_ydist = dem->GetSpacing()[1];
+
+        const typename TImage::RegionType region = dem->GetLargestPossibleRegion();
+        typename TImage::SizeType radius;
+        radius.Fill(1);
+
+        itk::ZeroFluxNeumannBoundaryCondition<TImage> bndCond;
+        KernelIterType inIter(radius, dem, region);
+        inIter.OverrideBoundaryCondition(&bndCond);
+        itk::ImageRegionIterator<TImage> outIter(out, region);
+        itk::ImageRegionConstIterator<TImage> faIter;
+        if (flowacc != nullptr)
+        {
+            faIter = itk::ImageRegionConstIterator<TImage>(flowacc, region);
+            faIter.GoToBegin();
+        }
+
+        for (inIter.GoToBegin(), outIter.GoToBegin(); !inIter.IsAtEnd(); ++inIter, ++outIter)
+        {
+            double val;
+            NeighborhoodType nh = inIter.GetNeighborhood();
+            const PixelType fa = flowacc != nullptr ? faIter.Get() : 0;
+            if (attribute.compare("LS") == 0)
+            {
+                this->LS(nh, fa, &val);
+                val = std::isnan(val) ? m_Nodata : val;
+            }
+            else if (attribute.compare("Wetness") == 0)
+            {
+                this->Wetness(nh, fa, &val);
+                val = std::isnan(val) ? m_Nodata : val;
+            }
+            else if (attribute.compare("SedTransport") == 0)
+            {
+                this->SedTrans(nh, fa, &val);
+                val = std::isnan(val) ? m_Nodata : val;
+            }
+            else
+            {
+                this->Slope(nh, &val);
+                val = std::isnan(val) ? 0 : val;
+            }
+            outIter.Set(val);
+
+            if (flowacc != nullptr)
+            {
+                ++faIter;
+            }
+        }
+    }
+
+protected:
+    void dZdX(const NeighborhoodType& nh, double* val)
+    {
+        if (m_bHorn)
+            *val = ((nh[2] + 2*nh[5] + nh[8]) - (nh[0] + 2*nh[3] + nh[6])) / (8*m_xdist);
+        else
+            *val = (-nh[3] + nh[5]) / (2*m_xdist);
+    }
+
+    void dZdY(const NeighborhoodType& nh, double* val)
+    {
+        if (m_bHorn)
+            *val = ((nh[8] + 2*nh[7] + nh[6]) - (nh[2] + 2*nh[1] + nh[0])) / (8*m_ydist);
+        else
+            *val = (nh[1] - nh[7]) / (2*m_ydist);
+    }
+
+    void Slope(const NeighborhoodType& nh, double* val)
+    {
+        double zx, zy;
+        dZdX(nh, &zx);
+        dZdY(nh, &zy);
+
+        if (m_Unit.compare("Aspect") == 0)
+        {
+            if (m_bHorn)
+                *val = atan2(zy,zx) - vnl_math::pi / 2.0;
+            else
+                *val = atan2(zx,zy) - vnl_math::pi;
+
+            *val *= 180 / vnl_math::pi;
+            if (*val < 0)
+                *val += 360;
+        }
+        else if (m_Unit.compare("Dim.less") == 0)
+        {
+            *val = sqrt(zx * zx + zy * zy);
+        }
+        else if (m_Unit.compare("Percent") == 0)
+        {
+            *val = sqrt(zx * zx + zy * zy) * 100;
+        }
+        else
+        {
+            *val = atan(sqrt(zx * zx + zy * zy)) * 180 / vnl_math::pi;
+        }
+    }
+
+    void Wetness(const NeighborhoodType& nDem, const PixelType& flowacc, double* val)
+    {
+        const double cellarea = m_xdist * m_ydist;
+        const double flaccx = static_cast<double>(flowacc * cellarea);
+        const double bigD = sqrt(cellarea/Pi) * 2;
+
+        double dzNdx, dzNdy;
+        dZdX(nDem, &dzNdx);
+        dZdY(nDem, &dzNdy);
+
+        const double tanbeta = sqrt(dzNdx*dzNdx + dzNdy*dzNdy);
+        if (tanbeta != 0)
+            *val = log((flaccx/bigD) / tanbeta);
+        else
+            *val = m_Nodata;
+    }
+
+    void SedTrans(const NeighborhoodType& nDem, const PixelType& flowacc, double* val)
+    {
+        const double cellarea = m_xdist * m_ydist;
+        const double flaccx = static_cast<double>(flowacc * cellarea);
+
+        double dzNdx, dzNdy;
+        dZdX(nDem, &dzNdx);
+        dZdY(nDem, &dzNdy);
+
+        const double sinbeta = sin(atan(sqrt(dzNdx*dzNdx + dzNdy*dzNdy)));
+        *val = pow((flaccx/22.13), 0.6) * pow((sinbeta/0.0896), 1.3);
+    }
+
+    void LS(const NeighborhoodType& nDem, const PixelType& flowacc, double* val)
+    {
+        const double cellarea = m_xdist * m_ydist;
+        const double flaccx = static_cast<double>(flowacc * cellarea);
+        const double bigD = sqrt(cellarea/Pi) * 2;
+
+        double rise_run, sx, ax, xij, sij, lij, m, beta;
+        double dzNdx, dzNdy;
+        double sinsx, sinax, cosax;
+
+        *val = m_Nodata;
+
+        this->dZdY(nDem, &dzNdy);
+        this->dZdX(nDem, &dzNdx);
+
+        rise_run = pow(((dzNdx*dzNdx) + (dzNdy*dzNdy)), 0.5);
+        sx = atan(rise_run) * RtoD;
+
+        if (m_bHorn)
+            ax = (atan2(dzNdy,dzNdx)-1.5707963) * RtoD;
+        else
+            ax = (atan2(dzNdx,dzNdy)-3.1415927) * RtoD;
+
+        if (ax < 0)
+            ax +=360;
+
+        bool equalelev = true;
+        for (int b=0; b < 7; ++b)
+        {
+            if (nDem[b] != nDem[b+1])
+            {
+                equalelev = false;
+                break;
+            }
+        }
+
+        sinsx = sin(sx * DegToRad);
+        sinax = sin(ax * DegToRad);
+        cosax = cos(ax * DegToRad);
+        if (sinsx < 0) sinsx *= -1;
+        if (sinax < 0) sinax *= -1;
+        if (cosax < 0) cosax *= -1;
+
+        xij = sinax + cosax;
+
+        beta = ( (sinsx / 0.0896) / ((3 * pow(sinsx, 0.8)) + 0.56) );
+        m = beta / (1 + beta);
+
+        if ((rise_run*100) < 9)
+            sij = (10.8 * sinsx) + 0.03;
+        else
+            sij = (16.8 * sinsx) - 0.5;
+
+        if (flaccx != m_Nodata)
+        {
+            if (equalelev)
+            {
+                lij = 1;
+            }
+            else
+            {
+                lij = ( (pow(flaccx,(m+1)) - pow(flaccx-cellarea,(m+1)) ) /
+                        (pow(bigD,(m+2)) * pow(xij,m) * pow(22.13, m)) );
+            }
+            *val = lij * sij;
+        }
+    }
+
+    static constexpr double RtoD = 57.29578;
+    static constexpr double DegToRad = 0.0174533;
+    static constexpr double Pi = 3.1415926535897932384626433832795;
+
+    bool m_bHorn;
+    std::string m_Unit;
+    double m_Nodata;
+    double m_xdist;
+    double m_ydist;
+};
+
+#endif // __DEMSlopeAspectReference_h
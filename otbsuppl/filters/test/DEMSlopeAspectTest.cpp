@@ -0,0 +1,276 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  DEMSlopeAspectTest
+ *
+ *  Compares the DEMSlopeAspectFilter's fused row buffer kernel with the
+ *  neighbourhood iterator implementation it replaced
+ *  (s. DEMSlopeAspectReference.h) for the Horn and the Zevenbergen
+ *  algorithm and checks that
+ *  - Slope (in each unit), LS, Wetness, and SedTransport agree, when
+ *    computed one attribute per run,
+ *  - the Aspect attribute agrees with Slope in unit 'Aspect', and
+ *  - the outputs of a single multi-attribute run agree with the
+ *    single attribute results.
+ *  The DEM contains a flat plateau, so the planar LS case and the
+ *  Wetness nodata case are covered as well.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "otbDEMSlopeAspectFilter.h"
+#include "DEMSlopeAspectReference.h"
+
+typedef float                               PixelType;
+typedef itk::Image<PixelType, 2>            ImageType;
+
+typedef otb::DEMSlopeAspectFilter<ImageType, ImageType>  SlopeFilterType;
+typedef DEMSlopeAspectReference<ImageType>               ReferenceType;
+
+namespace
+{
+
+const int NumCols = 61;
+const int NumRows = 47;
+const double Nodata = -9999;
+
+/*! a smooth but non-planar surface with a flat plateau; heights
+ *  are multiples of 1/16, so the gradients come out the same,
+ *  whether they are computed in float or in double precision */
+PixelType DemValue(long x, long y)
+{
+    if (x >= 40 && x < 50 && y >= 10 && y < 20)
+    {
+        return 120;
+    }
+
+    const double z = 100.0 + 3.0 * std::sin(x * 0.3) + 2.0 * std::cos(y * 0.2)
+                     + 0.05 * x * y;
+    return static_cast<PixelType>(std::floor(z * 16 + 0.5) / 16);
+}
+
+PixelType FlowAccValue(long x, long y)
+{
+    return static_cast<PixelType>(1 + (x * 3 + y * 5) % 50);
+}
+
+ImageType::Pointer CreateImage(bool bDem)
+{
+    ImageType::IndexType idx;
+    idx.Fill(0);
+    ImageType::SizeType size;
+    size[0] = NumCols;
+    size[1] = NumRows;
+
+    ImageType::SpacingType spacing;
+    spacing[0] = 10;
+    spacing[1] = 12.5;
+
+    ImageType::Pointer img = ImageType::New();
+    img->SetRegions(ImageType::RegionType(idx, size));
+    img->SetSpacing(spacing);
+    img->Allocate();
+
+    itk::ImageRegionIterator<ImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const ImageType::IndexType& i = it.GetIndex();
+        it.Set(bDem ? DemValue(i[0], i[1]) : FlowAccValue(i[0], i[1]));
+    }
+
+    return img;
+}
+
+ImageType::Pointer RunReference(ImageType* dem, ImageType* flowacc, bool bHorn,
+                                const std::string& attribute, const std::string& unit)
+{
+    ImageType::Pointer out = ImageType::New();
+    out->CopyInformation(dem);
+    out->SetRegions(dem->GetLargestPossibleRegion());
+    out->Allocate();
+
+    ReferenceType ref(bHorn, unit, Nodata);
+    ref.Run(dem, flowacc, attribute, out);
+
+    return out;
+}
+
+/*! runs the filter for the given attributes; a single attribute is
+ *  set as TerrainAttribute, several ones as TerrainAttributes */
+std::vector<ImageType::Pointer> RunFilter(ImageType* dem, ImageType* flowacc, bool bHorn,
+                                          const std::vector<std::string>& attributes,
+                                          const std::string& unit)
+{
+    std::vector<std::string> names;
+    names.push_back("dem");
+    names.push_back("flowacc");
+
+    SlopeFilterType::Pointer filter = SlopeFilterType::New();
+    filter->SetInputNames(names);
+    filter->SetNthInput(0, dem);
+    filter->SetNthInput(1, flowacc);
+    filter->SetTerrainAlgorithm(bHorn ? "Horn" : "Zevenbergen");
+    filter->SetAttributeUnit(unit);
+    filter->SetNodata(Nodata);
+    if (attributes.size() == 1)
+    {
+        filter->SetTerrainAttribute(attributes.at(0));
+    }
+    else
+    {
+        filter->SetTerrainAttributes(attributes);
+    }
+    filter->Update();
+
+    std::vector<ImageType::Pointer> outs;
+    for (size_t a=0; a < attributes.size(); ++a)
+    {
+        ImageType::Pointer out = filter->GetOutput(a);
+        out->DisconnectPipeline();
+        outs.push_back(out);
+    }
+    return outs;
+}
+
+/*! compares the filter with the reference output and reports the
+ *  first few mismatches; returns the number of pixels which differ
+ *  by more than a small relative tolerance */
+int CompareImages(const ImageType* ref, const ImageType* test, const std::string& label)
+{
+    itk::ImageRegionConstIterator<ImageType> rIt(ref, ref->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ImageType> tIt(test, test->GetLargestPossibleRegion());
+
+    int nerr = 0;
+    for (rIt.GoToBegin(), tIt.GoToBegin(); !rIt.IsAtEnd(); ++rIt, ++tIt)
+    {
+        const double r = rIt.Get();
+        const double t = tIt.Get();
+        if (std::fabs(r - t) > 1e-5 * std::max(1.0, std::fabs(r)))
+        {
+            if (nerr < 5)
+            {
+                std::cout << label << ": pixel " << rIt.GetIndex()
+                          << " reference=" << r << " fused=" << t << std::endl;
+            }
+            ++nerr;
+        }
+    }
+
+    return nerr;
+}
+
+int Report(int nerr, const std::string& label)
+{
+    if (nerr > 0)
+    {
+        std::cout << label << ": " << nerr << " pixel differ - FAILED!" << std::endl;
+        return 1;
+    }
+
+    std::cout << label << ": passed" << std::endl;
+    return 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const char* units[] = {"Degree", "Percent", "Dim.less", "Aspect"};
+    const char* fattrs[] = {"LS", "Wetness", "SedTransport"};
+
+    ImageType::Pointer dem = CreateImage(true);
+    ImageType::Pointer flowacc = CreateImage(false);
+
+    int nfailed = 0;
+    try
+    {
+        for (int h=0; h < 2; ++h)
+        {
+            const bool bHorn = h == 0;
+            const std::string algo = bHorn ? "Horn" : "Zevenbergen";
+
+            // single attribute runs
+            for (int u=0; u < 4; ++u)
+            {
+                const std::string label = algo + " Slope " + units[u];
+                ImageType::Pointer ref = RunReference(dem, flowacc, bHorn, "Slope", units[u]);
+                std::vector<ImageType::Pointer> out = RunFilter(
+                            dem, flowacc, bHorn, std::vector<std::string>(1, "Slope"), units[u]);
+                nfailed += Report(CompareImages(ref, out.at(0), label), label);
+            }
+
+            {
+                const std::string label = algo + " Aspect";
+                ImageType::Pointer ref = RunReference(dem, flowacc, bHorn, "Slope", "Aspect");
+                std::vector<ImageType::Pointer> out = RunFilter(
+                            dem, flowacc, bHorn, std::vector<std::string>(1, "Aspect"), "Degree");
+                nfailed += Report(CompareImages(ref, out.at(0), label), label);
+            }
+
+            std::vector<ImageType::Pointer> refs;
+            for (int a=0; a < 3; ++a)
+            {
+                const std::string label = algo + " " + fattrs[a];
+                refs.push_back(RunReference(dem, flowacc, bHorn, fattrs[a], "Degree"));
+                std::vector<ImageType::Pointer> out = RunFilter(
+                            dem, flowacc, bHorn, std::vector<std::string>(1, fattrs[a]), "Degree");
+                nfailed += Report(CompareImages(refs.back(), out.at(0), label), label);
+            }
+
+            // one multi-attribute run
+            std::vector<std::string> attrs;
+            attrs.push_back("Slope");
+            attrs.push_back("Aspect");
+            attrs.insert(attrs.end(), fattrs, fattrs + 3);
+            refs.insert(refs.begin(), RunReference(dem, flowacc, bHorn, "Slope", "Aspect"));
+            refs.insert(refs.begin(), RunReference(dem, flowacc, bHorn, "Slope", "Degree"));
+
+            std::vector<ImageType::Pointer> outs = RunFilter(dem, flowacc, bHorn, attrs, "Degree");
+            for (size_t a=0; a < attrs.size(); ++a)
+            {
+                const std::string label = algo + " fused " + attrs.at(a);
+                nfailed += Report(CompareImages(refs.at(a), outs.at(a), label), label);
+            }
+        }
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << eo.GetDescription() << " - FAILED!" << std::endl;
+        ++nfailed;
+    }
+
+    if (nfailed > 0)
+    {
+        std::cout << nfailed << " test(s) FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
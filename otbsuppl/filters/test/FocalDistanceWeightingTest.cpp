@@ -0,0 +1,227 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  FocalDistanceWeightingTest
+ *
+ *  Runs the FocalDistanceWeightingFilter with the direct method
+ *  (FFTMinRadius = 0) and with the FFT method (FFTMinRadius = 1) for
+ *  a range of radii and checks that
+ *  - integer outputs are identical, for integer weights (i.e. sums
+ *    the FFT may only approximate, e.g. 2.9999999 for 3) as well as
+ *    for fractional weights (incl. negative ones), and
+ *  - float outputs agree within a small relative tolerance.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+
+#include "otbFocalDistanceWeightingFilter.h"
+
+typedef float                               InputPixelType;
+typedef itk::Image<InputPixelType, 2>       InputImageType;
+typedef itk::Image<int, 2>                  IntImageType;
+typedef itk::Image<float, 2>                FloatImageType;
+
+typedef otb::FocalDistanceWeightingFilter<InputImageType, IntImageType>   IntFilterType;
+typedef otb::FocalDistanceWeightingFilter<InputImageType, FloatImageType> FloatFilterType;
+
+namespace
+{
+
+const int NumCols = 97;
+const int NumRows = 83;
+
+/*! class image with (pseudo random) values in [0, 4] */
+InputImageType::Pointer CreateImage(void)
+{
+    InputImageType::IndexType idx;
+    idx.Fill(0);
+    InputImageType::SizeType size;
+    size[0] = NumCols;
+    size[1] = NumRows;
+
+    InputImageType::Pointer img = InputImageType::New();
+    img->SetRegions(InputImageType::RegionType(idx, size));
+    img->Allocate();
+
+    unsigned int state = 12345;
+    itk::ImageRegionIterator<InputImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        state = state * 1103515245u + 12345u;
+        it.Set(static_cast<InputPixelType>((state >> 16) % 5));
+    }
+
+    return img;
+}
+
+/*! the weights matrix needs one column per distance class
+ *  of the circular kernel, s. FocalDistanceWeightingFilter;
+ *  fractional weights are multiples of 0.25 (i.e. exact in
+ *  float), so the exact sums have a well defined truncation
+ */
+IntFilterType::WeightMatrixType CreateWeights(unsigned int radius, size_t nvalues,
+                                              bool bIntegers)
+{
+    const int ncols = radius % 2 == 0 ? ((radius * radius) / 2.0) + 1.5
+                                      : ((radius * radius) / 2.0) + 0.5;
+    IntFilterType::WeightMatrixType weights(nvalues, ncols);
+    for (size_t r=0; r < nvalues; ++r)
+    {
+        for (int c=0; c < ncols; ++c)
+        {
+            const int w = static_cast<int>((r * 3 + c) % 7) - 2;
+            weights(r, c) = bIntegers ? w : w * 0.25f;
+        }
+    }
+    return weights;
+}
+
+template<class TFilter>
+typename TFilter::OutputImageType::Pointer
+RunFilter(InputImageType* img, unsigned int radius, unsigned int fftMinRadius,
+          const std::vector<InputPixelType>& values,
+          const typename TFilter::WeightMatrixType& weights)
+{
+    typename TFilter::Pointer filter = TFilter::New();
+    filter->SetInput(img);
+    filter->SetRadius(radius);
+    filter->SetFFTMinRadius(fftMinRadius);
+    filter->SetValues(values);
+    filter->SetWeights(weights);
+    filter->Update();
+
+    typename TFilter::OutputImageType::Pointer out = filter->GetOutput();
+    out->DisconnectPipeline();
+    return out;
+}
+
+/*! compares the direct with the FFT output and reports the first
+ *  few mismatches; returns the number of pixels which differ by
+ *  more than relTol (relative to the direct output)
+ */
+template<class TImage>
+int CompareImages(const TImage* direct, const TImage* fft, double relTol,
+                  const std::string& label)
+{
+    itk::ImageRegionConstIterator<TImage> dIt(direct, direct->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<TImage> fIt(fft, fft->GetLargestPossibleRegion());
+
+    int nerr = 0;
+    for (dIt.GoToBegin(), fIt.GoToBegin(); !dIt.IsAtEnd(); ++dIt, ++fIt)
+    {
+        const double d = dIt.Get();
+        const double f = fIt.Get();
+        if (std::fabs(d - f) > relTol * std::max(1.0, std::fabs(d)))
+        {
+            if (nerr < 5)
+            {
+                std::cout << label << ": pixel " << dIt.GetIndex()
+                          << " direct=" << d << " fft=" << f << std::endl;
+            }
+            ++nerr;
+        }
+    }
+
+    return nerr;
+}
+
+int Report(int nerr, const std::string& label)
+{
+    if (nerr > 0)
+    {
+        std::cout << label << ": " << nerr << " pixel differ - FAILED!" << std::endl;
+        return 1;
+    }
+
+    std::cout << label << ": passed" << std::endl;
+    return 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const unsigned int radii[] = {2, 5, 9, 17};
+    const unsigned int nradii = sizeof(radii) / sizeof(unsigned int);
+
+    InputImageType::Pointer img = CreateImage();
+
+    std::vector<InputPixelType> values;
+    values.push_back(1);
+    values.push_back(2);
+    values.push_back(4);
+
+    int nfailed = 0;
+    try
+    {
+        for (unsigned int r=0; r < nradii; ++r)
+        {
+            for (int w=0; w < 2; ++w)
+            {
+                const bool bIntegers = w == 0;
+                IntFilterType::WeightMatrixType weights =
+                        CreateWeights(radii[r], values.size(), bIntegers);
+
+                std::stringstream label;
+                label << "radius=" << radii[r]
+                      << (bIntegers ? " integer weights" : " fractional weights");
+
+                IntImageType::Pointer intDirect = RunFilter<IntFilterType>(
+                            img, radii[r], 0, values, weights);
+                IntImageType::Pointer intFFT = RunFilter<IntFilterType>(
+                            img, radii[r], 1, values, weights);
+                nfailed += Report(CompareImages<IntImageType>(intDirect, intFFT, 0,
+                                  label.str() + " int output"),
+                                  label.str() + " int output");
+
+                FloatImageType::Pointer fltDirect = RunFilter<FloatFilterType>(
+                            img, radii[r], 0, values, weights);
+                FloatImageType::Pointer fltFFT = RunFilter<FloatFilterType>(
+                            img, radii[r], 1, values, weights);
+                nfailed += Report(CompareImages<FloatImageType>(fltDirect, fltFFT, 1e-5,
+                                  label.str() + " float output"),
+                                  label.str() + " float output");
+            }
+        }
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << eo.GetDescription() << " - FAILED!" << std::endl;
+        ++nfailed;
+    }
+
+    if (nfailed > 0)
+    {
+        std::cout << nfailed << " test(s) FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
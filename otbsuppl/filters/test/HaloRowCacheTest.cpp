@@ -0,0 +1,437 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  HaloRowCacheTest
+ *
+ *  Runs each of the neighbourhood filters sharing the HaloRowCache once
+ *  unstreamed and then streamed with a range of stream divisions and
+ *  kernel radii and checks that
+ *  - the streamed output is bit-identical to the unstreamed one, and
+ *  - the streamed filter requests each input row only once per update,
+ *    i.e. the halo rows of later divisions are taken from the cache.
+ *  The streamed filters are fed by a source that only produces the
+ *  requested region (as a reader would), because the cache stands
+ *  aside when the input is buffered in full anyway. The same filter
+ *  object is re-used for all streamed runs, so that stale cache rows
+ *  from a previous update would show up as a mismatch.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "itkImage.h"
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkArray2D.h"
+
+#include "otbNeighbourhoodCountingFilter.h"
+#include "otbFocalDistanceWeightingFilter.h"
+#include "otbDEMSlopeAspectFilter.h"
+#include "otbNMScriptableKernelFilter2.h"
+
+typedef float                               PixelType;
+typedef itk::Image<PixelType, 2>            ImageType;
+typedef itk::StreamingImageFilter<ImageType, ImageType> StreamerType;
+
+typedef otb::NeighbourhoodCountingFilter<ImageType, ImageType>   CountingFilterType;
+typedef otb::FocalDistanceWeightingFilter<ImageType, ImageType>  WeightingFilterType;
+typedef otb::DEMSlopeAspectFilter<ImageType, ImageType>          SlopeFilterType;
+typedef otb::NMScriptableKernelFilter2<ImageType, ImageType>     KernelFilterType;
+
+namespace
+{
+
+// the number of rows is chosen such that, for all stream divisions
+// and radii tested, each stripe is taller than the kernel radius,
+// i.e. every division but the first one finds its top halo rows
+// in the cache
+const int NumCols = 37;
+const int NumRows = 64;
+
+/*! in class mode, pixel values are integers in [0, 4],
+ *  otherwise it is a smooth but non-planar surface
+ *  suitable for terrain analysis
+ */
+PixelType TestValue(long x, long y, bool bClasses)
+{
+    if (bClasses)
+    {
+        return static_cast<PixelType>((x * 7 + y * 13 + (x * y) % 5) % 5);
+    }
+
+    return static_cast<PixelType>(100.0 + 3.0 * std::sin(x * 0.3)
+                                  + 2.0 * std::cos(y * 0.2) + 0.05 * x * y);
+}
+
+ImageType::RegionType TestRegion(void)
+{
+    ImageType::IndexType idx;
+    idx.Fill(0);
+    ImageType::SizeType size;
+    size[0] = NumCols;
+    size[1] = NumRows;
+    return ImageType::RegionType(idx, size);
+}
+
+/*! creates the fully buffered test image fed to the reference filters */
+ImageType::Pointer CreateImage(bool bClasses)
+{
+    ImageType::Pointer img = ImageType::New();
+    img->SetRegions(TestRegion());
+    img->Allocate();
+
+    itk::ImageRegionIterator<ImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        it.Set(TestValue(it.GetIndex()[0], it.GetIndex()[1], bClasses));
+    }
+
+    return img;
+}
+
+/*! streaming source producing the test image for the requested
+ *  region only, and recording the regions it has been asked for
+ */
+class RecordingSource : public itk::ImageSource<ImageType>
+{
+public:
+    typedef RecordingSource                 Self;
+    typedef itk::ImageSource<ImageType>     Superclass;
+    typedef itk::SmartPointer<Self>         Pointer;
+    typedef itk::SmartPointer<const Self>   ConstPointer;
+
+    itkNewMacro(Self)
+    itkTypeMacro(RecordingSource, itk::ImageSource)
+
+    void SetClasses(bool bClasses)
+        {m_bClasses = bClasses; this->Modified();}
+
+    const std::vector<ImageType::RegionType>& GetRequestedRegions(void) const
+        {return m_vRequested;}
+    void ClearRequestedRegions(void)
+        {m_vRequested.clear();}
+
+protected:
+    RecordingSource() : m_bClasses(true) {}
+
+    virtual void GenerateOutputInformation() ITK_OVERRIDE
+    {
+        this->GetOutput()->SetLargestPossibleRegion(TestRegion());
+    }
+
+    virtual void GenerateData() ITK_OVERRIDE
+    {
+        ImageType* out = this->GetOutput();
+        out->SetBufferedRegion(out->GetRequestedRegion());
+        out->Allocate();
+        m_vRequested.push_back(out->GetRequestedRegion());
+
+        itk::ImageRegionIterator<ImageType> it(out, out->GetBufferedRegion());
+        for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+        {
+            it.Set(TestValue(it.GetIndex()[0], it.GetIndex()[1], m_bClasses));
+        }
+    }
+
+    bool m_bClasses;
+    std::vector<ImageType::RegionType> m_vRequested;
+};
+
+/*! compares the two images pixel by pixel and reports
+ *  the first few mismatches; returns the number of
+ *  pixels which are not bit-identical
+ */
+int CompareImages(const ImageType* ref, const ImageType* test,
+                  const std::string& label)
+{
+    if (ref->GetLargestPossibleRegion() != test->GetLargestPossibleRegion())
+    {
+        std::cout << label << ": output region mismatch!" << std::endl;
+        return 1;
+    }
+
+    itk::ImageRegionConstIterator<ImageType> refIt(ref, ref->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ImageType> testIt(test, test->GetLargestPossibleRegion());
+
+    int nerr = 0;
+    for (refIt.GoToBegin(), testIt.GoToBegin(); !refIt.IsAtEnd(); ++refIt, ++testIt)
+    {
+        const PixelType r = refIt.Get();
+        const PixelType t = testIt.Get();
+        if (std::memcmp(&r, &t, sizeof(PixelType)) != 0)
+        {
+            if (nerr < 5)
+            {
+                std::cout << label << ": pixel " << refIt.GetIndex()
+                          << " unstreamed=" << r << " streamed=" << t << std::endl;
+            }
+            ++nerr;
+        }
+    }
+
+    return nerr;
+}
+
+/*! checks that the source has been asked for each row
+ *  exactly once, i.e. in consecutive, non-overlapping stripes
+ */
+int CheckRequestedRows(const RecordingSource* source, const std::string& label)
+{
+    const std::vector<ImageType::RegionType>& regions = source->GetRequestedRegions();
+
+    long nextRow = 0;
+    for (size_t r=0; r < regions.size(); ++r)
+    {
+        const long start = regions.at(r).GetIndex(1);
+        const long nrows = regions.at(r).GetSize(1);
+        if (start != nextRow)
+        {
+            std::cout << label << ": division #" << r << " requested rows "
+                      << start << " - " << start + nrows - 1 << ", but expected "
+                      << "the request to start at row " << nextRow
+                      << " - halo rows not taken from the cache!" << std::endl;
+            return 1;
+        }
+        nextRow = start + nrows;
+    }
+
+    if (nextRow != NumRows)
+    {
+        std::cout << label << ": only rows 0 - " << nextRow - 1
+                  << " have been requested!" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+/*! runs the reference filter unstreamed and the filter fed by source
+ *  streamed using each of the given numbers of stream divisions;
+ *  returns the number of tests failed
+ */
+int RunStreamingTest(itk::ImageToImageFilter<ImageType, ImageType>* refFilter,
+                     itk::ImageToImageFilter<ImageType, ImageType>* filter,
+                     RecordingSource* source,
+                     const std::string& name)
+{
+    const unsigned int divisions[] = {2, 3, 5, 7, 11};
+    int nfailed = 0;
+
+    try
+    {
+        refFilter->Update();
+        const ImageType* ref = refFilter->GetOutput();
+
+        StreamerType::Pointer streamer = StreamerType::New();
+        streamer->SetInput(filter->GetOutput());
+
+        for (unsigned int d=0; d < sizeof(divisions) / sizeof(unsigned int); ++d)
+        {
+            std::stringstream label;
+            label << name << " divisions=" << divisions[d];
+
+            source->ClearRequestedRegions();
+            streamer->SetNumberOfStreamDivisions(divisions[d]);
+            streamer->Update();
+
+            const int nerr = CompareImages(ref, streamer->GetOutput(), label.str());
+            if (nerr > 0)
+            {
+                std::cout << label.str() << ": " << nerr << " pixel differ - FAILED!" << std::endl;
+                ++nfailed;
+            }
+            else if (CheckRequestedRows(source, label.str()) > 0)
+            {
+                std::cout << label.str() << ": FAILED!" << std::endl;
+                ++nfailed;
+            }
+            else
+            {
+                std::cout << label.str() << ": passed" << std::endl;
+            }
+        }
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << name << ": " << eo.GetDescription() << " - FAILED!" << std::endl;
+        ++nfailed;
+    }
+
+    return nfailed;
+}
+
+/*! the weights matrix needs one column per distance class
+ *  of the circular kernel, s. FocalDistanceWeightingFilter
+ */
+WeightingFilterType::WeightMatrixType CreateWeights(unsigned int radius, size_t nvalues)
+{
+    const int ncols = radius % 2 == 0 ? ((radius * radius) / 2.0) + 1.5
+                                      : ((radius * radius) / 2.0) + 0.5;
+    WeightingFilterType::WeightMatrixType weights(nvalues, ncols);
+    for (size_t r=0; r < nvalues; ++r)
+    {
+        for (int c=0; c < ncols; ++c)
+        {
+            weights(r, c) = (r + 1) / static_cast<float>(c + 1);
+        }
+    }
+    return weights;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const unsigned int radii[] = {1, 2, 3};
+    const unsigned int nradii = sizeof(radii) / sizeof(unsigned int);
+
+    ImageType::Pointer classImg = CreateImage(true);
+    ImageType::Pointer demImg = CreateImage(false);
+
+    int nfailed = 0;
+
+    // ----------------------------- NeighbourhoodCountingFilter
+    for (unsigned int r=0; r < nradii; ++r)
+    {
+        CountingFilterType::InputSizeType radius;
+        radius.Fill(radii[r]);
+
+        CountingFilterType::Pointer ref = CountingFilterType::New();
+        ref->SetInput(classImg);
+        ref->SetRadius(radius);
+        ref->SetTestvalue(1);
+
+        RecordingSource::Pointer source = RecordingSource::New();
+        source->SetClasses(true);
+
+        CountingFilterType::Pointer filter = CountingFilterType::New();
+        filter->SetInput(source->GetOutput());
+        filter->SetRadius(radius);
+        filter->SetTestvalue(1);
+
+        std::stringstream name;
+        name << "NeighbourhoodCountingFilter radius=" << radii[r];
+        nfailed += RunStreamingTest(ref, filter, source, name.str());
+    }
+
+    // ----------------------------- FocalDistanceWeightingFilter
+    std::vector<PixelType> values;
+    values.push_back(1);
+    values.push_back(3);
+    for (unsigned int r=0; r < nradii; ++r)
+    {
+        WeightingFilterType::WeightMatrixType weights = CreateWeights(radii[r], values.size());
+
+        WeightingFilterType::Pointer ref = WeightingFilterType::New();
+        ref->SetInput(classImg);
+        ref->SetRadius(radii[r]);
+        ref->SetFFTMinRadius(0);
+        ref->SetValues(values);
+        ref->SetWeights(weights);
+
+        RecordingSource::Pointer source = RecordingSource::New();
+        source->SetClasses(true);
+
+        WeightingFilterType::Pointer filter = WeightingFilterType::New();
+        filter->SetInput(source->GetOutput());
+        filter->SetRadius(radii[r]);
+        filter->SetFFTMinRadius(0);
+        filter->SetValues(values);
+        filter->SetWeights(weights);
+
+        std::stringstream name;
+        name << "FocalDistanceWeightingFilter radius=" << radii[r];
+        nfailed += RunStreamingTest(ref, filter, source, name.str());
+    }
+
+    // ----------------------------- DEMSlopeAspectFilter (fixed 3x3 kernel)
+    std::vector<std::string> demNames;
+    demNames.push_back("dem");
+    const char* algorithms[] = {"Horn", "Zevenbergen"};
+    for (unsigned int a=0; a < 2; ++a)
+    {
+        SlopeFilterType::Pointer ref = SlopeFilterType::New();
+        ref->SetInputNames(demNames);
+        ref->SetNthInput(0, demImg);
+        ref->SetTerrainAlgorithm(algorithms[a]);
+        ref->SetTerrainAttribute("Slope");
+
+        RecordingSource::Pointer source = RecordingSource::New();
+        source->SetClasses(false);
+
+        SlopeFilterType::Pointer filter = SlopeFilterType::New();
+        filter->SetInputNames(demNames);
+        filter->SetNthInput(0, source->GetOutput());
+        filter->SetTerrainAlgorithm(algorithms[a]);
+        filter->SetTerrainAttribute("Slope");
+
+        std::stringstream name;
+        name << "DEMSlopeAspectFilter algorithm=" << algorithms[a];
+        nfailed += RunStreamingTest(ref, filter, source, name.str());
+    }
+
+    // ----------------------------- NMScriptableKernelFilter2
+    std::vector<std::string> imgNames;
+    imgNames.push_back("img");
+    const std::string script = "out = kwinVal(img, 0, thid, addr) "
+                               "+ 2 * kwinVal(img, numPix-1, thid, addr) "
+                               "+ kwinVal(img, centrePixIdx, thid, addr);";
+    for (unsigned int r=0; r < nradii; ++r)
+    {
+        KernelFilterType::InputSizeType radius;
+        radius.Fill(radii[r]);
+
+        KernelFilterType::Pointer ref = KernelFilterType::New();
+        ref->SetInputNames(imgNames);
+        ref->SetNthInput(0, classImg);
+        ref->SetRadius(radius);
+        ref->SetKernelScript(script);
+        ref->SetOutputVarName("out");
+
+        RecordingSource::Pointer source = RecordingSource::New();
+        source->SetClasses(true);
+
+        KernelFilterType::Pointer filter = KernelFilterType::New();
+        filter->SetInputNames(imgNames);
+        filter->SetNthInput(0, source->GetOutput());
+        filter->SetRadius(radius);
+        filter->SetKernelScript(script);
+        filter->SetOutputVarName("out");
+
+        std::stringstream name;
+        name << "NMScriptableKernelFilter2 radius=" << radii[r];
+        nfailed += RunStreamingTest(ref, filter, source, name.str());
+    }
+
+    if (nfailed > 0)
+    {
+        std::cout << nfailed << " test(s) FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "all tests passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  NMImageReaderBenchmark
+ *
+ *  usage: NMImageReaderBenchmark [workspace dir] [image size (pixel)]
+ *
+ *  Reads a Byte GeoTIFF into a float image with NMImageReader
+ *  (GDAL converts the values while reading, s.
+ *  NMImageReader::ReadWithIOConversion) and compares it with reading
+ *  the Byte image and casting it to float in a separate filter, each
+ *  unstreamed and streamed; the float values of both are compared,
+ *  so the benchmark fails, if they don't match.
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include "otbImage.h"
+#include "otbImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkCastImageFilter.h"
+
+#include "otbNMImageReader.h"
+
+typedef otb::Image<unsigned char, 2>    ByteImageType;
+typedef otb::Image<float, 2>            FloatImageType;
+
+typedef otb::NMImageReader<ByteImageType>   ByteReaderType;
+typedef otb::NMImageReader<FloatImageType>  FloatReaderType;
+typedef itk::CastImageFilter<ByteImageType, FloatImageType>         CastFilterType;
+typedef itk::StreamingImageFilter<FloatImageType, FloatImageType>   StreamerType;
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/*! writes a size x size Byte GeoTIFF */
+bool CreateByteImage(const std::string& fileName, long size)
+{
+    ByteImageType::IndexType idx;
+    idx.Fill(0);
+    ByteImageType::SizeType isize;
+    isize.Fill(size);
+
+    ByteImageType::Pointer img = ByteImageType::New();
+    img->SetRegions(ByteImageType::RegionType(idx, isize));
+    img->Allocate();
+
+    itk::ImageRegionIterator<ByteImageType> it(img, img->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const ByteImageType::IndexType& i = it.GetIndex();
+        it.Set(static_cast<unsigned char>((i[0] * 7 + i[1] * 13) % 256));
+    }
+
+    typedef otb::ImageFileWriter<ByteImageType> WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetFileName(fileName);
+    writer->SetInput(img);
+    try
+    {
+        writer->Update();
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << "Failed writing '" << fileName << "': "
+                  << eo.GetDescription() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*! reads the image as float, either directly or by casting the
+ *  Byte image, using the given number of stream divisions; returns
+ *  the number of seconds it took; -1 on error
+ */
+double ReadAsFloat(const std::string& fileName, bool bCast, unsigned int divisions,
+                   FloatImageType::Pointer& result)
+{
+    const BenchClock::time_point start = BenchClock::now();
+
+    StreamerType::Pointer streamer = StreamerType::New();
+    streamer->SetNumberOfStreamDivisions(divisions);
+
+    ByteReaderType::Pointer byteReader = ByteReaderType::New();
+    CastFilterType::Pointer cast = CastFilterType::New();
+    FloatReaderType::Pointer floatReader = FloatReaderType::New();
+    if (bCast)
+    {
+        byteReader->SetFileName(fileName);
+        cast->SetInput(byteReader->GetOutput());
+        streamer->SetInput(cast->GetOutput());
+    }
+    else
+    {
+        floatReader->SetFileName(fileName);
+        streamer->SetInput(floatReader->GetOutput());
+    }
+
+    try
+    {
+        streamer->Update();
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << "Failed reading '" << fileName << "': "
+                  << eo.GetDescription() << std::endl;
+        return -1;
+    }
+    const double secs = SecondsSince(start);
+
+    result = streamer->GetOutput();
+    result->DisconnectPipeline();
+
+    return secs;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const std::string workspace = argc > 1 ? argv[1] : ".";
+    const long size = argc > 2 ? std::atol(argv[2]) : 8192;
+    const unsigned int divisions[] = {1, 16, 64};
+
+    const std::string tifFile = workspace + "/bench_byte.tif";
+    std::remove(tifFile.c_str());
+
+    std::cout << "NMImageReader benchmark: " << size << " x " << size
+              << " Byte GeoTIFF -> float" << std::endl;
+
+    if (!CreateByteImage(tifFile, size))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const double mpix = size * static_cast<double>(size) / 1e6;
+    int nerr = 0;
+    for (unsigned int d=0; d < sizeof(divisions) / sizeof(unsigned int); ++d)
+    {
+        FloatImageType::Pointer direct;
+        FloatImageType::Pointer casted;
+        const double directSecs = ReadAsFloat(tifFile, false, divisions[d], direct);
+        const double castSecs = ReadAsFloat(tifFile, true, divisions[d], casted);
+        if (directSecs < 0 || castSecs < 0)
+        {
+            std::remove(tifFile.c_str());
+            return EXIT_FAILURE;
+        }
+
+        std::cout << "divisions=" << divisions[d]
+                  << ", read as float:          " << directSecs << " s, "
+                  << mpix / directSecs << " Mpix/s" << std::endl;
+        std::cout << "divisions=" << divisions[d]
+                  << ", read as Byte + cast:    " << castSecs << " s, "
+                  << mpix / castSecs << " Mpix/s" << std::endl;
+
+        itk::ImageRegionConstIterator<FloatImageType> dIt(direct, direct->GetBufferedRegion());
+        itk::ImageRegionConstIterator<FloatImageType> cIt(casted, casted->GetBufferedRegion());
+        for (; !dIt.IsAtEnd() && !cIt.IsAtEnd(); ++dIt, ++cIt)
+        {
+            if (dIt.Get() != cIt.Get())
+            {
+                ++nerr;
+            }
+        }
+    }
+
+    std::remove(tifFile.c_str());
+
+    if (nerr > 0)
+    {
+        std::cout << nerr << " values differ - FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
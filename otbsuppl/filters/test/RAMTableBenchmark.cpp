@@ -0,0 +1,212 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  RAMTableBenchmark
+ *
+ *  usage: RAMTableBenchmark [number of rows]
+ *
+ *  Loads two string columns into a RAMTable the way GDALRATImageIO
+ *  loads a RAT (AddColumn, AddRows, SetValue per cell), i.e. a low
+ *  cardinality 'landuse' column and a high cardinality 'parcel' column
+ *  (one value per 8 rows, too long for the short string optimisation),
+ *  and compares load time and memory footprint of the dictionary
+ *  encoded columns with one std::string per cell (what RAMTable
+ *  stored before). The memory footprint is computed from the
+ *  containers' sizes (i.e. without allocator overhead); the values
+ *  of both layouts are compared, so the benchmark fails, if they
+ *  don't match.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include "otbRAMTable.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+const char* LandUse[] = {"forest", "pasture", "cropland", "urban", "water",
+                         "wetland", "scrub", "bare"};
+const int NumLandUse = sizeof(LandUse) / sizeof(LandUse[0]);
+const int NumCols = 2;
+
+/*! the value of column col in row */
+void CellValue(int col, long long row, char* buf, size_t len)
+{
+    if (col == 0)
+    {
+        std::snprintf(buf, len, "%s", LandUse[(row * 7) % NumLandUse]);
+    }
+    else
+    {
+        std::snprintf(buf, len, "parcel_%010lld_nz", row / 8);
+    }
+}
+
+/*! heap bytes of a string, if it doesn't fit into the
+ *  string object itself (short string optimisation) */
+size_t StringHeapBytes(const std::string& str)
+{
+    const char* data = str.data();
+    const char* obj = reinterpret_cast<const char*>(&str);
+    if (data >= obj && data < obj + sizeof(std::string))
+    {
+        return 0;
+    }
+    return str.capacity() + 1;
+}
+
+/*! the previous RAMTable layout, i.e. one std::string per cell */
+double LoadStdString(long long numRows, std::vector<std::vector<std::string> >& cols,
+                     size_t& bytes)
+{
+    char buf[64];
+
+    const BenchClock::time_point start = BenchClock::now();
+    cols.resize(NumCols);
+    for (int c=0; c < NumCols; ++c)
+    {
+        cols[c].resize(numRows, "");
+    }
+    for (long long r=0; r < numRows; ++r)
+    {
+        for (int c=0; c < NumCols; ++c)
+        {
+            CellValue(c, r, buf, sizeof(buf));
+            cols[c][r] = std::string(buf);
+        }
+    }
+    const double secs = SecondsSince(start);
+
+    bytes = 0;
+    for (int c=0; c < NumCols; ++c)
+    {
+        bytes += cols[c].capacity() * sizeof(std::string);
+        for (long long r=0; r < numRows; ++r)
+        {
+            bytes += StringHeapBytes(cols[c][r]);
+        }
+    }
+
+    return secs;
+}
+
+/*! the dictionary encoded RAMTable columns */
+double LoadRAMTable(long long numRows, otb::RAMTable::Pointer& tab, size_t& bytes)
+{
+    char buf[64];
+
+    const BenchClock::time_point start = BenchClock::now();
+    tab = otb::RAMTable::New();
+    tab->AddColumn("landuse", otb::AttributeTable::ATTYPE_STRING);
+    tab->AddColumn("parcel", otb::AttributeTable::ATTYPE_STRING);
+    tab->AddRows(numRows);
+    for (long long r=0; r < numRows; ++r)
+    {
+        for (int c=0; c < NumCols; ++c)
+        {
+            CellValue(c, r, buf, sizeof(buf));
+            tab->SetValue(c, r, buf);
+        }
+    }
+    const double secs = SecondsSince(start);
+
+    // codes + arena, offsets and hashes of the dictionary + its
+    // hash index, which is kept at a load factor below 0.5
+    bytes = 0;
+    for (int c=0; c < NumCols; ++c)
+    {
+        const size_t dictSize = tab->GetDictionarySize(c);
+        size_t numBuckets = 16;
+        while (dictSize * 2 > numBuckets)
+        {
+            numBuckets *= 2;
+        }
+
+        bytes += numRows * sizeof(int);
+        for (size_t code=0; code < dictSize; ++code)
+        {
+            bytes += tab->GetDictionaryValue(c, code).size() + 1;
+        }
+        bytes += (dictSize + 1) * sizeof(size_t)
+                 + dictSize * sizeof(size_t)
+                 + numBuckets * sizeof(int);
+    }
+
+    return secs;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const long long numRows = argc > 1 ? std::atoll(argv[1]) : 2000000;
+
+    std::cout << "RAMTable benchmark: " << numRows << " rows x "
+              << NumCols << " string columns" << std::endl;
+
+    std::vector<std::vector<std::string> > strCols;
+    size_t strBytes = 0;
+    const double strSecs = LoadStdString(numRows, strCols, strBytes);
+
+    otb::RAMTable::Pointer tab;
+    size_t dictBytes = 0;
+    const double dictSecs = LoadRAMTable(numRows, tab, dictBytes);
+
+    std::cout << "load, std::string per cell: " << strSecs << " s, "
+              << strBytes / 1048576.0 << " MiB" << std::endl;
+    std::cout << "load, dictionary encoded:   " << dictSecs << " s, "
+              << dictBytes / 1048576.0 << " MiB" << std::endl;
+    for (int c=0; c < NumCols; ++c)
+    {
+        std::cout << "'" << tab->GetColumnName(c) << "': "
+                  << tab->GetDictionarySize(c) << " unique values" << std::endl;
+    }
+
+    long long nerr = 0;
+    for (long long r=0; r < numRows; ++r)
+    {
+        for (int c=0; c < NumCols; ++c)
+        {
+            if (tab->GetStrValue(c, r) != strCols[c][r])
+            {
+                ++nerr;
+            }
+        }
+    }
+
+    if (nerr > 0)
+    {
+        std::cout << nerr << " values differ - FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  SQLiteTableBenchmark
+ *
+ *  usage: SQLiteTableBenchmark [workspace dir] [number of rows]
+ *
+ *  - bulk insert throughput of SQLiteTable in default and in
+ *    scratch mode (s. SQLiteTable::SetScratchMode)
+ *  - random read throughput of per-thread read-only tables, as
+ *    set up by RATBandMathImageFilter for each model iteration,
+ *    with and without the connection pool
+ *    (s. SQLiteTable::SetUseConnectionPool)
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <cstdio>
+
+#include "otbSQLiteTable.h"
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/*! creates a table with numRows rows of (rowidx, val) and
+ *  returns the number of seconds it took; -1 on error */
+double BulkInsert(const std::string& fileName, long long numRows, bool bScratch)
+{
+    const BenchClock::time_point start = BenchClock::now();
+
+    otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+    tab->SetScratchMode(bScratch);
+    if (tab->CreateTable(fileName, "1") != otb::SQLiteTable::ATCREATE_CREATED)
+    {
+        std::cout << "Failed creating '" << fileName << "': "
+                  << tab->getLastLogMsg() << std::endl;
+        return -1;
+    }
+
+    tab->BeginTransaction();
+    tab->AddColumn("val", otb::AttributeTable::ATTYPE_DOUBLE);
+
+    std::vector<std::string> colnames;
+    colnames.push_back(tab->GetPrimaryKey());
+    colnames.push_back("val");
+
+    std::vector<otb::AttributeTable::ColumnValue> values(2);
+    values[0].type = otb::AttributeTable::ATTYPE_INT;
+    values[1].type = otb::AttributeTable::ATTYPE_DOUBLE;
+
+    tab->PrepareBulkSet(colnames, true);
+    for (long long r=0; r < numRows; ++r)
+    {
+        values[0].ival = r;
+        values[1].dval = r * 0.5;
+        tab->DoBulkSet(values);
+    }
+    tab->EndTransaction();
+    tab->CloseTable();
+
+    return SecondsSince(start);
+}
+
+/*! emulates numIter model iterations of a filter opening one
+ *  read-only table per thread and reading numReads random values
+ *  with each of them; returns the number of seconds it took */
+double RandomRead(const std::string& fileName, long long numRows, bool bPool,
+                  int numIter, int numThreads, int numReads)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<long long> rowDist(0, numRows - 1);
+
+    double checksum = 0;
+    const BenchClock::time_point start = BenchClock::now();
+    for (int i=0; i < numIter; ++i)
+    {
+        std::vector<otb::SQLiteTable::Pointer> vTabs;
+        for (int t=0; t < numThreads; ++t)
+        {
+            otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+            tab->SetUseSharedCache(false);
+            tab->SetOpenReadOnly(true);
+            tab->SetUseConnectionPool(bPool);
+            if (tab->CreateTable(fileName, "1") != otb::SQLiteTable::ATCREATE_READ)
+            {
+                std::cout << "Failed opening '" << fileName << "': "
+                          << tab->getLastLogMsg() << std::endl;
+                return -1;
+            }
+            vTabs.push_back(tab);
+        }
+
+        for (int t=0; t < numThreads; ++t)
+        {
+            for (int r=0; r < numReads; ++r)
+            {
+                checksum += vTabs[t]->GetDblValue("val", rowDist(rng));
+            }
+        }
+
+        for (int t=0; t < numThreads; ++t)
+        {
+            vTabs[t]->CloseTable();
+        }
+    }
+    const double secs = SecondsSince(start);
+
+    // keep the reads from being optimised away
+    if (checksum < 0)
+    {
+        std::cout << checksum << std::endl;
+    }
+
+    return secs;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const std::string workspace = argc > 1 ? argv[1] : ".";
+    const long long numRows = argc > 2 ? std::atoll(argv[2]) : 200000;
+
+    const int numIter = 50;
+    const int numThreads = 8;
+    const int numReads = 1000;
+
+    const std::string defFile = workspace + "/bench_default.ldb";
+    const std::string scratchFile = workspace + "/bench_scratch.ldb";
+
+    // left-overs from a previous (aborted) run
+    std::remove(defFile.c_str());
+    std::remove(scratchFile.c_str());
+
+    std::cout << "SQLiteTable benchmark: " << numRows << " rows" << std::endl;
+
+    const double defInsert = BulkInsert(defFile, numRows, false);
+    const double scratchInsert = BulkInsert(scratchFile, numRows, true);
+    if (defInsert < 0 || scratchInsert < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << "bulk insert, default mode: " << defInsert << " s, "
+              << numRows / defInsert << " rows/s" << std::endl;
+    std::cout << "bulk insert, scratch mode: " << scratchInsert << " s, "
+              << numRows / scratchInsert << " rows/s" << std::endl;
+
+    const long long totalReads = static_cast<long long>(numIter) * numThreads * numReads;
+    const double plainRead = RandomRead(defFile, numRows, false, numIter, numThreads, numReads);
+    const double pooledRead = RandomRead(defFile, numRows, true, numIter, numThreads, numReads);
+    if (plainRead < 0 || pooledRead < 0)
+    {
+        return EXIT_FAILURE;
+    }
+    std::cout << "random read (" << numIter << " iterations x " << numThreads
+              << " tables x " << numReads << " reads), without pool: "
+              << plainRead << " s, " << totalReads / plainRead << " reads/s" << std::endl;
+    std::cout << "random read (" << numIter << " iterations x " << numThreads
+              << " tables x " << numReads << " reads), with pool:    "
+              << pooledRead << " s, " << totalReads / pooledRead << " reads/s" << std::endl;
+
+    // clean up; idle pooled connections must not hang on to the files
+    otb::SQLiteTable::ClearConnectionPool(defFile);
+    std::remove(defFile.c_str());
+    std::remove(scratchFile.c_str());
+
+    return EXIT_SUCCESS;
+}
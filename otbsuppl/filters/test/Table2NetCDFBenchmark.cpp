@@ -0,0 +1,225 @@
+/******************************************************************************
+ * Created by Alexander Herzig
+ * Copyright 2026 Landcare Research New Zealand Ltd
+ *
+ * This file is part of 'LUMASS', which is free software: you can redistribute
+ * it and/or modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the License,
+ * or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+/*
+ *  Table2NetCDFBenchmark
+ *
+ *  usage: Table2NetCDFBenchmark [workspace dir] [image size (pixel)] [number of slices]
+ *
+ *  Converts a table of (x, y, t, val) rows (default: 256 x 256 x 16)
+ *  into a float cube with Table2NetCDFFilter, using a range of stream
+ *  division counts, i.e. one region query per division; the cube's
+ *  values are compared with the table's, so the benchmark fails, if
+ *  any of the divisions misses rows.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+
+#include "otbImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkStreamingImageFilter.h"
+
+#include "otbSQLiteTable.h"
+#include "nmTable2NetCDFFilter.h"
+
+typedef otb::Image<float, 2>    ImageType;
+typedef otb::Image<float, 3>    CubeType;
+
+typedef nm::Table2NetCDFFilter<ImageType, CubeType>         FilterType;
+typedef itk::StreamingImageFilter<CubeType, CubeType>       StreamerType;
+
+namespace
+{
+
+typedef std::chrono::steady_clock BenchClock;
+
+double SecondsSince(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/*! the value stored for pixel (x, y, t) */
+float CellValue(long long x, long long y, long long t, long long size)
+{
+    return static_cast<float>(x + y * size + t * size * size);
+}
+
+/*! creates the table with one row per pixel of the cube */
+otb::SQLiteTable::Pointer CreateTable(const std::string& fileName,
+                                      long long size, long long numSlices)
+{
+    otb::SQLiteTable::Pointer tab = otb::SQLiteTable::New();
+    if (tab->CreateTable(fileName, "1") != otb::SQLiteTable::ATCREATE_CREATED)
+    {
+        std::cout << "Failed creating '" << fileName << "': "
+                  << tab->getLastLogMsg() << std::endl;
+        return 0;
+    }
+
+    tab->BeginTransaction();
+    tab->AddColumn("x", otb::AttributeTable::ATTYPE_INT);
+    tab->AddColumn("y", otb::AttributeTable::ATTYPE_INT);
+    tab->AddColumn("t", otb::AttributeTable::ATTYPE_INT);
+    tab->AddColumn("val", otb::AttributeTable::ATTYPE_DOUBLE);
+
+    std::vector<std::string> colnames;
+    colnames.push_back(tab->GetPrimaryKey());
+    colnames.push_back("x");
+    colnames.push_back("y");
+    colnames.push_back("t");
+    colnames.push_back("val");
+
+    std::vector<otb::AttributeTable::ColumnValue> values(5);
+    for (int c=0; c < 4; ++c)
+    {
+        values[c].type = otb::AttributeTable::ATTYPE_INT;
+    }
+    values[4].type = otb::AttributeTable::ATTYPE_DOUBLE;
+
+    tab->PrepareBulkSet(colnames, true);
+    long long rowidx = 0;
+    for (long long t=0; t < numSlices; ++t)
+    {
+        for (long long y=0; y < size; ++y)
+        {
+            for (long long x=0; x < size; ++x, ++rowidx)
+            {
+                values[0].ival = rowidx;
+                values[1].ival = x;
+                values[2].ival = y;
+                values[3].ival = t;
+                values[4].dval = CellValue(x, y, t, size);
+                tab->DoBulkSet(values);
+            }
+        }
+    }
+    tab->EndTransaction();
+
+    return tab;
+}
+
+/*! converts the table using the given number of stream
+ *  divisions; returns the number of seconds it took */
+double Convert(otb::SQLiteTable* tab, long long size, long long numSlices,
+               unsigned int divisions, CubeType::Pointer& result)
+{
+    std::vector<std::string> dimVars = {"x", "y", "t"};
+    std::vector<double> origin(3, 0.0);
+    std::vector<double> spacing(3, 1.0);
+    std::vector<long long> osize = {size, size, numSlices};
+    std::vector<long long> index(3, 0);
+
+    const BenchClock::time_point start = BenchClock::now();
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->setRAT(0, tab);
+    filter->SetImageVarName("val");
+    filter->SetDimVarNames(dimVars);
+    filter->SetOutputOrigin(origin);
+    filter->SetOutputSpacing(spacing);
+    filter->SetOutputSize(osize);
+    filter->SetOutputIndex(index);
+
+    StreamerType::Pointer streamer = StreamerType::New();
+    streamer->SetInput(filter->GetOutput());
+    streamer->SetNumberOfStreamDivisions(divisions);
+    streamer->Update();
+
+    const double secs = SecondsSince(start);
+
+    result = streamer->GetOutput();
+    result->DisconnectPipeline();
+
+    return secs;
+}
+
+/*! returns the number of pixels which don't match the table */
+long long CheckCube(const CubeType* cube, long long size)
+{
+    long long nerr = 0;
+    itk::ImageRegionConstIterator<CubeType> it(cube, cube->GetBufferedRegion());
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+        const CubeType::IndexType& i = it.GetIndex();
+        if (it.Get() != CellValue(i[0], i[1], i[2], size))
+        {
+            ++nerr;
+        }
+    }
+    return nerr;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    const std::string workspace = argc > 1 ? argv[1] : ".";
+    const long long size = argc > 2 ? std::atoll(argv[2]) : 256;
+    const long long numSlices = argc > 3 ? std::atoll(argv[3]) : 16;
+    const unsigned int divisions[] = {1, 4, 16, 64};
+
+    const std::string dbFile = workspace + "/bench_table2netcdf.ldb";
+    std::remove(dbFile.c_str());
+
+    std::cout << "Table2NetCDF benchmark: " << size << " x " << size << " x "
+              << numSlices << " float cube" << std::endl;
+
+    otb::SQLiteTable::Pointer tab = CreateTable(dbFile, size, numSlices);
+    if (tab.IsNull())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const double mpix = size * size * numSlices / 1e6;
+    long long nerr = 0;
+    try
+    {
+        for (unsigned int d=0; d < sizeof(divisions) / sizeof(unsigned int); ++d)
+        {
+            CubeType::Pointer cube;
+            const double secs = Convert(tab, size, numSlices, divisions[d], cube);
+            std::cout << "divisions=" << divisions[d] << ": " << secs << " s, "
+                      << mpix / secs << " Mpix/s" << std::endl;
+
+            nerr += CheckCube(cube, size);
+        }
+    }
+    catch (itk::ExceptionObject& eo)
+    {
+        std::cout << eo.GetDescription() << " - FAILED!" << std::endl;
+        tab->CloseTable();
+        std::remove(dbFile.c_str());
+        return EXIT_FAILURE;
+    }
+
+    tab->CloseTable();
+    std::remove(dbFile.c_str());
+
+    if (nerr > 0)
+    {
+        std::cout << nerr << " values differ - FAILED!" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+* Created by Alexander Herzig
+* Copyright 2016 Landcare Research New Zealand Ltd
+*
+* This file is part of 'LUMASS', which is free software: you can redistribute
+* it and/or modify it under the terms of the GNU General Public License as
+* published by the Free Software Foundation, either version 3 of the License,
+* or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+#ifndef NMLOGQUEUE_H
+#define NMLOGQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/*!
+ * \brief Unbounded lock-free multi-producer single-consumer queue
+ *
+ * Any number of threads may call push() concurrently; only one
+ * thread (the NMLogger worker) may call pop(). The implementation
+ * follows D. Vyukov's intrusive MPSC node queue: producers swap
+ * themselves into the head with a single atomic exchange, the
+ * consumer walks the list from the tail.
+ */
+template<class T>
+class NMLogQueue
+{
+public:
+    NMLogQueue()
+    {
+        Node* stub = new Node();
+        mHead.store(stub, std::memory_order_relaxed);
+        mTail = stub;
+    }
+
+    ~NMLogQueue()
+    {
+        T dummy;
+        while (this->pop(dummy)) {}
+        delete mTail;
+    }
+
+    NMLogQueue(const NMLogQueue&) = delete;
+    NMLogQueue& operator=(const NMLogQueue&) = delete;
+
+    void push(T&& value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /*! only to be called from the consumer thread */
+    bool pop(T& value)
+    {
+        Node* tail = mTail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        value = std::move(next->value);
+        mTail = next;
+        delete tail;
+        return true;
+    }
+
+    /*! only to be called from the consumer thread */
+    bool isEmpty() const
+    {
+        return mTail->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) {}
+        explicit Node(T&& v) : next(nullptr), value(std::move(v)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    std::atomic<Node*> mHead;
+    Node* mTail;
+};
+
+#endif // NMLOGQUEUE_H
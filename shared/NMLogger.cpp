@@ -16,19 +16,169 @@
 * along with this program. If not, see <http://www.gnu.org/licenses/>.
 ******************************************************************************/
 #include "NMLogger.h"
+#include "nmlog.h"
 
+#include <chrono>
 #include <mpi.h>
 
 NMLogger::NMLogger(QObject *parent)
-    : QObject(parent), mbHtml(false), mMPIRank(0), mMPIInitialised(0),
+    : QObject(parent), mbHtml(false),
 #ifdef LUMASS_DEBUG
-    mLogLevel(NM_LOG_DEBUG)
+    mLogLevel(NM_LOG_DEBUG),
 #else
-    mLogLevel(NM_LOG_INFO)
+    mLogLevel(NM_LOG_INFO),
 #endif
+      mMPIRank(0), mMPIInitialised(0),
+      mbAsync(false), mNumPushing(0), mbStopWorker(false), mJsonRank(0)
 {
 }
 
+NMLogger::~NMLogger()
+{
+    this->stopWorker();
+    if (mJsonFile.isOpen())
+    {
+        mJsonFile.flush();
+        mJsonFile.close();
+    }
+}
+
+void
+NMLogger::setLogLevel(LogEventType level)
+{
+    mLogLevel.store((int)level, std::memory_order_relaxed);
+
+    // make sure itk processes keep constructing messages
+    // this logger wants to see
+    if ((int)level < nmlog::procLogLevel().load())
+    {
+        nmlog::procLogLevel().store((int)level);
+    }
+}
+
+void
+NMLogger::setProcLogLevel(LogEventType level)
+{
+    nmlog::procLogLevel().store((int)level);
+}
+
+void
+NMLogger::setAsync(bool bAsync)
+{
+    if (bAsync == mbAsync.load())
+    {
+        return;
+    }
+
+    if (bAsync)
+    {
+        mbStopWorker.store(false);
+        mWorker = std::thread(&NMLogger::runWorker, this);
+        mbAsync.store(true);
+    }
+    else
+    {
+        this->stopWorker();
+    }
+}
+
+bool
+NMLogger::setJsonSink(const QString &fileName)
+{
+    // make sure the worker doesn't write
+    // while we're swapping files
+    this->stopWorker();
+
+    if (mJsonFile.isOpen())
+    {
+        mJsonFile.close();
+    }
+
+    mJsonFile.setFileName(fileName);
+    if (!mJsonFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    int init = 0;
+    MPI_Initialized(&init);
+    if (init)
+    {
+        MPI_Comm_rank(MPI_COMM_WORLD, &mJsonRank);
+    }
+
+    this->setAsync(true);
+    return true;
+}
+
+void
+NMLogger::stopWorker(void)
+{
+    if (!mbAsync.load())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mWorkerMutex);
+        mbStopWorker.store(true);
+    }
+    mWorkerCond.notify_one();
+
+    if (mWorker.joinable())
+    {
+        mWorker.join();
+    }
+    mbAsync.store(false);
+
+    // messages pushed after the worker's last drain, i.e. by producers
+    // which saw mbAsync still set, are delivered by this thread, once
+    // those producers are done pushing
+    while (mNumPushing.load() > 0)
+    {
+        std::this_thread::yield();
+    }
+    this->drainQueue();
+}
+
+void
+NMLogger::runWorker(void)
+{
+    std::unique_lock<std::mutex> lock(mWorkerMutex);
+    while (!mbStopWorker.load())
+    {
+        lock.unlock();
+        this->drainQueue();
+        lock.lock();
+
+        // producers don't take the lock when they push, so
+        // we may miss a notification; the timeout bounds the
+        // delay with which such a message gets delivered
+        mWorkerCond.wait_for(lock, std::chrono::milliseconds(50));
+    }
+    lock.unlock();
+
+    // deliver whatever is left before we go
+    this->drainQueue();
+}
+
+void
+NMLogger::drainQueue(void)
+{
+    bool bDelivered = false;
+    LogRecord rec;
+    while (mQueue.pop(rec))
+    {
+        this->deliverLogMsg(rec);
+        bDelivered = true;
+    }
+
+    if (bDelivered && mJsonFile.isOpen())
+    {
+        mJsonFile.flush();
+    }
+}
+
 void
 NMLogger::logProvN(const NMProvConcept &concept,
                    const QStringList& args,
@@ -121,12 +271,108 @@ void
 NMLogger::processLogMsg(const QString &time, LogEventType type, const QString &msg,
                         bool bForceNewLine)
 {
-    if (    (int)type < (int)mLogLevel
+    if (    !this->isLogLevelEnabled(type)
         ||  msg.isEmpty())
     {
         return;
     }
 
+    LogRecord rec;
+    rec.time = time;
+    rec.type = type;
+    rec.msg = msg;
+    rec.bForceNewLine = bForceNewLine;
+
+    // stopWorker waits for anybody still pushing, before
+    // it delivers what the worker has left in the queue
+    mNumPushing.fetch_add(1);
+    if (mbAsync.load())
+    {
+        mQueue.push(std::move(rec));
+        mNumPushing.fetch_sub(1);
+        mWorkerCond.notify_one();
+        return;
+    }
+    mNumPushing.fetch_sub(1);
+
+    this->deliverLogMsg(rec);
+}
+
+void
+NMLogger::deliverLogMsg(const LogRecord &rec)
+{
+    if (mJsonFile.isOpen())
+    {
+        mJsonFile.write(this->formatJsonMsg(rec).toUtf8());
+        return;
+    }
+
+    if (mMPIRank == 0)
+    {
+        emit sendLogMsg(this->formatLogMsg(rec));
+    }
+}
+
+QString
+NMLogger::formatJsonMsg(const LogRecord &rec) const
+{
+    QString level;
+    switch(rec.type)
+    {
+    case NM_LOG_DEBUG: level = QStringLiteral("DEBUG"); break;
+    case NM_LOG_INFO:  level = QStringLiteral("INFO"); break;
+    case NM_LOG_WARN:  level = QStringLiteral("WARN"); break;
+    case NM_LOG_ERROR: level = QStringLiteral("ERROR"); break;
+    default: level = QStringLiteral("NOLOG");
+    }
+
+    // we don't want trailing line breaks in the message field
+    int len = rec.msg.size();
+    while (len > 0 && (rec.msg.at(len-1) == '\n' || rec.msg.at(len-1) == '\r'))
+    {
+        --len;
+    }
+
+    QString esc;
+    esc.reserve(len + 8);
+    for (int c=0; c < len; ++c)
+    {
+        const QChar ch = rec.msg.at(c);
+        switch(ch.unicode())
+        {
+        case '"':  esc += QStringLiteral("\\\""); break;
+        case '\\': esc += QStringLiteral("\\\\"); break;
+        case '\n': esc += QStringLiteral("\\n"); break;
+        case '\r': esc += QStringLiteral("\\r"); break;
+        case '\t': esc += QStringLiteral("\\t"); break;
+        default:
+            if (ch.unicode() < 0x20)
+            {
+                esc += QString("\\u%1").arg((int)ch.unicode(), 4, 16, QChar('0'));
+            }
+            else
+            {
+                esc += ch;
+            }
+        }
+    }
+
+    return QString("{\"time\":\"%1\",\"level\":\"%2\",\"rank\":%3,\"newline\":%4,\"msg\":\"%5\"}\n")
+            .arg(rec.time)
+            .arg(level)
+            .arg(mJsonRank)
+            .arg(QString(rec.bForceNewLine ? "true" : "false"))
+            .arg(esc);
+}
+
+QString
+NMLogger::formatLogMsg(const LogRecord &rec) const
+{
+    const QString& time = rec.time;
+    const QString& msg = rec.msg;
+    const LogEventType type = rec.type;
+    const bool bForceNewLine = rec.bForceNewLine;
+
     QString logmsg = msg;
     // each message its own line unless we specifiy bForceNewLine = false!
     if (bForceNewLine && msg.at(msg.size()-1) != '\n')
@@ -203,8 +449,5 @@ NMLogger::processLogMsg(const QString &time, LogEventType type, const QString &m
         }
     }
 
-    if (mMPIRank == 0)
-    {
-        emit sendLogMsg(logmsg);
-    }
+    return logmsg;
 }
@@ -19,6 +19,14 @@
 #define NMLOGGER_H
 
 #include <QObject>
+#include <QFile>
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "NMLogQueue.h"
 
 class NMLogger : public QObject
 {
@@ -54,9 +62,40 @@ public:
 
 
     explicit NMLogger(QObject *parent = 0);
+    ~NMLogger();
+
     void setHtmlMode(bool bhtml){mbHtml=bhtml;}
-    void setLogLevel(LogEventType level){mLogLevel = level;}
-    LogEventType getLogLevel(void){return mLogLevel;}
+    void setLogLevel(LogEventType level);
+    LogEventType getLogLevel(void){return (LogEventType)mLogLevel.load(std::memory_order_relaxed);}
+
+    /*! cheap check to be done before any log message is
+     *  put together, i.e. before any formatting takes place
+     */
+    bool isLogLevelEnabled(LogEventType level) const
+        {return (int)level >= mLogLevel.load(std::memory_order_relaxed);}
+
+    /*! Sets the process-wide threshold below which itk process
+     *  objects don't even construct their log messages
+     *  (s. NMProc* macros in nmlog.h). Note: setLogLevel only
+     *  ever lowers this threshold.
+     */
+    static void setProcLogLevel(LogEventType level);
+
+    /*! In async mode, processLogMsg only enqueues the raw message
+     *  and returns; formatting and delivery (i.e. emitting sendLogMsg
+     *  or writing to the JSON sink) happens on a background thread.
+     *  Note: in async mode, sendLogMsg is emitted from the background
+     *  thread, so receivers should rely on queued connections.
+     */
+    void setAsync(bool bAsync);
+    bool isAsync(void) const {return mbAsync.load();}
+
+    /*! Writes log messages as JSON-lines (one JSON object per message)
+     *  into the given file rather than emitting sendLogMsg; implies
+     *  async mode
+     */
+    bool setJsonSink(const QString& fileName);
+    bool hasJsonSink(void) const {return mJsonFile.isOpen();}
 
 signals:
     void sendLogMsg(const QString& msg);
@@ -85,11 +124,38 @@ public slots:
 
 protected:
 
+    typedef struct
+    {
+        QString time;
+        LogEventType type;
+        QString msg;
+        bool bForceNewLine;
+    } LogRecord;
+
+    void deliverLogMsg(const LogRecord& rec);
+    QString formatLogMsg(const LogRecord& rec) const;
+    QString formatJsonMsg(const LogRecord& rec) const;
+
+    void runWorker(void);
+    void drainQueue(void);
+    void stopWorker(void);
+
     bool mbHtml;
-    LogEventType mLogLevel;
+    std::atomic<int> mLogLevel;
 
     int mMPIRank;
     int mMPIInitialised;
+
+    std::atomic<bool> mbAsync;
+    std::atomic<int> mNumPushing;
+    NMLogQueue<LogRecord> mQueue;
+    std::thread mWorker;
+    std::mutex mWorkerMutex;
+    std::condition_variable mWorkerCond;
+    std::atomic<bool> mbStopWorker;
+
+    QFile mJsonFile;
+    int mJsonRank;
 };
 
 #endif // NMLOGGER_H
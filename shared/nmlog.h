@@ -31,6 +31,7 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <atomic>
 
 #ifndef _WIN32
     #include <mpi.h>
@@ -43,6 +44,30 @@
 //}
 //#endif
 
+namespace nmlog
+{
+/*! process-wide log level threshold (0: debug, 1: info, 2: warn,
+ *  3: error, 4: no log) for messages of itk process objects;
+ *  NMProcDebug, NMProcInfo and NMProcWarn don't even construct
+ *  their message if it would be dropped by the logger anyway;
+ *  s. NMLogger::setProcLogLevel()
+ */
+inline std::atomic<int>& procLogLevel()
+{
+#ifdef LUMASS_DEBUG
+    static std::atomic<int> level(0);
+#else
+    static std::atomic<int> level(1);
+#endif
+    return level;
+}
+
+inline bool isProcLogLevelEnabled(int level)
+{
+    return level >= procLogLevel().load(std::memory_order_relaxed);
+}
+}
+
 // ======================================================================
 // DEBUG MACROS
 // ======================================================================
@@ -318,56 +343,74 @@
 
 #define NMLogInfo(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_INFO, \
-                           str.str().c_str()); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_INFO)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_INFO, \
+                               str.str().c_str()); \
+    } \
 }
 
 #define NMLogInfoNoNL(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_INFO, \
-                           str.str().c_str(), false); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_INFO)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_INFO, \
+                               str.str().c_str(), false); \
+    } \
 }
 
 #define NMLogWarn(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_WARN, \
-                           str.str().c_str()); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_WARN)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_WARN, \
+                               str.str().c_str()); \
+    } \
 }
 
 #define NMLogError(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_ERROR, \
-                           str.str().c_str()); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_ERROR)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_ERROR, \
+                               str.str().c_str()); \
+    } \
 }
 
 #define NMLogDebug(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_DEBUG, \
-                           str.str().c_str()); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_DEBUG)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_DEBUG, \
+                               str.str().c_str()); \
+    } \
 }
 
 #define NMLogDebugNoNL(arg) \
 { \
-    std::stringstream str; \
-    str arg; \
-    mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
-                           NMLogger::NM_LOG_DEBUG, \
-                           str.str().c_str(), false); \
+    if (mLogger != nullptr && mLogger->isLogLevelEnabled(NMLogger::NM_LOG_DEBUG)) \
+    { \
+        std::stringstream str; \
+        str arg; \
+        mLogger->processLogMsg(QDateTime::currentDateTime().time().toString(), \
+                               NMLogger::NM_LOG_DEBUG, \
+                               str.str().c_str(), false); \
+    } \
 }
 
 #define NMLogProv(concept, args, attr) mLogger->logProvN(concept, args, attr);
@@ -439,29 +482,38 @@
                     itk::NMLogEvent::NM_LOG_ERROR)); \
         }
 
-#define NMProcWarn(arg)  \
+#define NMProcWarn(arg) \
         { \
-            std::stringstream sstr; \
-            sstr arg; \
-            this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
-                    itk::NMLogEvent::NM_LOG_WARN)); \
+            if (nmlog::isProcLogLevelEnabled(itk::NMLogEvent::NM_LOG_WARN)) \
+            { \
+                std::stringstream sstr; \
+                sstr arg; \
+                this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
+                        itk::NMLogEvent::NM_LOG_WARN)); \
+            } \
         }
 
 #define NMProcInfo(arg) \
-       { \
-            std::stringstream sstr; \
-            sstr arg; \
-            this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
-                   itk::NMLogEvent::NM_LOG_INFO)); \
-       }
+        { \
+            if (nmlog::isProcLogLevelEnabled(itk::NMLogEvent::NM_LOG_INFO)) \
+            { \
+                std::stringstream sstr; \
+                sstr arg; \
+                this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
+                        itk::NMLogEvent::NM_LOG_INFO)); \
+            } \
+        }
 
 #define NMProcDebug(arg) \
-       { \
-            std::stringstream sstr; \
-            sstr arg; \
-            this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
-                   itk::NMLogEvent::NM_LOG_DEBUG)); \
-       }
+        { \
+            if (nmlog::isProcLogLevelEnabled(itk::NMLogEvent::NM_LOG_DEBUG)) \
+            { \
+                std::stringstream sstr; \
+                sstr arg; \
+                this->InvokeEvent(itk::NMLogEvent(sstr.str(), \
+                        itk::NMLogEvent::NM_LOG_DEBUG)); \
+            } \
+        }
 
 #define MPIProcErr( MPICALL )
 //\
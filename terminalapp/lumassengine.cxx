@@ -81,8 +81,25 @@ void showHelp()
     std::cout << "Usage: lumassengine --moso <settings file (*.los)> | "
                                   << "--model <LUMASS model file (*.lmx | *.yaml)> "
                                   << "[--workspace <absolute directory path for '$[LUMASS:Workspace]$'>] "
-                                  << "[--logfile <file name>] [--logprov]"
+                                  << "[--logfile <file name>] [--logprov] "
+                                  << "[--loglevel <debug | info | warn | error>] "
+                                  << "[--logformat <text | json>] "
+                                  << "[--profile <file name (*.json)>] "
+                                  << "[--max-memory <MB>] [--cache]"
                                   << std::endl << std::endl;
+    std::cout << "  --logformat json writes one JSON object per log message "
+              << "(JSON-lines) into the log file from a background thread"
+              << std::endl;
+    std::cout << "  --profile writes a per component execution profile "
+              << "(Chrome trace / Perfetto JSON) of the model run"
+              << std::endl;
+    std::cout << "  --max-memory sets the RAM budget of image writers "
+              << "using the AUTO streaming method"
+              << std::endl;
+    std::cout << "  --cache skips writers whose outputs of a previous "
+              << "iteration or run (with identical parameters and inputs) "
+              << "are still up-to-date; the cache index is kept in the workspace"
+              << std::endl << std::endl;
 }
 
 bool isFileAccessible(const QString& fileName)
@@ -133,7 +150,16 @@ int main(int argc, char** argv)
     QString modelFileName;
     QString logFileName;
     QString workspace;
+    QString profileFileName;
+    int maxMemory = 0;
     bool bLogProv = false;
+    bool bLogJson = false;
+    bool bOutputCache = false;
+#ifdef LUMASS_DEBUG
+    NMLogger::LogEventType logLevel = NMLogger::NM_LOG_DEBUG;
+#else
+    NMLogger::LogEventType logLevel = NMLogger::NM_LOG_INFO;
+#endif
 
     int arg = 1;
     while (arg < argc)
@@ -186,6 +212,70 @@ int main(int argc, char** argv)
         {
             bLogProv = true;
         }
+        else if (theArg == "--profile" && arg+1 < argc)
+        {
+            profileFileName = argv[arg+1];
+            QFileInfo fifo(profileFileName);
+            QFileInfo difo(fifo.absoluteDir().absolutePath());
+            if (!difo.isWritable())
+            {
+                NMWarn(ctx, << "Profile file directory is not writeable!");
+                profileFileName.clear();
+            }
+        }
+        else if (theArg == "--loglevel" && arg+1 < argc)
+        {
+            const QString level = QString(argv[arg+1]).toLower();
+            if (level == "debug")
+            {
+                logLevel = NMLogger::NM_LOG_DEBUG;
+            }
+            else if (level == "info")
+            {
+                logLevel = NMLogger::NM_LOG_INFO;
+            }
+            else if (level == "warn")
+            {
+                logLevel = NMLogger::NM_LOG_WARN;
+            }
+            else if (level == "error")
+            {
+                logLevel = NMLogger::NM_LOG_ERROR;
+            }
+            else
+            {
+                NMWarn(ctx, << "Unknown log level '" << level.toStdString()
+                            << "' - using default!");
+            }
+        }
+        else if (theArg == "--cache")
+        {
+            bOutputCache = true;
+        }
+        else if (theArg == "--max-memory" && arg+1 < argc)
+        {
+            bool bOk = false;
+            maxMemory = QString(argv[arg+1]).toInt(&bOk);
+            if (!bOk || maxMemory <= 0)
+            {
+                NMWarn(ctx, << "Invalid --max-memory '" << argv[arg+1]
+                            << "' - using the writers' streaming size!");
+                maxMemory = 0;
+            }
+        }
+        else if (theArg == "--logformat" && arg+1 < argc)
+        {
+            const QString format = QString(argv[arg+1]).toLower();
+            if (format == "json")
+            {
+                bLogJson = true;
+            }
+            else if (format != "text")
+            {
+                NMWarn(ctx, << "Unknown log format '" << format.toStdString()
+                            << "' - using text!");
+            }
+        }
 
         ++arg;
     }
@@ -208,15 +298,52 @@ int main(int argc, char** argv)
                 .arg(QDate::currentDate().toString())
                 .arg(QTime::currentTime().toString());
 
-        engine->setLogFileName(logFileName);
-        engine->writeLogMsg(logstart);
+        engine->getLogger()->setLogLevel(logLevel);
+        NMLogger::setProcLogLevel(logLevel);
+
+        if (bLogJson)
+        {
+            if (engine->getLogger()->setJsonSink(logFileName))
+            {
+                engine->getLogger()->processLogMsg(QTime::currentTime().toString(),
+                                                   NMLogger::NM_LOG_INFO,
+                                                   logstart);
+            }
+            else
+            {
+                NMErr(ctx, << "Failed creating log file '"
+                           << logFileName.toStdString() << "'!");
+            }
+        }
+        else
+        {
+            engine->setLogFileName(logFileName);
+            engine->writeLogMsg(logstart);
+        }
     }
     else
     {
-        // turn off logging altoghether
+        // turn off logging altoghether, incl.
+        // the assembly of process log messages
         engine->getLogger()->setLogLevel(NMLogger::NM_LOG_NOLOG);
+        NMLogger::setProcLogLevel(NMLogger::NM_LOG_NOLOG);
+    }
+
+
+    if (!profileFileName.isEmpty())
+    {
+        engine->setProfileFileName(QFileInfo(profileFileName).absoluteFilePath());
+    }
+
+    if (maxMemory > 0)
+    {
+        engine->setSetting(QStringLiteral("MaxMemory"), QString::number(maxMemory));
     }
 
+    if (bOutputCache)
+    {
+        engine->setSetting(QStringLiteral("OutputCache"), QStringLiteral("1"));
+    }
 
     switch(todo)
     {
@@ -30,8 +30,25 @@
 
 #include "NMPolygonToTriangles.h"
 
+#include <cstring>
+#include <map>
+#include <memory>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QList>
+#include <QFuture>
+#include <QtConcurrent>
+
 #include "vtkObject.h"
 #include "vtkLongArray.h"
+#include "vtkFloatArray.h"
+#include "vtkTypeInt64Array.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkInformation.h"
@@ -42,11 +59,103 @@
 #include "vtkPolygon.h"
 #include "vtkLookupTable.h"
 #include "vtkDoubleArray.h"
+#include "vtkVersionMacros.h"
 
 #include "avtPolygonToTrianglesTesselator.h"
 
+/*
+ * Triangle cache file layout (native byte order, 8-byte aligned sections)
+ *
+ *  header:         8 x int64: magic "NMTRIS01", source mtime (ms), source size,
+ *                  #input cells, #input points, #points, #triangles, reserved
+ *  points:         #points x 3 float (padded to 8 bytes)
+ *  offsets:        (#triangles + 1) x int64
+ *  connectivity:   #triangles x 3 x int64
+ *  polygon ids:    #triangles x int64
+ *
+ * i.e. points, offsets and connectivity can be used by vtkPoints and
+ * vtkCellArray (VTK >= 9) straight from the mapped file.
+ */
+namespace
+{
+    const char nmtrisMagic[] = "NMTRIS01";
+    const qint64 nmtrisHeaderSize = 8 * sizeof(qint64);
+
+    inline qint64 padTo8(qint64 bytes)
+    {
+        return (bytes + 7) & ~static_cast<qint64>(7);
+    }
+
+    // keeps the mapped cache files alive as long as
+    // any of the arrays referring to them exists
+    QMutex mappedArraysMutex;
+    std::map<void*, std::shared_ptr<QFile> > mappedArrays;
+
+    void releaseMappedArray(void* ptr)
+    {
+        QMutexLocker lock(&mappedArraysMutex);
+        mappedArrays.erase(ptr);
+    }
+}
+
 vtkStandardNewMacro(NMPolygonToTriangles);
 
+std::string
+NMPolygonToTriangles::GetCacheFileName(const std::string& sourceFileName)
+{
+    return sourceFileName + ".nmtris";
+}
+
+void
+NMPolygonToTriangles::tessellateBatch(vtkPoints* inputPts,
+                                      const std::vector<vtkIdType>& cellStart,
+                                      const std::vector<vtkIdType>& cellPts,
+                                      const std::vector<vtkIdType>& polyStart,
+                                      vtkIdType polyBegin, vtkIdType polyEnd,
+                                      TriangleBatch& batch)
+{
+    // one tessellator (and set of points) per batch, so
+    // batches can be processed concurrently
+    vtkSmartPointer<vtkPoints> batchPts = vtkSmartPointer<vtkPoints>::New();
+    batchPts->SetDataTypeToFloat();
+    avtPolygonToTrianglesTesselator tessellator(batchPts);
+    tessellator.SetNormal(0.0,0.0,1.0);
+
+    double coords[3];
+    for (vtkIdType poly=polyBegin; poly < polyEnd; ++poly)
+    {
+        // the outer ring followed by any holes
+        const vtkIdType lastCell = polyStart[poly+1] - 1;
+        for (vtkIdType cell=polyStart[poly]; cell <= lastCell; ++cell)
+        {
+            tessellator.BeginContour();
+            for (vtkIdType p=cellStart[cell]; p < cellStart[cell+1]; ++p)
+            {
+                inputPts->GetPoint(cellPts[p], coords);
+                tessellator.AddContourVertex(coords);
+            }
+            tessellator.EndContour();
+        }
+
+        const int ntris = tessellator.Tessellate();
+        for (int t=0; t < ntris; ++t)
+        {
+            int a, b, c;
+            tessellator.GetTriangleIndices(t, a, b, c);
+            batch.tris.push_back(a);
+            batch.tris.push_back(b);
+            batch.tris.push_back(c);
+
+            // colours are looked up by the id of the last ring
+            batch.polyIds.push_back(lastCell);
+        }
+    }
+
+    vtkFloatArray* pa = vtkFloatArray::SafeDownCast(batchPts->GetData());
+    const float* pp = pa->GetPointer(0);
+    batch.points.assign(pp, pp + batchPts->GetNumberOfPoints() * 3);
+}
+
 int
 NMPolygonToTriangles::RequestData(vtkInformation* vtkNotUsed(request),
                                   vtkInformationVector** inputVector,
@@ -81,25 +190,11 @@ NMPolygonToTriangles::RequestData(vtkInformation* vtkNotUsed(request),
         return 0;
     }
 
-
-    outTris->Allocate(input->GetNumberOfCells()*2);
-    vtkSmartPointer<vtkPoints> outPts = vtkSmartPointer<vtkPoints>::New();
-    outPts->Allocate(input->GetNumberOfCells()*2*3);
-    outTris->SetPoints(outPts);
-
     vtkPoints* inputPts = input->GetPoints();
 
     vtkIdType npolys = inputCells->GetNumberOfCells();
     std::cout << "polys2tris: npolys: " << npolys << "\n";
 
-    vtkIdType numPts;
-    const vtkIdType* pts;
-
-    vtkSmartPointer<vtkLongArray> nm_id = vtkSmartPointer<vtkLongArray>::New();
-    nm_id->SetName("nm_id");
-    nm_id->Allocate(input->GetNumberOfCells()*2*3);
-
-
     // ==========================================================================================
     // create lookup table
     if (InputColors.GetPointer() != nullptr)
@@ -116,81 +211,139 @@ NMPolygonToTriangles::RequestData(vtkInformation* vtkNotUsed(request),
     }
     std::vector<unsigned char> rawclr;
 
-    avtPolygonToTrianglesTesselator tessellator(outPts);
-    tessellator.SetNormal(0.0,0.0,1.0);
-
+    // clear the poly id mapping
+    PolyIds.clear();
 
     // ============================================================================================
-    // tessellate input polygons
-    std::cout << "polys2tris: processing input polygons ... \n";
+    // use the triangle cache, if it's still valid
+    if (this->readTriangleCache(input, outTris))
+    {
+        std::cout << "polys2tris: mapped triangles from '"
+                  << GetCacheFileName(SourceFileName) << "'\n";
+        this->UpdateProgress(1.0);
+        return 1;
+    }
 
-    // clear the poly id mapping
-    PolyIds.clear();
+    // ============================================================================================
+    // copy the cells' point ids and determine polygons,
+    // i.e. the outer ring followed by its hole cells
+    std::vector<vtkIdType> cellStart;
+    std::vector<vtkIdType> cellPts;
+    std::vector<vtkIdType> polyStart;
+    cellStart.reserve(npolys+1);
+    cellPts.reserve(inputCells->GetNumberOfConnectivityEntries());
 
+    vtkIdType numPts;
+    const vtkIdType* pts;
     inputCells->InitTraversal();
-    vtkIdType triscount = 0;
-    for (vtkIdType polycount=0; polycount < npolys && !this->GetAbortExecute(); ++polycount)
+    for (vtkIdType cell=0; cell < npolys; ++cell)
     {
+        inputCells->GetNextCell(numPts, pts);
+        cellStart.push_back(cellPts.size());
+        cellPts.insert(cellPts.end(), pts, pts + numPts);
 
-        //        std::cout << "\tcell id: " << polycount << " ring: 0 \n";
-
-        // get the input color
-        unsigned char tupleClr[] = {1,1,1,1};
-        if (InputColors.GetPointer() != nullptr)
+        if (cell == 0 || hole->GetValue(cell) != 1)
         {
-            vtkLookupTable::GetColorAsUnsignedChars(InputColors->GetTableValue(polycount), tupleClr);
+            polyStart.push_back(cell);
         }
+    }
+    cellStart.push_back(cellPts.size());
+    const vtkIdType numOuter = polyStart.size();
+    polyStart.push_back(npolys);
 
-        // add the first contour we always have
-        inputCells->GetNextCell(numPts, pts);
-        tessellator.BeginContour();
-        for (int p=0; p < numPts; ++p)
+    // ============================================================================================
+    // tessellate input polygons in batches on worker threads
+    std::cout << "polys2tris: processing input polygons ... \n";
+
+    const int nthreads = NumberOfThreads > 0 ? NumberOfThreads : QThread::idealThreadCount();
+    const vtkIdType nbatches = std::max(static_cast<vtkIdType>(1),
+                                        std::min(numOuter, static_cast<vtkIdType>(std::max(nthreads, 1) * 4)));
+    const vtkIdType batchSize = (numOuter + nbatches - 1) / nbatches;
+
+    std::vector<TriangleBatch> batches(nbatches);
+    QList<QFuture<void> > futures;
+    for (vtkIdType b=0; b < nbatches; ++b)
+    {
+        const vtkIdType polyBegin = std::min(b * batchSize, numOuter);
+        const vtkIdType polyEnd = std::min(polyBegin + batchSize, numOuter);
+        TriangleBatch* batch = &batches[b];
+        futures << QtConcurrent::run([inputPts, &cellStart, &cellPts, &polyStart,
+                                      polyBegin, polyEnd, batch]()
         {
-            double coords[3];
-            inputPts->GetPoint(pts[p], coords);
-            tessellator.AddContourVertex(coords);
-        }
-        tessellator.EndContour();
+            NMPolygonToTriangles::tessellateBatch(inputPts, cellStart, cellPts, polyStart,
+                                                  polyBegin, polyEnd, *batch);
+        });
+    }
+
+    vtkIdType totalPts = 0;
+    vtkIdType totalTris = 0;
+    for (int b=0; b < futures.size(); ++b)
+    {
+        futures[b].waitForFinished();
+        totalPts += batches[b].points.size() / 3;
+        totalTris += batches[b].polyIds.size();
+        this->UpdateProgress((float)(b+1) / futures.size());
+    }
 
-        // add more rings to the polygon if we've got
-        // a hole filed in the poly data set
-        // (wouldn't know how to detect more rings otherwise ... )
-        if (hole != nullptr)
+    // ============================================================================================
+    // write the cache and map it, or otherwise assemble the output
+    if (    npolys >= CacheMinPolygons
+        &&  this->writeTriangleCache(input, batches)
+        &&  this->readTriangleCache(input, outTris)
+       )
+    {
+        std::cout << "polys2tris: cached triangles in '"
+                  << GetCacheFileName(SourceFileName) << "'\n";
+    }
+    else
+    {
+        vtkSmartPointer<vtkPoints> outPts = vtkSmartPointer<vtkPoints>::New();
+        outPts->SetDataTypeToFloat();
+        outPts->SetNumberOfPoints(totalPts);
+        float* outPtsBuf = vtkFloatArray::SafeDownCast(outPts->GetData())->GetPointer(0);
+
+        vtkSmartPointer<vtkCellArray> outCells = vtkSmartPointer<vtkCellArray>::New();
+        outCells->Allocate(totalTris * 4);
+
+        vtkSmartPointer<vtkLongArray> nm_id = vtkSmartPointer<vtkLongArray>::New();
+        nm_id->SetName("nm_id");
+        nm_id->SetNumberOfValues(totalTris);
+
+        PolyIds.reserve(totalTris);
+        vtkIdType ptOffset = 0;
+        vtkIdType triscount = 0;
+        for (vtkIdType b=0; b < nbatches; ++b)
         {
-            while (polycount < npolys-1 && hole->GetValue(polycount+1) == 1)
+            TriangleBatch& batch = batches[b];
+            std::copy(batch.points.begin(), batch.points.end(), outPtsBuf + ptOffset * 3);
+
+            const vtkIdType ntris = batch.polyIds.size();
+            for (vtkIdType t=0; t < ntris; ++t)
             {
-                inputCells->GetNextCell(numPts, pts);
-                tessellator.BeginContour();
-                for (int r=0; r < numPts; ++r)
-                {
-                    double ring[3];
-                    inputPts->GetPoint(pts[r], ring);
-                    tessellator.AddContourVertex(ring);
-                }
-                tessellator.EndContour();
-                ++polycount;
+                const vtkIdType ids[3] = {batch.tris[t*3] + ptOffset,
+                                          batch.tris[t*3+1] + ptOffset,
+                                          batch.tris[t*3+2] + ptOffset};
+                outCells->InsertNextCell(3, ids);
+                nm_id->SetValue(triscount, triscount);
+                PolyIds.push_back(batch.polyIds[t]);
+                ++triscount;
             }
-        }
+            ptOffset += batch.points.size() / 3;
 
-        int ntris = tessellator.Tessellate(outTris);
-        for (int t=0; t < ntris; ++t)
-        {
-            nm_id->InsertValue(triscount, triscount);
-            PolyIds.push_back(polycount);
-            ++triscount;
+            // free the batch as we go
+            std::vector<float>().swap(batch.points);
+            std::vector<vtkIdType>().swap(batch.tris);
+            std::vector<vtkIdType>().swap(batch.polyIds);
         }
 
-        this->UpdateProgress((float)polycount / npolys);
+        outTris->SetPoints(outPts);
+        outTris->SetPolys(outCells);
+        outTris->GetCellData()->SetScalars(nm_id);
+        outTris->BuildCells();
     }
-    nm_id->Squeeze();
-    outPts->Squeeze();
-    outTris->Squeeze();
-    outTris->GetCellData()->SetScalars(nm_id);
-    outTris->BuildCells();
-
 
     vtkIdType nTriCells = outTris->GetPolys()->GetNumberOfCells();
-    vtkDebugMacro(<< "polys2tris: triscount: " << triscount-1 << "\n");
+    vtkDebugMacro(<< "polys2tris: triscount: " << totalTris-1 << "\n");
     vtkDebugMacro(<< "polys2tris: nTriCells: " << nTriCells-1 << "\n");
 
     // construct output lookup table from rawclr vector
@@ -212,6 +365,205 @@ NMPolygonToTriangles::RequestData(vtkInformation* vtkNotUsed(request),
     return 1;
 }
 
+bool
+NMPolygonToTriangles::writeTriangleCache(vtkPolyData* input,
+                                         const std::vector<TriangleBatch>& batches)
+{
+    QFileInfo srcInfo(QString::fromStdString(SourceFileName));
+    if (SourceFileName.empty() || !srcInfo.isFile())
+    {
+        return false;
+    }
+
+    qint64 npts = 0;
+    qint64 ntris = 0;
+    for (size_t b=0; b < batches.size(); ++b)
+    {
+        npts += batches[b].points.size() / 3;
+        ntris += batches[b].polyIds.size();
+    }
+    if (ntris == 0)
+    {
+        return false;
+    }
+
+    QSaveFile cacheFile(QString::fromStdString(GetCacheFileName(SourceFileName)));
+    if (!cacheFile.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    qint64 header[8];
+    std::memcpy(&header[0], nmtrisMagic, sizeof(qint64));
+    header[1] = srcInfo.lastModified().toMSecsSinceEpoch();
+    header[2] = srcInfo.size();
+    header[3] = input->GetPolys()->GetNumberOfCells();
+    header[4] = input->GetNumberOfPoints();
+    header[5] = npts;
+    header[6] = ntris;
+    header[7] = 0;
+    cacheFile.write(reinterpret_cast<const char*>(header), nmtrisHeaderSize);
+
+    // points
+    for (size_t b=0; b < batches.size(); ++b)
+    {
+        cacheFile.write(reinterpret_cast<const char*>(batches[b].points.data()),
+                        batches[b].points.size() * sizeof(float));
+    }
+    const qint64 ptsBytes = npts * 3 * sizeof(float);
+    const char pad[8] = {0};
+    cacheFile.write(pad, padTo8(ptsBytes) - ptsBytes);
+
+    // offsets
+    std::vector<qint64> buf;
+    buf.reserve(ntris + 1);
+    for (qint64 t=0; t <= ntris; ++t)
+    {
+        buf.push_back(t * 3);
+    }
+    cacheFile.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(qint64));
+
+    // connectivity, shifted by the batches' point offsets
+    qint64 ptOffset = 0;
+    for (size_t b=0; b < batches.size(); ++b)
+    {
+        buf.assign(batches[b].tris.begin(), batches[b].tris.end());
+        for (size_t i=0; i < buf.size(); ++i)
+        {
+            buf[i] += ptOffset;
+        }
+        cacheFile.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(qint64));
+        ptOffset += batches[b].points.size() / 3;
+    }
+
+    // polygon ids
+    for (size_t b=0; b < batches.size(); ++b)
+    {
+        buf.assign(batches[b].polyIds.begin(), batches[b].polyIds.end());
+        cacheFile.write(reinterpret_cast<const char*>(buf.data()), buf.size() * sizeof(qint64));
+    }
+
+    return cacheFile.commit();
+}
+
+bool
+NMPolygonToTriangles::readTriangleCache(vtkPolyData* input, vtkPolyData* outTris)
+{
+    if (SourceFileName.empty())
+    {
+        return false;
+    }
+
+    QFileInfo srcInfo(QString::fromStdString(SourceFileName));
+    std::shared_ptr<QFile> cacheFile = std::make_shared<QFile>(
+                QString::fromStdString(GetCacheFileName(SourceFileName)));
+    if (!srcInfo.isFile() || !cacheFile->open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const qint64 fileSize = cacheFile->size();
+    if (fileSize < nmtrisHeaderSize)
+    {
+        return false;
+    }
+
+    // private mapping, so that any changes to the arrays
+    // don't make it back into the cache
+    uchar* base = cacheFile->map(0, fileSize, QFileDevice::MapPrivateOption);
+    if (base == nullptr)
+    {
+        return false;
+    }
+
+    const qint64* header = reinterpret_cast<const qint64*>(base);
+    const qint64 npts = header[5];
+    const qint64 ntris = header[6];
+    if (    std::memcmp(&header[0], nmtrisMagic, sizeof(qint64)) != 0
+        ||  header[1] != srcInfo.lastModified().toMSecsSinceEpoch()
+        ||  header[2] != srcInfo.size()
+        ||  header[3] != input->GetPolys()->GetNumberOfCells()
+        ||  header[4] != input->GetNumberOfPoints()
+        ||  npts <= 0 || ntris <= 0
+       )
+    {
+        return false;
+    }
+
+    const qint64 ptsOffset = nmtrisHeaderSize;
+    const qint64 offsOffset = ptsOffset + padTo8(npts * 3 * sizeof(float));
+    const qint64 connOffset = offsOffset + (ntris + 1) * sizeof(qint64);
+    const qint64 polyOffset = connOffset + ntris * 3 * sizeof(qint64);
+    if (polyOffset + ntris * static_cast<qint64>(sizeof(qint64)) != fileSize)
+    {
+        return false;
+    }
+
+    float* ptsBuf = reinterpret_cast<float*>(base + ptsOffset);
+    vtkTypeInt64* offsBuf = reinterpret_cast<vtkTypeInt64*>(base + offsOffset);
+    vtkTypeInt64* connBuf = reinterpret_cast<vtkTypeInt64*>(base + connOffset);
+    const qint64* polyBuf = reinterpret_cast<const qint64*>(base + polyOffset);
+
+    vtkSmartPointer<vtkFloatArray> ptsArray = vtkSmartPointer<vtkFloatArray>::New();
+    ptsArray->SetNumberOfComponents(3);
+    vtkSmartPointer<vtkCellArray> outCells = vtkSmartPointer<vtkCellArray>::New();
+
+#if VTK_MAJOR_VERSION >= 9
+    // use the mapped points and cells straight away; the mapping
+    // is released once the last of the arrays is gone
+    vtkSmartPointer<vtkTypeInt64Array> offsArray = vtkSmartPointer<vtkTypeInt64Array>::New();
+    vtkSmartPointer<vtkTypeInt64Array> connArray = vtkSmartPointer<vtkTypeInt64Array>::New();
+    {
+        QMutexLocker lock(&mappedArraysMutex);
+        mappedArrays[ptsBuf] = cacheFile;
+        mappedArrays[offsBuf] = cacheFile;
+        mappedArrays[connBuf] = cacheFile;
+    }
+
+    ptsArray->SetArray(ptsBuf, npts * 3, 0, vtkFloatArray::VTK_DATA_ARRAY_USER_DEFINED);
+    ptsArray->SetArrayFreeFunction(releaseMappedArray);
+    offsArray->SetArray(offsBuf, ntris + 1, 0, vtkTypeInt64Array::VTK_DATA_ARRAY_USER_DEFINED);
+    offsArray->SetArrayFreeFunction(releaseMappedArray);
+    connArray->SetArray(connBuf, ntris * 3, 0, vtkTypeInt64Array::VTK_DATA_ARRAY_USER_DEFINED);
+    connArray->SetArrayFreeFunction(releaseMappedArray);
+
+    outCells->SetData(offsArray, connArray);
+#else
+    // legacy cell arrays have a different layout, so we copy
+    ptsArray->SetNumberOfTuples(npts);
+    std::copy(ptsBuf, ptsBuf + npts * 3, ptsArray->GetPointer(0));
+
+    outCells->Allocate(ntris * 4);
+    for (qint64 t=0; t < ntris; ++t)
+    {
+        const vtkIdType ids[3] = {static_cast<vtkIdType>(connBuf[t*3]),
+                                  static_cast<vtkIdType>(connBuf[t*3+1]),
+                                  static_cast<vtkIdType>(connBuf[t*3+2])};
+        outCells->InsertNextCell(3, ids);
+    }
+#endif
+
+    vtkSmartPointer<vtkPoints> outPts = vtkSmartPointer<vtkPoints>::New();
+    outPts->SetData(ptsArray);
+
+    vtkSmartPointer<vtkLongArray> nm_id = vtkSmartPointer<vtkLongArray>::New();
+    nm_id->SetName("nm_id");
+    nm_id->SetNumberOfValues(ntris);
+    PolyIds.resize(ntris);
+    for (qint64 t=0; t < ntris; ++t)
+    {
+        nm_id->SetValue(t, t);
+        PolyIds[t] = polyBuf[t];
+    }
+
+    outTris->SetPoints(outPts);
+    outTris->SetPolys(outCells);
+    outTris->GetCellData()->SetScalars(nm_id);
+    outTris->BuildCells();
+
+    return true;
+}
+
 
 void NMPolygonToTriangles::reportTris(vtkPolyData *pd, int minCell, int maxCell)
 {
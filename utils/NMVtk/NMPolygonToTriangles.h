@@ -34,8 +34,10 @@
 #include "vtkPolyDataAlgorithm.h"
 
 #include <string>
+#include <vector>
 
 class vtkLookupTable;
+class vtkPoints;
 
 
 class NMPolygonToTriangles : public vtkPolyDataAlgorithm
@@ -52,14 +54,59 @@ public:
 
     std::vector<vtkIdType> GetPolyIdMap() {return PolyIds;}
 
+    /*! Name of the file the input polygons were read from; if set,
+     *  the triangles are cached in '<SourceFileName>.nmtris' and
+     *  memory-mapped from there as long as the source file's
+     *  modification time and size haven't changed
+     */
+    void SetSourceFileName(const std::string& fileName)
+        {SourceFileName = fileName; this->Modified();}
+    std::string GetSourceFileName() {return SourceFileName;}
+
+    /*! Min number of input polygons for writing a triangle cache */
+    vtkSetMacro(CacheMinPolygons, vtkIdType)
+    vtkGetMacro(CacheMinPolygons, vtkIdType)
+
+    /*! Number of worker threads; <= 0 uses the ideal thread count */
+    vtkSetMacro(NumberOfThreads, int)
+    vtkGetMacro(NumberOfThreads, int)
+
+    static std::string GetCacheFileName(const std::string& sourceFileName);
+
 protected:
-    NMPolygonToTriangles() {}
+    NMPolygonToTriangles()
+        : CacheMinPolygons(10000), NumberOfThreads(0) {}
     ~NMPolygonToTriangles() override {}
 
     int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
     void reportTris(vtkPolyData* pd, int minCell=-1, int maxCell=-1);
 
+    /*! triangles of a contiguous range of polygons; point ids refer
+     *  to the batch's own points */
+    struct TriangleBatch
+    {
+        std::vector<float> points;
+        std::vector<vtkIdType> tris;
+        std::vector<vtkIdType> polyIds;
+    };
+
+    /*! tessellates polygons [polyBegin, polyEnd), i.e. the outer ring
+     *  cell polyStart[p] and its hole cells up to polyStart[p+1] */
+    static void tessellateBatch(vtkPoints* inputPts,
+                                const std::vector<vtkIdType>& cellStart,
+                                const std::vector<vtkIdType>& cellPts,
+                                const std::vector<vtkIdType>& polyStart,
+                                vtkIdType polyBegin, vtkIdType polyEnd,
+                                TriangleBatch& batch);
+
+    bool readTriangleCache(vtkPolyData* input, vtkPolyData* outTris);
+    bool writeTriangleCache(vtkPolyData* input, const std::vector<TriangleBatch>& batches);
+
+    std::string SourceFileName;
+    vtkIdType CacheMinPolygons;
+    int NumberOfThreads;
+
     vtkPolyData* m_Source;
     vtkPolyData* m_Output;
 
@@ -3621,6 +3621,11 @@ void NMVtkOpenGLPolyDataMapper2::RenderPiece(vtkRenderer* ren, vtkActor* actor)
   {
       vtkSmartPointer<NMPolygonToTriangles> tess = vtkSmartPointer<NMPolygonToTriangles>::New();
       tess->SetInputData(this->GetInput());
+      // the cache only reflects the polygons as read from file
+      if (m_Tris.GetPointer() == nullptr)
+      {
+          tess->SetSourceFileName(this->SourceFileName);
+      }
       tess->Update();
       this->m_Tris = tess->GetOutput();
       this->CurrentInput = m_Tris;
@@ -102,6 +102,13 @@ public:
   vtkGetMacro(PopulateSelectionSettings, int);
   void SetPopulateSelectionSettings(int v) { this->PopulateSelectionSettings = v; }
 
+  /**
+   * Source file of the input polygons; used for caching their
+   * tessellation (s. NMPolygonToTriangles::SetSourceFileName)
+   */
+  void SetSourceFileName(const std::string& fileName) { this->SourceFileName = fileName; }
+  std::string GetSourceFileName() { return this->SourceFileName; }
+
   /**
    * WARNING: INTERNAL METHOD - NOT INTENDED FOR GENERAL USE
    * DO NOT USE THIS METHOD OUTSIDE OF THE RENDERING PROCESS
@@ -506,6 +513,7 @@ protected:
 
   std::vector<vtkIdType> TriIdsToPolyIds;
   vtkMTimeType LastColorChange;
+  std::string SourceFileName;
 
   vtkSmartPointer<vtkPolyData> m_Tris;
   vtkSmartPointer<vtkPolyData> m_OrigInput;